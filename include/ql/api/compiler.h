@@ -364,6 +364,45 @@ public:
      */
     void compile_with_frontend(const Platform &platform);
 
+    /**
+     * Ensures that all passes have been constructed, and then reads each of
+     * the given cQASM 1.2 files and runs the passes on it. The files are read
+     * up front by a single cQASM reader for the given platform, parsing and
+     * analyzing them in parallel using the given number of threads, where 0
+     * means the number of hardware threads. The passes are then run on each
+     * program in turn, in the order of the given list. The pass list should
+     * therefore not start with a cQASM reader pass, and @ql.platform
+     * annotations in the cQASM files are ignored. The read options of the cQASM
+     * reader pass are not supported; the defaults are used.
+     */
+    void compile_cqasm_files(
+        const Platform &platform,
+        const std::vector<std::string> &fnames,
+        size_t num_threads = 0
+    );
+
+    /**
+     * Prints the profiling information recorded during the most recent
+     * compilation using this compiler, i.e. the wall-clock time, CPU time, and
+     * peak memory increase of each pass and pass group, as well as the number
+     * of statements and gates in the program before and after. Profiling
+     * information is only recorded when the `profile_passes` option is set.
+     */
+    void print_profile() const;
+
+    /**
+     * Returns the profiling information recorded during the most recent
+     * compilation using this compiler as a string.
+     */
+    std::string dump_profile() const;
+
+    /**
+     * Writes the profiling information recorded during the most recent
+     * compilation using this compiler to the given file. The file is written
+     * in CSV format if its name ends in `.csv`, or in JSON format otherwise.
+     */
+    void write_profile(const std::string &filename) const;
+
 };
 
 } // namespace api
@@ -195,11 +195,44 @@ public:
     void print_interaction_matrix() const;
 
     /**
-     * Writes the interaction matrix for each kernel in the program to a file.
-     * This is one of the few functions that still uses the global output_dir
-     * option.
+     * Returns the qubit interaction matrix of the kernel with the given index,
+     * counting only CNOT gates. The matrix is flattened in row-major order:
+     * element i * N + j is the number of counted gates between qubits i and j,
+     * where N is the number of qubits of the kernel. Operand order is not
+     * respected, so the matrix is symmetric.
      */
-    void write_interaction_matrix() const;
+    std::vector<size_t> get_qubit_interaction_matrix(size_t kernel_index = 0) const;
+
+    /**
+     * Same as get_qubit_interaction_matrix(size_t), but counts the two-qubit
+     * gates of the given instructions. Instructions are identified by their
+     * name without any specialization or template operands, so "cz" also
+     * counts gates of the specialized instruction "cz q0,q1". If the list is
+     * empty, all two-qubit gates are counted.
+     */
+    std::vector<size_t> get_qubit_interaction_matrix(
+        size_t kernel_index,
+        const std::vector<std::string> &instruction_names
+    ) const;
+
+    /**
+     * Writes the interaction matrix for each kernel in the program to a file,
+     * counting only CNOT gates. This is one of the few functions that still
+     * uses the global output_dir option. The files are named
+     * "<kernel>InteractionMatrix.dat", or "<kernel>InteractionMatrix.csv" if
+     * csv is set, in which case only the nonzero elements of the upper half of
+     * the matrix are written, as qubit0,qubit1,count lines.
+     */
+    void write_interaction_matrix(bool csv = false) const;
+
+    /**
+     * Same as write_interaction_matrix(bool), but counts the two-qubit gates
+     * of the given instructions, as for get_qubit_interaction_matrix().
+     */
+    void write_interaction_matrix(
+        bool csv,
+        const std::vector<std::string> &instruction_names
+    ) const;
 
 };
 
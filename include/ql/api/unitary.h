@@ -54,6 +54,23 @@ public:
      */
     static bool is_decompose_support_enabled();
 
+    /**
+     * Configures the cache for unitary decompositions, such that unitary gates
+     * with the same matrix are only decomposed once. At most max_entries
+     * decompositions are kept in memory, evicting the least recently used one
+     * when full; 0 disables the in-memory cache. If directory is nonempty,
+     * decompositions are also stored in and loaded from files in that
+     * directory, so they can be reused by later runs. Both are disabled by
+     * default.
+     */
+    static void set_decomposition_cache(size_t max_entries, const std::string &directory = "");
+
+    /**
+     * Removes all decompositions from the in-memory decomposition cache. Files
+     * in the on-disk cache directory are not removed.
+     */
+    static void clear_decomposition_cache();
+
 };
 
 } // namespace api
@@ -7,6 +7,9 @@
 #include "ql/utils/num.h"
 #include "ql/utils/str.h"
 #include "ql/utils/vec.h"
+#include "ql/utils/pair.h"
+#include "ql/utils/map.h"
+#include "ql/utils/set.h"
 #include "ql/ir/compat/compat.h"
 
 namespace ql {
@@ -16,44 +19,172 @@ namespace ana {
 // TODO JvS: this is really just an "advanced" metric, and should be written
 //  as such sometime.
 
+/**
+ * Decides which gates are counted as interactions by InteractionMatrix. A gate
+ * is counted when it has exactly two qubit operands and it is an instance of
+ * one of the configured instructions; if no instructions are configured, all
+ * two-qubit gates are counted. Instructions are identified by their name
+ * without any specialization or template operands, so "cz" also matches a gate
+ * of the specialized instruction "cz q0,q1", but not one of "cz_park". The
+ * decision is made once per distinct gate name and then cached.
+ */
+class InteractionGateClass {
+private:
+
+    /**
+     * The names of the instructions that are counted.
+     */
+    utils::Set<utils::Str> instruction_names;
+
+    /**
+     * Cache of the decision for each gate name seen so far.
+     */
+    utils::Map<utils::Str, utils::Bool> cache;
+
+public:
+
+    /**
+     * Constructs a gate class for the given instruction names. The default
+     * only counts CNOT gates.
+     */
+    explicit InteractionGateClass(const utils::Vec<utils::Str> &instruction_names = {"cnot"});
+
+    /**
+     * Returns whether the given gate is counted as an interaction.
+     */
+    utils::Bool contains(const ir::compat::Gate &gate);
+
+};
+
 /**
  * Utility for counting the number of two-qubit gates, grouped by their qubit
  * operands.
+ *
+ * The counts are stored sparsely in compressed sparse row (CSR) form, so the
+ * memory needed depends on the number of distinct interacting qubit pairs
+ * rather than on the square of the number of qubits. Operand order is not
+ * respected; the matrix is symmetric, and both halves are stored, such that
+ * every row lists all the qubits that the row qubit interacts with.
  */
 class InteractionMatrix {
-private:
+public:
 
     /**
-     * Shorthand for the matrix type.
+     * Shorthand for the dense matrix type.
      */
     using Matrix = utils::Vec<utils::Vec<utils::UInt>>;
 
+    /**
+     * A nonzero element of a row of the matrix.
+     */
+    struct Element {
+
+        /**
+         * The qubit that the row qubit interacts with.
+         */
+        utils::UInt qubit;
+
+        /**
+         * The number of counted gates between the two qubits.
+         */
+        utils::UInt count;
+
+    };
+
+private:
+
     /**
      * Size of the matrix, i.e. the number of qubits.
      */
-    const utils::UInt size;
+    utils::UInt size;
 
     /**
-     * Square matrix of unsigned integers, representing the number of two-qubit
-     * gates spanning the indexed qubits. Operand order is not respected; the
-     * matrix is symmetric.
+     * For each row (qubit), the index of its first element in elements. Has
+     * size + 1 entries; the last is the total number of elements.
      */
-    Matrix matrix;
+    utils::Vec<utils::UInt> row_start;
+
+    /**
+     * The nonzero elements, grouped by row and ordered by column within each
+     * row.
+     */
+    utils::Vec<Element> elements;
+
+    /**
+     * Computes the matrix for the given kernel and gate class. Used by the
+     * constructors.
+     */
+    void build(const ir::compat::KernelRef &kernel, InteractionGateClass &gate_class);
 
 public:
 
     /**
-     * Computes the interaction matrix for the given kernel.
+     * Computes the interaction matrix for the given kernel, counting only CNOT
+     * gates.
+     */
+    explicit InteractionMatrix(const ir::compat::KernelRef &kernel);
+
+    /**
+     * Computes the interaction matrix for the given kernel, counting the gates
+     * in the given gate class. The cache of the gate class is updated, so it
+     * can be reused for other kernels.
+     */
+    InteractionMatrix(
+        const ir::compat::KernelRef &kernel,
+        InteractionGateClass &gate_class
+    );
+
+    /**
+     * Computes the interaction matrices for all kernels of the given program
+     * in a single pass, sharing the gate classification between kernels.
+     */
+    static utils::Vec<InteractionMatrix> for_program(
+        const ir::compat::ProgramRef &program,
+        const utils::Vec<utils::Str> &instruction_names = {"cnot"}
+    );
+
+    /**
+     * Returns the number of qubits, i.e. the number of rows and columns.
+     */
+    utils::UInt get_size() const;
+
+    /**
+     * Returns the number of nonzero elements, counting both halves of the
+     * matrix.
+     */
+    utils::UInt get_num_elements() const;
+
+    /**
+     * Returns the nonzero elements in the row for the given qubit, ordered by
+     * column. The pointers delimit a range within the internal storage.
+     */
+    utils::Pair<const Element*, const Element*> get_row(utils::UInt qubit) const;
+
+    /**
+     * Returns the number of counted gates between the given qubits.
+     */
+    utils::UInt get_count(utils::UInt qubit0, utils::UInt qubit1) const;
+
+    /**
+     * Returns the matrix in dense form. Note that this needs memory quadratic
+     * in the number of qubits.
+     */
+    Matrix get_matrix() const;
+
+    /**
+     * Writes the matrix in dense, human-readable form to the given stream.
      */
-    InteractionMatrix(const ir::compat::KernelRef &kernel);
+    void dump(std::ostream &os) const;
 
     /**
-     * Returns the embedded matrix.
+     * Writes the nonzero elements of the upper half of the matrix to the given
+     * stream as CSV, one line with qubit0, qubit1, and the count per qubit
+     * pair, preceded by a header line.
      */
-    const Matrix &get_matrix() const;
+    void dump_csv(std::ostream &os) const;
 
     /**
-     * Returns the matrix as a string.
+     * Returns the matrix as a string, in the format of dump().
      */
     utils::Str get_string() const;
 
@@ -66,9 +197,17 @@ public:
     /**
      * Same as dump_for_program(), but writes the result to files in the
      * current globally-configured output directory, using the names
-     * "<prefix><kernel>InteractionMatrix.dat".
+     * "<prefix><kernel>InteractionMatrix.dat". If csv is set, the sparse CSV
+     * format of dump_csv() is written instead, to files named
+     * "<prefix><kernel>InteractionMatrix.csv". instruction_names selects the
+     * counted gates, as for InteractionGateClass.
      */
-    static void write_for_program(const utils::Str &output_prefix, const ir::compat::ProgramRef &program);
+    static void write_for_program(
+        const utils::Str &output_prefix,
+        const ir::compat::ProgramRef &program,
+        utils::Bool csv = false,
+        const utils::Vec<utils::Str> &instruction_names = {"cnot"}
+    );
 
 };
 
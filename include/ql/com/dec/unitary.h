@@ -71,6 +71,23 @@ public:
      */
     static utils::Bool is_decompose_support_enabled();
 
+    /**
+     * Configures the process-wide cache for unitary decompositions, which is
+     * keyed by the contents of the matrix. At most max_entries decompositions
+     * are kept in memory, evicting the least recently used one when full; 0
+     * disables the in-memory cache. If directory is nonempty, decompositions
+     * are also stored in and loaded from files in that directory, which is
+     * interpreted relative to the current OpenQL working directory. Both are
+     * disabled by default.
+     */
+    static void set_cache(utils::UInt max_entries, const utils::Str &directory = "");
+
+    /**
+     * Removes all decompositions from the in-memory cache. Files in the on-disk
+     * cache directory are not removed.
+     */
+    static void clear_cache();
+
     /**
      * Returns the decomposed circuit.
      */
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include "ql/utils/num.h"
 #include "ql/utils/opt.h"
 #include "ql/ir/ir.h"
@@ -42,29 +43,6 @@ namespace sch {
 template <typename HeuristicComparator = TrivialHeuristic>
 class Scheduler {
 
-    /**
-     * Criticality comparator for the availability list/set. The most critical
-     * statement will end up in the front, so set iteration starts with the most
-     * critical instruction. This uses the heuristic provided as template
-     * argument to the surrounding function, and falls back on the original
-     * statement order as recorded when the DDG was constructed for stability.
-     */
-    struct AvailableListComparator {
-        utils::Bool operator()(const ir::StatementRef &lhs, const ir::StatementRef &rhs) const {
-
-            // The heuristic implements "criticality less than," which would
-            // result in reverse order, so we swap the value here.
-            HeuristicComparator heuristic;
-            if (heuristic(rhs, lhs)) return true;
-            if (heuristic(lhs, rhs)) return false;
-
-            // If the heuristic says both RHS and LHS are equal, fall back to
-            // the original statement order.
-            return com::ddg::get_node(lhs)->order < com::ddg::get_node(rhs)->order;
-
-        }
-    };
-
     /**
      * Returns whether the absolute value of a is less than the absolute value
      * of b.
@@ -92,6 +70,60 @@ class Scheduler {
         }
     };
 
+    /**
+     * Immutable data structures derived from the block and its data dependency
+     * graph when the scheduler is constructed. The statements are assigned a
+     * dense index in the order in which the DDG builder encountered them, so
+     * the rest of the scheduler state can be kept in flat arrays rather than
+     * in sets and maps keyed by statement references. This is shared between
+     * copies of the scheduler.
+     */
+    struct Graph {
+
+        /**
+         * The statements by index, including the source (index 0) and sink
+         * (the last index).
+         */
+        utils::Vec<ir::StatementRef> statements;
+
+        /**
+         * Map from statement to its index.
+         */
+        utils::Map<ir::StatementRef, utils::UInt> indices;
+
+        /**
+         * The DDG successors of each statement, as pairs of the successor
+         * index and the weight of the edge to it.
+         */
+        utils::Vec<utils::Vec<utils::Pair<utils::UInt, utils::Int>>> successors;
+
+        /**
+         * The number of DDG predecessors of each statement.
+         */
+        utils::Vec<utils::UInt> num_predecessors;
+
+        /**
+         * The criticality rank of each statement, where rank 0 is the most
+         * critical. The heuristic only looks at statements that have not been
+         * scheduled yet, and for those its result does not change while
+         * scheduling, so the complete order can be determined in advance. Ties
+         * are broken using the original statement order, as recorded when the
+         * DDG was constructed, for stability.
+         */
+        utils::Vec<utils::UInt> ranks;
+
+        /**
+         * The inverse of ranks, i.e. the statement index for each rank.
+         */
+        utils::Vec<utils::UInt> by_rank;
+
+    };
+
+    /**
+     * The immutable graph data for this scheduler.
+     */
+    utils::Ptr<Graph> graph;
+
     /**
      * The block that we're scheduling for.
      */
@@ -116,40 +148,116 @@ class Scheduler {
     utils::Opt<rmgr::State> resource_state;
 
     /**
-     * Set of statements that have been scheduled.
+     * For each statement, the number of DDG predecessors that have not been
+     * scheduled yet.
+     */
+    utils::Vec<utils::UInt> num_unscheduled_predecessors;
+
+    /**
+     * For each statement, the cycle in which it becomes available as far as
+     * the predecessors scheduled thus far are concerned.
      */
-    utils::Set<ir::StatementRef> scheduled;
+    utils::Vec<utils::Int> available_from_cycle;
 
     /**
-     * List of available statements, i.e. statements we can immediately schedule
+     * Number of statements that have been scheduled.
+     */
+    utils::UInt num_scheduled;
+
+    /**
+     * Set of available statements, i.e. statements we can immediately schedule
      * as far as the data dependency graph is concerned (but not necessarily as
-     * far as the resource constraints are concerned). Per the comparator,
-     * forward iteration over the set yields statements starting from the most
-     * critical one per the HeuristicComparator template argument.
+     * far as the resource constraints are concerned), represented by their
+     * criticality rank. Forward iteration over the set thus yields statements
+     * starting from the most critical one per the HeuristicComparator template
+     * argument.
      */
-    utils::Set<ir::StatementRef, AvailableListComparator> available;
+    utils::Set<utils::UInt> available;
 
     /**
      * The statements for which all predecessors have been scheduled, but which
      * aren't available yet because of edge weights/preceding statement
-     * duration. The key is the cycle in which the accompanied list of
-     * statements becomes valid. The comparator ensures that the first cycle
-     * we'll encounter when scheduling will appear at the front, because we
-     * always schedule away from cycle 0 regardless of the scheduling direction.
+     * duration, represented by their index. The key is the cycle in which the
+     * accompanied list of statements becomes valid. The comparator ensures that
+     * the first cycle we'll encounter when scheduling will appear at the front,
+     * because we always schedule away from cycle 0 regardless of the
+     * scheduling direction.
      */
-    utils::Map<utils::Int, utils::List<ir::StatementRef>, AbsoluteComparator> available_in;
+    utils::Map<utils::Int, utils::Vec<utils::UInt>, AbsoluteComparator> available_in;
 
     /**
-     * Set of statements that are still blocked, because their data
+     * Number of statements that are still blocked, because their data
      * dependencies have not yet been scheduled.
      */
-    utils::Set<ir::StatementRef> waiting;
+    utils::UInt num_waiting;
 
     /**
-     * Schedules the given statement in the current cycle, updating all state
-     * accordingly.
+     * Builds the immutable graph data for the current block.
      */
-    void schedule(ir::StatementRef statement) {
+    void build_graph() {
+        graph.emplace();
+
+        // Assign indices to the statements.
+        graph->statements.push_back(com::ddg::get_source(block));
+        for (const auto &statement : block->statements) {
+            graph->statements.push_back(statement);
+        }
+        graph->statements.push_back(com::ddg::get_sink(block));
+        auto num_statements = graph->statements.size();
+        for (utils::UInt index = 0; index < num_statements; index++) {
+            QL_ASSERT(graph->indices.insert({graph->statements[index], index}).second);
+        }
+
+        // Convert the DDG edges.
+        graph->successors.resize(num_statements);
+        graph->num_predecessors.resize(num_statements);
+        for (utils::UInt index = 0; index < num_statements; index++) {
+            auto node = com::ddg::get_node(graph->statements[index]);
+            for (const auto &successor_ep : node->successors) {
+                graph->successors[index].push_back({
+                    graph->indices.at(successor_ep.first),
+                    successor_ep.second->weight
+                });
+            }
+            graph->num_predecessors[index] = node->predecessors.size();
+        }
+
+        // Rank the statements by decreasing criticality. The heuristic
+        // implements "criticality less than," which would result in reverse
+        // order, so we swap the value here. If the heuristic says both are
+        // equal, fall back to the original statement order.
+        utils::Vec<utils::Int> orders;
+        for (const auto &statement : graph->statements) {
+            orders.push_back(com::ddg::get_node(statement)->order);
+        }
+        graph->by_rank.resize(num_statements);
+        for (utils::UInt index = 0; index < num_statements; index++) {
+            graph->by_rank[index] = index;
+        }
+        const auto &statements = graph->statements;
+        std::sort(
+            graph->by_rank.begin(),
+            graph->by_rank.end(),
+            [&statements, &orders](utils::UInt lhs, utils::UInt rhs) {
+                HeuristicComparator heuristic;
+                if (heuristic(statements[rhs], statements[lhs])) return true;
+                if (heuristic(statements[lhs], statements[rhs])) return false;
+                return orders[lhs] < orders[rhs];
+            }
+        );
+        graph->ranks.resize(num_statements);
+        for (utils::UInt rank = 0; rank < num_statements; rank++) {
+            graph->ranks[graph->by_rank[rank]] = rank;
+        }
+
+    }
+
+    /**
+     * Schedules the statement with the given index in the current cycle,
+     * updating all state accordingly.
+     */
+    void schedule(utils::UInt index) {
+        const auto &statement = graph->statements[index];
 
         // Update the resource state.
         resource_state->reserve(cycle, statement);
@@ -158,59 +266,44 @@ class Scheduler {
         statement->cycle = cycle;
 
         // Move the statement from available to scheduled.
-        QL_ASSERT(available.erase(statement));
-        QL_ASSERT(scheduled.insert(statement).second);
-
-        // The DDG successors of the statement should all still be in the
-        // waiting list, but some may be unblocked now. Check for that, and
-        // move the unblocked statements to available_in or available
-        // accordingly.
-        for (const auto &successor_ep : com::ddg::get_node(statement)->successors) {
-            const auto &successor_stmt = successor_ep.first;
-            auto successor_node = com::ddg::get_node(successor_stmt);
-
-            // Check if this successor of the statement we just scheduled is
-            // now available.
-            utils::Bool is_now_available = true;
-            utils::Int available_from_cycle = 0;
-            for (const auto &predecessor_ep : successor_node->predecessors) {
-                const auto &predecessor_stmt = predecessor_ep.first;
-                const auto &edge = predecessor_ep.second;
-
-                // Ensure that all predecessors have been scheduled.
-                if (!scheduled.count(predecessor_stmt)) {
-                    is_now_available = false;
-                    break;
-                }
-
-                // Compute the minimum cycle for which this statement will
-                // become available.
-                available_from_cycle = abs_max(
-                    available_from_cycle,
-                    predecessor_stmt->cycle + edge->weight
-                );
-
-            }
+        QL_ASSERT(available.erase(graph->ranks[index]));
+        num_scheduled++;
+
+        // The DDG successors of the statement should all still be waiting, but
+        // some may be unblocked now. Check for that, and move the unblocked
+        // statements to available_in or available accordingly.
+        for (const auto &successor : graph->successors[index]) {
+            auto successor_index = successor.first;
+
+            // Update the minimum cycle for which the successor will become
+            // available.
+            available_from_cycle[successor_index] = abs_max(
+                available_from_cycle[successor_index],
+                cycle + successor.second
+            );
 
-            // If the statement is now available, actually make it available by
-            // moving it to the appropriate list.
-            if (is_now_available) {
-                if (available_from_cycle == cycle) {
+            // If all predecessors of the successor have now been scheduled,
+            // actually make it available by moving it to the appropriate list.
+            QL_ASSERT(num_unscheduled_predecessors[successor_index] > 0);
+            if (--num_unscheduled_predecessors[successor_index] == 0) {
+                auto from_cycle = available_from_cycle[successor_index];
+                if (from_cycle == cycle) {
 
                     // The statement is immediately available.
-                    QL_ASSERT(available.insert(successor_stmt).second);
+                    QL_ASSERT(available.insert(graph->ranks[successor_index]).second);
 
                 } else {
 
                     // The statement is not immediately available, so we have
                     // to move it to available_in.
-                    auto it = available_in.insert({available_from_cycle, {}});
-                    it.first->second.push_back(successor_stmt);
+                    auto it = available_in.insert({from_cycle, {}});
+                    it.first->second.push_back(successor_index);
 
                 }
 
-                // Remove the statement from the waiting list.
-                QL_ASSERT(waiting.erase(successor_stmt));
+                // The statement is no longer waiting.
+                QL_ASSERT(num_waiting > 0);
+                num_waiting--;
 
             }
 
@@ -222,8 +315,8 @@ class Scheduler {
             auto it = available_in.begin();
             if (it != available_in.end()) {
                 cycle = it->first;
-                for (const auto &available_statement : it->second) {
-                    QL_ASSERT(available.insert(available_statement).second);
+                for (auto available_index : it->second) {
+                    QL_ASSERT(available.insert(graph->ranks[available_index]).second);
                 }
                 available_in.erase(it);
             }
@@ -231,6 +324,27 @@ class Scheduler {
 
     }
 
+    /**
+     * Tries to schedule the statement with the given index in the current
+     * cycle. Returns whether scheduling was successful.
+     */
+    utils::Bool try_schedule_index(utils::UInt index) {
+        const auto &statement = graph->statements[index];
+        QL_DOUT("trying n" << utils::abs(ddg::get_node(statement)->order) << " = " << ir::describe(statement));
+        QL_DOUT(" |-> with criticality " << HeuristicComparator()(statement));
+        if (available.find(graph->ranks[index]) == available.end()) {
+            QL_DOUT(" '-> not available due to data dependencies");
+            return false;
+        }
+        if (!resource_state->available(cycle, statement)) {
+            QL_DOUT(" '-> not available due to resources");
+            return false;
+        }
+        QL_DOUT(" '-> ok, scheduling in cycle " << cycle);
+        schedule(index);
+        return true;
+    }
+
 public:
 
     /**
@@ -265,16 +379,20 @@ public:
             resource_state = resources->build(rmgr::Direction::BACKWARD);
         }
 
+        // Index the statements and the data dependency graph.
+        build_graph();
+
         // Initialize by putting the source statement in the available list and
         // all other statements in the waiting list.
-        QL_ASSERT(available.insert(com::ddg::get_source(block)).second);
-        for (const auto &statement : block->statements) {
-            QL_ASSERT(waiting.insert(statement).second);
-        }
-        QL_ASSERT(waiting.insert(com::ddg::get_sink(block)).second);
+        auto num_statements = graph->statements.size();
+        num_unscheduled_predecessors = graph->num_predecessors;
+        available_from_cycle.resize(num_statements, 0);
+        num_scheduled = 0;
+        QL_ASSERT(available.insert(graph->ranks[0]).second);
+        num_waiting = num_statements - 1;
 
         // Start by scheduling the source node.
-        schedule(com::ddg::get_source(block));
+        schedule(0);
 
     }
 
@@ -307,8 +425,8 @@ public:
         // from available_in to available.
         auto it = available_in.begin();
         if (it != available_in.end() && it->first == cycle) {
-            for (const auto &available_statement : it->second) {
-                QL_ASSERT(available.insert(available_statement).second);
+            for (auto available_index : it->second) {
+                QL_ASSERT(available.insert(graph->ranks[available_index]).second);
             }
             available_in.erase(it);
         }
@@ -321,7 +439,8 @@ public:
      */
     utils::List<ir::StatementRef> get_available() const {
         utils::List<ir::StatementRef> result;
-        for (const auto &statement : available) {
+        for (auto rank : available) {
+            const auto &statement = graph->statements[graph->by_rank[rank]];
             if (resource_state->available(cycle, statement)) {
                 result.push_back(statement);
             }
@@ -344,10 +463,10 @@ public:
 
             // Try to schedule statements that are available w.r.t. data
             // dependencies. Note that the iteration order here is implicitly by
-            // decreasing criticality, because available is a set that uses the
-            // criticality heuristic for its comparator.
-            for (const auto &statement : available) {
-                if (try_schedule(statement)) {
+            // decreasing criticality, because available is a set of
+            // criticality ranks.
+            for (auto rank : available) {
+                if (try_schedule_index(graph->by_rank[rank])) {
                     return true;
                 }
             }
@@ -356,19 +475,13 @@ public:
         } else {
 
             // Schedule the given statement, if it's available.
-            QL_DOUT("trying n" << utils::abs(ddg::get_node(statement)->order) << " = " << ir::describe(statement));
-            QL_DOUT(" |-> with criticality " << HeuristicComparator()(statement));
-            if (available.find(statement) == available.end()) {
+            auto it = graph->indices.find(statement);
+            if (it == graph->indices.end()) {
+                QL_DOUT("trying " << ir::describe(statement));
                 QL_DOUT(" '-> not available due to data dependencies");
                 return false;
             }
-            if (!resource_state->available(cycle, statement)) {
-                QL_DOUT(" '-> not available due to resources");
-                return false;
-            }
-            QL_DOUT(" '-> ok, scheduling in cycle " << cycle);
-            schedule(statement);
-            return true;
+            return try_schedule_index(it->second);
 
         }
     }
@@ -380,8 +493,8 @@ public:
     utils::Bool is_done() const {
         if (!available.empty()) return false;
         if (!available_in.empty()) return false;
-        if (!waiting.empty()) return false;
-        QL_ASSERT(scheduled.size() == block->statements.size() + 2);
+        if (num_waiting) return false;
+        QL_ASSERT(num_scheduled == graph->statements.size());
         return true;
     }
 
@@ -409,10 +522,10 @@ public:
         while (!is_done()) {
             QL_DOUT(
                 "cycle " << cycle << ", " <<
-                scheduled.size() << " scheduled, " <<
+                num_scheduled << " scheduled, " <<
                 available.size() << " available w.r.t. data dependencies, " <<
                 available_in.size() << " batches available later, " <<
-                waiting.size() << " waiting"
+                num_waiting << " waiting"
             );
             QL_ASSERT(!available.empty());
             utils::UInt advanced = 0;
@@ -425,8 +538,8 @@ public:
                     ss << "scheduling resources seem to be deadlocked! ";
                     ss << "The current cycle is " << cycle << ", ";
                     ss << "and the available statements are:\n";
-                    for (const auto &available_statement : available) {
-                        ss << "  " << ir::describe(available_statement) << "\n";
+                    for (auto rank : available) {
+                        ss << "  " << ir::describe(graph->statements[graph->by_rank[rank]]) << "\n";
                     }
                     ss << "The state of the resources is:\n";
                     resource_state->dump(ss, "  ");
@@ -182,17 +182,51 @@ private:
     Edge max_edge;
 
     /**
-     * The distance (number of edges) between a pair of qubits. Only used and
-     * initialized for specified connectivity; distance is computed by
-     * get_distance() on-the-fly for full connectivity.
+     * The distance (number of edges) between each pair of qubits, as a flat
+     * row-major matrix indexed by source * num_qubits + target, or utils::MAX
+     * if the target is unreachable. Only used and initialized for specified
+     * connectivity; distance is computed by get_distance() on-the-fly for full
+     * connectivity.
      */
-    utils::Vec<utils::Vec<utils::UInt>> distance;
+    utils::Vec<utils::UInt> distance;
+
+    /**
+     * The first hop on a shortest path between each pair of qubits, with the
+     * same layout and availability as distance. The hop from a qubit to
+     * itself is the qubit itself; unreachable targets yield utils::MAX.
+     */
+    utils::Vec<Qubit> next_hop;
 
     /**
      * Generates the neighbor list for the given qubit for full connectivity.
      */
     void generate_neighbors_list(utils::UInt qs, Neighbors &qubits) const;
 
+    /**
+     * Computes the distance and next-hop tables for specified connectivity,
+     * using a breadth-first search from each qubit.
+     */
+    void compute_paths();
+
+    /**
+     * Returns a hash of the number of qubits and the (ordered) neighbor lists,
+     * used to check whether a path cache file belongs to this topology.
+     */
+    utils::UInt get_path_fingerprint() const;
+
+    /**
+     * Tries to load the distance and next-hop tables from the given cache
+     * file. Returns false if the file does not exist or does not match this
+     * topology.
+     */
+    utils::Bool load_path_cache(const utils::Str &fname);
+
+    /**
+     * Writes the distance and next-hop tables to the given cache file.
+     * Failure to write the cache is not fatal.
+     */
+    void save_path_cache(const utils::Str &fname) const;
+
 public:
 
     /**
@@ -281,6 +315,14 @@ public:
      */
     utils::UInt get_distance(Qubit source, Qubit target) const;
 
+    /**
+     * Returns the first hop on a shortest path from source to target, being
+     * the first neighbor of source (in neighbor list order) on such a path.
+     * Returns source if source equals target, and utils::MAX if target is
+     * unreachable. This is a table lookup for specified connectivity.
+     */
+    Qubit get_next_hop(Qubit source, Qubit target) const;
+
     /**
      * Returns the distance between the given two qubits in terms of cores.
      */
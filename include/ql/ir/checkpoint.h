@@ -0,0 +1,78 @@
+/** \file
+ * Binary checkpoint format for the IR, allowing compilation to be resumed
+ * from an intermediate result without reparsing cQASM.
+ */
+
+#pragma once
+
+#include "ql/utils/str.h"
+#include "ql/ir/ir.h"
+
+namespace ql {
+namespace ir {
+namespace checkpoint {
+
+/**
+ * Version of the checkpoint format. Checkpoints with a different format
+ * version are rejected by the reader.
+ */
+static const utils::UInt FORMAT_VERSION = 1;
+
+/**
+ * Writes a binary checkpoint of the complete IR (platform and program) to the
+ * given stream.
+ *
+ * The checkpoint consists of a fixed-size header followed by three sections:
+ * the OpenQL version that wrote the checkpoint, the CBOR serialization of the
+ * IR tree, and the annotations that the old/new IR conversions depend on. The
+ * header records the size of each section, so a reader can locate them in a
+ * single buffer without parsing anything else. The topology, architecture,
+ * and resource manager objects of the platform are not restored from the
+ * checkpoint; they are taken from the platform of the IR that the checkpoint
+ * is read into.
+ */
+void write(const Ref &ir, std::ostream &os);
+
+/**
+ * Writes a binary checkpoint of the complete IR to the given file. See
+ * write(const Ref&, std::ostream&) for details.
+ */
+void write_file(const Ref &ir, const utils::Str &fname);
+
+/**
+ * Replaces the platform and program trees of the given IR with those stored
+ * in the given checkpoint data. The IR must already contain a platform built
+ * from the same platform configuration as the one the checkpoint was written
+ * for; its topology, architecture, resource manager, and annotations are
+ * carried over to the loaded platform. Checkpoints written by a different
+ * version of OpenQL are rejected. fname is only used for error messages.
+ *
+ * The CBOR reader of the tree library only accepts a complete string, so this
+ * copies the tree section out of the given data. Use the overload that takes
+ * ownership of the data to avoid that.
+ */
+void read(
+    const Ref &ir,
+    const utils::Str &data,
+    const utils::Str &fname = "<unknown>"
+);
+
+/**
+ * Same as read(), but takes ownership of the checkpoint data. Instead of
+ * copying the tree section, the data is trimmed down to it in place, so the
+ * checkpoint is never held in memory twice.
+ */
+void read(
+    const Ref &ir,
+    utils::Str &&data,
+    const utils::Str &fname = "<unknown>"
+);
+
+/**
+ * Same as read(), but reads the checkpoint from the given file.
+ */
+void read_file(const Ref &ir, const utils::Str &fname);
+
+} // namespace checkpoint
+} // namespace ir
+} // namespace ql
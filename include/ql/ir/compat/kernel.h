@@ -210,9 +210,11 @@ private:
 
     // if a specialized custom gate ("e.g. cz q0,q4") is available, add it to circuit and return true
     // if a parameterized custom gate ("e.g. cz") is available, add it to circuit and return true
+    // lookup is the platform's gate lookup entry for gname
     //
     // note that there is no check for the found gate being a composite gate
     utils::Bool add_custom_gate_if_available(
+        const GateLookup &lookup,
         const utils::Str &gname,
         const utils::Vec<utils::UInt> &qubits,
         const utils::Vec<utils::UInt> &cregs = {},
@@ -223,13 +225,17 @@ private:
         const utils::Vec<utils::UInt> &gcondregs = {}
     );
 
-    // FIXME: move to class composite_gate?
-    // return the subinstructions of a composite gate
-    // while doing, test whether the subinstructions have a definition (so they cannot be specialized or default ones!)
-    void get_decomposed_ins(
-        const gate_types::Composite &gate,
-        utils::Vec<utils::Str> &sub_instructons
-    ) const;
+    // add the subinstructions of a pre-parsed decomposition rule to the circuit, each as a custom gate (or a default gate);
+    // for a parameterized rule, the operands of the subinstructions are indices into all_qubits, otherwise they are the qubits
+    void add_decomposition(
+        const GateLookup::Decomposition &decomposition,
+        utils::Bool parameterized,
+        const utils::Vec<utils::UInt> &all_qubits,
+        const utils::Vec<utils::UInt> &cregs,
+        const utils::Vec<utils::UInt> &bregs,
+        ConditionType gcond,
+        const utils::Vec<utils::UInt> &gcondregs
+    );
 
     // if specialized composed gate: "e.g. cz q0,q3" available, with composition of subinstructions, return true
     //      also check each subinstruction for presence as a custom_gate (or a default gate)
@@ -238,6 +244,7 @@ private:
     //
     // add specialized decomposed gate, example JSON definition: "cl_14 q1": ["rx90 %0", "rym90 %0", "rxm90 %0"]
     utils::Bool add_spec_decomposed_gate_if_available(
+        const GateLookup &lookup,
         const utils::Str &gate_name,
         const utils::Vec<utils::UInt> &all_qubits,
         const utils::Vec<utils::UInt> &cregs = {},
@@ -253,6 +260,7 @@ private:
     //
     // add parameterized decomposed gate, example JSON definition: "cl_14 %0": ["rx90 %0", "rym90 %0", "rxm90 %0"]
     utils::Bool add_param_decomposed_gate_if_available(
+        const GateLookup &lookup,
         const utils::Str &gate_name,
         const utils::Vec<utils::UInt> &all_qubits,
         const utils::Vec<utils::UInt> &cregs = {},
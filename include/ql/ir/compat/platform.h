@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <memory>
 #include "ql/utils/num.h"
 #include "ql/utils/str.h"
 #include "ql/utils/opt.h"
@@ -28,6 +29,94 @@ class Platform;
  */
 using PlatformRef = utils::One<Platform>;
 
+/**
+ * The custom gates and decomposition rules of a platform that apply to gates
+ * with a particular (sanitized) name, pre-resolved from the instruction_map
+ * keys for that name. This lets Kernel::gate() find the definition of a gate
+ * with a few typed lookups, rather than by building the instruction_map keys
+ * as strings for every gate and parsing the sub-instructions of decomposition
+ * rules every time they are applied. See Platform::get_gate_lookup().
+ */
+struct GateLookup {
+
+    /**
+     * A sub-instruction of a decomposition rule, such as "x %0" or "x q3".
+     */
+    struct SubGate {
+
+        /**
+         * The name of the sub-instruction, without operands.
+         */
+        utils::Str name;
+
+        /**
+         * The lookup entry for the name of the sub-instruction.
+         */
+        const GateLookup *lookup;
+
+        /**
+         * The operand numbers following the name. For specialized rules these
+         * are the qubits, for parameterized rules they are indices into the
+         * qubit operands of the decomposed gate.
+         */
+        utils::Vec<utils::UInt> operands;
+
+    };
+
+    /**
+     * A pre-parsed decomposition rule.
+     */
+    struct Decomposition {
+
+        /**
+         * The instruction_map key of the rule, for messages.
+         */
+        utils::Str key;
+
+        /**
+         * The sub-instructions that the gate decomposes into.
+         */
+        utils::Vec<SubGate> sub_gates;
+
+        /**
+         * If nonempty, a sub-instruction could not be parsed, and applying the
+         * rule fails with this message.
+         */
+        utils::Str error;
+
+    };
+
+    /**
+     * Specialized custom gates and decomposition rules, i.e. keys of the form
+     * "<name> q<i>,q<j>,...", by their qubit operands. Note that a key with no
+     * operands ("<name> ") is both specialized and parameterized.
+     */
+    utils::Map<utils::Vec<utils::UInt>, CustomGateRef> specialized;
+
+    /**
+     * Parameterized decomposition rules, i.e. keys of the form
+     * "<name> %0,%1,...", by their number of operands.
+     */
+    utils::Map<utils::UInt, CustomGateRef> parameterized;
+
+    /**
+     * The parameterized custom gate, i.e. the key "<name>", if any.
+     */
+    CustomGateRef generic;
+
+    /**
+     * The pre-parsed decomposition rules among the above, by gate.
+     */
+    utils::Map<const gate_types::Custom*, Decomposition> decompositions;
+
+};
+
+/**
+ * Table of GateLookup entries by gate name, built when the platform is
+ * loaded. Defined in platform.cc.
+ */
+struct GateLookupTable;
+
 /**
  * Platform configuration structure. Represents everything we know about the
  * target qubit chip, simulator, control architecture, etc.
@@ -148,6 +237,23 @@ public:
      */
     utils::Json platform_config;
 
+    /**
+     * When the platform_cache option is set and kernels and programs can
+     * still change the register counts of the platform (see
+     * compat_implicit_creg_count), each construction gets a copy of the
+     * cached platform. This then points to the cached platform, which is
+     * never modified or destroyed. Otherwise this is null.
+     */
+    const Platform *cache_template = nullptr;
+
+private:
+
+    /**
+     * Gate lookup entries for get_gate_lookup(), shared with copies of the
+     * platform.
+     */
+    std::shared_ptr<GateLookupTable> gate_lookup;
+
 public:
 
     /**
@@ -232,6 +338,17 @@ public:
      */
     utils::UInt time_to_cycles(utils::Real time_ns) const;
 
+    /**
+     * Returns the custom gates and decomposition rules that apply to gates
+     * with the given (sanitized) name. The entries are built from
+     * instruction_map when the platform is loaded, so instruction_map must
+     * not be modified afterwards. For names that do not appear in
+     * instruction_map, an empty entry is returned. The returned reference
+     * remains valid for the lifetime of the platform. Thread-safe, and does
+     * not lock.
+     */
+    const GateLookup &get_gate_lookup(const utils::Str &name) const;
+
 };
 
 } // namespace compat
@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <memory>
+#include "ql/utils/num.h"
 #include "ql/utils/str.h"
+#include "ql/utils/vec.h"
 #include "ql/ir/ir.h"
 #include "ql/ir/compat/compat.h"
 
@@ -99,6 +102,97 @@ void read_file(
     const ReadOptions &options = {}
 );
 
+/**
+ * cQASM 1.2 reader bound to a platform, for reading many files for the same
+ * platform.
+ *
+ * read() builds a libqasm analyzer for the platform on every call, which
+ * involves registering a function for each data type, register, and builtin
+ * function in the platform, and building the q and b register mappings. When
+ * many small files are read for the same platform, this dominates the time
+ * spent. A Reader does all this only once, when it is constructed. It also
+ * offers read_files(), which parses and analyzes a list of files in parallel.
+ *
+ * A Reader is not thread-safe, even though its member functions are const:
+ * they all use the same analyzer, and libqasm analyzers cannot be used by
+ * more than one thread at a time. read_files() takes care of this for its own
+ * threads, but a Reader must not be used by more than one thread at a time.
+ * Construct a Reader per thread instead.
+ */
+class Reader {
+private:
+
+    /**
+     * Private state, containing the libqasm analyzer.
+     */
+    class Impl;
+
+    /**
+     * Pointer to the private state.
+     */
+    std::unique_ptr<Impl> impl;
+
+public:
+
+    /**
+     * Builds a reader for the platform of the given IR. The platform must not
+     * be replaced for as long as the reader is in use. The load_platform
+     * option is not supported, since the platform would differ per file.
+     */
+    explicit Reader(const Ref &ir, const ReadOptions &options = {});
+
+    /**
+     * Move constructor.
+     */
+    Reader(Reader &&reader) noexcept;
+
+    /**
+     * Move assignment.
+     */
+    Reader &operator=(Reader &&reader) noexcept;
+
+    /**
+     * Destructor.
+     */
+    ~Reader();
+
+    /**
+     * Reads a cQASM 1.2 file into the given IR, which must use the platform
+     * that the reader was built for. If reading is successful, ir->program is
+     * completely replaced. data represents the cQASM file contents, fname
+     * specifies the filename if one exists for the purpose of generating
+     * better error messages.
+     */
+    void read(
+        const Ref &ir,
+        const utils::Str &data,
+        const utils::Str &fname = "<unknown>"
+    ) const;
+
+    /**
+     * Same as read(), but given a file to load, rather than loading from a
+     * string.
+     */
+    void read_file(const Ref &ir, const utils::Str &fname) const;
+
+    /**
+     * Reads the given list of cQASM 1.2 files, returning a new IR tree for
+     * each of them. The platform node of the returned trees is shared with the
+     * IR the reader was built for. Parsing and analyzing the files is done in
+     * parallel using the given number of threads, where 0 means the number of
+     * hardware threads. Conversion to the IR modifies the shared platform, so
+     * it is done serially, in the order of the given list. The first thread
+     * uses the analyzer of this reader, and the other threads each use an
+     * analyzer for the platform that is built when first needed and kept in
+     * the reader for later calls.
+     */
+    utils::Vec<Ref> read_files(
+        const utils::Vec<utils::Str> &fnames,
+        utils::UInt num_threads = 0
+    ) const;
+
+};
+
 /**
  * Constructs a platform from the `@ql.platform` annotation in the given cQASM
  * file.
@@ -0,0 +1,64 @@
+/** \file
+ * Defines the IR checkpoint reader pass.
+ */
+
+#pragma once
+
+#include "ql/pmgr/pass_types/specializations.h"
+
+namespace ql {
+namespace pass {
+namespace io {
+namespace checkpoint {
+namespace read {
+
+/**
+ * IR checkpoint reader pass.
+ */
+class ReadCheckpointPass : public pmgr::pass_types::Transformation {
+protected:
+
+    /**
+     * Dumps docs for the IR checkpoint reader.
+     */
+    void dump_docs(
+        std::ostream &os,
+        const utils::Str &line_prefix
+    ) const override;
+
+public:
+
+    /**
+     * Returns a user-friendly type name for this pass.
+     */
+    utils::Str get_friendly_type() const override;
+
+    /**
+     * Constructs an IR checkpoint reader.
+     */
+    ReadCheckpointPass(
+        const utils::Ptr<const pmgr::Factory> &pass_factory,
+        const utils::Str &instance_name,
+        const utils::Str &type_name
+    );
+
+    /**
+     * Runs the IR checkpoint reader.
+     */
+    utils::Int run(
+        const ir::Ref &ir,
+        const pmgr::pass_types::Context &context
+    ) const override;
+
+};
+
+/**
+ * Shorthand for referring to the pass using namespace notation.
+ */
+using Pass = ReadCheckpointPass;
+
+} // namespace read
+} // namespace checkpoint
+} // namespace io
+} // namespace pass
+} // namespace ql
@@ -0,0 +1,64 @@
+/** \file
+ * Defines the IR checkpoint writer pass.
+ */
+
+#pragma once
+
+#include "ql/pmgr/pass_types/specializations.h"
+
+namespace ql {
+namespace pass {
+namespace io {
+namespace checkpoint {
+namespace write {
+
+/**
+ * IR checkpoint writer pass.
+ */
+class WriteCheckpointPass : public pmgr::pass_types::Analysis {
+protected:
+
+    /**
+     * Dumps docs for the IR checkpoint writer.
+     */
+    void dump_docs(
+        std::ostream &os,
+        const utils::Str &line_prefix
+    ) const override;
+
+public:
+
+    /**
+     * Returns a user-friendly type name for this pass.
+     */
+    utils::Str get_friendly_type() const override;
+
+    /**
+     * Constructs an IR checkpoint writer.
+     */
+    WriteCheckpointPass(
+        const utils::Ptr<const pmgr::Factory> &pass_factory,
+        const utils::Str &instance_name,
+        const utils::Str &type_name
+    );
+
+    /**
+     * Runs the IR checkpoint writer.
+     */
+    utils::Int run(
+        const ir::Ref &ir,
+        const pmgr::pass_types::Context &context
+    ) const override;
+
+};
+
+/**
+ * Shorthand for referring to the pass using namespace notation.
+ */
+using Pass = WriteCheckpointPass;
+
+} // namespace write
+} // namespace checkpoint
+} // namespace io
+} // namespace pass
+} // namespace ql
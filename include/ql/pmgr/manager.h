@@ -19,6 +19,7 @@
 #include "ql/pmgr/declarations.h"
 #include "ql/pmgr/pass_types/base.h"
 #include "ql/pmgr/factory.h"
+#include "ql/pmgr/profile.h"
 
 namespace ql {
 namespace pmgr {
@@ -73,6 +74,12 @@ private:
      */
     PassRef root;
 
+    /**
+     * Profiling information for the passes that ran during the most recent
+     * call to compile().
+     */
+    Profile profile;
+
 public:
 
     /**
@@ -311,6 +318,14 @@ public:
      */
     void compile(const ir::Ref &ir);
 
+    /**
+     * Returns the profiling information for the passes that ran during the
+     * most recent call to compile(), i.e. the wall-clock time, CPU time, and
+     * peak memory increase of each pass and pass group, as well as the size
+     * of the IR before and after.
+     */
+    const Profile &get_profile() const;
+
 };
 
 /**
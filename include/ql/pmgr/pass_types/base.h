@@ -14,6 +14,7 @@
 #include "ql/ir/ir.h"
 #include "ql/pmgr/declarations.h"
 #include "ql/pmgr/condition.h"
+#include "ql/pmgr/profile.h"
 
 namespace ql {
 namespace pmgr {
@@ -159,6 +160,12 @@ private:
      */
     condition::Ref condition;
 
+    /**
+     * Profiling information for this pass, accumulated over all runs of the
+     * pass since clear_profile() was last called.
+     */
+    PassProfile profile;
+
     /**
      * Throws an exception if the given pass instance name is invalid.
      */
@@ -612,6 +619,18 @@ public:
         const utils::Str &pass_name_prefix = ""
     );
 
+    /**
+     * Clears the profiling information of this pass and its sub-passes.
+     */
+    void clear_profile();
+
+    /**
+     * Appends the profiling information of this pass and its sub-passes to
+     * the given list in depth-first pre-order, skipping passes that have not
+     * run since clear_profile() was last called.
+     */
+    void get_profile(utils::Vec<PassProfile> &profiles, utils::UInt depth = 0) const;
+
 };
 
 } // namespace pass_types
@@ -17,6 +17,27 @@ namespace ql {
 namespace pmgr {
 namespace pass_types {
 
+/**
+ * Ends the legacy IR conversion session for the given IR, if one is active.
+ * When the `legacy_ir_session` global option is set, consecutive legacy passes
+ * share a single old-IR program that is only converted back to the new IR
+ * when this is called. If a legacy transformation ran during the session, the
+ * new IR is rebuilt from the old IR. Must be called before anything operates
+ * on the new IR after a legacy pass may have run. Returns the time spent
+ * converting in seconds.
+ */
+utils::Real flush_legacy_session(const ir::Ref &ir);
+
+/**
+ * Returns an up-to-date new-IR representation of the given IR without ending
+ * the legacy IR conversion session, if one is active. This is the given IR
+ * itself unless a legacy transformation ran during the session, in which case
+ * the old IR is converted into a separate IR tree, which is reused until the
+ * next legacy transformation and when the session is flushed. Used to inspect
+ * the program; the returned IR must not be modified.
+ */
+ir::Ref peek_legacy_session(const ir::Ref &ir);
+
 /**
  * A pass type for passes that always construct into a simple group. For
  * example, a generic optimizer pass with an option-configured set of
@@ -0,0 +1,197 @@
+/** \file
+ * Defines the structures used by the pass manager to record how much time and
+ * memory each pass takes.
+ */
+
+#pragma once
+
+#include <iostream>
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+#include "ql/utils/vec.h"
+#include "ql/utils/json.h"
+#include "ql/ir/ir.h"
+
+namespace ql {
+namespace pmgr {
+
+/**
+ * Snapshot of the resources used by the compiler process up to some point in
+ * time.
+ */
+struct ResourceUsage {
+
+    /**
+     * Monotonic wall-clock time in seconds, relative to an unspecified epoch.
+     */
+    utils::Real wall_time = 0.0;
+
+    /**
+     * CPU time (user and system) consumed by the process in seconds, summed
+     * over all its threads.
+     */
+    utils::Real cpu_time = 0.0;
+
+    /**
+     * Peak resident set size of the process in bytes, or 0 if this cannot be
+     * determined on this platform.
+     */
+    utils::UInt peak_rss = 0;
+
+    /**
+     * Returns the current resource usage of the process.
+     */
+    static ResourceUsage now();
+
+};
+
+/**
+ * The size of the program in the IR.
+ */
+struct IrSize {
+
+    /**
+     * The total number of statements, including those in the bodies of
+     * structured control-flow statements.
+     */
+    utils::UInt num_statements = 0;
+
+    /**
+     * The number of statements that are gates, i.e. custom instructions.
+     */
+    utils::UInt num_gates = 0;
+
+    /**
+     * Measures the size of the program in the given IR. The new-IR
+     * representation of the program is always measured, such that
+     * measurements before and after a pass can be compared regardless of the
+     * kind of pass. If a legacy IR conversion session is active and the old IR
+     * was modified, the old IR is converted for this purpose without ending
+     * the session. The conversion is reused until the next legacy pass runs.
+     */
+    static IrSize measure(const ir::Ref &ir);
+
+    /**
+     * Returns the total wall-clock and CPU time that the calling thread spent
+     * in measure() so far. The pass manager uses this to exclude the time
+     * spent measuring the sub-passes of a pass group from the time measured
+     * for the group.
+     */
+    static ResourceUsage get_measure_time();
+
+};
+
+/**
+ * Profiling information for a single pass or pass group, accumulated over all
+ * runs of the pass during a single compilation.
+ */
+struct PassProfile {
+
+    /**
+     * The fully-qualified pass name, using periods for hierarchy separation.
+     * Empty for the root pass group.
+     */
+    utils::Str full_pass_name;
+
+    /**
+     * The type name of the pass, or an empty string for pass groups without
+     * a type.
+     */
+    utils::Str type_name;
+
+    /**
+     * The depth of the pass in the pass tree; 0 for the root pass group.
+     */
+    utils::UInt depth = 0;
+
+    /**
+     * Whether this is a pass group, in which case the measurements include
+     * those of its sub-passes.
+     */
+    utils::Bool is_group = false;
+
+    /**
+     * The number of times the pass was run. This can be more than one for
+     * passes in loops, or zero for passes in conditional groups.
+     */
+    utils::UInt num_runs = 0;
+
+    /**
+     * Total wall-clock time spent in the pass in seconds.
+     */
+    utils::Real wall_time = 0.0;
+
+    /**
+     * Total CPU time spent in the pass in seconds.
+     */
+    utils::Real cpu_time = 0.0;
+
+    /**
+     * The amount by which the pass increased the peak resident set size of
+     * the process in bytes. This is zero when the pass used less memory than
+     * some earlier pass did.
+     */
+    utils::UInt peak_rss_delta = 0;
+
+    /**
+     * The size of the IR before the first run of the pass.
+     */
+    IrSize size_before;
+
+    /**
+     * The size of the IR after the last run of the pass.
+     */
+    IrSize size_after;
+
+    /**
+     * Records a run of the pass, given the resource usage and IR size before
+     * and after it.
+     */
+    void record(
+        const ResourceUsage &usage_before,
+        const IrSize &ir_size_before,
+        const ResourceUsage &usage_after,
+        const IrSize &ir_size_after
+    );
+
+};
+
+/**
+ * Profiling information for all passes that ran during a compilation, in the
+ * order of a depth-first, pre-order traversal of the pass tree.
+ */
+class Profile {
+public:
+
+    /**
+     * The profiles of the passes that ran.
+     */
+    utils::Vec<PassProfile> passes;
+
+    /**
+     * Dumps the profile as a human-readable table.
+     */
+    void dump(std::ostream &os = std::cout, const utils::Str &line_prefix = "") const;
+
+    /**
+     * Returns the profile as a JSON object with a single "passes" key mapping
+     * to an array of pass objects.
+     */
+    utils::Json to_json() const;
+
+    /**
+     * Dumps the profile in CSV format, with a header row and one row per
+     * pass.
+     */
+    void dump_csv(std::ostream &os) const;
+
+    /**
+     * Writes the profile to the given file. The file is written in CSV
+     * format if its name ends in `.csv`, or in JSON format otherwise.
+     */
+    void write(const utils::Str &filename) const;
+
+};
+
+} // namespace pmgr
+} // namespace ql
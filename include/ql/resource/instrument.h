@@ -39,6 +39,18 @@ private:
      */
     utils::Ptr<Config> config;
 
+    /**
+     * Checks availability of and/or reserves a gate. When the gate is not
+     * available, conflict is set to a reserved range that prevents it from
+     * being placed.
+     */
+    utils::Bool check_gate(
+        utils::Int cycle,
+        const rmgr::resource_types::GateData &gate,
+        utils::Bool commit,
+        State::Range &conflict
+    );
+
 protected:
 
     /**
@@ -55,6 +67,15 @@ protected:
         utils::Bool commit
     ) override;
 
+    /**
+     * Returns the given cycle if the gate is available in it, or otherwise
+     * the cycle before which the gate certainly can't be started.
+     */
+    utils::Int on_next_cycle(
+        utils::Int cycle,
+        const rmgr::resource_types::GateData &gate
+    ) override;
+
     /**
      * Dumps documentation for this resource.
      */
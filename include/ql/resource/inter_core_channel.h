@@ -5,18 +5,13 @@
 
 #pragma once
 
-#include "ql/utils/rangemap.h"
 #include "ql/rmgr/resource_types/base.h"
+#include "ql/rmgr/reservations.h"
 
 namespace ql {
 namespace resource {
 namespace inter_core_channel {
 
-/**
- * State per qubit.
- */
-using State = utils::RangeSet<utils::Int>;
-
 /**
  * Forward-declaration for the configuration structure, defined in the CC file.
  */
@@ -30,9 +25,11 @@ class InterCoreChannelResource : public rmgr::resource_types::Base {
 private:
 
     /**
-     * The reservations for each [core][channel].
+     * The reservations for each channel, indexed by core * num_channels +
+     * channel. When there is a defined scheduling direction, only the latest
+     * reservation for each channel is tracked.
      */
-    utils::Vec<utils::Vec<State>> state;
+    rmgr::ExclusiveReservations state;
 
     /**
      * Shared pointer to the configuration structure.
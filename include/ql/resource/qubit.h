@@ -5,18 +5,13 @@
 
 #pragma once
 
-#include "ql/utils/rangemap.h"
 #include "ql/rmgr/resource_types/base.h"
+#include "ql/rmgr/reservations.h"
 
 namespace ql {
 namespace resource {
 namespace qubit {
 
-/**
- * State per qubit.
- */
-using State = utils::RangeSet<utils::Int>;
-
 /**
  * Qubit resource. This resource prevents a qubit from being used more than once
  * in each cycle.
@@ -25,15 +20,10 @@ class QubitResource : public rmgr::resource_types::Base {
 private:
 
     /**
-     * The reservations for each qubit.
-     */
-    utils::Vec<State> state;
-
-    /**
-     * When set, there is a defined scheduling direction, which means it's
-     * sufficient to only track the latest reservation for each qubit.
+     * The reservations for each qubit. When there is a defined scheduling
+     * direction, only the latest reservation for each qubit is tracked.
      */
-    utils::Bool optimize;
+    rmgr::ExclusiveReservations state;
 
 protected:
 
@@ -51,6 +41,15 @@ protected:
         utils::Bool commit
     ) override;
 
+    /**
+     * Returns the given cycle if the gate is available in it, or otherwise
+     * the cycle before which the gate certainly can't be started.
+     */
+    utils::Int on_next_cycle(
+        utils::Int cycle,
+        const rmgr::resource_types::GateData &gate
+    ) override;
+
     /**
      * Dumps documentation for this resource.
      */
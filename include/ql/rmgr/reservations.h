@@ -0,0 +1,122 @@
+/** \file
+ * Defines a compact reservation state for resources that can only be used by
+ * one gate at a time.
+ */
+
+#pragma once
+
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+#include "ql/utils/pair.h"
+#include "ql/utils/vec.h"
+#include "ql/utils/rangemap.h"
+#include "ql/rmgr/types.h"
+
+namespace ql {
+namespace rmgr {
+
+/**
+ * Reservation state for a number of resources that can each only be used by
+ * one gate at a time, such as qubits or communication channels.
+ *
+ * When the scheduling direction is defined, gates are reserved in monotonic
+ * order of their start cycle, and availability is never checked beyond the
+ * start cycle of the most recent reservation, i.e. the scheduling frontier.
+ * Because the reservations for a resource never overlap, all but the most
+ * recent one then lie entirely behind the frontier, and can be retired as soon
+ * as a new reservation is made. The state is then just a flat vector with the
+ * most recent reservation for each resource, so checking availability takes
+ * constant time, and copying the state (which the mapper does for every
+ * alternative it evaluates) doesn't allocate anything per resource. When the
+ * direction is undefined, the complete reservation history is kept in a
+ * RangeSet per resource instead.
+ */
+class ExclusiveReservations {
+public:
+
+    /**
+     * A cycle range, including the first and excluding the second cycle.
+     */
+    using Range = utils::Pair<utils::Int, utils::Int>;
+
+private:
+
+    /**
+     * The scheduling direction.
+     */
+    Direction direction = Direction::UNDEFINED;
+
+    /**
+     * Whether only the most recent reservation of each resource is tracked.
+     */
+    utils::Bool windowed = false;
+
+    /**
+     * The most recent reservation for each resource when windowed is set, or
+     * NONE if there is none yet. Empty otherwise.
+     */
+    utils::Vec<Range> latest;
+
+    /**
+     * All reservations for each resource when windowed is cleared. Empty
+     * otherwise.
+     */
+    utils::Vec<utils::RangeSet<utils::Int>> history;
+
+    /**
+     * Placeholder for the most recent reservation of a resource that has not
+     * been reserved yet. This does not overlap with any valid range.
+     */
+    static const Range NONE;
+
+public:
+
+    /**
+     * Constructs an empty state for zero resources.
+     */
+    ExclusiveReservations() = default;
+
+    /**
+     * Constructs an empty state for the given number of resources and the
+     * given scheduling direction.
+     */
+    ExclusiveReservations(utils::UInt num_resources, Direction direction);
+
+    /**
+     * Returns the number of resources.
+     */
+    utils::UInt size() const;
+
+    /**
+     * Returns whether the given resource is free for the given cycle range.
+     */
+    utils::Bool is_available(utils::UInt resource, const Range &range) const;
+
+    /**
+     * Returns a cycle beyond the start of the given range, in scheduling
+     * direction, before which a gate with the duration of the given range can
+     * certainly not use the given resource, given that the resource is not
+     * available for the given range. When the direction is undefined, this is
+     * simply the next cycle.
+     */
+    utils::Int get_next_cycle(utils::UInt resource, const Range &range) const;
+
+    /**
+     * Reserves the given resource for the given cycle range, which must be
+     * available.
+     */
+    void reserve(utils::UInt resource, const Range &range);
+
+    /**
+     * Dumps the reservations of the given resource.
+     */
+    void dump_state(
+        utils::UInt resource,
+        std::ostream &os,
+        const utils::Str &line_prefix
+    ) const;
+
+};
+
+} // namespace rmgr
+} // namespace ql
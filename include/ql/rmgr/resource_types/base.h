@@ -94,6 +94,11 @@ private:
      */
     utils::Int prev_cycle;
 
+    /**
+     * Converts the given old-IR gate to the GateData wrapper.
+     */
+    GateData get_gate_data(const ir::compat::GateRef &gate) const;
+
 protected:
 
     /**
@@ -119,6 +124,23 @@ protected:
         utils::Bool commit
     ) = 0;
 
+    /**
+     * Abstract implementation for next_cycle(). It should return the given
+     * cycle if the gate is available in it, like on_gate() without commit.
+     * Otherwise, it should return a cycle beyond the given one, in the
+     * scheduling direction, before which the gate can certainly not be
+     * started given the current state. Note that this must remain true when
+     * more gates with a nonzero duration are added to the state in scheduling
+     * order, because the scheduler relies on this to avoid checking the gate
+     * again before then. The default implementation checks availability using
+     * on_gate() and returns the next cycle in scheduling direction if the gate
+     * is not available, which is always correct.
+     */
+    virtual utils::Int on_next_cycle(
+        utils::Int cycle,
+        const GateData &gate
+    );
+
     /**
      * Abstract implementation for dump_docs().
      */
@@ -228,6 +250,27 @@ public:
         utils::Bool commit
     );
 
+    /**
+     * Returns the first cycle from the given cycle onward, in scheduling
+     * direction, at which the given gate might be schedulable as far as this
+     * resource is concerned. This is the given cycle itself if the gate is
+     * schedulable for it. Otherwise, it is a cycle before which the gate can
+     * certainly not be started, even when more gates with a nonzero duration
+     * are scheduled in the meantime.
+     */
+    utils::Int next_cycle(
+        utils::Int cycle,
+        const GateData &data
+    );
+
+    /**
+     * Same as the above, but for the given old-IR gate.
+     */
+    utils::Int next_cycle(
+        utils::UInt cycle,
+        const ir::compat::GateRef &gate
+    );
+
     /**
      * Dumps a debug representation of the current resource state.
      */
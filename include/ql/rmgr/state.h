@@ -37,6 +37,11 @@ private:
      */
     utils::Bool is_broken;
 
+    /**
+     * The scheduling direction that the resources were initialized for.
+     */
+    Direction direction;
+
     /**
      * Constructor for the initial state, called from Manager::build().
      */
@@ -82,6 +87,20 @@ public:
         const ir::StatementRef &statement
     ) const;
 
+    /**
+     * Returns the first cycle from the given cycle onward, in scheduling
+     * direction, at which the given old-IR gate might be schedulable. This is
+     * the given cycle itself if available() returns true for it. Otherwise,
+     * the gate can certainly not be scheduled before the returned cycle, even
+     * when more gates with a nonzero duration are scheduled in the meantime.
+     * Schedulers use this to avoid checking gates blocked by resources over
+     * and over again.
+     */
+    utils::UInt get_next_cycle(
+        utils::UInt cycle,
+        const ir::compat::GateRef &gate
+    ) const;
+
     /**
      * Schedules the given old-IR gate at the given (start) cycle. Throws an
      * exception if this is not possible. When an exception is thrown, the
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <fstream>
+#include <memory>
 #include "ql/utils/str.h"
 #include "ql/utils/exception.h"
 #include "ql/utils/compat.h"
@@ -109,7 +110,7 @@ private:
     std::ofstream ofs;
     Str path;
 public:
-    explicit OutFile(const Str &path);
+    explicit OutFile(const Str &path, Bool binary = false);
     void write(const Str &content);
     void close();
     void check();
@@ -122,6 +123,35 @@ public:
     }
 };
 
+/**
+ * Like OutFile, but writes a gzip-compressed file. The data is compressed in
+ * large blocks as the internal buffer fills up, so writing many small pieces
+ * of text to unwrap() is cheap. This is only supported when OpenQL was built
+ * with zlib; otherwise, construction throws a UserError. As for OutFile,
+ * close() does not need to be called, but any error that occurs while
+ * flushing the last block is silently ignored if it isn't.
+ */
+class GzOutFile {
+private:
+    class Buffer;
+    std::unique_ptr<Buffer> buf;
+    std::ostream os;
+    Str path;
+public:
+    explicit GzOutFile(const Str &path);
+    ~GzOutFile();
+    void write(const Str &content);
+    void close();
+    void check();
+    std::ostream &unwrap();
+    template <typename T>
+    GzOutFile &operator<<(T &&rhs) {
+        os << std::forward<T>(rhs);
+        check();
+        return *this;
+    }
+};
+
 /**
  * Wrapper for std::ifstream that:
  *  - takes care of the insane error handling magic of C++ streams;
@@ -137,7 +167,7 @@ private:
     std::ifstream ifs;
     Str path;
 public:
-    InFile(const Str &path);
+    InFile(const Str &path, Bool binary = false);
     Str read();
     void close();
     void check();
@@ -0,0 +1,155 @@
+/** \file
+ * Provides a simple thread pool for running independent work items
+ * concurrently.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ql/utils/num.h"
+
+namespace ql {
+namespace utils {
+
+/**
+ * A fixed-size pool of worker threads for executing data-parallel loops.
+ *
+ * The only operation is parallel_for(), which runs a function for each index
+ * in a range and returns when all of them have completed. The calling thread
+ * always participates in the work, so parallel_for() may be called
+ * recursively from within a work item without risk of deadlock; idle workers
+ * simply help out with whatever loop is pending. The order in which indices
+ * are executed is undefined, so work items must only write to state that is
+ * private to their index if the result is to be deterministic.
+ */
+class ThreadPool {
+private:
+
+    /**
+     * State of a single parallel_for() invocation.
+     */
+    struct Job {
+
+        /**
+         * The function to call for each index.
+         */
+        std::function<void(UInt)> function;
+
+        /**
+         * The number of indices to process.
+         */
+        UInt count;
+
+        /**
+         * The next index that has not been claimed by any thread yet.
+         */
+        std::atomic<UInt> next;
+
+        /**
+         * The number of indices that have completed.
+         */
+        UInt done;
+
+        /**
+         * The first exception thrown by a work item, if any.
+         */
+        std::exception_ptr error;
+
+        /**
+         * Mutex protecting done and error.
+         */
+        std::mutex mutex;
+
+        /**
+         * Condition variable signalled when done reaches count.
+         */
+        std::condition_variable completed;
+
+    };
+
+    /**
+     * The worker threads.
+     */
+    std::vector<std::thread> workers;
+
+    /**
+     * Jobs that (may) still have unclaimed indices.
+     */
+    std::deque<std::shared_ptr<Job>> jobs;
+
+    /**
+     * Mutex protecting jobs and stopping.
+     */
+    std::mutex mutex;
+
+    /**
+     * Condition variable signalled when a job is pushed or the pool is
+     * stopping.
+     */
+    std::condition_variable wakeup;
+
+    /**
+     * Set by the destructor to make the workers terminate.
+     */
+    Bool stopping;
+
+    /**
+     * Entry point for the worker threads.
+     */
+    void worker_main();
+
+    /**
+     * Claims and executes indices of the given job until none remain.
+     */
+    static void work_on(Job &job);
+
+public:
+
+    /**
+     * Constructs a thread pool. num_threads is the total number of threads
+     * that will work on a parallel_for(), including the calling thread, so
+     * num_threads - 1 worker threads are started. 0 means the number of
+     * hardware threads reported by the system. When this results in a single
+     * thread, parallel_for() simply runs the loop serially.
+     */
+    explicit ThreadPool(UInt num_threads = 0);
+
+    /**
+     * Stops and joins the worker threads.
+     */
+    ~ThreadPool();
+
+    /**
+     * Thread pools cannot be copied or moved.
+     */
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool(ThreadPool &&) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ThreadPool &operator=(ThreadPool &&) = delete;
+
+    /**
+     * Returns the total number of threads that work on a parallel_for(),
+     * including the calling thread.
+     */
+    UInt get_num_threads() const;
+
+    /**
+     * Calls function for each index in [0, count), using the worker threads
+     * and the calling thread, and returns when all calls have completed. If
+     * any of the calls throws an exception, the first one that was thrown is
+     * rethrown after all other calls have completed.
+     */
+    void parallel_for(UInt count, const std::function<void(UInt)> &function);
+
+};
+
+} // namespace utils
+} // namespace ql
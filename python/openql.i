@@ -22,6 +22,7 @@ namespace std {
    %template(vectorf) vector<float>;
    %template(vectord) vector<double>;
    %template(vectorc) vector<std::complex<double>>;
+   %template(vectors) vector<std::string>;
    %template(mapss) map<std::string, std::string>;
 };
 
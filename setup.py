@@ -169,6 +169,11 @@ class build_ext(_build_ext):
             if 'OPENQL_DISABLE_UNITARY' in os.environ:
                 cmd = cmd['-DWITH_UNITARY_DECOMPOSITION=OFF']
 
+            # gzip-compressed output support can be disabled using an
+            # environment variable, for systems without zlib.
+            if 'OPENQL_DISABLE_ZLIB' in os.environ:
+                cmd = cmd['-DWITH_ZLIB=OFF']
+
             # Initial placement support can be enabled using an environment
             # variable.
             if 'OPENQL_ENABLE_INITIAL_PLACEMENT' in os.environ:
@@ -694,5 +694,89 @@ Returns
 None
 """
 
+%feature("docstring") ql::api::Compiler::compile_cqasm_files
+"""
+Ensures that all passes have been constructed, and then reads each of the given
+cQASM 1.2 files and runs the passes on it. The files are read up front by a
+single cQASM reader for the given platform, parsing and analyzing them in
+parallel using the given number of threads, where 0 means the number of
+hardware threads. The passes are then run on each program in turn, in the order
+of the given list. The pass list should therefore not start with a cQASM reader
+pass, and @ql.platform annotations in the cQASM files are ignored. The read
+options of the cQASM reader pass are not supported; the defaults are used.
+
+Parameters
+----------
+platform : Platform
+    The platform to compile for.
+fnames : List[str]
+    The cQASM files to compile.
+num_threads : int
+    The number of threads used to parse and analyze the files, or 0 for the
+    number of hardware threads.
+
+Returns
+-------
+None
+"""
+
+%feature("docstring") ql::api::Compiler::print_profile
+"""
+Prints the profiling information recorded during the most recent compilation
+using this compiler. For each pass and pass group that ran, this lists how
+often it ran, the wall-clock time and CPU time it took, how much it increased
+the peak resident set size of the process, and the number of statements and
+gates in the program before and after.
+
+Profiling information is only recorded when the `profile_passes` option is
+set; otherwise, the table is empty.
+
+Parameters
+----------
+None
+
+Returns
+-------
+None
+"""
+
+
+%feature("docstring") ql::api::Compiler::dump_profile
+"""
+Returns the profiling information recorded during the most recent compilation
+using this compiler as a string. See print_profile().
+
+Parameters
+----------
+None
+
+Returns
+-------
+str
+    The profiling information as a multiline string.
+"""
+
+
+%feature("docstring") ql::api::Compiler::write_profile
+"""
+Writes the profiling information recorded during the most recent compilation
+using this compiler to the given file. The file is written in CSV format if
+its name ends in `.csv`, or in JSON format otherwise. Both contain one record
+per pass or pass group that ran, with its fully-qualified name, type, depth
+in the pass tree, number of runs, wall-clock and CPU time in seconds, peak
+resident set size increase in bytes, and statement and gate counts before and
+after.
+
+Parameters
+----------
+filename : str
+    The file to write to.
+
+Returns
+-------
+None
+"""
+
+
 
 %include "ql/api/compiler.h"
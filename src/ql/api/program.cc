@@ -223,14 +223,71 @@ void Program::print_interaction_matrix() const {
 }
 
 /**
- * Writes the interaction matrix for each kernel in the program to a file.
- * This is one of the few functions that still uses the global output_dir
- * option.
+ * Returns the qubit interaction matrix of the kernel with the given index,
+ * counting only CNOT gates. The matrix is flattened in row-major order:
+ * element i * N + j is the number of counted gates between qubits i and j,
+ * where N is the number of qubits of the kernel. Operand order is not
+ * respected, so the matrix is symmetric.
  */
-void Program::write_interaction_matrix() const {
+std::vector<size_t> Program::get_qubit_interaction_matrix(size_t kernel_index) const {
+    return get_qubit_interaction_matrix(kernel_index, {"cnot"});
+}
+
+/**
+ * Same as get_qubit_interaction_matrix(size_t), but counts the two-qubit
+ * gates of the given instructions. Instructions are identified by their
+ * name without any specialization or template operands, so "cz" also
+ * counts gates of the specialized instruction "cz q0,q1". If the list is
+ * empty, all two-qubit gates are counted.
+ */
+std::vector<size_t> Program::get_qubit_interaction_matrix(
+    size_t kernel_index,
+    const std::vector<std::string> &instruction_names
+) const {
+    if (kernel_index >= program->kernels.size()) {
+        throw ql::utils::Exception(
+            "kernel index " + ql::utils::to_string(kernel_index) + " is out of range; "
+            "the program has " + ql::utils::to_string(program->kernels.size()) + " kernels"
+        );
+    }
+    ql::com::ana::InteractionGateClass gate_class(instruction_names);
+    ql::com::ana::InteractionMatrix matrix(program->kernels[kernel_index], gate_class);
+    auto size = matrix.get_size();
+    std::vector<size_t> retval(size * size, 0);
+    for (size_t qubit = 0; qubit < size; qubit++) {
+        auto row = matrix.get_row(qubit);
+        for (auto it = row.first; it != row.second; ++it) {
+            retval[qubit * size + it->qubit] = it->count;
+        }
+    }
+    return retval;
+}
+
+/**
+ * Writes the interaction matrix for each kernel in the program to a file,
+ * counting only CNOT gates. This is one of the few functions that still
+ * uses the global output_dir option. The files are named
+ * "<kernel>InteractionMatrix.dat", or "<kernel>InteractionMatrix.csv" if
+ * csv is set, in which case only the nonzero elements of the upper half of
+ * the matrix are written, as qubit0,qubit1,count lines.
+ */
+void Program::write_interaction_matrix(bool csv) const {
+    write_interaction_matrix(csv, {"cnot"});
+}
+
+/**
+ * Same as write_interaction_matrix(bool), but counts the two-qubit gates
+ * of the given instructions, as for get_qubit_interaction_matrix().
+ */
+void Program::write_interaction_matrix(
+    bool csv,
+    const std::vector<std::string> &instruction_names
+) const {
     ql::com::ana::InteractionMatrix::write_for_program(
         get_option("output_dir") + "/",
-        program
+        program,
+        csv,
+        instruction_names
     );
 }
 
@@ -306,15 +306,48 @@ None
 """
 
 
+%feature("docstring") ql::api::Program::get_qubit_interaction_matrix
+"""
+Returns the qubit interaction matrix of the kernel with the given index,
+flattened in row-major order: element i * N + j is the number of counted
+gates between qubits i and j, where N is the number of qubits of the kernel.
+Operand order is not respected, so the matrix is symmetric.
+
+Parameters
+----------
+kernel_index : int
+    The index of the kernel in the program, default 0.
+instruction_names : List[str]
+    The instructions whose two-qubit gates are counted as interactions.
+    Instructions are identified by their name without any specialization or
+    template operands, so "cz" also counts gates of the specialized
+    instruction "cz q0,q1". If empty, all two-qubit gates are counted. If
+    not specified, only CNOT gates are counted.
+
+Returns
+-------
+List[int]
+    The flattened interaction matrix.
+"""
+
+
 %feature("docstring") ql::api::Program::write_interaction_matrix
 """
 Writes the interaction matrix for each kernel in the program to a file.
 This is one of the few functions that still uses the global output_dir
-option.
+option. The files are named "<kernel>InteractionMatrix.dat", or
+"<kernel>InteractionMatrix.csv" if csv is set.
 
 Parameters
 ----------
-None
+csv : bool
+    Whether to write only the nonzero elements of the upper half of the
+    matrix as qubit0,qubit1,count CSV lines, rather than the dense matrix.
+    Default False.
+instruction_names : List[str]
+    The instructions whose two-qubit gates are counted as interactions, as
+    for get_qubit_interaction_matrix(). If not specified, only CNOT gates are
+    counted.
 
 Returns
 -------
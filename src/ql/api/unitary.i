@@ -44,4 +44,41 @@ bool
 """
 
 
+%feature("docstring") ql::api::Unitary::set_decomposition_cache
+"""
+Configures the cache for unitary decompositions, such that unitary gates with
+the same matrix are only decomposed once. At most max_entries decompositions
+are kept in memory, evicting the least recently used one when full; 0 disables
+the in-memory cache. If directory is nonempty, decompositions are also stored
+in and loaded from files in that directory, so they can be reused by later
+runs. Both are disabled by default.
+
+Parameters
+----------
+max_entries : int
+    Maximum number of decompositions kept in memory.
+directory : str
+    Directory for the on-disk cache, or an empty string to disable it.
+
+Returns
+-------
+None
+"""
+
+
+%feature("docstring") ql::api::Unitary::clear_decomposition_cache
+"""
+Removes all decompositions from the in-memory decomposition cache. Files in
+the on-disk cache directory are not removed.
+
+Parameters
+----------
+None
+
+Returns
+-------
+None
+"""
+
+
 %include "ql/api/unitary.h"
@@ -0,0 +1,103 @@
+/**
+ * @file    arch/cc/pass/gen/vq1asm/detail/asm_stream.cc
+ * @date    20211015
+ * @brief   buffered output of generated assembly text to file
+ * @note
+ */
+
+#include "asm_stream.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace ql {
+namespace arch {
+namespace cc {
+namespace pass {
+namespace gen {
+namespace vq1asm {
+namespace detail {
+
+using namespace utils;
+
+AsmStream::AsmStream() {
+    // NB: a line may make the buffer go beyond its size, see endl()
+    buf.reserve(BUFFER_SIZE + 256);
+}
+
+AsmStream::~AsmStream() {
+    if (file) {
+        // compilation failed: discard the partial program, keeping any previous output file
+        file.reset();
+        std::remove(tmpFileName.c_str());
+    }
+}
+
+void AsmStream::open(const Str &fileName) {
+    this->fileName = fileName;
+    tmpFileName = fileName + ".tmp";
+    file.reset(new OutFile(tmpFileName));
+    flush();    // write anything generated before opening the file
+}
+
+void AsmStream::close() {
+    if (file) {
+        flush();
+        file->close();
+        file.reset();
+
+        // NB: std::rename() does not replace an existing file on Windows
+#ifdef _WIN32
+        std::remove(fileName.c_str());
+#endif
+        if (std::rename(tmpFileName.c_str(), fileName.c_str()) != 0) {
+            std::remove(tmpFileName.c_str());
+            QL_SYSTEM_ERROR("failed to move \"" << tmpFileName << "\" to \"" << fileName << "\"");
+        }
+    }
+}
+
+void AsmStream::flush() {
+    if (file && !buf.empty()) {
+        file->write(buf);
+        buf.clear();
+    }
+}
+
+AsmStream &AsmStream::put(const char *s) {
+    UInt len = std::strlen(s);
+    buf.append(s, len);
+    col += len;
+    return *this;
+}
+
+AsmStream &AsmStream::dec(Int value) {
+    char digits[24];
+    char *p = digits + sizeof(digits);
+    UInt v = value < 0 ? -(UInt)value : (UInt)value;
+    do {
+        *--p = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    if (value < 0) *--p = '-';
+    UInt len = digits + sizeof(digits) - p;
+    buf.append(p, len);
+    col += len;
+    return *this;
+}
+
+AsmStream &AsmStream::padTo(UInt column) {
+    if (col < column) {
+        buf.append(column - col, ' ');
+        col = column;
+    }
+    return *this;
+}
+
+} // namespace detail
+} // namespace vq1asm
+} // namespace gen
+} // namespace pass
+} // namespace cc
+} // namespace arch
+} // namespace ql
@@ -0,0 +1,86 @@
+/**
+ * @file    arch/cc/pass/gen/vq1asm/detail/asm_stream.h
+ * @date    20211015
+ * @brief   buffered output of generated assembly text to file
+ * @note    text is collected in a fixed-size buffer that is written to file
+ *          when full, or when flush() is called (i.e. at the end of every
+ *          kernel), so the size of the generated program does not affect
+ *          memory usage. The text is written to a temporary file that only
+ *          replaces the output file when close() succeeds, so a failing
+ *          compilation never leaves a partial program behind
+ */
+
+#pragma once
+
+#include <memory>
+#include "ql/utils/filesystem.h"
+
+#include "types.h"
+
+namespace ql {
+namespace arch {
+namespace cc {
+namespace pass {
+namespace gen {
+namespace vq1asm {
+namespace detail {
+
+class AsmStream {
+public:     // funcs
+    AsmStream();
+    ~AsmStream();                               // removes the temporary file if close() was not reached
+
+    void open(const Str &fileName);             // start writing to fileName. Until then, all text is kept in the buffer
+    void close();                               // write remaining text, close file and move it to fileName
+    void flush();                               // write buffered text to file, if open
+
+    // text output. NB: these functions maintain the current column, which is reset by endl()
+    AsmStream &put(char c) {
+        buf.push_back(c);
+        col++;
+        return *this;
+    }
+
+    AsmStream &put(const Str &s) {
+        buf.append(s);
+        col += s.size();
+        return *this;
+    }
+
+    AsmStream &put(const char *s);
+    AsmStream &dec(Int value);                  // decimal, without padding
+    AsmStream &padTo(UInt column);              // add spaces up to column, if not already there
+
+    // like std::setw(width) << std::left << s
+    AsmStream &field(const Str &s, UInt width) {
+        UInt end = col + width;
+        return put(s).padTo(end);
+    }
+
+    AsmStream &endl() {
+        buf.push_back('\n');
+        col = 0;
+        if (buf.size() >= BUFFER_SIZE) flush();
+        return *this;
+    }
+
+    UInt column() const { return col; }
+    const Str &getBuffered() const { return buf; }  // text not yet written to file
+
+private:    // vars
+    static const UInt BUFFER_SIZE = 64*1024;
+
+    Str buf;                                    // text not yet written to file
+    UInt col = 0;                               // column of the next character
+    std::unique_ptr<utils::OutFile> file;       // temporary output file, if opened
+    Str fileName;                               // final name of the output file
+    Str tmpFileName;                            // name of the temporary file written until close()
+}; // class
+
+} // namespace detail
+} // namespace vq1asm
+} // namespace gen
+} // namespace pass
+} // namespace cc
+} // namespace arch
+} // namespace ql
@@ -95,13 +95,9 @@ void Backend::compile(const ir::compat::ProgramRef &program, const OptionsRef &o
         codegenKernelEpilogue(kernel);
     }
 
+    // NB: this also completes writing the program to file
     codegen.programFinish(program->unique_name);
 
-    // write program to file
-    Str file_name(options->output_prefix + ".vq1asm");
-    QL_IOUT("Writing Central Controller program to " << file_name);
-    OutFile(file_name).write(codegen.getProgram());
-
     // write instrument map to file (unless we were using input file)
     Str map_input_file = options->map_input_file;
     if (!map_input_file.empty()) {
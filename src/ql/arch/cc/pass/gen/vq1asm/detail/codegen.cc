@@ -47,7 +47,7 @@ void Codegen::init(const ir::compat::PlatformRef &platform, const OptionsRef &op
 #if OPT_FEEDBACK
     // iterate over instruments
     for (UInt instrIdx = 0; instrIdx < settings.getInstrumentsSize(); instrIdx++) {
-        const Settings::InstrumentControl ic = settings.getInstrumentControl(instrIdx);
+        const Settings::InstrumentControl &ic = settings.getInstrumentControl(instrIdx);
         if (QL_JSON_EXISTS(ic.controlMode, "result_bits")) {  // this instrument mode produces results (i.e. it is a measurement device)
             QL_IOUT("instrument '" << ic.ii.instrumentName << "' (index " << instrIdx << ") is used for feedback");
         }
@@ -55,14 +55,6 @@ void Codegen::init(const ir::compat::PlatformRef &platform, const OptionsRef &op
 #endif
 }
 
-Str Codegen::getProgram() {
-#if OPT_FEEDBACK
-    return codeSection.str() + dp.getDatapathSection();
-#else
-    return codeSection.str();
-#endif
-}
-
 Str Codegen::getMap() {
     Json map;
 
@@ -77,6 +69,11 @@ Str Codegen::getMap() {
 \************************************************************************/
 
 void Codegen::programStart(const Str &progName) {
+    // the program is written to file while it is being generated, a kernel at a time
+    Str fileName(options->output_prefix + ".vq1asm");
+    QL_IOUT("Writing Central Controller program to " << fileName);
+    codeSection.open(fileName);
+
     emitProgramStart(progName);
 
     dp.programStart();
@@ -89,6 +86,10 @@ void Codegen::programFinish(const Str &progName) {
     emitProgramFinish();
 
     dp.programFinish();
+#if OPT_FEEDBACK
+    codeSection.put(dp.getDatapathSection());
+#endif
+    codeSection.close();
 
     vcd.programFinish(options->output_prefix + ".vcd");
 }
@@ -103,6 +104,7 @@ void Codegen::kernelStart() {
 
 void Codegen::kernelFinish(const Str &kernelName, UInt durationInCycles) {
     vcd.kernelFinish(kernelName, durationInCycles);
+    codeSection.flush();
 }
 
 /************************************************************************\
@@ -131,7 +133,7 @@ void Codegen::bundleStart(const Str &cmnt) {
     bundleInfo.clear();
     BundleInfo empty;
     for (UInt instrIdx = 0; instrIdx < settings.getInstrumentsSize(); instrIdx++) {
-        const Settings::InstrumentControl ic = settings.getInstrumentControl(instrIdx);
+        const Settings::InstrumentControl &ic = settings.getInstrumentControl(instrIdx);
         bundleInfo.emplace_back(
             ic.controlModeGroupCnt,     // one BundleInfo per group in the control mode selected for instrument
             empty                       // empty BundleInfo
@@ -276,7 +278,7 @@ Codegen::CodeGenMap Codegen::collectCodeGenInfo(
     // iterate over instruments
     for (UInt instrIdx = 0; instrIdx < settings.getInstrumentsSize(); instrIdx++) {
         // get control info from instrument settings
-        const Settings::InstrumentControl ic = settings.getInstrumentControl(instrIdx);
+        const Settings::InstrumentControl &ic = settings.getInstrumentControl(instrIdx);
         if (ic.ii.slot >= MAX_SLOTS) {
             QL_JSON_FATAL(
                 "illegal slot " << ic.ii.slot
@@ -357,7 +359,7 @@ Codegen::CodeGenMap Codegen::collectCodeGenInfo(
                 // get our qubit
                 const Json qubits = json_get<const Json>(*ic.ii.instrument, "qubits", ic.ii.instrumentName);   // NB: json_get<const Json&> unavailable
                 UInt qubitGroupCnt = qubits.size();                                  // NB: JSON key qubits is a 'matrix' of [groups*qubits]
-                if (group >= qubitGroupCnt) {    // FIXME: also tested in settings_cc::findSignalInfoForQubit
+                if (group >= qubitGroupCnt) {    // FIXME: also tested in Settings::findSignalInfoForType
                     QL_FATAL("group " << group << " not defined in '" << ic.ii.instrumentName << "/qubits'");
                 }
                 const Json qubitsOfGroup = qubits[group];
@@ -518,41 +520,39 @@ void Codegen::customGate(
 
     vcd.customGate(iname, operands, startCycle, durationInCycles);
 
-    Bool isReadout = settings.isReadout(iname);        //  determine whether this is a readout instruction
+    // get instruction (gate definition) information, resolved from JSON on first use
+    const Settings::InstructionInfo &ii = settings.getInstructionInfo(iname);
 
     // generate comment
-    if (isReadout) {
-        comment(Str(" # READOUT: '") + qasm(iname, operands, breg_operands) + "'");
-    } else { // handle all other instruction types than "readout"
-        // generate comment. NB: we don't have a particular limit for the number of operands
-        comment(Str(" # gate '") + qasm(iname, operands, breg_operands) + "'");
+    if (options->verbose) {
+        if (ii.isReadout) {
+            comment(Str(" # READOUT: '") + qasm(iname, operands, breg_operands) + "'");
+        } else { // handle all other instruction types than "readout"
+            // generate comment. NB: we don't have a particular limit for the number of operands
+            comment(Str(" # gate '") + qasm(iname, operands, breg_operands) + "'");
+        }
     }
 
-    // find instruction (gate definition)
-    const Json &instruction = platform->find_instruction(iname);
-    // find signal vector definition for instruction
-    Settings::SignalDef sd = settings.findSignalDefinition(instruction, iname);
-
     // scatter signals defined for instruction (e.g. several operands and/or types) to instruments & groups
-    for (UInt s = 0; s < sd.signal.size(); s++) {
-        CalcSignalValue csv = calcSignalValue(sd, s, operands, iname);
+    for (const Settings::InstructionSignal &is : ii.signals) {
+        CalcSignalValue csv = calcSignalValue(is, operands, iname);
 
         // store signal value, checking for conflicts
-        BundleInfo &bi = bundleInfo[csv.si.instrIdx][csv.si.group];         // shorthand
+        BundleInfo &bi = bundleInfo[csv.si->instrIdx][csv.si->group];       // shorthand
         if (!csv.signalValueString.empty()) {                               // empty implies no signal
             if (bi.signalValue.empty()) {                                   // signal not yet used
                 bi.signalValue = csv.signalValueString;
 #if OPT_SUPPORT_STATIC_CODEWORDS
                 // FIXME: this does not only provide support, but findStaticCodewordOverride() currently actually requires static codewords
-                bi.staticCodewordOverride = Settings::findStaticCodewordOverride(instruction, csv.operandIdx, iname); // NB: function return -1 means 'no override'
+                bi.staticCodewordOverride = is.staticCodewordOverride;      // NB: resolved by Settings::findStaticCodewordOverride()
 #endif
             } else if (bi.signalValue == csv.signalValueString) {           // signal unchanged
                 // do nothing
             } else {
                 showCodeSoFar();
                 QL_FATAL(
-                    "Signal conflict on instrument='" << csv.si.ic.ii.instrumentName
-                    << "', group=" << csv.si.group
+                    "Signal conflict on instrument='" << csv.si->ic.ii.instrumentName
+                    << "', group=" << csv.si->group
                     << ", between '" << bi.signalValue
                     << "' and '" << csv.signalValueString << "'"
                 );  // FIXME: add offending instruction
@@ -565,7 +565,7 @@ void Codegen::customGate(
 #if OPT_FEEDBACK
         // FIXME: assumes that group configuration for readout input matches that of output
         // store operands used for readout, actual work is postponed to bundleFinish()
-        if (isReadout) {
+        if (ii.isReadout) {
             /*
              * kernel->gate allows 3 types of measurement:
              *         - no explicit result. Historically this implies either:
@@ -595,7 +595,7 @@ void Codegen::customGate(
             }
 
             // store operands
-            if (settings.getReadoutMode(iname)=="feedback") {
+            if (ii.isFeedback) {
                 bi.isMeasFeedback = true;
                 bi.operands = operands;
                 //bi.creg_operands = creg_operands;    // NB: will be empty because of checks performed earlier
@@ -610,14 +610,14 @@ void Codegen::customGate(
 
         QL_DOUT("customGate(): iname='" << iname <<
              "', duration=" << durationInCycles <<
-             " [cycles], instrIdx=" << csv.si.instrIdx <<
-             ", group=" << csv.si.group);
+             " [cycles], instrIdx=" << csv.si->instrIdx <<
+             ", group=" << csv.si->group);
 
         // NB: code is generated in bundleFinish()
     }   // for(signal)
 
 #if OPT_PRAGMA
-    RawPtr<const Json> pragma = settings.getPragma(iname);
+    RawPtr<const Json> pragma = ii.pragma;
     if (pragma) {
         for (Vec<BundleInfo> &vbi : bundleInfo) {
             // FIXME: for now we just store the JSON of the pragma statement in bundleInfo[*][0]
@@ -711,13 +711,13 @@ void Codegen::comment(const Str &c) {
 
 void Codegen::emit(const Str &labelOrComment, const Str &instr) {
     if (labelOrComment.empty()) {                       // no label
-        codeSection << "        " << instr << std::endl;
+        codeSection.put("        ").put(instr).endl();
     } else if (labelOrComment.length() < 8) {           // label fits before instr
-        codeSection << std::setw(8) << labelOrComment << instr << std::endl;
+        codeSection.field(labelOrComment, 8).put(instr).endl();
     } else if (instr.empty()) {                         // no instr
-        codeSection << labelOrComment << std::endl;
+        codeSection.put(labelOrComment).endl();
     } else {
-        codeSection << labelOrComment << std::endl << "        " << instr << std::endl;
+        codeSection.put(labelOrComment).endl().put("        ").put(instr).endl();
     }
 }
 
@@ -725,11 +725,11 @@ void Codegen::emit(const Str &labelOrComment, const Str &instr) {
 // @param   labelOrSel      label must include trailing ":"
 // @param   comment         must include leading "#"
 void Codegen::emit(const Str &labelOrSel, const Str &instr, const Str &ops, const Str &comment) {
-    codeSection << std::setw(16) << labelOrSel << std::setw(16) << instr << std::setw(24) << ops << comment << std::endl;
+    codeSection.field(labelOrSel, 16).field(instr, 16).field(ops, 24).put(comment).endl();
 }
 
 void Codegen::emit(Int slot, const Str &instr, const Str &ops, const Str &comment) {
-    emit(QL_SS2S("[" << slot << "]"), instr, ops, comment);
+    codeSection.put('[').dec(slot).put(']').padTo(16).field(instr, 16).field(ops, 24).put(comment).endl();
 }
 
 /************************************************************************\
@@ -737,18 +737,17 @@ void Codegen::emit(Int slot, const Str &instr, const Str &ops, const Str &commen
 \************************************************************************/
 
 void Codegen::showCodeSoFar() {
-    // provide context to help finding reason. FIXME: limit # lines
-    QL_EOUT("Code so far:\n" << codeSection.str());
+    // provide context to help finding reason. NB: code of previous kernels has already been written to file
+    QL_EOUT("Code so far (current kernel):\n" << codeSection.getBuffered());
 }
 
 void Codegen::emitProgramStart(const Str &progName) {
     // emit program header
-    codeSection << std::left;    // assumed by emit()
-    codeSection << "# Program: '" << progName << "'" << std::endl;   // NB: put on top so it shows up in internal CC logging
-    codeSection << "# CC_BACKEND_VERSION " << CC_BACKEND_VERSION_STRING << std::endl;
-    codeSection << "# OPENQL_VERSION " << OPENQL_VERSION_STRING << std::endl;
-    codeSection << "# Note:    generated by OpenQL Central Controller backend" << std::endl;
-    codeSection << "#" << std::endl;
+    codeSection.put("# Program: '").put(progName).put("'").endl();   // NB: put on top so it shows up in internal CC logging
+    codeSection.put("# CC_BACKEND_VERSION " CC_BACKEND_VERSION_STRING).endl();
+    codeSection.put("# OPENQL_VERSION " OPENQL_VERSION_STRING).endl();
+    codeSection.put("# Note:    generated by OpenQL Central Controller backend").endl();
+    codeSection.put("#").endl();
 
 #if OPT_FEEDBACK
     emit(".CODE");   // start .CODE section
@@ -945,22 +944,21 @@ void Codegen::emitPadToCycle(UInt instrIdx, UInt startCycle, Int slot, const Str
 }
 
 
-// compute signalValueString, and some meta information, for sd[s] (i.e. one of the signals in the JSON definition of an instruction)
+// compute signalValueString, and some meta information, for signal is (i.e. one of the signals in the JSON definition of an instruction)
+// NB: the JSON has already been resolved by Settings::getInstructionInfo(), what remains is selecting the qubit
 Codegen::CalcSignalValue Codegen::calcSignalValue(
-    const Settings::SignalDef &sd,
-    UInt s,
+    const Settings::InstructionSignal &is,
     const Vec<UInt> &operands,
     const Str &iname
 ) {
     CalcSignalValue ret;
-    Str signalSPath = QL_SS2S(sd.path<<"["<<s<<"]");                   // for JSON error reporting
 
     /************************************************************************\
     | get signal properties, mapping operand index to qubit
     \************************************************************************/
 
     // get the operand index & qubit to work on
-    ret.operandIdx = json_get<UInt>(sd.signal[s], "operand_idx", signalSPath);
+    ret.operandIdx = is.operandIdx;
     if (ret.operandIdx >= operands.size()) {
         QL_JSON_FATAL(
             "instruction '" << iname
@@ -971,54 +969,48 @@ Codegen::CalcSignalValue Codegen::calcSignalValue(
     }
     UInt qubit = operands[ret.operandIdx];
 
-    // get signal value
-    const Json instructionSignalValue = json_get<const Json>(sd.signal[s], "value", signalSPath);   // NB: json_get<const Json&> unavailable
-    Str sv = QL_SS2S(instructionSignalValue);   // serialize/stream instructionSignalValue into std::string
-
-    // get instruction signal type (e.g. "mw", "flux", etc)
-    // NB: instructionSignalType is different from "instruction/type" provided by find_instruction_type, although some identical strings are used). NB: that key is no longer used by the 'core' of OpenQL
-    Str instructionSignalType = json_get<Str>(sd.signal[s], "type", signalSPath);
-
     /************************************************************************\
     | map signal type for qubit to instrument & group
     \************************************************************************/
 
     // find signalInfo, i.e. perform the mapping
-    ret.si = settings.findSignalInfoForQubit(instructionSignalType, qubit);
+    if (!is.signalTypeFound) {
+        QL_JSON_FATAL("No instruments found providing signal type '" << is.type << "'");
+    }
+    if (qubit >= is.signalInfo.size() || !is.signalInfo[qubit]) {
+        QL_JSON_FATAL("No instruments found driving qubit " << qubit << " for signal type '" << is.type << "'");
+    }
+    ret.si = is.signalInfo[qubit];
 
-    if (instructionSignalValue.empty()) {    // allow empty signal
+    if (is.valueEmpty) {    // allow empty signal
         ret.signalValueString = "";
     } else {
         // verify signal dimensions
-        UInt channelsPergroup = ret.si.ic.controlModeGroupSize;
-        if (instructionSignalValue.size() != channelsPergroup) {
+        UInt channelsPergroup = ret.si->ic.controlModeGroupSize;
+        if (is.valueSize != channelsPergroup) {
             QL_JSON_FATAL(
                 "signal dimension mismatch on instruction '" << iname
-                << "' : control mode '" << ret.si.ic.refControlMode
+                << "' : control mode '" << ret.si->ic.refControlMode
                 << "' requires " <<  channelsPergroup
-                << " signals, but signal '" << signalSPath+"/value"
-                << "' provides " << instructionSignalValue.size()
+                << " signals, but signal '" << is.path+"/value"
+                << "' provides " << is.valueSize
             );
         }
 
-        // expand macros
-        sv = replace_all(sv, "\"", "");   // get rid of quotes
-        sv = replace_all(sv, "{gateName}", iname);
-        sv = replace_all(sv, "{instrumentName}", ret.si.ic.ii.instrumentName);
-        sv = replace_all(sv, "{instrumentGroup}", to_string(ret.si.group));
-        // FIXME: allow using all qubits involved (in same signalType?, or refer to signal: qubitOfSignal[n]), e.g. qubit[0], qubit[1], qubit[2]
-        sv = replace_all(sv, "{qubit}", to_string(qubit));
-        ret.signalValueString = sv;
+        // get value with macros expanded
+        ret.signalValueString = Settings::getSignalValue(is, qubit);
 
         // FIXME: note that the actual contents of the signalValue only become important when we'll do automatic codeword assignment and provide codewordTable to downstream software to assign waveforms to the codewords
     }
 
-    comment(QL_SS2S(
-        "  # slot=" << ret.si.ic.ii.slot
-        << ", instrument='" << ret.si.ic.ii.instrumentName << "'"
-        << ", group=" << ret.si.group
-        << "': signalValue='" << ret.signalValueString << "'"
-    ));
+    if (options->verbose) {
+        comment(QL_SS2S(
+            "  # slot=" << ret.si->ic.ii.slot
+            << ", instrument='" << ret.si->ic.ii.instrumentName << "'"
+            << ", group=" << ret.si->group
+            << "': signalValue='" << ret.signalValueString << "'"
+        ));
+    }
 
     return ret;
 }
@@ -11,6 +11,7 @@
 
 #include "ql/ir/compat/platform.h"
 #include "types.h"
+#include "asm_stream.h"
 #include "options.h"
 #include "bundle_info.h"
 #include "datapath.h"
@@ -32,7 +33,6 @@ public: //  functions
 
     // Generic
     void init(const ir::compat::PlatformRef &platform, const OptionsRef &options);
-    Str getProgram();                           // return the CC source code that was created
     Str getMap();                               // return a map of codeword assignments, useful for configuring AWGs
 
     // Compile support
@@ -90,7 +90,7 @@ private:    // types
     struct CalcSignalValue {
         Str signalValueString;
         UInt operandIdx;
-        Settings::SignalInfo si;
+        RawPtr<const Settings::SignalInfo> si;
     }; // return type for calcSignalValue()
 
 
@@ -108,7 +108,7 @@ private:    // vars
 
     // codegen state, program scope
     Json codewordTable;                                         // codewords versus signals per instrument group
-    StrStrm codeSection;                                        // the code generated
+    AsmStream codeSection;                                      // the code generated, streamed to file
 
     // codegen state, kernel scope FIXME: create class
     UInt lastEndCycle[MAX_INSTRS];                              // vector[instrIdx], maintain where we got per slot
@@ -137,7 +137,7 @@ private:    // funcs
 
     // generic helpers
     CodeGenMap collectCodeGenInfo(UInt startCycle, UInt durationInCycles);
-    CalcSignalValue calcSignalValue(const Settings::SignalDef &sd, UInt s, const Vec<UInt> &operands, const Str &iname);
+    CalcSignalValue calcSignalValue(const Settings::InstructionSignal &is, const Vec<UInt> &operands, const Str &iname);
 #if !OPT_SUPPORT_STATIC_CODEWORDS
     Codeword assignCodeword(const Str &instrumentName, Int instrIdx, Group group);
 #endif
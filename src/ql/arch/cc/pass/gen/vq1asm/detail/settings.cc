@@ -37,6 +37,14 @@ void Settings::loadBackendSettings(const ir::compat::PlatformRef &platform) {
     QL_JSON_ASSERT(jsonBackendSettings, "signals", "eqasm_backend_cc");
     jsonSignals = &jsonBackendSettings["signals"];
 
+    // resolve control information for all instruments once, instead of per bundle
+    instrumentControls.clear();
+    for (UInt instrIdx = 0; instrIdx < jsonInstruments->size(); instrIdx++) {
+        instrumentControls.push_back(loadInstrumentControl(instrIdx));
+    }
+    signalInfoMaps.clear();
+    instructionInfos.clear();
+
 #if 0   // FIXME: print some info, which also helps detecting errors early on
     // read instrument definitions
     // FIXME: the following requires json>v3.1.0: (NB: we now moved to 3.9!) for(auto& id : jsonInstrumentDefinitions->items()) {
@@ -66,14 +74,6 @@ void Settings::loadBackendSettings(const ir::compat::PlatformRef &platform) {
 #endif
 }
 
-// NB: assumes prior test for isReadout()==true
-Str Settings::getReadoutMode(const Str &iname) {
-    const Json &instruction = platform->find_instruction(iname);
-    Str instructionPath = "instructions/"+iname;
-    QL_JSON_ASSERT(instruction, "cc", instructionPath);
-    return json_get<Str>(instruction["cc"], "readout_mode", instructionPath);
-}
-
 // determine whether this is a 'readout instruction'
 Bool Settings::isReadout(const Json &instruction, const Str &iname) {
     Str instructionPath = "instructions/" + iname;
@@ -81,23 +81,6 @@ Bool Settings::isReadout(const Json &instruction, const Str &iname) {
     return QL_JSON_EXISTS(instruction["cc"], "readout_mode");
 }
 
-// determine whether this is a 'readout instruction'
-Bool Settings::isReadout(const Str &iname) {
-#if 1    // new semantics
-    const Json &instruction = platform->find_instruction(iname);
-    return isReadout(instruction, iname);
-#else
-    /*
-        NB: we only use the instruction_type "readout" and don't care about the rest
-        because the terms "mw" and "flux" don't fully cover gate functionality. It
-        would be nice if custom gates could mimic gate_type_t
-    */
-    // FIXME: it seems that key "instruction/type" is no longer used by the 'core' of OpenQL, so we need a better criterion
-    // FIXME: must not trigger in "prepz", which has type "readout" in (some?) configuration files (with empty signal though)
-    // FIXME: gate semantics should be handled at the OpenQL core
-    return platform->find_instruction_type(iname) == "readout";
-#endif
-}
 
 
 // determine whether this is a 'flux instruction'
@@ -114,38 +97,6 @@ Bool Settings::isFlux(const Json &instruction, RawPtr<const Json> signals, const
     }
 }
 
-Bool Settings::isFlux(const Str &iname) {
-#if 1   //new semantics
-    const Json &instruction = platform->find_instruction(iname);
-    return isFlux(instruction, jsonSignals, iname);
-#else
-    const Json &instruction = platform->find_instruction(iname);
-    if (!QL_JSON_EXISTS(instruction, "type")) {
-        return false;
-    } else {
-        return instruction["type"] == "flux";
-    }
-#endif
-}
-
-
-Bool Settings::isPragma(const Str &iname) {
-    return getPragma(iname).has_value();
-}
-
-
-RawPtr<const Json> Settings::getPragma(const Str &iname) {
-    const Json &instruction = platform->find_instruction(iname);
-    Str instructionPath = "instructions/" + iname;
-    QL_JSON_ASSERT(instruction, "cc", instructionPath);
-    if (QL_JSON_EXISTS(instruction["cc"], "pragma")) {
-        return &instruction["cc"]["pragma"];
-    } else {
-        return nullptr;
-    }
-}
-
-
 // find JSON signal definition for instruction, either inline or via 'ref_signal'
 Settings::SignalDef Settings::findSignalDefinition(const Json &instruction, RawPtr<const Json> signals, const Str &iname) {
     SignalDef ret;
@@ -172,36 +123,6 @@ Settings::SignalDef Settings::findSignalDefinition(const Json &instruction, RawP
 }
 
 
-// find JSON signal definition for instruction, either inline or via 'ref_signal'
-Settings::SignalDef Settings::findSignalDefinition(const Json &instruction, const Str &iname) const {
-#if 1
-    return findSignalDefinition(instruction, jsonSignals, iname);
-#else
-    SignalDef ret;
-
-    Str instructionPath = "instructions/" + iname;
-    QL_JSON_ASSERT(instruction, "cc", instructionPath);
-    if (QL_JSON_EXISTS(instruction["cc"], "ref_signal")) {                      // optional syntax: "ref_signal"
-        Str refSignal = instruction["cc"]["ref_signal"].get<Str>();
-        ret.signal = (*jsonSignals)[refSignal];                                 // poor man's JSON pointer
-        if(ret.signal.empty()) {
-            QL_JSON_FATAL(
-                "instruction '" << iname
-                << "': ref_signal '" << refSignal
-                << "' does not resolve"
-            );
-        }
-        ret.path = "signals/" + refSignal;
-    } else {                                                                    // alternative syntax: "signal"
-        ret.signal = json_get<Json>(instruction["cc"], "signal", instructionPath + "/cc");
-        QL_DOUT("signal for '" << instruction << "': " << ret.signal);
-        ret.path = instructionPath + "/cc/signal";
-    }
-    return ret;
-#endif
-}
-
-
 // collect some configuration info for an instrument
 Settings::InstrumentInfo Settings::getInstrumentInfo(UInt instrIdx) const {
     InstrumentInfo ret = {nullptr};
@@ -230,7 +151,16 @@ Settings::InstrumentInfo Settings::getInstrumentInfo(UInt instrIdx) const {
 }
 
 
-Settings::InstrumentControl Settings::getInstrumentControl(UInt instrIdx) const {
+// get the control info for an instrument, as resolved by loadBackendSettings()
+const Settings::InstrumentControl &Settings::getInstrumentControl(UInt instrIdx) const {
+    if (instrIdx >= instrumentControls.size()) {
+        QL_JSON_FATAL("node not defined: instruments[" << instrIdx << "]");     // probably an internal backend error
+    }
+    return instrumentControls[instrIdx];
+}
+
+
+Settings::InstrumentControl Settings::loadInstrumentControl(UInt instrIdx) const {
     InstrumentControl ret;
 
     ret.ii = getInstrumentInfo(instrIdx);
@@ -284,18 +214,22 @@ Int Settings::getResultBit(const InstrumentControl &ic, Int group) {
 }
 
 
-// find instrument&group given instructionSignalType for qubit
+// find instruments&groups given instructionSignalType, per qubit
 // NB: this implies that we map signal *vectors* to groups, i.e. it is not possible to map individual channels
 // Conceptually, this is were we map an abstract signal definition, eg: {"flux", q3} (which may also be
 // interpreted as port "q3.flux") onto an instrument & group
-Settings::SignalInfo Settings::findSignalInfoForQubit(const Str &instructionSignalType, UInt qubit) const {
-    SignalInfo ret;
+RawPtr<const Settings::SignalInfoMap> Settings::findSignalInfoForType(const Str &instructionSignalType) {
+    auto it = signalInfoMaps.find(instructionSignalType);
+    if (it != signalInfoMaps.end()) {
+        return &it->second;
+    }
+
+    SignalInfoMap ret;
     Bool signalTypeFound = false;
-    Bool qubitFound = false;
 
     // iterate over instruments
-    for (UInt instrIdx = 0; instrIdx < jsonInstruments->size() && !qubitFound; instrIdx++) {
-        InstrumentControl ic = getInstrumentControl(instrIdx);
+    for (UInt instrIdx = 0; instrIdx < jsonInstruments->size(); instrIdx++) {
+        const InstrumentControl &ic = getInstrumentControl(instrIdx);
         Str instrumentSignalType = json_get<Str>(*ic.ii.instrument, "signal_type", ic.ii.instrumentName);
         if (instrumentSignalType == instructionSignalType) {
             signalTypeFound = true;
@@ -312,35 +246,115 @@ Settings::SignalInfo Settings::findSignalInfoForQubit(const Str &instructionSign
                 );
             }
 
-            // anyone connected to qubit?
-            for (UInt group = 0; group < qubitGroupCnt && !qubitFound; group++) {
-                for (UInt idx = 0; idx < qubits[group].size() && !qubitFound; idx++) {
-                    if (qubits[group][idx].get<UInt>() == qubit) {
-                        qubitFound = true;                                      // also: stop searching
-
+            // remind which qubits are connected. NB: the first instrument&group found for a qubit is used
+            for (UInt group = 0; group < qubitGroupCnt; group++) {
+                for (UInt idx = 0; idx < qubits[group].size(); idx++) {
+                    UInt qubit = qubits[group][idx].get<UInt>();
+                    if (ret.find(qubit) == ret.end()) {
                         QL_DOUT(
                             "qubit " << qubit
                             << " signal type '" << instructionSignalType
                             << "' driven by instrument '" << ic.ii.instrumentName
                             << "' group " << group
                         );
-
-                        ret.ic = ic;
-                        ret.instrIdx = instrIdx;
-                        ret.group = group;
+                        ret.set(qubit) = SignalInfo{ic, instrIdx, (Int)group};
                     }
                 }
             }
         }
     }
     if (!signalTypeFound) {
-        QL_JSON_FATAL("No instruments found providing signal type '" << instructionSignalType << "'");
+        return nullptr;
+    }
+
+    return &(signalInfoMaps.set(instructionSignalType) = ret);
+}
+
+
+// get the information for instruction iname. This resolves all JSON (and
+// strings) needed by Codegen::customGate() for every gate once per instruction,
+// and resolves its signals to instruments & groups for every qubit
+const Settings::InstructionInfo &Settings::getInstructionInfo(const Str &iname) {
+    auto it = instructionInfos.find(iname);
+    if (it != instructionInfos.end()) {
+        return it->second;
     }
-    if (!qubitFound) {
-        QL_JSON_FATAL("No instruments found driving qubit " << qubit << " for signal type '" << instructionSignalType << "'");
+
+    InstructionInfo ret;
+    const Json &instruction = platform->find_instruction(iname);
+    Str instructionPath = "instructions/" + iname;
+
+    // readout
+    ret.isReadout = isReadout(instruction, iname);  // NB: also asserts existence of key 'cc'
+    ret.isFeedback = ret.isReadout && json_get<Str>(instruction["cc"], "readout_mode", instructionPath) == "feedback";
+
+    // pragma
+    if (QL_JSON_EXISTS(instruction["cc"], "pragma")) {
+        ret.pragma = &instruction["cc"]["pragma"];
     }
 
-    return ret;
+    // signals
+    SignalDef sd = findSignalDefinition(instruction, jsonSignals, iname);
+    for (UInt s = 0; s < sd.signal.size(); s++) {
+        InstructionSignal is;
+        is.path = QL_SS2S(sd.path << "[" << s << "]");                         // for JSON error reporting
+        is.operandIdx = json_get<UInt>(sd.signal[s], "operand_idx", is.path);
+
+        // get signal value
+        const Json instructionSignalValue = json_get<const Json>(sd.signal[s], "value", is.path);   // NB: json_get<const Json&> unavailable
+        is.valueEmpty = instructionSignalValue.empty();
+        is.valueSize = instructionSignalValue.size();
+        is.staticCodewordOverride = NO_STATIC_CODEWORD_OVERRIDE;
+#if OPT_SUPPORT_STATIC_CODEWORDS
+        if (!is.valueEmpty) {
+            is.staticCodewordOverride = findStaticCodewordOverride(instruction, is.operandIdx, iname);
+        }
+#endif
+
+        // get instruction signal type (e.g. "mw", "flux", etc)
+        // NB: instructionSignalType is different from "instruction/type" provided by find_instruction_type, although some identical strings are used). NB: that key is no longer used by the 'core' of OpenQL
+        is.type = json_get<Str>(sd.signal[s], "type", is.path);
+
+        // map signal type for every qubit to instrument & group. The macros in the signal value that depend on the
+        // qubit are expanded by getSignalValue(), only for the qubits the instruction is actually used on
+        RawPtr<const SignalInfoMap> signalInfoMap = findSignalInfoForType(is.type);
+        is.signalTypeFound = signalInfoMap.has_value();
+        is.signalInfo.resize(platform->qubit_count);
+        is.signalValue.resize(platform->qubit_count);
+        is.signalValueExpanded.resize(platform->qubit_count, false);
+        if (is.signalTypeFound) {
+            if (!is.valueEmpty) {
+                Str sv = QL_SS2S(instructionSignalValue);   // serialize/stream instructionSignalValue into std::string
+                sv = replace_all(sv, "\"", "");             // get rid of quotes
+                is.signalValueTemplate = replace_all(sv, "{gateName}", iname);
+            }
+            for (const auto &qsi : *signalInfoMap) {
+                UInt qubit = qsi.first;
+                if (qubit >= platform->qubit_count) {
+                    continue;   // NB: cannot be used by gates
+                }
+                is.signalInfo[qubit] = &qsi.second;
+            }
+        }
+
+        ret.signals.push_back(is);
+    }
+
+    return instructionInfos.set(iname) = ret;
+}
+
+const Str &Settings::getSignalValue(const InstructionSignal &is, UInt qubit) {
+    if (!is.signalValueExpanded[qubit]) {
+        if (!is.valueEmpty) {
+            const SignalInfo &si = *is.signalInfo[qubit];
+            Str qsv = replace_all(is.signalValueTemplate, "{instrumentName}", si.ic.ii.instrumentName);
+            qsv = replace_all(qsv, "{instrumentGroup}", to_string(si.group));
+            // FIXME: allow using all qubits involved (in same signalType?, or refer to signal: qubitOfSignal[n]), e.g. qubit[0], qubit[1], qubit[2]
+            is.signalValue[qubit] = replace_all(qsv, "{qubit}", to_string(qubit));
+        }
+        is.signalValueExpanded[qubit] = true;
+    }
+    return is.signalValue[qubit];
 }
 
 /************************************************************************\
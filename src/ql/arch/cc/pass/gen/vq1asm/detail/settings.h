@@ -52,26 +52,45 @@ public: // types
 
     static const Int NO_STATIC_CODEWORD_OVERRIDE = -1;
 
+    struct InstructionSignal {      // information from one element of the signal vector of an instruction, resolved per qubit
+        Str path;                   // path of the signal node, for reporting purposes
+        UInt operandIdx;            // key 'operand_idx'
+        Str type;                   // key 'type', e.g. "mw", "flux"
+        Bool valueEmpty;            // whether key 'value' is empty, implying no signal
+        UInt valueSize;             // size of key 'value', i.e. the number of channels it requires
+        Int staticCodewordOverride; // see findStaticCodewordOverride(), NO_STATIC_CODEWORD_OVERRIDE if value is empty
+        Bool signalTypeFound;       // whether any instrument provides signal type
+        Vec<RawPtr<const SignalInfo>> signalInfo;   // vector[qubit], instrument & group providing the signal for qubit, nullptr if none
+        Str signalValueTemplate;    // key 'value' with quotes removed and '{gateName}' expanded, empty if value is empty
+
+        // vector[qubit], signalValueTemplate with the remaining macros expanded, filled by getSignalValue() on first use
+        mutable Vec<Str> signalValue;
+        mutable Vec<Bool> signalValueExpanded;
+    };
+
+    struct InstructionInfo {        // information from key 'instructions/<name>/cc', resolved once per instruction
+        Bool isReadout;             // see isReadout()
+        Bool isFeedback;            // whether key 'readout_mode' is "feedback"
+        RawPtr<const Json> pragma;  // key 'pragma', nullptr if not present
+        Vec<InstructionSignal> signals;
+    };
+
 public: // functions
     Settings() = default;
     ~Settings() = default;
 
     void loadBackendSettings(const ir::compat::PlatformRef &platform);
-    Str getReadoutMode(const Str &iname);
     static Bool isReadout(const Json &instruction, const Str &iname);
-    Bool isReadout(const Str &iname);
     static Bool isFlux(const Json &instruction, RawPtr<const Json> signals, const Str &iname);
-    Bool isFlux(const Str &iname);
-    Bool isPragma(const Str &iname);
-    RawPtr<const Json> getPragma(const Str &iname);
     static SignalDef findSignalDefinition(const Json &instruction, RawPtr<const Json> signals, const Str &iname);
-    SignalDef findSignalDefinition(const Json &instruction, const Str &iname) const;
-    InstrumentInfo getInstrumentInfo(UInt instrIdx) const;
-    InstrumentControl getInstrumentControl(UInt instrIdx) const;
+    const InstrumentControl &getInstrumentControl(UInt instrIdx) const;
     static Int getResultBit(const InstrumentControl &ic, Int group) ;
 
-    // find instrument/group providing instructionSignalType for qubit
-    SignalInfo findSignalInfoForQubit(const Str &instructionSignalType, UInt qubit) const;
+    // get the information for instruction iname, resolving it from JSON on first use
+    const InstructionInfo &getInstructionInfo(const Str &iname);
+
+    // get the signal value of is for qubit, expanding its macros on first use. NB: qubit must have signalInfo
+    static const Str &getSignalValue(const InstructionSignal &is, UInt qubit);
 
     static Int findStaticCodewordOverride(const Json &instruction, UInt operandIdx, const Str &iname);
 
@@ -79,12 +98,26 @@ public: // functions
     const Json &getInstrumentAtIdx(UInt instrIdx) const { return (*jsonInstruments)[instrIdx]; }
     UInt getInstrumentsSize() const { return jsonInstruments->size(); }
 
+private:    // types
+    using SignalInfoMap = Map<UInt, SignalInfo>;                // NB: key is qubit
+
+private:    // functions
+    InstrumentInfo getInstrumentInfo(UInt instrIdx) const;
+    InstrumentControl loadInstrumentControl(UInt instrIdx) const;
+
+    // find instruments/groups providing instructionSignalType, per qubit. Returns nullptr if there are none
+    RawPtr<const SignalInfoMap> findSignalInfoForType(const Str &instructionSignalType);
+
 private:    // vars
     ir::compat::PlatformRef platform;
     RawPtr<const Json> jsonInstrumentDefinitions;
     RawPtr<const Json> jsonControlModes;
     RawPtr<const Json> jsonInstruments;
     RawPtr<const Json> jsonSignals;
+
+    Vec<InstrumentControl> instrumentControls;                  // vector[instrIdx]
+    Map<Str, SignalInfoMap> signalInfoMaps;                     // NB: key is signal type
+    Map<Str, InstructionInfo> instructionInfos;                 // NB: key is instruction name
 }; // class
 
 } // namespace detail
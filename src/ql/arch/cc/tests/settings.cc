@@ -0,0 +1,96 @@
+#include "ql/ir/compat/platform.h"
+#include "../pass/gen/vq1asm/detail/settings.h"
+
+using namespace ql;
+using namespace ql::arch::cc::pass::gen::vq1asm::detail;
+
+/**
+ * Computes the signal value of the given signal of an instruction for the
+ * given qubit directly from the JSON configuration, the way the backend did
+ * for every gate before it resolved instructions into a table. Returns false
+ * if no instrument drives the qubit for the type of the signal.
+ */
+static utils::Bool old_signal_value(
+    const ir::compat::PlatformRef &platform,
+    const utils::Json &signal,
+    const utils::Str &iname,
+    utils::UInt qubit,
+    utils::Str &value
+) {
+    const auto &instruments = platform->hardware_settings["eqasm_backend_cc"]["instruments"];
+    for (const auto &instrument : instruments) {
+        if (instrument["signal_type"].get<utils::Str>() != signal["type"].get<utils::Str>()) {
+            continue;
+        }
+        const auto &groups = instrument["qubits"];
+        for (utils::UInt group = 0; group < groups.size(); group++) {
+            for (const auto &q : groups[group]) {
+                if (q.get<utils::UInt>() != qubit) {
+                    continue;
+                }
+                if (signal["value"].empty()) {
+                    value = "";
+                    return true;
+                }
+                utils::Str sv = QL_SS2S(signal["value"]);
+                sv = utils::replace_all(sv, "\"", "");
+                sv = utils::replace_all(sv, "{gateName}", iname);
+                sv = utils::replace_all(sv, "{instrumentName}", instrument["name"].get<utils::Str>());
+                sv = utils::replace_all(sv, "{instrumentGroup}", utils::to_string(group));
+                value = utils::replace_all(sv, "{qubit}", utils::to_string(qubit));
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Checks that the signal values that the backend expands on first use for
+ * every instruction and qubit match the ones computed from the JSON.
+ */
+int main() {
+    auto platform = ir::compat::Platform::build("s-17", utils::Str("cc/test_cfg_cc.json"));
+    Settings settings;
+    settings.loadBackendSettings(platform);
+
+    utils::UInt num_checked = 0;
+    for (const auto &it : platform->instruction_settings.items()) {
+        const auto &iname = it.key();
+
+        // Instructions that the backend rejects, for instance for lacking a
+        // static codeword override for an operand, can't be checked.
+        RawPtr<const Settings::InstructionInfo> info_ptr;
+        try {
+            info_ptr = &settings.getInstructionInfo(iname);
+        } catch (std::exception &) {
+            continue;
+        }
+        const auto &info = *info_ptr;
+        auto sd = Settings::findSignalDefinition(
+            it.value(),
+            &platform->hardware_settings["eqasm_backend_cc"]["signals"],
+            iname
+        );
+        QL_ASSERT(info.signals.size() == sd.signal.size());
+        for (utils::UInt s = 0; s < sd.signal.size(); s++) {
+            const auto &is = info.signals[s];
+            for (utils::UInt qubit = 0; qubit < platform->qubit_count; qubit++) {
+                utils::Str expected;
+                auto found = old_signal_value(platform, sd.signal[s], iname, qubit, expected);
+                QL_ASSERT(found == is.signalInfo[qubit].has_value());
+                if (!found) {
+                    continue;
+                }
+
+                // Twice, to check that the cached value is returned as well.
+                QL_ASSERT(Settings::getSignalValue(is, qubit) == expected);
+                QL_ASSERT(Settings::getSignalValue(is, qubit) == expected);
+                num_checked++;
+            }
+        }
+    }
+    QL_ASSERT(num_checked > 0);
+
+    return 0;
+}
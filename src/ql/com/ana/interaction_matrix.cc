@@ -5,6 +5,7 @@
 #include "ql/com/ana/interaction_matrix.h"
 
 #include <iomanip>
+#include <algorithm>
 #include "ql/utils/filesystem.h"
 #include "ql/com/options.h"
 
@@ -14,37 +15,184 @@ namespace ana {
 
 using namespace utils;
 
+/**
+ * Constructs a gate class for the given instruction names. The default only
+ * counts CNOT gates.
+ */
+InteractionGateClass::InteractionGateClass(
+    const Vec<Str> &instruction_names
+) : instruction_names(instruction_names.begin(), instruction_names.end()) {
+}
+
+/**
+ * Returns whether the given gate is counted as an interaction.
+ */
+Bool InteractionGateClass::contains(const ir::compat::Gate &gate) {
+    if (gate.operands.size() != 2) {
+        return false;
+    }
+    if (instruction_names.empty()) {
+        return true;
+    }
+    auto it = cache.find(gate.name);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    // The names of custom gates may include the operands of specialized or
+    // templated instructions, like "cz q0,q1" or "cz %0,%1", after a space.
+    // The names of the default gates never do.
+    Str instruction_name = gate.name.substr(0, gate.name.find(' '));
+    Bool result = instruction_names.find(instruction_name) != instruction_names.end();
+    cache.set(gate.name) = result;
+    return result;
+}
+
+/**
+ * Computes the interaction matrix for the given kernel, counting only CNOT
+ * gates.
+ */
 InteractionMatrix::InteractionMatrix(
     const ir::compat::KernelRef &kernel
-) : size(kernel->qubit_count) {
-    matrix.resize(size, Vec<UInt>(size, 0));
-    for (auto ins : kernel->gates) {
-        Str insName = ins->qasm();
-        if (insName.find("cnot") != Str::npos) {
-            // for now the interaction matrix only for cnot
-            auto operands = ins->operands;
-            if (operands.size() == 2) {
-                UInt operand0 = operands[0];
-                UInt operand1 = operands[1];
-                matrix[operand0][operand1] += 1;
-                matrix[operand1][operand0] += 1;
-            }
+) {
+    InteractionGateClass gate_class;
+    build(kernel, gate_class);
+}
+
+/**
+ * Computes the interaction matrix for the given kernel, counting the gates
+ * in the given gate class. The cache of the gate class is updated, so it
+ * can be reused for other kernels.
+ */
+InteractionMatrix::InteractionMatrix(
+    const ir::compat::KernelRef &kernel,
+    InteractionGateClass &gate_class
+) {
+    build(kernel, gate_class);
+}
+
+/**
+ * Computes the matrix for the given kernel and gate class. Used by the
+ * constructors.
+ */
+void InteractionMatrix::build(
+    const ir::compat::KernelRef &kernel,
+    InteractionGateClass &gate_class
+) {
+    size = kernel->qubit_count;
+
+    // Collect the matrix coordinates of all counted gates in both halves of
+    // the matrix, encoded as row * size + column.
+    Vec<UInt> coordinates;
+    for (const auto &gate : kernel->gates) {
+        if (gate_class.contains(*gate)) {
+            UInt operand0 = gate->operands[0];
+            UInt operand1 = gate->operands[1];
+            QL_ASSERT(operand0 < size && operand1 < size);
+            coordinates.push_back(operand0 * size + operand1);
+            coordinates.push_back(operand1 * size + operand0);
+        }
+    }
+
+    // Sorting the coordinates puts them in CSR order, after which the counts
+    // are just the lengths of the runs of equal coordinates.
+    std::sort(coordinates.begin(), coordinates.end());
+    row_start.assign(size + 1, 0);
+    for (UInt i = 0; i < coordinates.size(); ) {
+        UInt j = i + 1;
+        while (j < coordinates.size() && coordinates[j] == coordinates[i]) {
+            j++;
         }
+        UInt row = coordinates[i] / size;
+        elements.push_back({coordinates[i] % size, j - i});
+        row_start[row + 1]++;
+        i = j;
     }
+    for (UInt row = 0; row < size; row++) {
+        row_start[row + 1] += row_start[row];
+    }
+
+}
+
+/**
+ * Computes the interaction matrices for all kernels of the given program
+ * in a single pass, sharing the gate classification between kernels.
+ */
+Vec<InteractionMatrix> InteractionMatrix::for_program(
+    const ir::compat::ProgramRef &program,
+    const Vec<Str> &instruction_names
+) {
+    InteractionGateClass gate_class(instruction_names);
+    Vec<InteractionMatrix> matrices;
+    matrices.reserve(program->kernels.size());
+    for (const auto &kernel : program->kernels) {
+        matrices.emplace_back(kernel, gate_class);
+    }
+    return matrices;
 }
 
 /**
- * Returns the embedded matrix.
+ * Returns the number of qubits, i.e. the number of rows and columns.
  */
-const InteractionMatrix::Matrix &InteractionMatrix::get_matrix() const {
+UInt InteractionMatrix::get_size() const {
+    return size;
+}
+
+/**
+ * Returns the number of nonzero elements, counting both halves of the
+ * matrix.
+ */
+UInt InteractionMatrix::get_num_elements() const {
+    return elements.size();
+}
+
+/**
+ * Returns the nonzero elements in the row for the given qubit, ordered by
+ * column. The pointers delimit a range within the internal storage.
+ */
+Pair<const InteractionMatrix::Element*, const InteractionMatrix::Element*> InteractionMatrix::get_row(
+    UInt qubit
+) const {
+    QL_ASSERT(qubit < size);
+    return {elements.data() + row_start[qubit], elements.data() + row_start[qubit + 1]};
+}
+
+/**
+ * Returns the number of counted gates between the given qubits.
+ */
+UInt InteractionMatrix::get_count(UInt qubit0, UInt qubit1) const {
+    auto row = get_row(qubit0);
+    auto it = std::lower_bound(
+        row.first, row.second, qubit1,
+        [](const Element &element, UInt qubit) {
+            return element.qubit < qubit;
+        }
+    );
+    if (it == row.second || it->qubit != qubit1) {
+        return 0;
+    }
+    return it->count;
+}
+
+/**
+ * Returns the matrix in dense form. Note that this needs memory quadratic
+ * in the number of qubits.
+ */
+InteractionMatrix::Matrix InteractionMatrix::get_matrix() const {
+    Matrix matrix(size, Vec<UInt>(size, 0));
+    for (UInt p = 0; p < size; p++) {
+        auto row = get_row(p);
+        for (auto it = row.first; it != row.second; ++it) {
+            matrix[p][it->qubit] = it->count;
+        }
+    }
     return matrix;
 }
 
 /**
- * Returns the matrix as a string.
+ * Writes the matrix in dense, human-readable form to the given stream.
  */
-Str InteractionMatrix::get_string() const {
-    StrStrm ss;
+void InteractionMatrix::dump(std::ostream &os) const {
 
     // Use the following for properly aligned matrix print for visual inspection
     // This can be problematic of width not set properly to be processed by gnuplot script
@@ -54,21 +202,53 @@ Str InteractionMatrix::get_string() const {
     // generate the columns properly for further processing by other tools
     // #define ALIGNMENT ("    ")
 
-    ss << ALIGNMENT << " ";
+    os << ALIGNMENT << " ";
     for (UInt c = 0; c < size; c++) {
-        ss << ALIGNMENT << "q" + to_string(c);
+        os << ALIGNMENT << "q" + to_string(c);
     }
-    ss << std::endl;
+    os << "\n";
 
     for (UInt p = 0; p < size; p++) {
-        ss << ALIGNMENT << "q" + to_string(p);
+        os << ALIGNMENT << "q" + to_string(p);
+        auto row = get_row(p);
+        auto it = row.first;
         for (UInt c = 0; c < size; c++) {
-            ss << ALIGNMENT << matrix[p][c];
+            if (it != row.second && it->qubit == c) {
+                os << ALIGNMENT << it->count;
+                ++it;
+            } else {
+                os << ALIGNMENT << 0;
+            }
         }
-        ss << std::endl;
+        os << "\n";
     }
 #undef ALIGNMENT
 
+}
+
+/**
+ * Writes the nonzero elements of the upper half of the matrix to the given
+ * stream as CSV, one line with qubit0, qubit1, and the count per qubit
+ * pair, preceded by a header line.
+ */
+void InteractionMatrix::dump_csv(std::ostream &os) const {
+    os << "qubit0,qubit1,count\n";
+    for (UInt p = 0; p < size; p++) {
+        auto row = get_row(p);
+        for (auto it = row.first; it != row.second; ++it) {
+            if (it->qubit >= p) {
+                os << p << "," << it->qubit << "," << it->count << "\n";
+            }
+        }
+    }
+}
+
+/**
+ * Returns the matrix as a string, in the format of dump().
+ */
+Str InteractionMatrix::get_string() const {
+    StrStrm ss;
+    dump(ss);
     return ss.str();
 }
 
@@ -80,29 +260,38 @@ void InteractionMatrix::dump_for_program(
     const ir::compat::ProgramRef &program,
     std::ostream &os
 ) {
-    for (const auto &k : program->kernels) {
-        InteractionMatrix imat(k);
-        utils::Str mstr = imat.get_string();
-        os << mstr << std::endl;
+    for (const auto &imat : for_program(program)) {
+        imat.dump(os);
+        os << std::endl;
     }
 }
 
 /**
  * Same as dump_for_program(), but writes the result to files in the
  * current globally-configured output directory, using the names
- * "<kernel>InteractionMatrix.dat".
+ * "<prefix><kernel>InteractionMatrix.dat". If csv is set, the sparse CSV
+ * format of dump_csv() is written instead, to files named
+ * "<prefix><kernel>InteractionMatrix.csv". instruction_names selects the
+ * counted gates, as for InteractionGateClass.
  */
 void InteractionMatrix::write_for_program(
     const utils::Str &output_prefix,
-    const ir::compat::ProgramRef &program
+    const ir::compat::ProgramRef &program,
+    utils::Bool csv,
+    const utils::Vec<utils::Str> &instruction_names
 ) {
-    for (const auto &k : program->kernels) {
-        ql::com::ana::InteractionMatrix imat(k);
-        utils::Str mstr = imat.get_string();
-
-        utils::Str fname = output_prefix + "/" + k->get_name() + "InteractionMatrix.dat";
+    auto matrices = for_program(program, instruction_names);
+    for (UInt i = 0; i < matrices.size(); i++) {
+        utils::Str fname = output_prefix + "/" + program->kernels[i]->get_name()
+                         + "InteractionMatrix" + (csv ? ".csv" : ".dat");
         QL_IOUT("writing interaction matrix to '" << fname << "' ...");
-        utils::OutFile(fname).write(mstr);
+        utils::OutFile file(fname);
+        if (csv) {
+            matrices[i].dump_csv(file.unwrap());
+        } else {
+            matrices[i].dump(file.unwrap());
+        }
+        file.close();
     }
 }
 
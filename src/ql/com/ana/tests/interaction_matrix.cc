@@ -0,0 +1,67 @@
+#include "ql/utils/str.h"
+#include "ql/ir/compat/compat.h"
+#include "ql/com/ana/interaction_matrix.h"
+
+using namespace ql;
+using namespace ql::utils;
+using namespace ql::com::ana;
+
+int main() {
+    auto plat = ir::compat::Platform::build("test_plat", Str("none"));
+    auto program = make<ir::compat::Program>("test_prog", plat, 10, 32, 10);
+
+    auto kernel = make<ir::compat::Kernel>("first", plat, 10, 32, 10);
+    kernel->cnot(0, 2);
+    kernel->cnot(2, 0);
+    kernel->cnot(1, 6);
+    kernel->cz(3, 4);
+    kernel->x(5);
+    program->add(kernel);
+
+    kernel = make<ir::compat::Kernel>("second", plat, 10, 32, 10);
+    kernel->cz(3, 4);
+    kernel->cz(4, 3);
+    program->add(kernel);
+
+    // By default, only CNOTs are counted, ignoring operand order.
+    auto matrices = InteractionMatrix::for_program(program);
+    QL_ASSERT_EQ(matrices.size(), 2);
+    QL_ASSERT_EQ(matrices[0].get_size(), 10);
+    QL_ASSERT_EQ(matrices[0].get_num_elements(), 4);
+    QL_ASSERT_EQ(matrices[0].get_count(0, 2), 2);
+    QL_ASSERT_EQ(matrices[0].get_count(2, 0), 2);
+    QL_ASSERT_EQ(matrices[0].get_count(6, 1), 1);
+    QL_ASSERT_EQ(matrices[0].get_count(3, 4), 0);
+    QL_ASSERT_EQ(matrices[1].get_num_elements(), 0);
+
+    // The dense matrix and the text output agree with the sparse form.
+    auto dense = matrices[0].get_matrix();
+    for (UInt q0 = 0; q0 < 10; q0++) {
+        for (UInt q1 = 0; q1 < 10; q1++) {
+            QL_ASSERT_EQ(dense[q0][q1], matrices[0].get_count(q0, q1));
+        }
+    }
+    QL_ASSERT_EQ(InteractionMatrix(program->kernels[0]).get_string(), matrices[0].get_string());
+
+    // With an empty gate class, all two-qubit gates are counted.
+    matrices = InteractionMatrix::for_program(program, {});
+    QL_ASSERT_EQ(matrices[0].get_count(4, 3), 1);
+    QL_ASSERT_EQ(matrices[1].get_count(3, 4), 2);
+
+    // Gates are classified by instruction, ignoring the operands in the names
+    // of specialized instructions.
+    InteractionGateClass gate_class({"cz"});
+    ir::compat::gate_types::Custom specialized("cz q3,q4");
+    specialized.operands = {3, 4};
+    QL_ASSERT(gate_class.contains(specialized));
+    ir::compat::gate_types::Custom other("cz_park");
+    other.operands = {3, 4};
+    QL_ASSERT(!gate_class.contains(other));
+
+    // The CSV output only lists the upper half of the matrix.
+    StrStrm ss;
+    matrices[0].dump_csv(ss);
+    QL_ASSERT_EQ(ss.str(), "qubit0,qubit1,count\n0,2,2\n1,6,1\n3,4,1\n");
+
+    return 0;
+}
@@ -5,6 +5,8 @@
 
 #include "ql/com/ddg/build.h"
 
+#include <algorithm>
+
 #include "ql/ir/ops.h"
 #include "ql/ir/describe.h"
 #include "ql/com/ddg/ops.h"
@@ -265,6 +267,14 @@ private:
          */
         ir::StatementRef statement;
 
+        /**
+         * The position of this pair in the commuting or non-commuting list
+         * that it currently belongs to. Pairs are only ever appended to these
+         * lists, so this is just the value of position_accumulator at the time
+         * the pair was appended.
+         */
+        utils::UInt position = 0;
+
         /**
          * Returns whether this event commutes with the given event. Also
          * returns true when the events are caused by the same node.
@@ -289,32 +299,182 @@ private:
     using EventNodePairs = utils::List<EventNodePair>;
 
     /**
-     * List of events/nodes that commute with each other. That is, all events
-     * in this list commute with all other events in this list. Incoming events
-     * will always be pushed into this set, evicting any entries that don't
-     * commute with the incoming event to the non_commuting list. Whenever an
-     * event is evicted from commuting to non_commuting, any entries previously
-     * in non_commuting that operate on the same object or a subset thereof that
-     * don't commute with the evicted event are pruned, to avoid redundant edges
-     * in the DDG as much as possible.
+     * The part of the commuting and non_commuting lists described below that
+     * operates on a single bucket of objects.
+     *
+     * commuting is the list of events/nodes that commute with each other.
+     * That is, all events in this list commute with all other events in this
+     * list. Incoming events will always be pushed into this set, evicting any
+     * entries that don't commute with the incoming event to the non_commuting
+     * list. Whenever an event is evicted from commuting to non_commuting, any
+     * entries previously in non_commuting that operate on the same object or a
+     * subset thereof that don't commute with the evicted event are pruned, to
+     * avoid redundant edges in the DDG as much as possible.
+     *
+     * non_commuting is the list of events and associated DDG nodes in the
+     * past, that can't possibly commute with any future events anymore. When a
+     * new event is pushed into the commuting list, a data dependency must be
+     * added between all events in this list that may (partially) operate on
+     * the same object, regardless of whether the incoming event would commute
+     * with that event (because something in commuting is already preventing
+     * this).
+     *
+     * Both lists are split up into buckets by the object (and major index)
+     * that the events refer to, such that an incoming event only needs to look
+     * at the events that may refer to the same object. The order of the
+     * complete lists is recovered where needed using the position field of
+     * the event-node pairs.
+     */
+    struct Bucket {
+
+        /**
+         * The events/nodes in this bucket that are in the commuting list.
+         */
+        EventNodePairs commuting;
+
+        /**
+         * The events/nodes in this bucket that are in the non_commuting list.
+         */
+        EventNodePairs non_commuting;
+
+    };
+
+    /**
+     * The buckets for a single object, as accessed via a single data type.
+     */
+    struct ObjectBuckets {
+
+        /**
+         * Buckets for references to the object of which the major index is
+         * statically known, mapped by that index.
+         */
+        utils::Map<utils::UInt, Bucket> elements;
+
+        /**
+         * Bucket for references to the object of which the major index is not
+         * statically known, including references to scalar objects.
+         */
+        Bucket whole;
+
+    };
+
+    /**
+     * Bucket for events that refer to the global state.
      */
-    EventNodePairs commuting;
+    Bucket global;
 
     /**
-     * List of events and associated DDG nodes in the past, that can't possibly
-     * commute with any future events anymore. When a new event is pushed into
-     * the commuting list, a data dependency must be added between all events
-     * in this list that may (partially) operate on the same object, regardless
-     * of whether the incoming event would commute with that event (because
-     * something in commuting is already preventing this).
+     * Buckets for events that refer to a particular object. The key is a
+     * reference to the object without indices.
      */
-    EventNodePairs non_commuting;
+    utils::Map<Reference, ObjectBuckets> objects;
+
+    /**
+     * A candidate event-node pair found in a bucket.
+     */
+    struct Candidate {
+
+        /**
+         * The bucket that the event-node pair belongs to.
+         */
+        Bucket *bucket;
+
+        /**
+         * Iterator to the event-node pair within the list it belongs to.
+         */
+        EventNodePairs::Iter it;
+
+        /**
+         * Orders candidates by their position in the complete list.
+         */
+        utils::Bool operator<(const Candidate &rhs) const {
+            return it->position < rhs.it->position;
+        }
+
+    };
+
+    /**
+     * Accumulator for the position field of event-node pairs.
+     */
+    utils::UInt position_accumulator;
+
+    /**
+     * The total number of event-node pairs in the commuting list.
+     */
+    utils::UInt num_commuting;
+
+    /**
+     * The total number of event-node pairs in the non_commuting list.
+     */
+    utils::UInt num_non_commuting;
 
     /**
      * Accumulator for the order field of the DDG nodes.
      */
     utils::Int order_accumulator;
 
+    /**
+     * Returns the bucket that events with the given reference belong to,
+     * creating it if it doesn't exist yet.
+     */
+    Bucket &get_bucket(const Reference &reference) {
+        if (reference.is_global_state()) {
+            return global;
+        }
+        Reference object = reference;
+        object.indices.clear();
+        auto &object_buckets = objects.set(object);
+        if (reference.indices.empty()) {
+            return object_buckets.whole;
+        }
+        return object_buckets.elements.set(reference.indices[0]);
+    }
+
+    /**
+     * Returns all buckets that may contain events with references that are not
+     * provably distinct from the given reference, including the global bucket.
+     */
+    utils::Vec<Bucket*> get_overlapping_buckets(const Reference &reference) {
+        utils::Vec<Bucket*> buckets;
+        buckets.push_back(&global);
+
+        // The global state overlaps with everything.
+        if (reference.is_global_state()) {
+            for (auto &it : objects) {
+                buckets.push_back(&it.second.whole);
+                for (auto &it2 : it.second.elements) {
+                    buckets.push_back(&it2.second);
+                }
+            }
+            return buckets;
+        }
+
+        // References to different objects or via different data types are
+        // always provably distinct.
+        Reference object = reference;
+        object.indices.clear();
+        auto it = objects.find(object);
+        if (it == objects.end()) {
+            return buckets;
+        }
+
+        // References without a statically known major index overlap with all
+        // elements of the object. Otherwise, only references with the same
+        // major index or without a known major index may overlap.
+        buckets.push_back(&it->second.whole);
+        if (reference.indices.empty()) {
+            for (auto &it2 : it->second.elements) {
+                buckets.push_back(&it2.second);
+            }
+        } else {
+            auto it2 = it->second.elements.find(reference.indices[0]);
+            if (it2 != it->second.elements.end()) {
+                buckets.push_back(&it2->second);
+            }
+        }
+        return buckets;
+    }
+
     /**
      * Adds a data dependency edge between the nodes of the given two event-node
      * pairs, using the duration of the "from" statement as weight.
@@ -362,10 +522,9 @@ private:
     /**
      * Evicts an event-node pair from the commuting list into the non_commuting
      * list, and prunes the non_commuting list accordingly. it must be an
-     * iterator of the commuting list. It is advanced to the next event-node
-     * pair after eviction.
+     * iterator of the commuting list of the given bucket.
      */
-    void evict_from_commuting(EventNodePairs::Iter &it) {
+    void evict_from_commuting(Bucket &bucket, EventNodePairs::Iter it) {
         QL_DOUT("    evict: " << it->event << " for " << ir::describe(it->statement));
 
         // Remove any event-node pairs in non_commuting of which the event is
@@ -374,19 +533,28 @@ private:
         // between them. Because anything that would get an edge from *nc_it
         // would also get an edge to *it in this case, and because dependency
         // relations are transitive, we can safely forget about nc_it, and thus
-        // optimize the graph and the generation thereof.
-        auto nc_it = non_commuting.begin();
-        while (nc_it != non_commuting.end()) {
-            if (nc_it->event.is_shadowed_by(it->event)) {
-                nc_it = non_commuting.erase(nc_it);
-            } else {
-                ++nc_it;
+        // optimize the graph and the generation thereof. Shadowed events
+        // necessarily overlap with the evicted event, so only the overlapping
+        // buckets need to be considered.
+        for (auto nc_bucket : get_overlapping_buckets(it->event.reference)) {
+            auto &non_commuting = nc_bucket->non_commuting;
+            auto nc_it = non_commuting.begin();
+            while (nc_it != non_commuting.end()) {
+                if (nc_it->event.is_shadowed_by(it->event)) {
+                    nc_it = non_commuting.erase(nc_it);
+                    num_non_commuting--;
+                } else {
+                    ++nc_it;
+                }
             }
         }
 
         // Move the event-node pair from commuting to non_commuting.
-        non_commuting.push_back(*it);
-        it = commuting.erase(it);
+        it->position = position_accumulator++;
+        bucket.non_commuting.push_back(*it);
+        bucket.commuting.erase(it);
+        num_commuting--;
+        num_non_commuting++;
 
     }
 
@@ -397,43 +565,59 @@ private:
     void process_event(const EventNodePair &incoming) {
         QL_DOUT("  process event: " << incoming.event << " for " << ir::describe(incoming.statement));
 
+        // Only events that are not provably distinct from the incoming event
+        // can be affected by it, so we only need to look at the overlapping
+        // buckets.
+        auto buckets = get_overlapping_buckets(incoming.event.reference);
+
         // Evict any event-node pairs that don't commute with the incoming pair
-        // from the commuting list.
-        auto it = commuting.begin();
-        while (it != commuting.end()) {
-            if (!it->commutes_with(incoming)) {
-                evict_from_commuting(it);
-            } else {
-                ++it;
+        // from the commuting list. This must be done in list order, because
+        // evicting a pair may prune pairs evicted before it.
+        utils::Vec<Candidate> candidates;
+        for (auto bucket : buckets) {
+            for (auto it = bucket->commuting.begin(); it != bucket->commuting.end(); ++it) {
+                if (!it->commutes_with(incoming)) {
+                    candidates.push_back({bucket, it});
+                }
             }
         }
+        std::sort(candidates.begin(), candidates.end());
+        for (const auto &candidate : candidates) {
+            evict_from_commuting(*candidate.bucket, candidate.it);
+        }
 
         // Add DDG edges from nodes in non_commuting that hit the same object as
-        // incoming to the node corresponding to incoming. As a special case,
-        // don't make edges to global state writes if we find any other node we
-        // need an edge with, because said node necessarily will already have an
-        // edge to this global state write.
-        utils::Bool any_edge = false;
-        utils::List<std::reference_wrapper<const EventNodePair>> global_write;
-        for (const auto &nc : non_commuting) {
-            if (nc.event.reference.is_global_state()) {
-                global_write.push_back(nc);
+        // incoming to the node corresponding to incoming, in list order. As a
+        // special case, don't make edges to global state writes if we find any
+        // other node we need an edge with, because said node necessarily will
+        // already have an edge to this global state write.
+        candidates.clear();
+        for (auto bucket : buckets) {
+            if (bucket == &global) {
                 continue;
             }
-            if (!nc.event.reference.is_provably_distinct_from(incoming.event.reference)) {
-                add_edge(nc, incoming);
-                any_edge = true;
+            for (auto it = bucket->non_commuting.begin(); it != bucket->non_commuting.end(); ++it) {
+                if (!it->event.reference.is_provably_distinct_from(incoming.event.reference)) {
+                    candidates.push_back({bucket, it});
+                }
             }
         }
-        if (!any_edge) {
-            for (const auto &nc : global_write) {
-                QL_ASSERT(!nc.get().commutes_with(incoming));
+        std::sort(candidates.begin(), candidates.end());
+        for (const auto &candidate : candidates) {
+            add_edge(*candidate.it, incoming);
+        }
+        if (candidates.empty()) {
+            for (const auto &nc : global.non_commuting) {
+                QL_ASSERT(!nc.commutes_with(incoming));
                 add_edge(nc, incoming);
             }
         }
 
         // Add the incoming pair to the commuting list.
-        commuting.push_back(incoming);
+        auto &bucket = get_bucket(incoming.event.reference);
+        bucket.commuting.push_back(incoming);
+        bucket.commuting.back().position = position_accumulator++;
+        num_commuting++;
 
     }
 
@@ -442,8 +626,8 @@ private:
      */
     void process_statement(const ir::StatementRef &statement) {
         QL_DOUT("process statement: " << ir::describe(statement));
-        QL_DOUT("  currently " << commuting.size() << " commuting entries");
-        QL_DOUT("  currently " << non_commuting.size() << " non-commuting entries");
+        QL_DOUT("  currently " << num_commuting << " commuting entries");
+        QL_DOUT("  currently " << num_non_commuting << " non-commuting entries");
 
         // Make a node for the statement and add it.
         NodeRef node;
@@ -488,6 +672,9 @@ public:
         ir(ir),
         block(block),
         gatherer(ir),
+        position_accumulator(0),
+        num_commuting(0),
+        num_non_commuting(0),
         order_accumulator(0)
     {
         gatherer.disable_multi_qubit_commutation = !commute_multi_qubit;
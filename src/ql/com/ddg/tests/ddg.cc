@@ -1,5 +1,6 @@
 #include "ql/ir/compat/compat.h"
 #include "ql/ir/old_to_new.h"
+#include "ql/ir/ops.h"
 #include "ql/com/ddg/build.h"
 #include "ql/com/ddg/ops.h"
 #include "ql/com/ddg/consistency.h"
@@ -7,6 +8,14 @@
 
 using namespace ql;
 
+/**
+ * Returns whether there is a DDG edge between the given statements of the
+ * given block.
+ */
+static utils::Bool has_edge(const ir::BlockBaseRef &block, utils::UInt from, utils::UInt to) {
+    return !com::ddg::get_edge(block->statements[from], block->statements[to]).empty();
+}
+
 int main() {
     auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
     auto program = utils::make<ir::compat::Program>("test_prog", plat, 7, 32, 10);
@@ -26,14 +35,77 @@ int main() {
     kernel->z(0);
     program->add(kernel);
 
+    auto wide_kernel = utils::make<ir::compat::Kernel>("wide_kernel", plat, 7, 32, 10);
+    for (utils::UInt layer = 0; layer < 3; layer++) {
+        for (utils::UInt q = 0; q < 7; q++) {
+            wide_kernel->hadamard(q);
+        }
+        for (utils::UInt q = layer % 2; q + 1 < 7; q += 2) {
+            wide_kernel->cz(q, q + 1);
+        }
+    }
+    wide_kernel->wait({1, 2, 3}, 0);
+    for (utils::UInt q = 0; q < 7; q++) {
+        wide_kernel->measure(q);
+    }
+    program->add(wide_kernel);
+
     auto ir = ir::convert_old_to_new(program);
 
-    com::ddg::build(ir, ir->program->blocks[0]);
-    com::ddg::check_consistency(ir->program->blocks[0]);
-    com::ddg::dump_dot(ir->program->blocks[0]);
+    // Static references to an element of the qubit register, and to the
+    // register as a whole.
+    com::ddg::Reference q0 = ir::make_qubit_ref(ir, 0);
+    com::ddg::Reference q1 = ir::make_qubit_ref(ir, 1);
+    com::ddg::Reference qs = ir::make_reference(ir, ir->platform->qubits);
+    QL_ASSERT(q0.is_provably_distinct_from(q1));
+    QL_ASSERT(!q0.is_provably_distinct_from(q0));
+    QL_ASSERT(!q0.is_provably_distinct_from(qs));
+    QL_ASSERT(!qs.is_provably_distinct_from(q0));
+    QL_ASSERT(!qs.is_provably_distinct_from(com::ddg::Reference()));
+
+    // x, y, and z gates commute with themselves but not with each other, so
+    // each pair depends on both gates of the preceding pair and nothing
+    // earlier.
+    const auto &block = ir->program->blocks[0];
+    com::ddg::build(ir, block);
+    QL_ASSERT(block->statements.size() == 12);
+    for (utils::UInt pair = 0; pair < 6; pair++) {
+        QL_ASSERT(!has_edge(block, 2 * pair, 2 * pair + 1));
+        if (pair == 0) continue;
+        for (utils::UInt from = 2 * pair - 2; from < 2 * pair; from++) {
+            QL_ASSERT(has_edge(block, from, 2 * pair));
+            QL_ASSERT(has_edge(block, from, 2 * pair + 1));
+        }
+        if (pair == 1) continue;
+        QL_ASSERT(!has_edge(block, 2 * pair - 4, 2 * pair));
+    }
+    com::ddg::check_consistency(block);
+    com::ddg::dump_dot(block);
     com::ddg::reverse(ir->program->blocks[0]);
     com::ddg::check_consistency(ir->program->blocks[0]);
     com::ddg::dump_dot(ir->program->blocks[0]);
 
+    // In the wide block, statements 0-6 are the first layer of Hadamards and
+    // 7-9 the CZs on (0, 1), (2, 3), and (4, 5), followed by the second layer
+    // of Hadamards at 10-16 and CZs on (1, 2), (3, 4), and (5, 6) at 17-19.
+    // Only gates on common qubits may depend on each other, and dependencies
+    // that are implied by others are pruned.
+    const auto &wide_block = ir->program->blocks[1];
+    com::ddg::build(ir, wide_block);
+    QL_ASSERT(has_edge(wide_block, 0, 7));
+    QL_ASSERT(has_edge(wide_block, 1, 7));
+    QL_ASSERT(!has_edge(wide_block, 2, 7));
+    QL_ASSERT(has_edge(wide_block, 2, 8));
+    QL_ASSERT(has_edge(wide_block, 7, 10));
+    QL_ASSERT(has_edge(wide_block, 7, 11));
+    QL_ASSERT(!has_edge(wide_block, 7, 12));
+    QL_ASSERT(has_edge(wide_block, 11, 17));
+    QL_ASSERT(has_edge(wide_block, 12, 17));
+    QL_ASSERT(!has_edge(wide_block, 7, 17));
+    QL_ASSERT(!has_edge(wide_block, 8, 17));
+    QL_ASSERT(has_edge(wide_block, 6, 16));
+    com::ddg::check_consistency(wide_block);
+    com::ddg::dump_dot(wide_block);
+
     return 0;
 }
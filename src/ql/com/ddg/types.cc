@@ -137,8 +137,9 @@ utils::Bool Reference::is_provably_distinct_from(const Reference &reference) con
     // non-scalar, they may still be referring to provably different elements of
     // that object. You can do all sorts of fancy aliasing stuff here, but for
     // now we'll only worry about static indices for as far as they are known.
-    // If they differ, the targets are distinct.
-    utils::UInt known_dims = utils::max(indices.size(), reference.indices.size());
+    // If they differ, the targets are distinct. Indices that are only known
+    // for one of the two references can't prove anything.
+    utils::UInt known_dims = utils::min(indices.size(), reference.indices.size());
     for (utils::UInt dim = 0; dim < known_dims; dim++) {
         if (indices[dim] != reference.indices[dim]) {
             return true;
@@ -6,6 +6,7 @@
 
 #include "ql/utils/exception.h"
 #include "ql/utils/logger.h"
+#include "ql/com/options.h"
 
 #ifndef WITHOUT_UNITARY_DECOMPOSITION
 #include <Eigen/MatrixFunctions>
@@ -16,6 +17,17 @@
 #endif
 
 #include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <list>
+#include <mutex>
+#include <thread>
+#include "ql/utils/map.h"
+#include "ql/utils/filesystem.h"
+#include "ql/utils/thread_pool.h"
 
 namespace ql {
 namespace com {
@@ -46,10 +58,9 @@ UInt Unitary::size() const {
 #ifdef WITHOUT_UNITARY_DECOMPOSITION
 
 /**
- * Explicitly runs the matrix decomposition algorithm. Used to be required,
- * nowadays is called implicitly by get_decomposition() if not done explicitly.
+ * Runs the matrix decomposition algorithm, returning the instruction list.
  */
-void Unitary::decompose() {
+static Vec<Real> decompose_matrix(const Str &, const Vec<Complex> &) {
     throw Exception("unitary decomposition was explicitly disabled in this build!");
 }
 
@@ -63,6 +74,34 @@ Bool Unitary::is_decompose_support_enabled() {
 
 #else
 
+/**
+ * Returns the thread pool used for unitary decomposition with the given number
+ * of threads (0 meaning the number of hardware threads), or nullptr if this
+ * results in a single thread. The pools are created on first use and then
+ * shared by all decompositions in the process, so the worker threads are not
+ * started and joined again for every unitary. They are deliberately never
+ * destroyed, as joining threads during static destruction can deadlock on
+ * some platforms; the idle workers are simply terminated with the process.
+ */
+static ThreadPool *get_decomposition_pool(UInt num_threads) {
+    static std::mutex mutex;
+    static Map<UInt, ThreadPool*> pools;
+    if (num_threads == 1) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = pools.find(num_threads);
+    if (it == pools.end()) {
+        auto pool = new ThreadPool(num_threads);
+        if (pool->get_num_threads() == 1) {
+            delete pool;
+            pool = nullptr;
+        }
+        it = pools.insert({num_threads, pool}).first;
+    }
+    return it->second;
+}
+
 // JvS: this was originally the class "unitary" itself, but compile times of
 // Eigen are so excessive that I moved it into its own compile unit and
 // provided a wrapper instead. It doesn't actually NEED to be wrapped like
@@ -78,23 +117,34 @@ public:
     Vec<Complex> array;
     Vec<Complex> SU;
     Real delta;
-    Real alpha;
-    Real beta;
-    Real gamma;
     Bool decomposed;
     Vec<Real> instruction_list;
 
+    // when set, the multiplexed rotation angles are also computed with a dense least-squares solver and compared
+    Bool verify;
+
+    // worker threads for decomposing independent sub-unitaries concurrently, shared between decompositions, or
+    // nullptr for serial decomposition
+    ThreadPool *pool;
+
+    // sub-unitaries with fewer qubits than this are always decomposed serially, as they're not worth a task
+    static const Int MIN_PARALLEL_BITS = 3;
+
     typedef Eigen::Matrix<Complex, Eigen::Dynamic, Eigen::Dynamic> complex_matrix;
 
-    UnitaryDecomposer() : name(""), decomposed(false) {}
+    UnitaryDecomposer() : name(""), decomposed(false), verify(false), pool(nullptr) {}
 
     UnitaryDecomposer(
         const Str &name,
-        const Vec<Complex> &array
+        const Vec<Complex> &array,
+        Bool verify = false,
+        UInt num_threads = 1
     ) :
         name(name),
         array(array),
-        decomposed(false)
+        decomposed(false),
+        verify(verify),
+        pool(get_decomposition_pool(num_threads))
     {
         QL_DOUT("constructing unitary: " << name
                   << ", containing: " << array.size() << " elements");
@@ -136,10 +186,12 @@ public:
 
             throw utils::Exception("Error: Unitary '"+ name+"' is not a unitary matrix. Cannot be decomposed!" + to_string(matmatadjoint));
         }
-        // initialize the general M^k lookuptable
-        genMk();
+        // initialize the general M^k lookuptable, only needed to verify the fast solver
+        if (verify) {
+            genMk();
+        }
 
-        decomp_function(_matrix, numberofbits); //needed because the matrix is read in columnmajor
+        decomp_function(_matrix, numberofbits, instruction_list); //needed because the matrix is read in columnmajor
 
         QL_DOUT("Done decomposing");
         decomposed = true;
@@ -162,10 +214,24 @@ public:
     // std::chrono::duration<Real> multiplexing_time;
     // std::chrono::duration<Real> demultiplexing_time;
 
-    void decomp_function(const Eigen::Ref<const complex_matrix>& matrix, Int numberofbits) {
+    // calls fn(i) for i in [0, count), for independent sub-unitaries of numberofbits qubits each. These run
+    // concurrently when a thread pool is available and they are big enough. fn must only write to state private to i.
+    void forEachSubproblem(UInt count, Int numberofbits, const std::function<void(UInt)> &fn) {
+        if (pool && numberofbits >= MIN_PARALLEL_BITS) {
+            pool->parallel_for(count, fn);
+        } else {
+            for (UInt i = 0; i < count; i++) {
+                fn(i);
+            }
+        }
+    }
+
+    // appends the decomposition of matrix to insns. Sub-unitaries are decomposed into lists of their own that are
+    // appended in a fixed order, so the result does not depend on whether they were decomposed concurrently.
+    void decomp_function(const Eigen::Ref<const complex_matrix>& matrix, Int numberofbits, Vec<Real> &insns) {
         QL_DOUT("decomp_function: \n" << to_string(matrix));
         if(numberofbits == 1) {
-            zyz_decomp(matrix);
+            zyz_decomp(matrix, insns);
         } else {
             Int n = matrix.rows()/2;
 
@@ -175,17 +241,22 @@ public:
             // if q2 is zero, the whole thing is a demultiplexing problem instead of full CSD
             if (matrix.bottomLeftCorner(n,n).isZero(10e-14) && matrix.topRightCorner(n,n).isZero(10e-14)) {
                 QL_DOUT("Optimization: q2 is zero, only demultiplexing will be performed.");
-                instruction_list.push_back(200.0);
+                insns.push_back(200.0);
                 if (matrix.topLeftCorner(n, n).isApprox(matrix.bottomRightCorner(n,n),10e-4)) {
                     QL_DOUT("Optimization: Unitaries are equal, skip one step in the recursion for unitaries of size: " << n << " They are both: " << matrix.topLeftCorner(n, n));
-                    instruction_list.push_back(300.0);
-                    decomp_function(matrix.topLeftCorner(n, n), numberofbits-1);
+                    insns.push_back(300.0);
+                    decomp_function(matrix.topLeftCorner(n, n), numberofbits-1, insns);
                 } else {
                     demultiplexing(matrix.topLeftCorner(n, n), matrix.bottomRightCorner(n,n), V, D, W, numberofbits-1);
 
-                    decomp_function(W, numberofbits-1);
-                    multicontrolledZ(D, D.rows());
-                    decomp_function(V, numberofbits-1);
+                    const complex_matrix *subs[2] = {&W, &V};
+                    Vec<Real> parts[2];
+                    forEachSubproblem(2, numberofbits-1, [&](UInt i) {
+                        decomp_function(*subs[i], numberofbits-1, parts[i]);
+                    });
+                    insns.insert(insns.end(), parts[0].begin(), parts[0].end());
+                    multicontrolledZ(D, D.rows(), insns);
+                    insns.insert(insns.end(), parts[1].begin(), parts[1].end());
                 }
             } else if (
                 // Check to see if it the kronecker product of a bigger matrix and the identity matrix.
@@ -198,8 +269,8 @@ public:
             ) {
                 QL_DOUT("Optimization: last qubit is not affected, skip one step in the recursion.");
                 // Code for last qubit not affected
-                instruction_list.push_back(100.0);
-                decomp_function(matrix(Eigen::seqN(0, n, 2), Eigen::seqN(0, n, 2)), numberofbits-1);
+                insns.push_back(100.0);
+                decomp_function(matrix(Eigen::seqN(0, n, 2), Eigen::seqN(0, n, 2)), numberofbits-1, insns);
             } else {
                 complex_matrix ss(n,n);
                 complex_matrix L0(n,n);
@@ -209,17 +280,34 @@ public:
                 // auto start = std::chrono::steady_clock::now();
                 CSD(matrix, L0, L1, R0, R1, ss);
                 // CSD_time += (std::chrono::steady_clock::now() - start);
-                demultiplexing(R0, R1, V, D, W, numberofbits-1);
-                decomp_function(W, numberofbits-1);
-                multicontrolledZ(D, D.rows());
-                decomp_function(V, numberofbits-1);
 
-                multicontrolledY(ss.diagonal(), n);
-
-                demultiplexing(L0, L1, V, D, W, numberofbits-1);
-                decomp_function(W, numberofbits-1);
-                multicontrolledZ(D, D.rows());
-                decomp_function(V, numberofbits-1);
+                // demultiplex R0/R1 into V, D, W and L0/L1 into V2, D2, W2
+                complex_matrix V2(n,n);
+                complex_matrix W2(n,n);
+                Eigen::VectorXcd D2(n);
+                forEachSubproblem(2, numberofbits-1, [&](UInt i) {
+                    if (i == 0) {
+                        demultiplexing(R0, R1, V, D, W, numberofbits-1);
+                    } else {
+                        demultiplexing(L0, L1, V2, D2, W2, numberofbits-1);
+                    }
+                });
+
+                const complex_matrix *subs[4] = {&W, &V, &W2, &V2};
+                Vec<Real> parts[4];
+                forEachSubproblem(4, numberofbits-1, [&](UInt i) {
+                    decomp_function(*subs[i], numberofbits-1, parts[i]);
+                });
+
+                insns.insert(insns.end(), parts[0].begin(), parts[0].end());
+                multicontrolledZ(D, D.rows(), insns);
+                insns.insert(insns.end(), parts[1].begin(), parts[1].end());
+
+                multicontrolledY(ss.diagonal(), n, insns);
+
+                insns.insert(insns.end(), parts[2].begin(), parts[2].end());
+                multicontrolledZ(D2, D2.rows(), insns);
+                insns.insert(insns.end(), parts[3].begin(), parts[3].end());
             }
         }
     }
@@ -359,7 +447,7 @@ public:
 
     }
 
-    void zyz_decomp(const Eigen::Ref<const complex_matrix> &matrix) {
+    void zyz_decomp(const Eigen::Ref<const complex_matrix> &matrix, Vec<Real> &insns) {
         // auto start = std::chrono::steady_clock::now();
 
         Complex det = matrix.determinant();// matrix(0,0)*matrix(1,1)-matrix(1,0)*matrix(0,1);
@@ -381,12 +469,12 @@ public:
 
         Real t1 = atan2(A.imag(),A.real());
         Real t2 = atan2(B.imag(), B.real());
-        alpha = t1+t2;
-        gamma = t1-t2;
-        beta = 2*atan2(sw*sqrt(pow((Real) wx,2)+pow((Real) wy,2)),sqrt(pow((Real) A.real(),2)+pow((wz*sw),2)));
-        instruction_list.push_back(-gamma);
-        instruction_list.push_back(-beta);
-        instruction_list.push_back(-alpha);
+        Real alpha = t1+t2;
+        Real gamma = t1-t2;
+        Real beta = 2*atan2(sw*sqrt(pow((Real) wx,2)+pow((Real) wy,2)),sqrt(pow((Real) A.real(),2)+pow((wz*sw),2)));
+        insns.push_back(-gamma);
+        insns.push_back(-beta);
+        insns.push_back(-alpha);
         // zyz_time += (std::chrono::steady_clock::now() - start);
     }
 
@@ -461,6 +549,58 @@ public:
         // return genMk_lookuptable[numberqubits-1];
     }
 
+    // in-place fast Walsh-Hadamard transform, i.e. v = H*v with H(i,j) = (-1)^(b_i*b_j), in O(N log N)
+    static void fwht(Eigen::Ref<Eigen::VectorXd> v) {
+        Int size = v.rows();
+        for (Int h = 1; h < size; h <<= 1) {
+            for (Int i = 0; i < size; i += h << 1) {
+                for (Int j = i; j < i + h; j++) {
+                    Real a = v[j];
+                    Real b = v[j + h];
+                    v[j] = a + b;
+                    v[j + h] = a - b;
+                }
+            }
+        }
+    }
+
+    // solves M^k*x = b. M^k = H*P, with H the Walsh-Hadamard matrix and P the permutation taking column j to
+    // gray code g(j) = j^(j>>1). Since H*H = N*I, x(j) = (H*b)(g(j))/N.
+    static Eigen::VectorXd solveMk(const Eigen::Ref<const Eigen::VectorXd> &b) {
+        Int size = b.rows();
+        Eigen::VectorXd y = b;
+        fwht(y);
+        Eigen::VectorXd x(size);
+        for (Int j = 0; j < size; j++) {
+            x[j] = y[j^(j>>1)]/size;
+        }
+        return x;
+    }
+
+    // returns M^k*x, see solveMk()
+    static Eigen::VectorXd applyMk(const Eigen::Ref<const Eigen::VectorXd> &x) {
+        Int size = x.rows();
+        Eigen::VectorXd y(size);
+        for (Int j = 0; j < size; j++) {
+            y[j^(j>>1)] = x[j];
+        }
+        fwht(y);
+        return y;
+    }
+
+    // in verification mode, checks the solution tr of M^k*tr = temp found by solveMk() against a dense least-squares solver
+    void verifyMk(const Eigen::VectorXd &temp, const Eigen::VectorXd &tr, Int halfthesizeofthematrix, const Str &what) {
+        if (!verify) {
+            return;
+        }
+        Eigen::CompleteOrthogonalDecomposition<Eigen::MatrixXd> dec(genMk_lookuptable[uint64_log2(halfthesizeofthematrix)-1]);
+        Eigen::VectorXd reference = dec.solve(temp);
+        if ((reference - tr).norm() > 10e-8 * std::max(1.0, temp.norm())) {
+            QL_EOUT("Multicontrolled " << what << " does not match the reference solver!");
+            throw utils::Exception("Fast multiplexor solve for unitary '"+ name+"' does not match the reference solver at multicontrolled " + what);
+        }
+    }
+
     // source: https://stackoverflow.com/questions/994593/how-to-do-an-integer-log2-in-c user Todd Lehman
     Int uint64_log2(uint64_t n) {
 #define S(k) if (n >= (UINT64_C(1) << k)) { i += k; n >>= k; }
@@ -481,34 +621,34 @@ public:
         }
     }
 
-    void multicontrolledY(const Eigen::Ref<const Eigen::VectorXcd> &ss, Int halfthesizeofthematrix) {
+    void multicontrolledY(const Eigen::Ref<const Eigen::VectorXcd> &ss, Int halfthesizeofthematrix, Vec<Real> &insns) {
         // auto start = std::chrono::steady_clock::now();
         Eigen::VectorXd temp =  2*Eigen::asin(ss.array()).real();
-        Eigen::CompleteOrthogonalDecomposition<Eigen::MatrixXd> dec(genMk_lookuptable[uint64_log2(halfthesizeofthematrix)-1]);
-        Eigen::VectorXd tr = dec.solve(temp);
+        Eigen::VectorXd tr = solveMk(temp);
         // Check is very approximate to account for low-precision input matrices
-        if (!temp.isApprox(genMk_lookuptable[uint64_log2(halfthesizeofthematrix)-1]*tr, 10e-2)) {
+        if (!temp.isApprox(applyMk(tr), 10e-2)) {
             QL_EOUT("Multicontrolled Y not correct!");
             throw utils::Exception("Demultiplexing of unitary '"+ name+"' not correct! Failed at demultiplexing of matrix ss: \n"  + to_string(ss));
         }
+        verifyMk(temp, tr, halfthesizeofthematrix, "Y");
 
-        instruction_list.insert(instruction_list.end(), &tr[0], &tr[halfthesizeofthematrix]);
+        insns.insert(insns.end(), tr.data(), tr.data() + halfthesizeofthematrix);
         // multiplexing_time += std::chrono::steady_clock::now() - start;
     }
 
-    void multicontrolledZ(const Eigen::Ref<const Eigen::VectorXcd> &D, Int halfthesizeofthematrix) {
+    void multicontrolledZ(const Eigen::Ref<const Eigen::VectorXcd> &D, Int halfthesizeofthematrix, Vec<Real> &insns) {
         // auto start = std::chrono::steady_clock::now();
 
         Eigen::VectorXd temp =  (Complex(0,-2)*Eigen::log(D.array())).real();
-        Eigen::CompleteOrthogonalDecomposition<Eigen::MatrixXd> dec(genMk_lookuptable[uint64_log2(halfthesizeofthematrix)-1]);
-        Eigen::VectorXd tr = dec.solve(temp);
+        Eigen::VectorXd tr = solveMk(temp);
         // Check is very approximate to account for low-precision input matrices
-        if (!temp.isApprox(genMk_lookuptable[uint64_log2(halfthesizeofthematrix)-1]*tr, 10e-2)) {
+        if (!temp.isApprox(applyMk(tr), 10e-2)) {
             QL_EOUT("Multicontrolled Z not correct!");
             throw utils::Exception("Demultiplexing of unitary '"+ name+"' not correct! Failed at demultiplexing of matrix D: \n"+ to_string(D));
         }
+        verifyMk(temp, tr, halfthesizeofthematrix, "Z");
 
-        instruction_list.insert(instruction_list.end(), &tr[0], &tr[halfthesizeofthematrix]);
+        insns.insert(insns.end(), tr.data(), tr.data() + halfthesizeofthematrix);
         // multiplexing_time += std::chrono::steady_clock::now() - start;
 
     }
@@ -520,21 +660,16 @@ public:
 };
 
 /**
- * Explicitly runs the matrix decomposition algorithm. Used to be required,
- * nowadays is called implicitly by get_circuit() if not done explicitly.
+ * Runs the matrix decomposition algorithm, returning the instruction list.
  */
-void Unitary::decompose() {
-    if (decomposed) {
-        return;
-    }
-    UnitaryDecomposer decomposer(name, array);
+static Vec<Real> decompose_matrix(const Str &name, const Vec<Complex> &array) {
+    UnitaryDecomposer decomposer(
+        name, array,
+        com::options::global["unitary_decomposition_verify"].as_bool(),
+        com::options::global["unitary_decomposition_threads"].as_uint()
+    );
     decomposer.decompose();
-    //SU = decomposer.SU;
-    //alpha = decomposer.alpha;
-    //beta = decomposer.beta;
-    //gamma = decomposer.gamma;
-    decomposed = decomposer.decomposed;
-    instruction_list = decomposer.instruction_list;
+    return std::move(decomposer.instruction_list);
 }
 
 /**
@@ -547,6 +682,429 @@ Bool Unitary::is_decompose_support_enabled() {
 
 #endif
 
+/**
+ * Magic number at the start of on-disk unitary decomposition cache files.
+ */
+static const char CACHE_MAGIC[8] = {'Q', 'L', 'U', 'N', 'I', 'T', '0', '2'};
+
+/**
+ * Written in native byte order after the magic number of on-disk unitary
+ * decomposition cache files, such that files written on a machine with a
+ * different byte order are recognized as such.
+ */
+static const UInt CACHE_BYTE_ORDER_MARK = 0x0102030405060708ull;
+
+/**
+ * Maximum number of on-disk cache files probed for a single hash.
+ */
+static const UInt CACHE_MAX_PROBES = 16;
+
+/**
+ * Cache for the decompositions of unitary matrices, keyed by the contents of
+ * the matrix, such that applying the same matrix many times only decomposes
+ * it once. The cache lives in memory, bounded to a maximum number of entries
+ * by evicting the least recently used entry, and optionally also in a
+ * directory on disk. Both are disabled by default; see Unitary::set_cache().
+ */
+class DecompositionCache {
+private:
+
+    /**
+     * Version of the decomposition output. Part of the hash, such that stale
+     * cache files are not used when the decomposition algorithm changes.
+     */
+    static const UInt VERSION = 1;
+
+    /**
+     * A cached decomposition.
+     */
+    struct Entry {
+
+        /**
+         * The decomposed matrix, to rule out hash collisions.
+         */
+        Vec<Complex> array;
+
+        /**
+         * The decomposition.
+         */
+        Vec<Real> instruction_list;
+
+        /**
+         * Position of this entry in the LRU list.
+         */
+        std::list<UInt>::iterator lru_position;
+
+    };
+
+    /**
+     * Maximum number of entries in memory. 0 disables the in-memory cache.
+     */
+    UInt max_entries = 0;
+
+    /**
+     * Directory for the on-disk cache. Empty disables the on-disk cache.
+     */
+    Str directory;
+
+    /**
+     * The in-memory cache entries by hash.
+     */
+    Map<UInt, Entry> entries;
+
+    /**
+     * Hashes of the in-memory entries, most recently used first.
+     */
+    std::list<UInt> lru;
+
+    /**
+     * Mutex protecting the above. It is not held during disk I/O.
+     */
+    std::mutex mutex;
+
+    /**
+     * Returns the hash of the given matrix.
+     */
+    static UInt hash(const Vec<Complex> &array) {
+        UInt hash = 14695981039346656037ull;
+        auto feed = [&hash](UInt value) {
+            hash = (hash ^ value) * 1099511628211ull;
+        };
+        feed(VERSION);
+        feed(array.size());
+        for (const auto &element : array) {
+            UInt bits[2];
+            Real parts[2] = {element.real(), element.imag()};
+            std::memcpy(bits, parts, sizeof(bits));
+            feed(bits[0]);
+            feed(bits[1]);
+        }
+        return hash;
+    }
+
+    /**
+     * Returns the name of the on-disk cache file with the given index for the
+     * given hash. The name includes the byte order of this machine, because
+     * the file contents are stored in native byte order.
+     */
+    static Str file_name(const Str &directory, UInt key, UInt index) {
+        unsigned char first_byte;
+        std::memcpy(&first_byte, &CACHE_BYTE_ORDER_MARK, sizeof(first_byte));
+        StrStrm ss;
+        ss << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key;
+        ss << std::dec << "-" << (first_byte == 0x08 ? "le" : "be") << "-" << index << ".qlu";
+        return ss.str();
+    }
+
+    /**
+     * Result of reading an on-disk cache file.
+     */
+    enum class FileState {
+
+        /**
+         * The file does not exist.
+         */
+        MISSING,
+
+        /**
+         * The file is not a valid cache file for this machine, so it can be
+         * replaced.
+         */
+        INVALID,
+
+        /**
+         * The file is a valid cache file, but for a different matrix with the
+         * same hash.
+         */
+        COLLISION,
+
+        /**
+         * The file holds the decomposition of the matrix.
+         */
+        MATCH
+
+    };
+
+    /**
+     * Reads the given on-disk cache file, returning whether it holds the
+     * decomposition of the given matrix. If so, instruction_list is set to
+     * it.
+     */
+    static FileState read_file(
+        const Str &fname,
+        const Vec<Complex> &array,
+        Vec<Real> &instruction_list
+    ) {
+        std::ifstream ifs(fname, std::ios::binary);
+        if (!ifs.is_open()) {
+            return FileState::MISSING;
+        }
+        char magic[sizeof(CACHE_MAGIC)];
+        UInt header[3];
+        ifs.read(magic, sizeof(magic));
+        ifs.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (
+            !ifs.good()
+            || !std::equal(magic, magic + sizeof(magic), CACHE_MAGIC)
+            || header[0] != CACHE_BYTE_ORDER_MARK
+        ) {
+            QL_IOUT("unitary cache file " << fname << " does not match and will be regenerated");
+            return FileState::INVALID;
+        }
+        if (header[1] != array.size()) {
+            return FileState::COLLISION;
+        }
+        Vec<Complex> cached_array(header[1]);
+        Vec<Real> cached_list(header[2]);
+        ifs.read(reinterpret_cast<char*>(cached_array.data()), cached_array.size() * sizeof(Complex));
+        ifs.read(reinterpret_cast<char*>(cached_list.data()), cached_list.size() * sizeof(Real));
+        if (!ifs.good() || ifs.peek() != std::ifstream::traits_type::eof()) {
+            QL_IOUT("unitary cache file " << fname << " is corrupt and will be regenerated");
+            return FileState::INVALID;
+        }
+        if (cached_array != array) {
+            return FileState::COLLISION;
+        }
+        instruction_list = std::move(cached_list);
+        return FileState::MATCH;
+    }
+
+    /**
+     * Tries to load the decomposition of the given matrix from the on-disk
+     * cache. Matrices with the same hash are stored in files with increasing
+     * indices, so all files for the hash are probed until the matrix is found
+     * or a free slot is encountered. Returns false if there is no valid cache
+     * file for the matrix.
+     */
+    static Bool load(
+        const Str &directory,
+        UInt key,
+        const Vec<Complex> &array,
+        Vec<Real> &instruction_list
+    ) {
+        for (UInt index = 0; index < CACHE_MAX_PROBES; index++) {
+            Str fname = file_name(directory, key, index);
+            switch (read_file(fname, array, instruction_list)) {
+                case FileState::MATCH:
+                    QL_DOUT("loaded unitary decomposition from " << fname);
+                    return true;
+                case FileState::COLLISION:
+                    continue;
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Writes the decomposition of the given matrix to the on-disk cache, in
+     * the first file for its hash that is free, invalid, or already holds it.
+     * The file is written under a temporary name and then renamed, such that
+     * concurrent readers and writers never see a partially-written file.
+     * Failure to write the cache is not fatal.
+     */
+    static void save(
+        const Str &directory,
+        UInt key,
+        const Vec<Complex> &array,
+        const Vec<Real> &instruction_list
+    ) {
+        Str fname;
+        for (UInt index = 0; index < CACHE_MAX_PROBES; index++) {
+            Str candidate = file_name(directory, key, index);
+            Vec<Real> existing;
+            auto state = read_file(candidate, array, existing);
+            if (state == FileState::MATCH) {
+                return;
+            } else if (state != FileState::COLLISION) {
+                fname = candidate;
+                break;
+            }
+        }
+        if (fname.empty()) {
+            QL_WOUT("too many unitary cache files with hash " << std::hex << key << std::dec << "; not caching");
+            return;
+        }
+        StrStrm tmp_ss;
+        tmp_ss << fname << "." << std::hash<std::thread::id>()(std::this_thread::get_id());
+        tmp_ss << "." << std::chrono::steady_clock::now().time_since_epoch().count() << ".tmp";
+        Str tmp_fname = tmp_ss.str();
+        make_dirs(directory);
+        std::ofstream ofs(tmp_fname, std::ios::binary | std::ios::trunc);
+        UInt header[3] = {CACHE_BYTE_ORDER_MARK, array.size(), instruction_list.size()};
+        ofs.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        ofs.write(reinterpret_cast<const char*>(header), sizeof(header));
+        ofs.write(reinterpret_cast<const char*>(array.data()), array.size() * sizeof(Complex));
+        ofs.write(reinterpret_cast<const char*>(instruction_list.data()), instruction_list.size() * sizeof(Real));
+        ofs.close();
+        if (ofs.fail()) {
+            QL_WOUT("failed to write unitary cache file " << tmp_fname);
+            std::remove(tmp_fname.c_str());
+            return;
+        }
+#ifdef _WIN32
+        std::remove(fname.c_str());
+#endif
+        if (std::rename(tmp_fname.c_str(), fname.c_str())) {
+            QL_WOUT("failed to rename unitary cache file " << tmp_fname << " to " << fname);
+            std::remove(tmp_fname.c_str());
+            return;
+        }
+        QL_DOUT("wrote unitary decomposition to " << fname);
+    }
+
+    /**
+     * Adds an entry to the in-memory cache, evicting the least recently used
+     * entries as needed. The mutex must be held.
+     */
+    void insert(UInt key, const Vec<Complex> &array, const Vec<Real> &instruction_list) {
+        if (!max_entries) {
+            return;
+        }
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            lru.erase(it->second.lru_position);
+            entries.erase(it);
+        }
+        while (entries.size() >= max_entries) {
+            entries.erase(lru.back());
+            lru.pop_back();
+        }
+        lru.push_front(key);
+        auto &entry = entries.set(key);
+        entry.array = array;
+        entry.instruction_list = instruction_list;
+        entry.lru_position = lru.begin();
+    }
+
+public:
+
+    /**
+     * Returns the process-wide cache.
+     */
+    static DecompositionCache &get() {
+        static DecompositionCache cache;
+        return cache;
+    }
+
+    /**
+     * Configures the cache. Evicts in-memory entries beyond the new maximum.
+     */
+    void configure(UInt new_max_entries, const Str &new_directory) {
+        std::lock_guard<std::mutex> lock(mutex);
+        max_entries = new_max_entries;
+        directory = new_directory;
+        while (entries.size() > max_entries) {
+            entries.erase(lru.back());
+            lru.pop_back();
+        }
+    }
+
+    /**
+     * Removes all entries from the in-memory cache. The on-disk cache is not
+     * affected.
+     */
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        lru.clear();
+    }
+
+    /**
+     * Looks up the decomposition of the given matrix, first in memory and
+     * then on disk. Returns whether it was found.
+     */
+    Bool lookup(const Vec<Complex> &array, Vec<Real> &instruction_list) {
+        UInt key;
+        Str dir;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!max_entries && directory.empty()) {
+                return false;
+            }
+            key = hash(array);
+            auto it = entries.find(key);
+            if (it != entries.end() && it->second.array == array) {
+                lru.splice(lru.begin(), lru, it->second.lru_position);
+                instruction_list = it->second.instruction_list;
+                return true;
+            }
+            dir = directory;
+        }
+        if (dir.empty() || !load(dir, key, array, instruction_list)) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        insert(key, array, instruction_list);
+        return true;
+    }
+
+    /**
+     * Stores the decomposition of the given matrix in memory and on disk, as
+     * far as enabled.
+     */
+    void store(const Vec<Complex> &array, const Vec<Real> &instruction_list) {
+        UInt key;
+        Str dir;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!max_entries && directory.empty()) {
+                return;
+            }
+            key = hash(array);
+            insert(key, array, instruction_list);
+            dir = directory;
+        }
+        if (!dir.empty()) {
+            save(dir, key, array, instruction_list);
+        }
+    }
+
+};
+
+/**
+ * Configures the process-wide cache for unitary decompositions, which is
+ * keyed by the contents of the matrix. At most max_entries decompositions
+ * are kept in memory, evicting the least recently used one when full; 0
+ * disables the in-memory cache. If directory is nonempty, decompositions
+ * are also stored in and loaded from files in that directory, which is
+ * interpreted relative to the current OpenQL working directory. Both are
+ * disabled by default.
+ */
+void Unitary::set_cache(UInt max_entries, const Str &directory) {
+    DecompositionCache::get().configure(
+        max_entries,
+        directory.empty() ? directory : path_relative_to(get_working_directory(), directory)
+    );
+}
+
+/**
+ * Removes all decompositions from the in-memory cache. Files in the on-disk
+ * cache directory are not removed.
+ */
+void Unitary::clear_cache() {
+    DecompositionCache::get().clear();
+}
+
+/**
+ * Explicitly runs the matrix decomposition algorithm. Used to be required,
+ * nowadays is called implicitly by get_decomposition() if not done explicitly.
+ * If the decomposition cache is enabled and contains the decomposition of
+ * this matrix, it is taken from there.
+ */
+void Unitary::decompose() {
+    if (decomposed) {
+        return;
+    }
+    auto &cache = DecompositionCache::get();
+    if (!cache.lookup(array, instruction_list)) {
+        instruction_list = decompose_matrix(name, array);
+        cache.store(array, instruction_list);
+    }
+    decomposed = true;
+}
+
 
 //controlled qubit is the first in the list.
 static void multicontrolled_rz(
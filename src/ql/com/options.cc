@@ -78,6 +78,67 @@ Options make_ql_options() {
         "only used when %N is used in the `output_prefix` common pass option."
     );
 
+    options.add_bool(
+        "unitary_decomposition_verify",
+        "When set, the rotation angles of the multiplexed rotations generated "
+        "by unitary decomposition, which are normally computed with a fast "
+        "Walsh-Hadamard transform, are also computed with a dense "
+        "least-squares solver, and decomposition fails if the results differ. "
+        "This is much slower, and only intended for verification."
+    );
+
+    options.add_int(
+        "unitary_decomposition_threads",
+        "Number of threads used to decompose unitary gates. The independent "
+        "sub-unitaries produced at each level of the recursive decomposition "
+        "are then decomposed concurrently. `1` decomposes serially, `0` uses "
+        "as many threads as the hardware supports. The worker threads are "
+        "started on first use and then reused for the rest of the process. The "
+        "result does not depend on the number of threads.",
+        "1",
+        0, utils::MAX
+    );
+
+    options.add_bool(
+        "platform_cache",
+        "When set, platforms constructed with the same name, configuration "
+        "file contents (or JSON data), and compiler configuration share a "
+        "single, immutable platform object instead of loading the "
+        "configuration again, and the conversion of such a platform to the "
+        "new IR is only done once, after which each program gets a copy of "
+        "the result. If the configuration does not specify the number of "
+        "classical registers, each platform instead gets a cheap copy of the "
+        "cached platform with its own register counts, and the conversion is "
+        "done once per register count. Files referenced from within the "
+        "platform configuration are not checked for changes once a platform "
+        "has been cached."
+    );
+
+    options.add_bool(
+        "legacy_ir_session",
+        "When set, consecutive passes that operate on the old IR share a "
+        "single old-IR representation of the program, rather than converting "
+        "from the new IR and back again for each pass. The old IR is only "
+        "converted back when a pass that uses the new IR is run, when a "
+        "pass's `debug` option requires the new IR, or at the end of the "
+        "compilation strategy."
+    );
+
+    options.add_bool(
+        "profile_passes",
+        "When set, the pass manager records the wall-clock time, CPU time, "
+        "peak memory increase, and program size before and after each pass "
+        "and pass group, and logs the time each pass took at info level. The "
+        "results of the most recent compilation can be retrieved with the "
+        "`print_profile()`, `dump_profile()`, and `write_profile()` methods "
+        "of the compiler. The program size is always measured in the new IR; "
+        "when `legacy_ir_session` is also set, this requires converting the "
+        "old IR after each legacy transformation pass, which is then reused "
+        "when the session ends. The time spent measuring is not included in "
+        "the measured times, also not in those of the enclosing pass groups, "
+        "but it may be reflected in the peak memory increase."
+    );
+
     //========================================================================//
     // Default pass order                                                     //
     //========================================================================//
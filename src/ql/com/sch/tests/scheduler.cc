@@ -0,0 +1,130 @@
+#include "ql/ir/compat/compat.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/com/ddg/build.h"
+#include "ql/com/ddg/ops.h"
+#include "ql/com/sch/scheduler.h"
+
+using namespace ql;
+
+/**
+ * Builds a program with a single block of seven statements on the default
+ * CC-light platform, where x, y, and h take two cycles and cz takes four:
+ *
+ *     0: y q2
+ *     1: x q1
+ *     2: h q0
+ *     3: h q0
+ *     4: cz q0, q1
+ *     5: x q0
+ *     6: y q1
+ *
+ * Returns the block, and the statements in the original order via statements.
+ */
+static ir::BlockBaseRef build_block(ir::Ref &ir, utils::Vec<ir::StatementRef> &statements) {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+    auto program = utils::make<ir::compat::Program>("test_prog", plat, 7, 32, 10);
+    auto kernel = utils::make<ir::compat::Kernel>("kernel", plat, 7, 32, 10);
+    kernel->y(2);
+    kernel->x(1);
+    kernel->hadamard(0);
+    kernel->hadamard(0);
+    kernel->cz(0, 1);
+    kernel->x(0);
+    kernel->y(1);
+    program->add(kernel);
+    ir = ir::convert_old_to_new(program);
+    const auto &block = ir->program->blocks[0];
+    QL_ASSERT(block->statements.size() == 7);
+    statements.clear();
+    for (const auto &statement : block->statements) {
+        statements.push_back(statement);
+    }
+    com::ddg::build(ir, block);
+    return block;
+}
+
+/**
+ * Checks that the statements were scheduled in the given cycles.
+ */
+static void check_cycles(
+    const utils::Vec<ir::StatementRef> &statements,
+    const utils::Vec<utils::Int> &cycles
+) {
+    QL_ASSERT(statements.size() == cycles.size());
+    for (utils::UInt i = 0; i < statements.size(); i++) {
+        QL_ASSERT_EQ(statements[i]->cycle, cycles[i]);
+    }
+}
+
+/**
+ * Checks that the given statements are available, in the given order.
+ */
+static void check_available(
+    const utils::List<ir::StatementRef> &available,
+    const utils::Vec<ir::StatementRef> &expected
+) {
+    QL_ASSERT(available.size() == expected.size());
+    utils::UInt i = 0;
+    for (const auto &statement : available) {
+        QL_ASSERT(statement == expected[i++]);
+    }
+}
+
+int main() {
+    ir::Ref ir;
+    utils::Vec<ir::StatementRef> s;
+
+    // ASAP. Everything on q0 follows the Hadamards, and the statements are
+    // sorted by cycle afterwards, keeping the original order for statements
+    // in the same cycle.
+    {
+        auto block = build_block(ir, s);
+        com::sch::Scheduler<> scheduler(block);
+        check_available(scheduler.get_available(), {s[0], s[1], s[2]});
+        scheduler.run();
+        scheduler.convert_cycles();
+        check_cycles(s, {0, 0, 0, 2, 4, 8, 8});
+        QL_ASSERT_EQ(com::ddg::get_sink(block)->cycle, 10);
+        utils::Vec<ir::StatementRef> order = {s[0], s[1], s[2], s[3], s[4], s[5], s[6]};
+        for (utils::UInt i = 0; i < order.size(); i++) {
+            QL_ASSERT(block->statements[i] == order[i]);
+        }
+    }
+
+    // ALAP. The statements that are not on the critical path move to the end
+    // of the schedule.
+    {
+        auto block = build_block(ir, s);
+        com::ddg::reverse(block);
+        com::sch::Scheduler<> scheduler(block);
+        scheduler.run();
+        scheduler.convert_cycles();
+        check_cycles(s, {8, 2, 0, 2, 4, 8, 8});
+        utils::Vec<ir::StatementRef> order = {s[2], s[1], s[3], s[4], s[0], s[5], s[6]};
+        for (utils::UInt i = 0; i < order.size(); i++) {
+            QL_ASSERT(block->statements[i] == order[i]);
+        }
+    }
+
+    // Critical path heuristic with explicit scheduling. The available
+    // statements are ordered by the length of their path to the sink, and
+    // scheduling a less critical one first must not affect the result.
+    {
+        auto block = build_block(ir, s);
+        com::ddg::reverse(block);
+        com::sch::Scheduler<>(block).run();
+        com::ddg::reverse(block);
+        com::sch::Scheduler<com::sch::CriticalPathHeuristic> scheduler(block);
+        check_available(scheduler.get_available(), {s[2], s[1], s[0]});
+        QL_ASSERT(!scheduler.try_schedule(s[4]));
+        QL_ASSERT(scheduler.try_schedule(s[0]));
+        check_available(scheduler.get_available(), {s[2], s[1]});
+        QL_ASSERT(!scheduler.try_schedule(s[0]));
+        scheduler.run();
+        QL_ASSERT(scheduler.is_done());
+        scheduler.convert_cycles();
+        check_cycles(s, {0, 0, 0, 2, 4, 8, 8});
+    }
+
+    return 0;
+}
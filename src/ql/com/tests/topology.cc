@@ -0,0 +1,107 @@
+#include <iostream>
+#include <cstdio>
+
+#include "ql/utils/filesystem.h"
+#include "ql/com/topology.h"
+
+using namespace ql::utils;
+using namespace ql::com;
+
+/**
+ * Builds a topology for a 3x4 grid with bidirectional nearest-neighbor edges,
+ * minus the edges between (1,1) and (2,1).
+ */
+static Json grid_json(const Str &path_cache = "") {
+    Json json;
+    json["form"] = "irregular";
+    json["connectivity"] = "specified";
+    json["edges"] = Json::array();
+    auto add = [&json](UInt a, UInt b) {
+        json["edges"].push_back({{"src", a}, {"dst", b}});
+        json["edges"].push_back({{"src", b}, {"dst", a}});
+    };
+    for (UInt y = 0; y < 4; y++) {
+        for (UInt x = 0; x < 3; x++) {
+            UInt q = y * 3 + x;
+            if (x < 2 && !(q == 4)) add(q, q + 1);
+            if (y < 3) add(q, q + 3);
+        }
+    }
+    if (!path_cache.empty()) {
+        json["path_cache"] = path_cache;
+    }
+    return json;
+}
+
+/**
+ * Checks the distance and next-hop tables of the given topology against a
+ * naive Floyd-Warshall computation.
+ */
+static void check(const Topology &top) {
+    UInt n = top.get_num_qubits();
+    Vec<Vec<UInt>> dist(n, Vec<UInt>(n, MAX));
+    for (UInt i = 0; i < n; i++) {
+        dist[i][i] = 0;
+        for (auto j : top.get_neighbors(i)) {
+            dist[i][j] = 1;
+        }
+    }
+    for (UInt k = 0; k < n; k++) {
+        for (UInt i = 0; i < n; i++) {
+            for (UInt j = 0; j < n; j++) {
+                if (dist[i][k] != MAX && dist[k][j] != MAX && dist[i][k] + dist[k][j] < dist[i][j]) {
+                    dist[i][j] = dist[i][k] + dist[k][j];
+                }
+            }
+        }
+    }
+    for (UInt i = 0; i < n; i++) {
+        for (UInt j = 0; j < n; j++) {
+            QL_ASSERT(top.get_distance(i, j) == dist[i][j]);
+            if (i == j) {
+                QL_ASSERT(top.get_next_hop(i, j) == i);
+                continue;
+            }
+            UInt expected = MAX;
+            for (auto k : top.get_neighbors(i)) {
+                if (dist[k][j] + 1 == dist[i][j]) {
+                    expected = k;
+                    break;
+                }
+            }
+            QL_ASSERT(top.get_next_hop(i, j) == expected);
+        }
+    }
+}
+
+int main() {
+
+    // Without cache.
+    check(Topology(12, grid_json()));
+
+    // A disconnected qubit.
+    check(Topology(13, grid_json()));
+
+    // Write the cache, then read it back.
+    Str fname = "topology_path_cache.bin";
+    std::remove(fname.c_str());
+    check(Topology(12, grid_json(fname)));
+    QL_ASSERT(path_exists(fname));
+    check(Topology(12, grid_json(fname)));
+
+    // A cache for a different topology must be regenerated.
+    check(Topology(13, grid_json(fname)));
+    check(Topology(13, grid_json(fname)));
+
+    // Full connectivity computes paths on the fly.
+    Json full;
+    full["number_of_cores"] = (UInt)2;
+    full["comm_qubits_per_core"] = (UInt)1;
+    Topology top(8, full);
+    QL_ASSERT(top.get_next_hop(1, 2) == 2);
+    QL_ASSERT(top.get_next_hop(1, 1) == 1);
+    QL_ASSERT(top.get_distance(top.get_next_hop(1, 5), 5) + 1 == top.get_distance(1, 5));
+
+    std::remove(fname.c_str());
+    return 0;
+}
@@ -5,7 +5,14 @@
 
 #include "ql/com/topology.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <thread>
 #include "ql/utils/logger.h"
+#include "ql/utils/filesystem.h"
 
 // uncomment next line to enable multi-line dumping
 // #define MULTI_LINE_LOG_DEBUG
@@ -69,7 +76,8 @@ void Topology::dump_docs(std::ostream &os, const utils::Str &line_prefix) {
         "number_of_cores": <optional positive integer, default 1>,
         "comm_qubits_per_core": <optional positive integer, num_qubits / number_of_cores>,
         "connectivity": <optional string, either "specified" or "full">,
-        "edges": <mandatory array of objects for connectivity="specified", unused for "full">
+        "edges": <mandatory array of objects for connectivity="specified", unused for "full">,
+        "path_cache": <optional string, unused for "full">
         ...
     }
     ```
@@ -139,6 +147,15 @@ void Topology::dump_docs(std::ostream &os, const utils::Str &line_prefix) {
     If the `"connectivity"` key is missing, its value is derived from whether
     an "edges" list is given.
 
+    For specified connectivity, the distance between each pair of qubits and
+    the first hop along a shortest path are precomputed when the platform is
+    loaded. For large topologies, these tables can be cached on disk by
+    setting `"path_cache"` to a filename, interpreted relative to the
+    platform configuration file. If the file exists and was generated for
+    the same topology, the tables are loaded from it; otherwise they are
+    computed and (re)written to it. The file format is specific to the
+    machine that wrote it.
+
     Any additional keys in the topology root object are silently ignored, as
     other parts of OpenQL may use the structure as well.
     )");
@@ -162,6 +179,135 @@ void Topology::generate_neighbors_list(utils::UInt qs, Neighbors &qubits) const
     }
 }
 
+/**
+ * Magic number identifying path cache files, including a format version.
+ */
+static const char PATH_CACHE_MAGIC[8] = {'Q', 'L', 'P', 'A', 'T', 'H', '0', '1'};
+
+/**
+ * Computes the distance and next-hop tables for specified connectivity, using
+ * a breadth-first search from each qubit. Because the neighbors of each qubit
+ * are visited in order, the first hop recorded for each target is the first
+ * neighbor (in neighbor list order) that lies on a shortest path to it.
+ */
+void Topology::compute_paths() {
+    distance.assign(num_qubits * num_qubits, utils::MAX);
+    next_hop.assign(num_qubits * num_qubits, utils::MAX);
+    utils::Vec<Qubit> queue(num_qubits);
+    for (Qubit source = 0; source < num_qubits; source++) {
+        auto dist = &distance[source * num_qubits];
+        auto hop = &next_hop[source * num_qubits];
+        dist[source] = 0;
+        hop[source] = source;
+        utils::UInt head = 0;
+        utils::UInt tail = 0;
+        queue[tail++] = source;
+        while (head < tail) {
+            Qubit q = queue[head++];
+            for (Qubit n : neighbors.get(q)) {
+                if (dist[n] != utils::MAX) {
+                    continue;
+                }
+                dist[n] = dist[q] + 1;
+                hop[n] = (q == source) ? n : hop[q];
+                queue[tail++] = n;
+            }
+        }
+    }
+}
+
+/**
+ * Returns a hash of the number of qubits and the (ordered) neighbor lists,
+ * used to check whether a path cache file belongs to this topology.
+ */
+utils::UInt Topology::get_path_fingerprint() const {
+    utils::UInt hash = 14695981039346656037ull;
+    auto feed = [&hash](utils::UInt value) {
+        hash = (hash ^ value) * 1099511628211ull;
+    };
+    feed(num_qubits);
+    for (Qubit q = 0; q < num_qubits; q++) {
+        const auto &nbs = neighbors.get(q);
+        feed(nbs.size());
+        for (Qubit n : nbs) {
+            feed(n);
+        }
+    }
+    return hash;
+}
+
+/**
+ * Tries to load the distance and next-hop tables from the given cache file.
+ * Returns false if the file does not exist or does not match this topology.
+ */
+utils::Bool Topology::load_path_cache(const utils::Str &fname) {
+    std::ifstream ifs(fname, std::ios::binary);
+    if (!ifs.is_open()) {
+        return false;
+    }
+    char magic[sizeof(PATH_CACHE_MAGIC)];
+    utils::UInt header[2];
+    ifs.read(magic, sizeof(magic));
+    ifs.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (
+        !ifs.good()
+        || !std::equal(magic, magic + sizeof(magic), PATH_CACHE_MAGIC)
+        || header[0] != num_qubits
+        || header[1] != get_path_fingerprint()
+    ) {
+        QL_IOUT("path cache " << fname << " does not match the topology and will be regenerated");
+        return false;
+    }
+    distance.resize(num_qubits * num_qubits);
+    next_hop.resize(num_qubits * num_qubits);
+    std::streamsize size = num_qubits * num_qubits * sizeof(utils::UInt);
+    ifs.read(reinterpret_cast<char*>(distance.data()), size);
+    ifs.read(reinterpret_cast<char*>(next_hop.data()), size);
+    if (!ifs.good() || ifs.peek() != std::ifstream::traits_type::eof()) {
+        QL_IOUT("path cache " << fname << " is corrupt and will be regenerated");
+        distance.clear();
+        next_hop.clear();
+        return false;
+    }
+    QL_DOUT("loaded distance and next-hop tables from " << fname);
+    return true;
+}
+
+/**
+ * Writes the distance and next-hop tables to the given cache file. The file
+ * is written under a temporary name and then renamed, such that concurrent
+ * compilations never read a partially-written file. Failure to write the
+ * cache is not fatal.
+ */
+void Topology::save_path_cache(const utils::Str &fname) const {
+    utils::StrStrm tmp_ss;
+    tmp_ss << fname << "." << std::hash<std::thread::id>()(std::this_thread::get_id());
+    tmp_ss << "." << std::chrono::steady_clock::now().time_since_epoch().count() << ".tmp";
+    utils::Str tmp_fname = tmp_ss.str();
+    std::ofstream ofs(tmp_fname, std::ios::binary | std::ios::trunc);
+    utils::UInt header[2] = {num_qubits, get_path_fingerprint()};
+    std::streamsize size = num_qubits * num_qubits * sizeof(utils::UInt);
+    ofs.write(PATH_CACHE_MAGIC, sizeof(PATH_CACHE_MAGIC));
+    ofs.write(reinterpret_cast<const char*>(header), sizeof(header));
+    ofs.write(reinterpret_cast<const char*>(distance.data()), size);
+    ofs.write(reinterpret_cast<const char*>(next_hop.data()), size);
+    ofs.close();
+    if (ofs.fail()) {
+        QL_WOUT("failed to write path cache " << tmp_fname);
+        std::remove(tmp_fname.c_str());
+        return;
+    }
+#ifdef _WIN32
+    std::remove(fname.c_str());
+#endif
+    if (std::rename(tmp_fname.c_str(), fname.c_str())) {
+        QL_WOUT("failed to rename path cache " << tmp_fname << " to " << fname);
+        std::remove(tmp_fname.c_str());
+        return;
+    }
+    QL_DOUT("wrote distance and next-hop tables to " << fname);
+}
+
 /**
  * Constructs the grid for the given number of qubits from the given JSON
  * object. Refer to dump_docs() for details.
@@ -428,45 +574,6 @@ Topology::Topology(utils::UInt num_qubits, const utils::Json &topology) {
             }
         }
 
-        // Compute distances between all qubits using Floyd-Warshall. When not
-        // connected, distance remains set to utils::MAX.
-        distance.resize(num_qubits);
-        for (utils::UInt i = 0; i < num_qubits; i++) {
-
-            // Initialize all distances to maximum value...
-            distance[i].resize(num_qubits, utils::MAX);
-
-            // ... except the self-edge, which is 0 distance...
-            distance[i][i] = 0;
-
-            // ... and the neighbors, which get distance 1.
-            for (utils::UInt j : neighbors.get(i)) {
-                distance[i][j] = 1;
-            }
-
-        }
-
-        // Find shorter distances by gradually including more qubits (k) in path
-        for (utils::UInt k = 0; k < num_qubits; k++) {
-            for (utils::UInt i = 0; i < num_qubits; i++) {
-                for (utils::UInt j = 0; j < num_qubits; j++) {
-
-                    // Prevent overflow in the sum below by explicitly checking for
-                    // MAX.
-                    if (distance[i][k] == utils::MAX) {
-                        continue;
-                    }
-                    if (distance[k][j] == utils::MAX) {
-                        continue;
-                    }
-
-                    if (distance[i][j] > distance[i][k] + distance[k][j]) {
-                        distance[i][j] = distance[i][k] + distance[k][j];
-                    }
-                }
-            }
-        }
-
     } else if (connectivity == GridConnectivity::FULL) {
 
         // If we have full connectivity and the qubits have coordinates, we
@@ -506,6 +613,27 @@ Topology::Topology(utils::UInt num_qubits, const utils::Json &topology) {
         }
     }
 
+    // For specified connectivity, precompute the distance and next-hop
+    // tables, or load them from the cache file if one is configured and it
+    // matches this topology. This must happen after sorting the neighbor
+    // lists, because the next hops depend on their order.
+    if (connectivity == GridConnectivity::SPECIFIED) {
+        utils::Str cache_fname;
+        it = topology.find("path_cache");
+        if (it != topology.end()) {
+            if (it->type() != JsonType::string) {
+                throw utils::Exception("topology.path_cache must be a string if specified");
+            }
+            cache_fname = utils::path_relative_to(utils::get_working_directory(), it->get<utils::Str>());
+        }
+        if (cache_fname.empty() || !load_path_cache(cache_fname)) {
+            compute_paths();
+            if (!cache_fname.empty()) {
+                save_path_cache(cache_fname);
+            }
+        }
+    }
+
 #ifdef MULTI_LINE_LOG_DEBUG
     QL_IF_LOG_DEBUG {
         QL_DOUT("Dump the grid structure to stdout ...");
@@ -683,7 +811,29 @@ utils::UInt Topology::get_distance(Qubit source, Qubit target) const {
         return d;
     }
 
-    return distance[source][target];
+    return distance[source * num_qubits + target];
+}
+
+/**
+ * Returns the first hop on a shortest path from source to target, being the
+ * first neighbor of source (in neighbor list order) on such a path. Returns
+ * source if source equals target, and utils::MAX if target is unreachable.
+ * This is a table lookup for specified connectivity.
+ */
+Topology::Qubit Topology::get_next_hop(Qubit source, Qubit target) const {
+    if (connectivity != GridConnectivity::FULL) {
+        return next_hop[source * num_qubits + target];
+    }
+    if (source == target) {
+        return source;
+    }
+    utils::UInt d = get_distance(source, target);
+    for (Qubit n : get_neighbors(source)) {
+        if (get_distance(n, target) + 1 == d) {
+            return n;
+        }
+    }
+    return utils::MAX;
 }
 
 /**
@@ -0,0 +1,459 @@
+/** \file
+ * Binary checkpoint format for the IR, allowing compilation to be resumed
+ * from an intermediate result without reparsing cQASM.
+ */
+
+#include "ql/ir/checkpoint.h"
+
+#include <cstring>
+#include "ql/version.h"
+#include "ql/utils/filesystem.h"
+#include "ql/ir/old_to_new.h"
+
+namespace ql {
+namespace ir {
+namespace checkpoint {
+
+namespace {
+
+/**
+ * Magic number at the start of every checkpoint.
+ */
+const char MAGIC[8] = {'Q', 'L', 'I', 'R', 'C', 'K', 'P', 'T'};
+
+/**
+ * The number of sections in a checkpoint.
+ */
+const utils::UInt NUM_SECTIONS = 3;
+
+/**
+ * The size of the header: the magic number, the format version, and the size
+ * of each section, all as 64-bit little-endian integers except for the magic
+ * number.
+ */
+const utils::UInt HEADER_SIZE = sizeof(MAGIC) + 8 * (1 + NUM_SECTIONS);
+
+/**
+ * Flag bits used in the annotation section.
+ */
+enum AnnotationFlags : utils::UInt {
+    HAS_OBJECT_USAGE = 1,
+    HAS_KERNEL_NAME = 2,
+    HAS_KERNEL_CYCLES_VALID = 4,
+    KERNEL_CYCLES_VALID = 8,
+    PROTOTYPE_INFERRED = 16
+};
+
+/**
+ * Appends a 64-bit little-endian integer to the given buffer.
+ */
+void put_uint(utils::Str &buf, utils::UInt value) {
+    for (utils::UInt i = 0; i < 8; i++) {
+        buf.push_back((char)((value >> (8 * i)) & 0xFF));
+    }
+}
+
+/**
+ * Appends a length-prefixed string to the given buffer.
+ */
+void put_str(utils::Str &buf, const utils::Str &value) {
+    put_uint(buf, value.size());
+    buf.append(value);
+}
+
+/**
+ * Cursor for reading integers and strings from a section of a checkpoint,
+ * with bounds checking.
+ */
+class Cursor {
+private:
+
+    /**
+     * The checkpoint data.
+     */
+    const utils::Str &data;
+
+    /**
+     * The current read position.
+     */
+    utils::UInt pos;
+
+    /**
+     * The end of the section being read.
+     */
+    utils::UInt end;
+
+    /**
+     * Name of the checkpoint file, for error messages.
+     */
+    const utils::Str &fname;
+
+    /**
+     * Throws an error if fewer than the given number of bytes remain.
+     */
+    void require(utils::UInt size) const {
+        if (size > end - pos) {
+            QL_USER_ERROR("checkpoint file \"" << fname << "\" is truncated or corrupt");
+        }
+    }
+
+public:
+
+    /**
+     * Constructs a cursor for the given range of the checkpoint data.
+     */
+    Cursor(
+        const utils::Str &data,
+        utils::UInt pos,
+        utils::UInt end,
+        const utils::Str &fname
+    ) : data(data), pos(pos), end(end), fname(fname) {}
+
+    /**
+     * Reads a 64-bit little-endian integer.
+     */
+    utils::UInt get_uint() {
+        require(8);
+        utils::UInt value = 0;
+        for (utils::UInt i = 0; i < 8; i++) {
+            value |= (utils::UInt)(unsigned char)data[pos + i] << (8 * i);
+        }
+        pos += 8;
+        return value;
+    }
+
+    /**
+     * Reads a length-prefixed string.
+     */
+    utils::Str get_str() {
+        auto size = get_uint();
+        require(size);
+        auto value = data.substr(pos, size);
+        pos += size;
+        return value;
+    }
+
+    /**
+     * Returns whether the end of the section has been reached.
+     */
+    utils::Bool at_end() const {
+        return pos == end;
+    }
+
+};
+
+/**
+ * Appends the PrototypeInferred flag of the given instruction type and its
+ * specializations to the annotation section, in pre-order.
+ */
+void put_instruction_type_annotations(utils::Str &buf, const utils::One<InstructionType> &insn) {
+    put_uint(buf, insn->has_annotation<PrototypeInferred>() ? PROTOTYPE_INFERRED : 0);
+    for (const auto &spec : insn->specializations) {
+        put_instruction_type_annotations(buf, spec);
+    }
+}
+
+/**
+ * Restores the annotations written by put_instruction_type_annotations().
+ */
+void get_instruction_type_annotations(Cursor &cursor, const utils::One<InstructionType> &insn) {
+    if (cursor.get_uint() & PROTOTYPE_INFERRED) {
+        insn->set_annotation<PrototypeInferred>({});
+    }
+    for (const auto &spec : insn->specializations) {
+        get_instruction_type_annotations(cursor, spec);
+    }
+}
+
+/**
+ * Serializes the annotations of the IR that the conversions between the old
+ * and new IR depend on. These are not tree nodes, so the tree serializer does
+ * not handle them. The tree structure itself is used to identify the nodes
+ * they belong to.
+ */
+utils::Str put_annotations(const Ref &ir) {
+    utils::Str buf;
+
+    // Instruction types in the platform.
+    put_uint(buf, ir->platform->instructions.size());
+    for (const auto &insn : ir->platform->instructions) {
+        put_instruction_type_annotations(buf, insn);
+    }
+
+    // The program and its blocks.
+    if (ir->program.empty()) {
+        return buf;
+    }
+    if (auto usage = ir->program->get_annotation_ptr<ObjectUsage>()) {
+        put_uint(buf, HAS_OBJECT_USAGE);
+        put_uint(buf, usage->num_qubits);
+        put_uint(buf, usage->num_cregs);
+        put_uint(buf, usage->num_bregs);
+    } else {
+        put_uint(buf, 0);
+    }
+    put_uint(buf, ir->program->blocks.size());
+    for (const auto &block : ir->program->blocks) {
+        utils::UInt flags = 0;
+        auto kernel_name = block->get_annotation_ptr<KernelName>();
+        if (kernel_name) {
+            flags |= HAS_KERNEL_NAME;
+        }
+        if (auto cycles_valid = block->get_annotation_ptr<KernelCyclesValid>()) {
+            flags |= HAS_KERNEL_CYCLES_VALID;
+            if (cycles_valid->valid) {
+                flags |= KERNEL_CYCLES_VALID;
+            }
+        }
+        put_uint(buf, flags);
+        if (kernel_name) {
+            put_str(buf, kernel_name->name);
+        }
+    }
+
+    return buf;
+}
+
+/**
+ * Restores the annotations serialized by put_annotations() to the given
+ * (loaded) IR.
+ */
+void get_annotations(Root &root, Cursor &cursor, const utils::Str &fname) {
+
+    // Instruction types in the platform.
+    if (cursor.get_uint() != root.platform->instructions.size()) {
+        QL_USER_ERROR("checkpoint file \"" << fname << "\" is corrupt");
+    }
+    for (const auto &insn : root.platform->instructions) {
+        get_instruction_type_annotations(cursor, insn);
+    }
+
+    // The program and its blocks.
+    if (root.program.empty()) {
+        return;
+    }
+    if (cursor.get_uint() & HAS_OBJECT_USAGE) {
+        ObjectUsage usage;
+        usage.num_qubits = cursor.get_uint();
+        usage.num_cregs = cursor.get_uint();
+        usage.num_bregs = cursor.get_uint();
+        root.program->set_annotation<ObjectUsage>(usage);
+    }
+    if (cursor.get_uint() != root.program->blocks.size()) {
+        QL_USER_ERROR("checkpoint file \"" << fname << "\" is corrupt");
+    }
+    for (const auto &block : root.program->blocks) {
+        auto flags = cursor.get_uint();
+        if (flags & HAS_KERNEL_NAME) {
+            block->set_annotation<KernelName>({cursor.get_str()});
+        }
+        if (flags & HAS_KERNEL_CYCLES_VALID) {
+            block->set_annotation<KernelCyclesValid>({(flags & KERNEL_CYCLES_VALID) != 0});
+        }
+    }
+
+}
+
+/**
+ * Checks the header of the given checkpoint data and the OpenQL version that
+ * wrote it, and determines the range of each section.
+ */
+void locate_sections(
+    const utils::Str &data,
+    const utils::Str &fname,
+    utils::UInt (&section_begin)[NUM_SECTIONS],
+    utils::UInt (&section_end)[NUM_SECTIONS]
+) {
+
+    // Check the header and locate the sections.
+    if (data.size() < HEADER_SIZE || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        QL_USER_ERROR("\"" << fname << "\" is not an OpenQL IR checkpoint file");
+    }
+    Cursor header{data, sizeof(MAGIC), HEADER_SIZE, fname};
+    auto version = header.get_uint();
+    if (version != FORMAT_VERSION) {
+        QL_USER_ERROR(
+            "checkpoint file \"" << fname << "\" uses format version " << version
+            << ", but this version of OpenQL only supports version " << FORMAT_VERSION
+        );
+    }
+    utils::UInt pos = HEADER_SIZE;
+    for (utils::UInt i = 0; i < NUM_SECTIONS; i++) {
+        auto size = header.get_uint();
+        if (size > data.size() - pos) {
+            QL_USER_ERROR("checkpoint file \"" << fname << "\" is truncated or corrupt");
+        }
+        section_begin[i] = pos;
+        pos += size;
+        section_end[i] = pos;
+    }
+
+    // Reject checkpoints written by a different version of OpenQL; the format
+    // version may be the same, but the IR tree itself may not be.
+    if (data.compare(
+        section_begin[0], section_end[0] - section_begin[0], OPENQL_VERSION_STRING
+    ) != 0) {
+        QL_USER_ERROR(
+            "checkpoint file \"" << fname << "\" was written by OpenQL "
+            << data.substr(section_begin[0], section_end[0] - section_begin[0])
+            << ", but can only be read by the same version (" << OPENQL_VERSION_STRING << ")"
+        );
+    }
+
+}
+
+/**
+ * Deserializes the given tree section of a checkpoint, restores the
+ * annotations from the given cursor over its annotation section, and replaces
+ * the platform and program trees of the given IR with the result.
+ */
+void load(
+    const Ref &ir,
+    const utils::Str &tree,
+    Cursor &annotations,
+    const utils::Str &fname
+) {
+
+    // Deserialize the tree.
+    utils::Maybe<Root> loaded = utils::tree::base::deserialize<Root>(tree);
+
+    // The platform objects that aren't part of the checkpoint are taken from
+    // the current platform, so it must be the same platform.
+    if (ir->platform.empty()) {
+        QL_USER_ERROR(
+            "cannot load checkpoint file \"" << fname << "\" without a platform"
+        );
+    }
+    if (loaded->platform->data != ir->platform->data) {
+        QL_USER_ERROR(
+            "checkpoint file \"" << fname << "\" was written for a different "
+            "platform configuration"
+        );
+    }
+    loaded->platform->topology = ir->platform->topology;
+    loaded->platform->architecture = ir->platform->architecture;
+    loaded->platform->resources = ir->platform->resources;
+    loaded->platform->copy_annotations(*ir->platform);
+
+    // Restore the remaining annotations.
+    get_annotations(*loaded, annotations, fname);
+    if (!annotations.at_end()) {
+        QL_USER_ERROR("checkpoint file \"" << fname << "\" is corrupt");
+    }
+
+    // Replace the platform and program in the given IR.
+    ir->platform = loaded->platform;
+    ir->program = loaded->program;
+
+}
+
+} // anonymous namespace
+
+/**
+ * Writes a binary checkpoint of the complete IR (platform and program) to the
+ * given stream.
+ *
+ * The checkpoint consists of a fixed-size header followed by three sections:
+ * the OpenQL version that wrote the checkpoint, the CBOR serialization of the
+ * IR tree, and the annotations that the old/new IR conversions depend on. The
+ * header records the size of each section, so a reader can locate them in a
+ * single buffer without parsing anything else. The topology, architecture,
+ * and resource manager objects of the platform are not restored from the
+ * checkpoint; they are taken from the platform of the IR that the checkpoint
+ * is read into.
+ */
+void write(const Ref &ir, std::ostream &os) {
+    utils::Str sections[NUM_SECTIONS] = {
+        OPENQL_VERSION_STRING,
+        utils::tree::base::serialize(ir),
+        put_annotations(ir)
+    };
+
+    utils::Str header(MAGIC, sizeof(MAGIC));
+    put_uint(header, FORMAT_VERSION);
+    for (const auto &section : sections) {
+        put_uint(header, section.size());
+    }
+    QL_ASSERT(header.size() == HEADER_SIZE);
+
+    os.write(header.data(), header.size());
+    for (const auto &section : sections) {
+        os.write(section.data(), section.size());
+    }
+}
+
+/**
+ * Writes a binary checkpoint of the complete IR to the given file. See
+ * write(const Ref&, std::ostream&) for details.
+ */
+void write_file(const Ref &ir, const utils::Str &fname) {
+    utils::OutFile file{fname, true};
+    write(ir, file.unwrap());
+    file.close();
+}
+
+/**
+ * Replaces the platform and program trees of the given IR with those stored
+ * in the given checkpoint data. The IR must already contain a platform built
+ * from the same platform configuration as the one the checkpoint was written
+ * for; its topology, architecture, resource manager, and annotations are
+ * carried over to the loaded platform. fname is only used for error messages.
+ *
+ * The CBOR reader of the tree library only accepts a complete string, so this
+ * copies the tree section out of the given data. Use the overload that takes
+ * ownership of the data to avoid that.
+ */
+void read(
+    const Ref &ir,
+    const utils::Str &data,
+    const utils::Str &fname
+) {
+    utils::UInt section_begin[NUM_SECTIONS];
+    utils::UInt section_end[NUM_SECTIONS];
+    locate_sections(data, fname, section_begin, section_end);
+    Cursor annotations{data, section_begin[2], section_end[2], fname};
+    load(
+        ir,
+        data.substr(section_begin[1], section_end[1] - section_begin[1]),
+        annotations,
+        fname
+    );
+}
+
+/**
+ * Same as read(), but takes ownership of the checkpoint data. Instead of
+ * copying the tree section, the data is trimmed down to it in place, so the
+ * checkpoint is never held in memory twice.
+ */
+void read(
+    const Ref &ir,
+    utils::Str &&data,
+    const utils::Str &fname
+) {
+    utils::UInt section_begin[NUM_SECTIONS];
+    utils::UInt section_end[NUM_SECTIONS];
+    locate_sections(data, fname, section_begin, section_end);
+
+    // The annotation section is small, so it is simply copied out before the
+    // data is trimmed.
+    auto annotation_data = data.substr(section_begin[2], section_end[2] - section_begin[2]);
+    Cursor annotations{annotation_data, 0, annotation_data.size(), fname};
+
+    // Trim the data down to the tree section, back first such that the front
+    // erase moves as little as possible.
+    data.erase(section_end[1]);
+    data.erase(0, section_begin[1]);
+    load(ir, data, annotations, fname);
+
+}
+
+/**
+ * Same as read(), but reads the checkpoint from the given file.
+ */
+void read_file(const Ref &ir, const utils::Str &fname) {
+    read(ir, utils::InFile(fname, true).read(), fname);
+}
+
+} // namespace checkpoint
+} // namespace ir
+} // namespace ql
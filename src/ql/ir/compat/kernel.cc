@@ -524,9 +524,11 @@ Bool Kernel::add_default_gate_if_available(
 
 // if a specialized custom gate ("e.g. cz q0,q4") is available, add it to circuit and return true
 // if a parameterized custom gate ("e.g. cz") is available, add it to circuit and return true
+// lookup is the platform's gate lookup entry for gname
 //
 // note that there is no check for the found gate being a composite gate
 Bool Kernel::add_custom_gate_if_available(
+    const GateLookup &lookup,
     const Str &gname,
     const Vec<UInt> &qubits,
     const Vec<UInt> &cregs,
@@ -541,30 +543,21 @@ Bool Kernel::add_custom_gate_if_available(
         return false;   // return, so a default gate will be attempted
     }
 #endif
-    // construct canonical name
-    Str instr = "";
-    for (auto qubit : qubits) {
-        if (!instr.empty()) {
-            instr += ",";
-        }
-        instr += "q" + to_string(qubit);
-    }
-    instr = gname + " " + instr;
-
     // first check if a specialized custom gate is available
-    // a specialized custom gate is of the form: "cz q0 q3"
-    // QL_DOUT("is specialized custom gate available for for instr " << instr);
-    auto it = platform->instruction_map.find(instr);
-    if (it == platform->instruction_map.end()) {
-        // QL_DOUT("is parameterized custom gate available for gate " << gname);
-        it = platform->instruction_map.find(gname);
-    }
-    if (it == platform->instruction_map.end()) {
+    // a specialized custom gate is of the form: "cz q0,q3"
+    // if not, check if a parameterized custom gate is available
+    const CustomGateRef *custom_gate;
+    auto it = lookup.specialized.find(qubits);
+    if (it != lookup.specialized.end()) {
+        custom_gate = &it->second;
+    } else if (!lookup.generic.empty()) {
+        custom_gate = &lookup.generic;
+    } else {
         QL_DOUT("custom gate not added for " << gname);
         return false;
     }
 
-    auto g = GateRef::make<gate_types::Custom>(*(it->second));
+    auto g = GateRef::make<gate_types::Custom>(**custom_gate);
     g->operands.clear();
     for (auto qubit : qubits) {
         g->operands.push_back(qubit);
@@ -590,24 +583,59 @@ Bool Kernel::add_custom_gate_if_available(
     return true;
 }
 
-// FIXME: move to class composite_gate?
-// return the subinstructions of a composite gate
-// while doing, test whether the subinstructions have a definition (so they cannot be specialized or default ones!)
-void Kernel::get_decomposed_ins(
-    const gate_types::Composite &gate,
-    Vec<Str> &sub_instructions
-) const {
-    auto &sub_gates = gate.gs;
-    QL_DOUT("composite ins: " << gate.name);
-    for (auto &agate : sub_gates) {
-        const Str &sub_ins = agate->name;
-        QL_DOUT("  sub ins: " << sub_ins);
-        auto it = platform->instruction_map.find(sub_ins);
-        if (it != platform->instruction_map.end()) {
-            // QL_DOUT("  sub ins found in instruction_map: " << sub_ins);
-            sub_instructions.push_back(sub_ins);
+// add the subinstructions of a pre-parsed decomposition rule to the circuit, each as a custom gate (or a default gate);
+// for a parameterized rule, the operands of the subinstructions are indices into all_qubits, otherwise they are the qubits
+void Kernel::add_decomposition(
+    const GateLookup::Decomposition &decomposition,
+    Bool parameterized,
+    const Vec<UInt> &all_qubits,
+    const Vec<UInt> &cregs,
+    const Vec<UInt> &bregs,
+    ConditionType gcond,
+    const Vec<UInt> &gcondregs
+) {
+    if (!decomposition.error.empty()) {
+        QL_USER_ERROR(decomposition.error);
+    }
+    Vec<UInt> this_gate_qubits;
+    for (const auto &sub : decomposition.sub_gates) {
+        QL_DOUT("Adding sub ins: " << sub.name << " of composite " << decomposition.key);
+        if (parameterized) {
+            this_gate_qubits.clear();
+            for (auto qubit_idx : sub.operands) {
+                if (qubit_idx >= all_qubits.size()) {
+                    QL_FATAL("Illegal qubit parameter index " << qubit_idx
+                                                              << " exceeds actual number of parameters given (" << all_qubits.size()
+                                                              << ") while adding sub ins '" << sub.name
+                                                              << "' in parameterized instruction '" << decomposition.key << "'");
+                }
+                this_gate_qubits.push_back(all_qubits[qubit_idx]);
+            }
         } else {
-            QL_ICE("gate decomposition not available for '" << sub_ins << "' in the target platform");
+            this_gate_qubits = sub.operands;
+        }
+        QL_DOUT("actual qubits of this gate: " << this_gate_qubits);
+
+        // custom gate check
+        // when found, custom_added is true, and the expanded subinstruction was added to the circuit
+        Bool custom_added = add_custom_gate_if_available(*sub.lookup, sub.name, this_gate_qubits, cregs, 0, 0.0, bregs, gcond, gcondregs);
+        if (!custom_added) {
+            if (com::options::global["use_default_gates"].as_bool()) {
+                // default gate check
+                QL_DOUT("adding default gate for " << sub.name);
+                Bool default_available = add_default_gate_if_available(sub.name, this_gate_qubits, cregs, 0, 0.0, bregs, gcond, gcondregs);
+                if (default_available) {
+                    if (parameterized) {
+                        QL_WOUT("added default gate '" << sub.name << "' with qubits " << this_gate_qubits);
+                    } else {
+                        QL_DOUT("added default gate '" << sub.name << "' with qubits " << this_gate_qubits); // // NB: changed WOUT to DOUT, since this is common for 'barrier', spamming log
+                    }
+                } else {
+                    QL_USER_ERROR("unknown gate '" << sub.name << "' with qubits " << this_gate_qubits);
+                }
+            } else {
+                QL_USER_ERROR("unknown gate '" << sub.name << "' with qubits " << this_gate_qubits);
+            }
         }
     }
 }
@@ -619,6 +647,7 @@ void Kernel::get_decomposed_ins(
 //
 // add specialized decomposed gate, example JSON definition: "cl_14 q1": ["rx90 %0", "rym90 %0", "rxm90 %0"]
 Bool Kernel::add_spec_decomposed_gate_if_available(
+    const GateLookup &lookup,
     const Str &gate_name,
     const Vec<UInt> &all_qubits,
     const Vec<UInt> &cregs,
@@ -626,88 +655,30 @@ Bool Kernel::add_spec_decomposed_gate_if_available(
     ConditionType gcond,
     const Vec<UInt> &gcondregs
 ) {
-    Bool added = false;
-    QL_DOUT("Checking if specialized decomposition is available for " << gate_name);
+    QL_DOUT("Checking if specialized decomposition is available for " << gate_name << " with qubits " << all_qubits);
 
-    // construct canonical name
-    Str instr_parameterized = "";
-    for (auto qubit : all_qubits) {
-        if (!instr_parameterized.empty()) {
-            instr_parameterized += ",";
-        }
-        instr_parameterized += "q" + to_string(qubit);
+    // find the specialized gate
+    auto it = lookup.specialized.find(all_qubits);
+    if (it == lookup.specialized.end()) {
+        QL_DOUT("composite gate not found for " << gate_name << " with qubits " << all_qubits);
+        return false;
     }
-    instr_parameterized = gate_name + " " + instr_parameterized;
-    QL_DOUT("specialized instruction name: " << instr_parameterized);
-
-    // find the name
-    auto it = platform->instruction_map.find(instr_parameterized);
-    if (it != platform->instruction_map.end()) {
-        // check gate type
-        QL_DOUT("specialized composite gate found for " << instr_parameterized);
-        if (it->second->type() == GateType::COMPOSITE) {
-            QL_DOUT("gate type is composite gate type " << instr_parameterized);
-        } else {
-            QL_DOUT("not a composite gate type " << instr_parameterized);
-            return false;
-        }
-        auto gptr = it->second.as<gate_types::Composite>();
-        if (gptr.empty()) {
-            QL_DOUT("but its gate pointer is empty, not a composite gate type");
-            return false;
-        }
-
-        // perform decomposition
-        Vec<Str> sub_instructions;
-        get_decomposed_ins(*gptr, sub_instructions);
-        for (auto &sub_ins : sub_instructions) {
-            // extract name and qubits
-            QL_DOUT("Adding sub ins: " << sub_ins << " of composite " << instr_parameterized);
-            std::replace(sub_ins.begin(), sub_ins.end(), ',', ' ');    // FIXME: perform all conversions in sanitize_instruction_name()
-            QL_DOUT(" after comma removal, sub ins: " << sub_ins);
-            std::istringstream iss(sub_ins);
-
-            Vec<Str> tokens{
-                std::istream_iterator<Str>{iss},
-                std::istream_iterator<Str>{}
-            };
-
-            Vec<UInt> this_gate_qubits;
-            Str &sub_ins_name = tokens[0];
-
-            for (UInt i = 1; i < tokens.size(); i++) {
-                QL_DOUT("tokens[i] : " << tokens[i]);
-                auto sub_str_token = tokens[i].substr(1);
-                QL_DOUT("sub_str_token[i] : " << sub_str_token);
-                this_gate_qubits.push_back(stoi(tokens[i].substr(1)));
-            }
-
-            QL_DOUT("actual qubits of this gate:" << this_gate_qubits);
 
-            // custom gate check
-            // when found, custom_added is true, and the expanded subinstruction was added to the circuit
-            Bool custom_added = add_custom_gate_if_available(sub_ins_name, this_gate_qubits, cregs, 0, 0.0, bregs, gcond, gcondregs);
-            if (!custom_added) {
-                if (com::options::get("use_default_gates") == "yes") {
-                    // default gate check
-                    QL_DOUT("adding default gate for " << sub_ins_name);
-                    Bool default_available = add_default_gate_if_available(sub_ins_name, this_gate_qubits, cregs, 0, 0.0, bregs, gcond, gcondregs);
-                    if (default_available) {
-                        QL_DOUT("added default gate '" << sub_ins_name << "' with qubits " << this_gate_qubits); // // NB: changed WOUT to DOUT, since this is common for 'barrier', spamming log
-                    } else {
-                        QL_USER_ERROR("unknown gate '" << sub_ins_name << "' with qubits " << this_gate_qubits);
-                    }
-                } else {
-                    QL_USER_ERROR("unknown gate '" << sub_ins_name << "' with qubits " << this_gate_qubits);
-                }
-            }
-        }
-        added = true;
-    } else {
-        QL_DOUT("composite gate not found for " << instr_parameterized);
+    // check gate type
+    QL_DOUT("specialized composite gate found for " << gate_name);
+    if (it->second->type() != GateType::COMPOSITE) {
+        QL_DOUT("not a composite gate type " << gate_name);
+        return false;
+    }
+    auto dit = lookup.decompositions.find(it->second.get_ptr().get());
+    if (dit == lookup.decompositions.end()) {
+        QL_DOUT("but its gate pointer is empty, not a composite gate type");
+        return false;
     }
 
-    return added;
+    // perform decomposition
+    add_decomposition(dit->second, false, all_qubits, cregs, bregs, gcond, gcondregs);
+    return true;
 }
 
 // if composite gate: "e.g. cz %0 %1" available, return true;
@@ -717,6 +688,7 @@ Bool Kernel::add_spec_decomposed_gate_if_available(
 //
 // add parameterized decomposed gate, example JSON definition: "cl_14 %0": ["rx90 %0", "rym90 %0", "rxm90 %0"]
 Bool Kernel::add_param_decomposed_gate_if_available(
+    const GateLookup &lookup,
     const Str &gate_name,
     const Vec<UInt> &all_qubits,
     const Vec<UInt> &cregs,
@@ -724,90 +696,28 @@ Bool Kernel::add_param_decomposed_gate_if_available(
     ConditionType gcond,
     const Vec<UInt> &gcondregs
 ) {
-    Bool added = false;
     QL_DOUT("Checking if parameterized composite gate is available for " << gate_name);
 
-    // construct instruction name from gate_name and actual qubit parameters
-    Str instr_parameterized = "";
-    for (UInt i = 0; i < all_qubits.size(); i++) {
-        if (!instr_parameterized.empty()) {
-            instr_parameterized += ",";
-        }
-        instr_parameterized += "%" + to_string(i);
+    // check for composite ins with this number of parameters
+    auto it = lookup.parameterized.find(all_qubits.size());
+    if (it == lookup.parameterized.end()) {
+        QL_DOUT("composite gate not found for " << gate_name << " with " << all_qubits.size() << " parameters");
+        return false;
     }
-    instr_parameterized = gate_name + " " + instr_parameterized;
-    QL_DOUT("parameterized instruction name: " << instr_parameterized);
-
-    // check for composite ins
-    auto it = platform->instruction_map.find(instr_parameterized);
-    if (it != platform->instruction_map.end()) {
-        QL_DOUT("parameterized gate found for " << instr_parameterized);
-        if (it->second->type() == GateType::COMPOSITE) {
-            QL_DOUT("gate type is COMPOSITE for " << instr_parameterized);
-        } else {
-            QL_DOUT("not a composite gate type " << instr_parameterized);
-            return false;
-        }
-        auto gptr = it->second.as<gate_types::Composite>();
-        if (gptr.empty()) {
-            QL_DOUT("is composite but gate pointer is empty, so not a composite gate type");
-            return false;
-        }
-
-        Vec<Str> sub_instructions;
-        get_decomposed_ins(*gptr, sub_instructions);
-        for (auto &sub_ins : sub_instructions) {
-            QL_DOUT("Adding sub ins: " << sub_ins);
-            std::replace( sub_ins.begin(), sub_ins.end(), ',', ' ');
-            QL_DOUT(" after comma removal, sub ins: " << sub_ins);
-
-            // tokenize sub_ins into sub_ins_name and this_gate_qubits
-            // FIXME: similar code in add_spec_decomposed_gate_if_available()
-            std::istringstream iss(sub_ins);
-            Vec<Str> tokens{ std::istream_iterator<Str>{iss},
-                                             std::istream_iterator<Str>{} };
-
-            Vec<UInt> this_gate_qubits;
-            Str & sub_ins_name = tokens[0];
-
-            for (UInt i = 1; i < tokens.size(); i++) {
-                auto sub_str_token = tokens[i].substr(1);   // example: tokens[i] equals "%1" -> sub_str_token equals "1"
-                UInt qubit_idx = stoi(sub_str_token);
-                if (qubit_idx >= all_qubits.size()) {
-                    QL_FATAL("Illegal qubit parameter index " << sub_str_token
-                                                              << " exceeds actual number of parameters given (" << all_qubits.size()
-                                                              << ") while adding sub ins '" << sub_ins
-                                                              << "' in parameterized instruction '" << instr_parameterized << "'");
-                }
-                this_gate_qubits.push_back(all_qubits[qubit_idx]);
-            }
-            QL_DOUT("actual qubits of this gate: " << this_gate_qubits);
-
-            // FIXME: following code block exists several times in this file
-            // custom gate check
-            // when found, custom_added is true, and the expanded subinstruction was added to the circuit
-            Bool custom_added = add_custom_gate_if_available(sub_ins_name, this_gate_qubits, cregs, 0, 0.0, bregs, gcond, gcondregs);
-            if (!custom_added) {
-                if (com::options::get("use_default_gates") == "yes") {
-                    // default gate check
-                    QL_DOUT("adding default gate for " << sub_ins_name);
-                    Bool default_available = add_default_gate_if_available(sub_ins_name, this_gate_qubits, cregs, 0, 0.0, bregs, gcond, gcondregs);
-                    if (default_available) {
-                        QL_WOUT("added default gate '" << sub_ins_name << "' with qubits " << this_gate_qubits);
-                    } else {
-                        QL_USER_ERROR("unknown gate '" << sub_ins_name << "' with qubits " << this_gate_qubits);
-                    }
-                } else {
-                    QL_USER_ERROR("unknown gate '" << sub_ins_name << "' with qubits " << this_gate_qubits);
-                }
-            }
-        }
-        added = true;
-        QL_DOUT("added composite gate and subinstrs for " << instr_parameterized);
-    } else {
-        QL_DOUT("composite gate not found for " << instr_parameterized);
+    QL_DOUT("parameterized gate found for " << gate_name);
+    if (it->second->type() != GateType::COMPOSITE) {
+        QL_DOUT("not a composite gate type " << gate_name);
+        return false;
     }
-    return added;
+    auto dit = lookup.decompositions.find(it->second.get_ptr().get());
+    if (dit == lookup.decompositions.end()) {
+        QL_DOUT("is composite but gate pointer is empty, so not a composite gate type");
+        return false;
+    }
+
+    add_decomposition(dit->second, true, all_qubits, cregs, bregs, gcond, gcondregs);
+    QL_DOUT("added composite gate and subinstrs for " << dit->second.key);
+    return true;
 }
 
 void Kernel::gate(const Str &gname, UInt q0) {
@@ -991,17 +901,18 @@ Bool Kernel::gate_nonfatal(
 
     auto gname_lower = to_lower(gname);
     QL_DOUT("Adding gate : " << gname_lower << " with qubits " << qubits);
+    const auto &lookup = platform->get_gate_lookup(gname_lower);
 
     // specialized composite gate check
     QL_DOUT("trying to add specialized composite gate for: " << gname_lower);
-    Bool spec_decom_added = add_spec_decomposed_gate_if_available(gname_lower, qubits, cregs, bregs, gcond, lcondregs);
+    Bool spec_decom_added = add_spec_decomposed_gate_if_available(lookup, gname_lower, qubits, cregs, bregs, gcond, lcondregs);
     if (spec_decom_added) {
         added = true;
         QL_DOUT("specialized decomposed gates added for " << gname_lower);
     } else {
         // parameterized composite gate check
         QL_DOUT("trying to add parameterized composite gate for: " << gname_lower);
-        Bool param_decom_added = add_param_decomposed_gate_if_available(gname_lower, qubits, cregs, bregs, gcond, lcondregs);
+        Bool param_decom_added = add_param_decomposed_gate_if_available(lookup, gname_lower, qubits, cregs, bregs, gcond, lcondregs);
         if (param_decom_added) {
             added = true;
             QL_DOUT("decomposed gates added for " << gname_lower);
@@ -1009,12 +920,12 @@ Bool Kernel::gate_nonfatal(
             // specialized/parameterized custom gate check
             QL_DOUT("adding custom gate for " << gname_lower);
             // when found, custom_added is true, and the gate was added to the circuit
-            Bool custom_added = add_custom_gate_if_available(gname_lower, qubits, cregs, duration, angle, bregs, gcond, lcondregs);
+            Bool custom_added = add_custom_gate_if_available(lookup, gname_lower, qubits, cregs, duration, angle, bregs, gcond, lcondregs);
             if (custom_added) {
                 added = true;
                 QL_DOUT("custom gate added for " << gname_lower);
             } else {
-                if (com::options::get("use_default_gates") == "yes") {
+                if (com::options::global["use_default_gates"].as_bool()) {
                     // default gate check (which is always parameterized)
                     QL_DOUT("adding default gate for " << gname_lower);
 
@@ -4,9 +4,12 @@
 
 #include "ql/ir/compat/platform.h"
 
-#include <regex>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
 #include "ql/config.h"
 #include "ql/utils/filesystem.h"
+#include "ql/com/options.h"
 #include "ql/rmgr/manager.h"
 #include "ql/arch/factory.h"
 
@@ -14,6 +17,31 @@ namespace ql {
 namespace ir {
 namespace compat {
 
+/**
+ * Table of GateLookup entries by gate name, built when the platform is
+ * loaded.
+ */
+struct GateLookupTable {
+
+    /**
+     * The entries, one for each gate name that appears in instruction_map.
+     * References to elements of an unordered_map remain valid when other
+     * elements are inserted, so entries can refer to each other while the
+     * table is being built.
+     */
+    std::unordered_map<utils::Str, GateLookup> entries;
+
+};
+
+/**
+ * Builds the gate lookup entries for all gate names in the given instruction
+ * map. Defined along with Platform::get_gate_lookup() below.
+ */
+static void build_gate_lookups(
+    GateLookupTable &table,
+    const InstructionMap &instruction_map
+);
+
 /**
  * Dumps the documentation for the platform configuration file structure.
  */
@@ -412,18 +440,29 @@ void Platform::dump_docs(std::ostream &os, const utils::Str &line_prefix) {
     )");
 }
 
-static const std::regex trim_pattern("^(\\s)+|(\\s)+$");
-static const std::regex multiple_space_pattern("(\\s)+");
-
 /**
- * Sanitizes the name of an instruction by converting to lower case and removing
- * the unnecessary spaces.
+ * Sanitizes the name of an instruction by converting to lower case, removing
+ * leading and trailing whitespace, replacing all other runs of whitespace with
+ * a single space, and removing whitespace around commas.
  */
-static utils::Str sanitize_instruction_name(utils::Str name) {
-    name = utils::to_lower(name);
-    name = std::regex_replace(name, trim_pattern, "");
-    name = std::regex_replace(name, multiple_space_pattern, " ");
-    return name;
+static utils::Str sanitize_instruction_name(const utils::Str &name) {
+    utils::Str result;
+    result.reserve(name.size());
+    utils::Bool pending_space = false;
+    for (char c : name) {
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            pending_space = !result.empty();
+        } else {
+            if (c == ',') {
+                pending_space = false;
+            } else if (pending_space && result.back() != ',') {
+                result += ' ';
+            }
+            pending_space = false;
+            result += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    return result;
 }
 
 static GateRef load_instruction(
@@ -597,21 +636,28 @@ void Platform::load(
         QL_WOUT("'topology' section is not specified in the hardware config file; a fully-connected topology will be generated");
         topology.emplace(qubit_count, "{}"_json);
     } else {
-        topology.emplace(qubit_count, platform_config["topology"]);
+
+        // The topology path cache filename is relative to the platform JSON
+        // file, if any.
+        auto topology_config = platform_config["topology"];
+        auto it = topology_config.find("path_cache");
+        if (it != topology_config.end() && it->is_string() && !platform_config_fname.empty()) {
+            *it = utils::path_relative_to(utils::dir_name(platform_config_fname), it->get<utils::Str>());
+        }
+        topology.emplace(qubit_count, topology_config);
+
     }
 
     QL_DOUT("compatibility platform load instructions");
 
     // load instructions
     const utils::Json &instructions = platform_config["instructions"];
-    static const std::regex comma_space_pattern("\\s*,\\s*");
 
     for (auto it = instructions.begin(); it != instructions.end(); ++it) {
         utils::Str instr_name = it.key();
         utils::Json attr = *it; //.value();
 
         instr_name = sanitize_instruction_name(instr_name);
-        instr_name = std::regex_replace(instr_name, comma_space_pattern, ",");
 
         // check for duplicate operations
         if (instruction_map.find(instr_name) != instruction_map.end()) {
@@ -647,7 +693,6 @@ void Platform::load(
             QL_DOUT("");
             QL_DOUT("Adding composite instr : " << comp_ins);
             comp_ins = sanitize_instruction_name(comp_ins);
-            comp_ins = std::regex_replace(comp_ins, comma_space_pattern, ",");
             QL_DOUT("Adjusted composite instr : " << comp_ins);
 
             // format in json.instructions:
@@ -682,7 +727,6 @@ void Platform::load(
                 utils::Str sub_ins = sub_instructions[i];
                 QL_DOUT("Adding sub instr: " << sub_ins);
                 sub_ins = sanitize_instruction_name(sub_ins);
-                sub_ins = std::regex_replace(sub_ins, comma_space_pattern, ",");
                 if (instruction_map.find(sub_ins) != instruction_map.end()) {
                     // using existing sub ins, e.g. "x q0" or "x %0"
                     QL_DOUT("using existing sub instr : " << sub_ins);
@@ -714,6 +758,10 @@ void Platform::load(
             instruction_map.set(comp_ins).emplace<gate_types::Composite>(comp_ins, gs);
         }
     }
+    // Build the gate lookup table now that instruction_map is complete, such
+    // that Kernel::gate() can use it without locking.
+    build_gate_lookups(*gate_lookup, instruction_map);
+
     QL_DOUT("compatibility load of configuration from json [DONE]");
 }
 
@@ -724,7 +772,7 @@ Platform::Platform(
     const utils::Str &name,
     const utils::Str &platform_config,
     const utils::Str &compiler_config
-) : name(name) {
+) : name(name), gate_lookup(std::make_shared<GateLookupTable>()) {
 
     arch::Factory arch_factory = {};
 
@@ -760,11 +808,65 @@ Platform::Platform(
     const utils::Str &name,
     const utils::Json &platform_config,
     const utils::Str &compiler_config
-) : name(name) {
+) : name(name), gate_lookup(std::make_shared<GateLookupTable>()) {
     utils::Json platform_config_mut = platform_config;
     load(platform_config_mut, compiler_config);
 }
 
+/**
+ * Returns the contents of the given file for use in a platform cache key, or
+ * an empty string if there is no such file.
+ */
+static utils::Str cache_key_file_contents(const utils::Str &fname) {
+    if (fname.empty() || !utils::is_file(fname)) {
+        return "";
+    }
+    return utils::InFile(fname).read();
+}
+
+/**
+ * Returns the platform built by build_fn. If the platform_cache option is set,
+ * the platform is only built the first time a particular key is seen, and is
+ * then reused for all subsequent calls with that key. The key must therefore
+ * represent everything that build_fn depends on.
+ *
+ * The cached platform itself is never modified. If it specifies its register
+ * counts, nothing can modify it, so it is returned as is. Otherwise, kernels
+ * and programs increase its register counts as needed, so each call returns a
+ * copy of it. The copy shares the gates, architecture, and gate lookup table,
+ * so it is still much cheaper than loading the configuration.
+ */
+static PlatformRef build_cached(
+    const std::function<utils::Str()> &key_fn,
+    const std::function<PlatformRef()> &build_fn
+) {
+    if (!com::options::global["platform_cache"].as_bool()) {
+        return build_fn();
+    }
+    static utils::Map<utils::Str, PlatformRef> cache;
+    static std::mutex mutex;
+    auto key = key_fn();
+    PlatformRef cached;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            QL_DOUT("using cached platform '" << it->second->name << "'");
+            cached = it->second;
+        } else {
+            cached = build_fn();
+            cache.set(key) = cached;
+        }
+    }
+    if (!cached->compat_implicit_creg_count && !cached->compat_implicit_breg_count) {
+        return cached;
+    }
+    PlatformRef platform;
+    platform.set(std::make_shared<Platform>(*cached));
+    platform->cache_template = cached.get_ptr().get();
+    return platform;
+}
+
 /**
  * Constructs a platform from the given configuration filename.
  */
@@ -773,10 +875,19 @@ PlatformRef Platform::build(
     const utils::Str &platform_config,
     const utils::Str &compiler_config
 ) {
-    PlatformRef ref;
-    ref.set(std::shared_ptr<Platform>(new Platform(name, platform_config, compiler_config)));
-    ref->architecture->post_process_platform(ref);
-    return ref;
+    return build_cached(
+        [&]() {
+            return utils::Str("file") + '\0' + name + '\0'
+                + platform_config + '\0' + cache_key_file_contents(platform_config) + '\0'
+                + compiler_config + '\0' + cache_key_file_contents(compiler_config);
+        },
+        [&]() {
+            PlatformRef ref;
+            ref.set(std::shared_ptr<Platform>(new Platform(name, platform_config, compiler_config)));
+            ref->architecture->post_process_platform(ref);
+            return ref;
+        }
+    );
 }
 
 /**
@@ -787,10 +898,19 @@ PlatformRef Platform::build(
     const utils::Json &platform_config,
     const utils::Str &compiler_config
 ) {
-    PlatformRef ref;
-    ref.set(std::shared_ptr<Platform>(new Platform(name, platform_config, compiler_config)));
-    ref->architecture->post_process_platform(ref);
-    return ref;
+    return build_cached(
+        [&]() {
+            return utils::Str("json") + '\0' + name + '\0'
+                + platform_config.dump() + '\0'
+                + compiler_config + '\0' + cache_key_file_contents(compiler_config);
+        },
+        [&]() {
+            PlatformRef ref;
+            ref.set(std::shared_ptr<Platform>(new Platform(name, platform_config, compiler_config)));
+            ref->architecture->post_process_platform(ref);
+            return ref;
+        }
+    );
 }
 
 /**
@@ -837,6 +957,228 @@ utils::UInt Platform::time_to_cycles(utils::Real time_ns) const {
     return ceil(time_ns / cycle_time);
 }
 
+/**
+ * Parses the operand number of a sub-instruction operand such as "%1" or
+ * "q3", skipping the first character without looking at it, as the legacy
+ * implementation did. Returns false if there are no digits.
+ */
+static utils::Bool parse_sub_gate_operand(const utils::Str &token, utils::UInt &value) {
+    value = 0;
+    utils::UInt pos = 1;
+    while (pos < token.size() && token[pos] >= '0' && token[pos] <= '9') {
+        value = value * 10 + (token[pos] - '0');
+        pos++;
+    }
+    return pos > 1;
+}
+
+/**
+ * Splits the given string into tokens separated by any of the given
+ * separator characters, dropping empty tokens if skip_empty is set.
+ */
+static utils::Vec<utils::Str> split_tokens(
+    const utils::Str &str,
+    utils::Bool (*is_separator)(char),
+    utils::Bool skip_empty
+) {
+    utils::Vec<utils::Str> tokens;
+    utils::Str token;
+    for (char c : str) {
+        if (is_separator(c)) {
+            if (!skip_empty || !token.empty()) {
+                tokens.push_back(std::move(token));
+            }
+            token.clear();
+        } else {
+            token += c;
+        }
+    }
+    if (!skip_empty || !token.empty()) {
+        tokens.push_back(std::move(token));
+    }
+    return tokens;
+}
+
+/**
+ * Separator predicate for the operand lists of instruction_map keys.
+ */
+static utils::Bool is_comma(char c) {
+    return c == ',';
+}
+
+/**
+ * Separator predicate for the sub-instructions of decomposition rules, which
+ * may separate operands with commas and/or whitespace.
+ */
+static utils::Bool is_comma_or_space(char c) {
+    return c == ',' || std::isspace(static_cast<unsigned char>(c));
+}
+
+/**
+ * Parses the operands of an instruction_map key, i.e. the part after the
+ * gate name and a space, as a specialized gate's qubits. This only succeeds
+ * if Kernel::gate() would produce exactly the same key for those qubits.
+ */
+static utils::Bool parse_specialized_operands(
+    const utils::Str &operands,
+    utils::Vec<utils::UInt> &qubits
+) {
+    qubits.clear();
+    if (operands.empty()) {
+        return true;
+    }
+    for (const auto &token : split_tokens(operands, is_comma, false)) {
+        utils::UInt qubit;
+        if (
+            token.size() < 2 || token[0] != 'q' || !parse_sub_gate_operand(token, qubit)
+            || "q" + utils::to_string(qubit) != token
+        ) {
+            return false;
+        }
+        qubits.push_back(qubit);
+    }
+    return true;
+}
+
+/**
+ * Parses the operands of an instruction_map key, i.e. the part after the
+ * gate name and a space, as a parameterized gate's operand count. This only
+ * succeeds if the operands are exactly "%0,%1,...", as generated by
+ * Kernel::gate() for that number of operands.
+ */
+static utils::Bool parse_parameterized_operands(
+    const utils::Str &operands,
+    utils::UInt &count
+) {
+    count = 0;
+    if (operands.empty()) {
+        return true;
+    }
+    for (const auto &token : split_tokens(operands, is_comma, false)) {
+        if (token != "%" + utils::to_string(count)) {
+            return false;
+        }
+        count++;
+    }
+    return true;
+}
+
+/**
+ * Builds (if needed) and returns the gate lookup entry for the given name.
+ */
+static const GateLookup &build_gate_lookup(
+    GateLookupTable &table,
+    const InstructionMap &instruction_map,
+    const utils::Str &name
+) {
+    auto found = table.entries.find(name);
+    if (found != table.entries.end()) {
+        return found->second;
+    }
+
+    // Insert the entry before filling it, so a decomposition rule that refers
+    // to its own gate name doesn't recurse indefinitely.
+    auto &lookup = table.entries[name];
+
+    // The parameterized custom gate.
+    auto it = instruction_map.find(name);
+    if (it != instruction_map.end()) {
+        lookup.generic = it->second;
+    }
+
+    // Specialized custom gates and specialized or parameterized decomposition
+    // rules all have keys consisting of the name, a space, and the operands.
+    utils::Str prefix = name + " ";
+    for (it = instruction_map.lower_bound(prefix); it != instruction_map.end(); ++it) {
+        if (!utils::starts_with(it->first, prefix)) {
+            break;
+        }
+        auto operands = it->first.substr(prefix.size());
+        utils::Bool used = false;
+        utils::Vec<utils::UInt> qubits;
+        if (parse_specialized_operands(operands, qubits)) {
+            lookup.specialized.set(qubits) = it->second;
+            used = true;
+        }
+        utils::UInt count;
+        if (parse_parameterized_operands(operands, count)) {
+            lookup.parameterized.set(count) = it->second;
+            used = true;
+        }
+        if (!used || it->second->type() != GateType::COMPOSITE) {
+            continue;
+        }
+        auto composite = it->second.as<gate_types::Composite>();
+        if (composite.empty()) {
+            continue;
+        }
+
+        // Pre-parse the decomposition rule.
+        auto &decomposition = lookup.decompositions.set(it->second.get_ptr().get());
+        decomposition.key = it->first;
+        for (const auto &sub_gate : composite->gs) {
+            const auto &sub_ins = sub_gate->name;
+            if (instruction_map.find(sub_ins) == instruction_map.end()) {
+                QL_ICE("gate decomposition not available for '" << sub_ins << "' in the target platform");
+            }
+            auto tokens = split_tokens(sub_ins, is_comma_or_space, true);
+            if (tokens.empty()) {
+                decomposition.error = "empty sub-instruction in decomposition rule '" + it->first + "'";
+                break;
+            }
+            GateLookup::SubGate sub;
+            sub.name = tokens[0];
+            for (utils::UInt i = 1; i < tokens.size(); i++) {
+                utils::UInt operand;
+                if (!parse_sub_gate_operand(tokens[i], operand)) {
+                    decomposition.error = "malformed operand '" + tokens[i] + "' of sub-instruction '"
+                        + sub_ins + "' in decomposition rule '" + it->first + "'";
+                    break;
+                }
+                sub.operands.push_back(operand);
+            }
+            if (!decomposition.error.empty()) {
+                break;
+            }
+            sub.lookup = &build_gate_lookup(table, instruction_map, sub.name);
+            decomposition.sub_gates.push_back(std::move(sub));
+        }
+
+    }
+
+    return lookup;
+}
+
+/**
+ * Builds the gate lookup entries for all gate names in the given instruction
+ * map.
+ */
+static void build_gate_lookups(
+    GateLookupTable &table,
+    const InstructionMap &instruction_map
+) {
+    for (const auto &it : instruction_map) {
+        build_gate_lookup(table, instruction_map, it.first.substr(0, it.first.find(' ')));
+    }
+}
+
+/**
+ * Returns the custom gates and decomposition rules that apply to gates
+ * with the given (sanitized) name. The entries are built from
+ * instruction_map when the platform is loaded, so instruction_map must not
+ * be modified afterwards. For names that do not appear in instruction_map, an
+ * empty entry is returned. The returned reference remains valid for the
+ * lifetime of the platform. Thread-safe, and does not lock.
+ */
+const GateLookup &Platform::get_gate_lookup(const utils::Str &name) const {
+    static const GateLookup EMPTY{};
+    auto it = gate_lookup->entries.find(name);
+    if (it == gate_lookup->entries.end()) {
+        return EMPTY;
+    }
+    return it->second;
+}
+
 } // namespace compat
 } // namespace ir
 } // namespace ql
@@ -0,0 +1,177 @@
+#include <random>
+
+#include "ql/utils/str.h"
+#include "ql/utils/vec.h"
+#include "ql/utils/pair.h"
+#include "ql/utils/json.h"
+#include "ql/ir/compat/platform.h"
+#include "ql/ir/compat/kernel.h"
+
+using namespace ql;
+using namespace ql::utils;
+using namespace ql::ir::compat;
+
+/**
+ * Returns a platform configuration with the given custom instructions and
+ * decomposition rules.
+ */
+static Json make_config(
+    const Vec<Str> &instructions,
+    const Vec<Pair<Str, Vec<Str>>> &decompositions = {}
+) {
+    Json config;
+    config["eqasm_compiler"] = "none";
+    config["hardware_settings"]["qubit_number"] = 4;
+    config["hardware_settings"]["cycle_time"] = 20;
+    config["instructions"] = Json::object();
+    for (const auto &name : instructions) {
+        config["instructions"][name]["duration"] = 20;
+    }
+    config["gate_decomposition"] = Json::object();
+    for (const auto &decomposition : decompositions) {
+        auto &rule = config["gate_decomposition"][decomposition.first] = Json::array();
+        for (const auto &sub_instruction : decomposition.second) {
+            rule.push_back(sub_instruction);
+        }
+    }
+    return config;
+}
+
+/**
+ * Adds the given gate to a new kernel, and returns the names of the gates
+ * that end up in it.
+ */
+static Vec<Str> gate_names(const PlatformRef &platform, const Str &name, const Vec<UInt> &qubits) {
+    auto kernel = make<Kernel>("kernel", platform, 4);
+    kernel->gate(name, qubits);
+    Vec<Str> names;
+    for (const auto &gate : kernel->gates) {
+        names.push_back(gate->name);
+    }
+    return names;
+}
+
+/**
+ * Joins the given operands with the given prefix the way Kernel::gate() built
+ * instruction_map keys before the lookup table existed.
+ */
+static Str make_key(const Str &name, const Str &prefix, const Vec<UInt> &operands) {
+    Str key = name + " ";
+    for (UInt i = 0; i < operands.size(); i++) {
+        if (i) key += ",";
+        key += prefix + to_string(operands[i]);
+    }
+    return key;
+}
+
+/**
+ * Checks the lookup entry of each of the given names against looking up the
+ * keys in instruction_map, for all qubit operand lists of up to three qubits.
+ */
+static void check_against_keys(const PlatformRef &platform, const Vec<Str> &names) {
+    const auto &map = platform->instruction_map;
+    auto find = [&map](const Str &key) -> const gate_types::Custom* {
+        auto it = map.find(key);
+        return it == map.end() ? nullptr : it->second.get_ptr().get();
+    };
+    Vec<Vec<UInt>> qubit_lists = {{}};
+    for (UInt length = 1; length <= 3; length++) {
+        for (UInt i = 0; i < (1u << (2 * length)); i++) {
+            Vec<UInt> qubits;
+            for (UInt j = 0; j < length; j++) {
+                qubits.push_back((i >> (2 * j)) & 3);
+            }
+            qubit_lists.push_back(qubits);
+        }
+    }
+    for (const auto &name : names) {
+        const auto &lookup = platform->get_gate_lookup(name);
+        QL_ASSERT(lookup.generic.get_ptr().get() == find(name));
+        for (const auto &qubits : qubit_lists) {
+            auto it = lookup.specialized.find(qubits);
+            auto expected = find(make_key(name, "q", qubits));
+            QL_ASSERT((it == lookup.specialized.end() ? nullptr : it->second.get_ptr().get()) == expected);
+        }
+        for (UInt count = 1; count <= 3; count++) {
+            Vec<UInt> operands;
+            for (UInt i = 0; i < count; i++) {
+                operands.push_back(i);
+            }
+            auto it = lookup.parameterized.find(count);
+            auto expected = find(make_key(name, "%", operands));
+            QL_ASSERT((it == lookup.parameterized.end() ? nullptr : it->second.get_ptr().get()) == expected);
+        }
+    }
+}
+
+int main() {
+    auto platform = Platform::build("gate_lookup", make_config(
+        {"ga", "ga q0", "gb", "gc q0", "gd", "gd q00", "u", "u q2"},
+        {
+            {"ga q1", {"u q2"}},
+            {"gb %0", {"u %0", "gb %0"}},
+            {"gc %0", {"u %0"}},
+            {"ge q1", {"u q2"}},
+            {"ge %0", {"u %0"}},
+            {"gf %1,%0", {"u %0"}},
+            {"gh %0", {"u %x"}}
+        }
+    ));
+
+    // Specialized decomposition rules take precedence over parameterized
+    // ones, which take precedence over specialized custom gates, which take
+    // precedence over the parameterized custom gate.
+    QL_ASSERT_EQ(gate_names(platform, "ga", {1}), (Vec<Str>{"u q2"}));
+    QL_ASSERT_EQ(gate_names(platform, "ga", {0}), (Vec<Str>{"ga q0"}));
+    QL_ASSERT_EQ(gate_names(platform, "ga", {3}), (Vec<Str>{"ga"}));
+    QL_ASSERT_EQ(gate_names(platform, "ge", {1}), (Vec<Str>{"u q2"}));
+    QL_ASSERT_EQ(gate_names(platform, "ge", {3}), (Vec<Str>{"u"}));
+    QL_ASSERT_EQ(gate_names(platform, "gc", {0}), (Vec<Str>{"u"}));
+
+    // Keys must match the operands exactly as Kernel::gate() used to format
+    // them, so "q00" is not qubit 0, and "%1,%0" is not a two-operand rule.
+    QL_ASSERT(platform->get_gate_lookup("gd").specialized.empty());
+    QL_ASSERT_EQ(gate_names(platform, "gd", {0}), (Vec<Str>{"gd"}));
+    QL_ASSERT(platform->get_gate_lookup("gf").parameterized.empty());
+    QL_ASSERT(!make<Kernel>("kernel", platform, 4)->gate_nonfatal("gf", {0, 1}));
+
+    // A rule may refer to its own name, in which case the sub-instruction
+    // resolves to the custom gates of that name rather than to the rule.
+    const auto &gb = platform->get_gate_lookup("gb");
+    QL_ASSERT(gb.decompositions.size() == 1);
+    const auto &gb_subs = gb.decompositions.begin()->second.sub_gates;
+    QL_ASSERT(gb_subs.size() == 2);
+    QL_ASSERT(gb_subs[1].lookup == &gb);
+    QL_ASSERT_EQ(gate_names(platform, "gb", {1}), (Vec<Str>{"u", "gb"}));
+    QL_ASSERT_EQ(gate_names(platform, "gb", {2}), (Vec<Str>{"u q2", "gb"}));
+
+    // A malformed sub-instruction operand only fails when the rule is used.
+    QL_ASSERT(!platform->get_gate_lookup("gh").decompositions.begin()->second.error.empty());
+    QL_ASSERT_RAISES(gate_names(platform, "gh", {0}));
+
+    // Names without any definition get an empty entry.
+    const auto &none = platform->get_gate_lookup("does_not_exist");
+    QL_ASSERT(none.generic.empty() && none.specialized.empty() && none.parameterized.empty());
+
+    // Random keys, with operands that are formatted correctly, have leading
+    // zeros, are out of order, or are separated differently.
+    const Vec<Str> names = {"ra", "rb", "rc"};
+    const Vec<Str> operand_forms = {"q", "q", "q0", "%", "%", "%0", "Q", "r"};
+    const Vec<Str> separators = {",", ",", ", ", " ,", " "};
+    std::mt19937 rng(42);
+    Vec<Str> keys;
+    for (UInt i = 0; i < 200; i++) {
+        auto key = names[rng() % names.size()];
+        auto num_operands = rng() % 4;
+        for (UInt j = 0; j < num_operands; j++) {
+            key += j ? separators[rng() % separators.size()] : " ";
+            auto form = operand_forms[rng() % operand_forms.size()];
+            auto operand = (form[0] == '%' && rng() % 4) ? j : rng() % 4;
+            key += form + to_string(operand);
+        }
+        keys.push_back(key);
+    }
+    check_against_keys(Platform::build("gate_lookup_random", make_config(keys)), names);
+
+    return 0;
+}
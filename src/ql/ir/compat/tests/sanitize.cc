@@ -0,0 +1,91 @@
+#include <random>
+#include <regex>
+
+#include "ql/utils/str.h"
+#include "ql/utils/set.h"
+#include "ql/utils/json.h"
+#include "ql/ir/compat/platform.h"
+
+using namespace ql;
+using namespace ql::utils;
+
+/**
+ * Sanitizes an instruction name the way the platform loader did with regular
+ * expressions, before this was replaced with a single pass over the name.
+ */
+static Str regex_sanitize(const Str &name) {
+    static const std::regex trim_pattern("^(\\s)+|(\\s)+$");
+    static const std::regex multiple_space_pattern("(\\s)+");
+    static const std::regex comma_space_pattern("\\s*,\\s*");
+    Str result = to_lower(name);
+    result = std::regex_replace(result, trim_pattern, "");
+    result = std::regex_replace(result, multiple_space_pattern, " ");
+    result = std::regex_replace(result, comma_space_pattern, ",");
+    return result;
+}
+
+/**
+ * Returns a platform configuration with a custom instruction for each of the
+ * given (unsanitized) names.
+ */
+static Json make_config(const Vec<Str> &names) {
+    Json config;
+    config["eqasm_compiler"] = "none";
+    config["hardware_settings"]["qubit_number"] = 4;
+    config["hardware_settings"]["cycle_time"] = 20;
+    config["instructions"] = Json::object();
+    for (const auto &name : names) {
+        config["instructions"][name]["duration"] = 20;
+    }
+    return config;
+}
+
+/**
+ * Checks that the instruction names in the instruction map of the platform
+ * built from the given names are those that the regular expressions produce.
+ */
+static void check(const Vec<Str> &names) {
+    auto platform = ir::compat::Platform::build("sanitize", make_config(names));
+    Set<Str> expected;
+    for (const auto &name : names) {
+        auto sanitized = regex_sanitize(name);
+        QL_ASSERT(platform->instruction_map.find(sanitized) != platform->instruction_map.end());
+        expected.insert(sanitized);
+    }
+    QL_ASSERT(platform->instruction_map.size() == expected.size());
+}
+
+int main() {
+
+    // Hand-picked cases: case, leading and trailing whitespace, tabs and
+    // newlines, runs of whitespace, and whitespace around commas.
+    check({
+        "X q0",
+        "  Y   Q1  ",
+        "\tz\tq2\t",
+        "cz q0 , q1",
+        "CNOT\tq2,\t\tq3",
+        "swap q0 ,q1",
+        "measure\n q3",
+        "a , , b",
+        "prep_z",
+        " h  ",
+    });
+
+    // Random names over an alphabet of letters, digits, whitespace, and
+    // commas, prefixed with a letter such that they are never empty.
+    const Str alphabet = "aB1 \t\n,%";
+    std::mt19937 rng(42);
+    Vec<Str> names;
+    for (UInt i = 0; i < 500; i++) {
+        Str name = "g";
+        auto length = rng() % 12;
+        for (UInt j = 0; j < length; j++) {
+            name += alphabet[rng() % alphabet.size()];
+        }
+        names.push_back(name);
+    }
+    check(names);
+
+    return 0;
+}
@@ -4,7 +4,10 @@
 
 #include "ql/ir/cqasm/read.h"
 
+#include <algorithm>
 #include "ql/utils/filesystem.h"
+#include "ql/utils/ptr.h"
+#include "ql/utils/thread_pool.h"
 #include "ql/ir/compat/program.h"
 #include "ql/ir/ops.h"
 #include "ql/ir/consistency.h"
@@ -1114,19 +1117,13 @@ static ir::compat::PlatformRef load_platform(const cq::parser::ParseResult &pres
 }
 
 /**
- * Reads a cQASM 1.2 file into the IR. If reading is successful, ir->program is
- * completely replaced. data represents the cQASM file contents, fname specifies
- * the filename if one exists for the purpose of generating better error
- * messages.
+ * Parses the given cQASM file contents without analyzing them, throwing a
+ * user error if parsing fails.
  */
-void read(
-    const Ref &ir,
+static cq::parser::ParseResult parse(
     const utils::Str &data,
-    const utils::Str &fname,
-    const ReadOptions &options
+    const utils::Str &fname
 ) {
-
-    // Start by parsing the file without analysis.
     auto pres = cq::parser::parse_string(data, fname);
     if (!pres.errors.empty()) {
         utils::StrStrm errors;
@@ -1137,17 +1134,22 @@ void read(
         }
         QL_USER_ERROR(errors.str());
     }
+    return pres;
+}
 
-    // If the load_platform option was passed to us, look for the
-    // `pragma @ql.platform(...)` annotation in the AST and build the platform
-    // from it, before even building the analyzer, because we need said platform
-    // to correctly build the analyzer.
-    if (options.load_platform) {
-        ir->platform = ir::convert_old_to_new(load_platform(pres))->platform;
-    }
-
-    // Create an analyzer for files with a version up to cQASM 1.2.
-    cq::analyzer::Analyzer a{"1.2"};
+/**
+ * Registers the functions and mappings for the given platform and options with
+ * the given libqasm analyzer.
+ *
+ * The registered values and functions are shared by everything the analyzer
+ * analyzes, so the functions must never modify their arguments in place; they
+ * may be mappings owned by the analyzer.
+ */
+static void register_platform(
+    cq::analyzer::Analyzer &a,
+    const PlatformRef &platform,
+    const ReadOptions &options
+) {
 
     // Add the default constant-propagation functions and mappings such as true
     // and false.
@@ -1160,31 +1162,34 @@ void read(
     // there is only one integer type in the platform, but when there are
     // different types, for example different register sizes, these typecast
     // will be needed.
-    for (const auto &dt : ir->platform->data_types) {
+    for (const auto &dt : platform->data_types) {
         a.register_function(
             dt->name,
             {make_cq_type(dt)},
             [dt](const cqv::Values &ops) -> cqv::Value {
-                ops[0]->set_annotation<DataTypeLink>(dt);
-                return ops[0];
+                auto val = ops[0].clone();
+                val->set_annotation<DataTypeLink>(dt);
+                return val;
             }
         );
     }
 
     // Also allow qubits to be "cast" to their implicit measurement bit.
+    DataTypeLink bit_type = platform->default_bit_type;
     a.register_function(
-        ir->platform->default_bit_type->name,
-        {make_cq_type(ir->platform->qubits->data_type)},
-        [ir](const cqv::Values &ops) -> cqv::Value {
+        bit_type->name,
+        {make_cq_type(platform->qubits->data_type)},
+        [bit_type](const cqv::Values &ops) -> cqv::Value {
             if (auto qrefs = ops[0]->as_qubit_refs()) {
                 auto brefs = cqt::make<cqv::BitRefs>();
                 brefs->index = qrefs->index;
-                brefs->set_annotation<DataTypeLink>(ir->platform->default_bit_type);
+                brefs->set_annotation<DataTypeLink>(bit_type);
                 return std::move(brefs);
-            } else if (auto fun = ops[0]->as_function()) {
-                fun->return_type = make_cq_type(ir->platform->default_bit_type);
-                ops[0]->set_annotation<DataTypeLink>(ir->platform->default_bit_type);
-                return ops[0];
+            } else if (ops[0]->as_function()) {
+                auto val = ops[0].clone();
+                val->as_function()->return_type = make_cq_type(bit_type);
+                val->set_annotation<DataTypeLink>(bit_type);
+                return val;
             } else {
                 throw cqe::AnalysisError("unexpected argument type");
             }
@@ -1192,8 +1197,8 @@ void read(
     );
 
     // Add registers as default mappings and builtin function calls.
-    for (const auto &obj : ir->platform->objects) {
-        if (ir->platform->qubits.links_to(obj)) {
+    for (const auto &obj : platform->objects) {
+        if (platform->qubits.links_to(obj)) {
 
             // Predefine the q and b registers as well. These will be overridden
             // to the same thing (possibly with a different size) if the cQASM
@@ -1238,8 +1243,9 @@ void read(
     if (!options.operands.empty()) {
         cqty::Types types;
         types.emplace<cqty::Int>();
-        a.register_function("op", types, [options](const cqv::Values &ops) -> cqv::Value {
-            return make_cq_operand_ref(options.operands, ops[0]);
+        auto operands = options.operands;
+        a.register_function("op", types, [operands](const cqv::Values &ops) -> cqv::Value {
+            return make_cq_operand_ref(operands, ops[0]);
         });
     }
 
@@ -1251,7 +1257,7 @@ void read(
     // otherwise be legal in cQASM won't work anymore. For example, if
     // operator+(int, int) is defined here, weird stuff like "qubits 1 + 2"
     // won't work anymore.
-    for (const auto &fun : ir->platform->functions) {
+    for (const auto &fun : platform->functions) {
         cqty::Types cq_types;
         for (const auto &ql_op_type : fun->operand_types) {
             cq_types.add(make_cq_op_type(ql_op_type));
@@ -1267,6 +1273,17 @@ void read(
             return cq_val;
         });
     }
+}
+
+/**
+ * Analyzes the given parse result using the given analyzer, throwing a user
+ * error if analysis fails.
+ */
+static cqt::Maybe<cqs::Program> analyze(
+    cq::analyzer::Analyzer &a,
+    const cq::parser::ParseResult &pres,
+    const utils::Str &fname
+) {
 
     // Analyze the file. Note that we didn't add any instruction or error model
     // types, which disables libqasm's resolver. This lets us completely ignore
@@ -1282,7 +1299,20 @@ void read(
         }
         QL_USER_ERROR(errors.str());
     }
-    auto cq_program = res.root;
+    return res.root;
+
+}
+
+/**
+ * Converts an analyzed cQASM program to an OpenQL program, and uses it to
+ * replace ir->program. Instruction types may be added to the platform in the
+ * process, so this must not be called concurrently for the same platform.
+ */
+static void convert_program(
+    const Ref &ir,
+    const cqt::Maybe<cqs::Program> &cq_program,
+    const ReadOptions &options
+) {
 
     // Make a corresponding OpenQL program node.
     auto ql_program = utils::make<Program>();
@@ -1510,6 +1540,38 @@ void read(
 
 }
 
+/**
+ * Reads a cQASM 1.2 file into the IR. If reading is successful, ir->program is
+ * completely replaced. data represents the cQASM file contents, fname specifies
+ * the filename if one exists for the purpose of generating better error
+ * messages.
+ */
+void read(
+    const Ref &ir,
+    const utils::Str &data,
+    const utils::Str &fname,
+    const ReadOptions &options
+) {
+
+    // Start by parsing the file without analysis.
+    auto pres = parse(data, fname);
+
+    // If the load_platform option was passed to us, look for the
+    // `pragma @ql.platform(...)` annotation in the AST and build the platform
+    // from it, before even building the analyzer, because we need said platform
+    // to correctly build the analyzer.
+    if (options.load_platform) {
+        ir->platform = ir::convert_old_to_new(load_platform(pres))->platform;
+    }
+
+    // Create an analyzer for files with a version up to cQASM 1.2 for this
+    // platform, and use it to analyze and convert the file.
+    cq::analyzer::Analyzer a{"1.2"};
+    register_platform(a, ir->platform, options);
+    convert_program(ir, analyze(a, pres, fname), options);
+
+}
+
 /**
  * Same as read(), but given a file to load, rather than loading from a string.
  */
@@ -1523,6 +1585,187 @@ void read_file(
     read(ir, data, fname, options);
 }
 
+/**
+ * Private state of a Reader.
+ */
+class Reader::Impl {
+public:
+
+    /**
+     * The platform that the reader was built for.
+     */
+    PlatformRef platform;
+
+    /**
+     * The read options that the reader was built with.
+     */
+    ReadOptions options;
+
+    /**
+     * The analyzer, with all the functions and mappings for the platform
+     * registered.
+     */
+    cq::analyzer::Analyzer analyzer;
+
+    /**
+     * Analyzers for the threads of read_files() other than the first, which
+     * uses the analyzer above. Entry i belongs to thread i + 1. The entries
+     * are built on first use and kept for subsequent calls.
+     */
+    utils::Vec<utils::Ptr<cq::analyzer::Analyzer>> thread_analyzers;
+
+    /**
+     * Builds the analyzer for the given platform and options.
+     */
+    Impl(
+        const PlatformRef &platform,
+        const ReadOptions &options
+    ) :
+        platform(platform),
+        options(options),
+        analyzer("1.2")
+    {
+        register_platform(analyzer, platform, options);
+    }
+
+    /**
+     * Returns the analyzer for the given thread of read_files(), building it
+     * if it does not exist yet. thread_analyzers must already have an entry
+     * for the thread, such that threads only ever touch their own entry.
+     */
+    cq::analyzer::Analyzer &get_thread_analyzer(utils::UInt thread) {
+        if (!thread) {
+            return analyzer;
+        }
+        auto &a = thread_analyzers.at(thread - 1);
+        if (!a.has_value()) {
+            a.emplace("1.2");
+            register_platform(*a, platform, options);
+        }
+        return *a;
+    }
+
+    /**
+     * Throws an exception if the given IR does not use the platform that the
+     * reader was built for.
+     */
+    void check_platform(const Ref &ir) const {
+        if (ir->platform.get_ptr() != platform.get_ptr()) {
+            QL_USER_ERROR(
+                "cQASM reader cannot be used for a different platform than the "
+                "one it was built for"
+            );
+        }
+    }
+
+};
+
+/**
+ * Builds a reader for the platform of the given IR. The platform must not be
+ * replaced for as long as the reader is in use. The load_platform option is
+ * not supported, since the platform would differ per file.
+ */
+Reader::Reader(
+    const Ref &ir,
+    const ReadOptions &options
+) {
+    if (options.load_platform) {
+        QL_USER_ERROR(
+            "the load_platform option cannot be used for a reusable cQASM reader"
+        );
+    }
+    impl = std::unique_ptr<Impl>(new Impl(ir->platform, options));
+}
+
+/**
+ * Move constructor.
+ */
+Reader::Reader(Reader &&reader) noexcept = default;
+
+/**
+ * Move assignment.
+ */
+Reader &Reader::operator=(Reader &&reader) noexcept = default;
+
+/**
+ * Destructor.
+ */
+Reader::~Reader() = default;
+
+/**
+ * Reads a cQASM 1.2 file into the given IR, which must use the platform that
+ * the reader was built for. If reading is successful, ir->program is
+ * completely replaced. data represents the cQASM file contents, fname
+ * specifies the filename if one exists for the purpose of generating better
+ * error messages.
+ */
+void Reader::read(
+    const Ref &ir,
+    const utils::Str &data,
+    const utils::Str &fname
+) const {
+    impl->check_platform(ir);
+    convert_program(ir, analyze(impl->analyzer, parse(data, fname), fname), impl->options);
+}
+
+/**
+ * Same as read(), but given a file to load, rather than loading from a string.
+ */
+void Reader::read_file(
+    const Ref &ir,
+    const utils::Str &fname
+) const {
+    read(ir, utils::InFile(fname).read(), fname);
+}
+
+/**
+ * Reads the given list of cQASM 1.2 files, returning a new IR tree for each
+ * of them. The platform node of the returned trees is shared with the IR the
+ * reader was built for. Parsing and analyzing the files is done in parallel
+ * using the given number of threads, where 0 means the number of hardware
+ * threads. Conversion to the IR modifies the shared platform, so it is done
+ * serially, in the order of the given list. The first thread uses the analyzer
+ * of this reader, and the other threads each use an analyzer for the platform
+ * that is built when first needed and kept in the reader for later calls.
+ */
+utils::Vec<Ref> Reader::read_files(
+    const utils::Vec<utils::Str> &fnames,
+    utils::UInt num_threads
+) const {
+
+    // Parse and analyze the files. The analyzer registers values as mappings
+    // that end up in the analyzed trees, so an analyzer is not shared between
+    // threads. Instead, the files are divided over a chunk per thread, each
+    // with its own analyzer. The analyzers are kept in the reader, so building
+    // them is only paid for by the first call that uses that many threads.
+    // This is safe because a Reader may only be used by one thread at a time
+    // (see the class documentation).
+    utils::Vec<cqt::Maybe<cqs::Program>> cq_programs(fnames.size());
+    utils::ThreadPool pool(num_threads);
+    auto num_chunks = std::min<utils::UInt>(pool.get_num_threads(), fnames.size());
+    if (num_chunks > impl->thread_analyzers.size() + 1) {
+        impl->thread_analyzers.resize(num_chunks - 1);
+    }
+    pool.parallel_for(num_chunks, [&](utils::UInt chunk) {
+        auto &a = impl->get_thread_analyzer(chunk);
+        for (utils::UInt i = chunk; i < fnames.size(); i += num_chunks) {
+            const auto &fname = fnames[i];
+            cq_programs[i] = analyze(a, parse(utils::InFile(fname).read(), fname), fname);
+        }
+    });
+
+    // Convert the analyzed programs.
+    utils::Vec<Ref> irs;
+    irs.reserve(fnames.size());
+    for (const auto &cq_program : cq_programs) {
+        auto ir = utils::make<Root>(impl->platform);
+        convert_program(ir, cq_program, impl->options);
+        irs.push_back(ir);
+    }
+
+    return irs;
+}
+
 /**
  * Constructs a platform from the `@ql.platform` annotation in the given cQASM
  * file.
@@ -1533,18 +1776,8 @@ ir::compat::PlatformRef read_platform(
 ) {
 
     // Read the file without analyzing it.
-    auto pres = cq::parser::parse_string(data, fname);
-    if (!pres.errors.empty()) {
-        utils::StrStrm errors;
-        errors << "failed to parse " << fname << " for the following reasons:";
-        for (const auto &error : pres.errors) {
-            QL_EOUT(error);
-            errors << "\n  " << error;
-        }
-        QL_USER_ERROR(errors.str());
-    }
+    return load_platform(parse(data, fname));
 
-    return load_platform(pres);
 }
 
 /**
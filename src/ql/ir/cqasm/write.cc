@@ -57,6 +57,42 @@ protected:
      */
     utils::UInt precedence = 0;
 
+    /**
+     * Stream manipulator that writes the indentation at the start of a line
+     * directly to the stream, returned by sl().
+     */
+    struct LineStart {
+        utils::Int indent;
+
+        friend std::ostream &operator<<(std::ostream &os, const LineStart &ls) {
+            static const char SPACES[] = "                                ";
+            auto remain = ls.indent * 4;
+            while (remain > 0) {
+                auto count = utils::min<utils::Int>(remain, sizeof(SPACES) - 1);
+                os.write(SPACES, count);
+                remain -= count;
+            }
+            return os;
+        }
+    };
+
+    /**
+     * Stream manipulator that writes the end of a line (and any blank lines
+     * after it) directly to the stream, returned by el().
+     */
+    struct LineEnd {
+        utils::UInt blank;
+        const utils::Str &line_prefix;
+
+        friend std::ostream &operator<<(std::ostream &os, const LineEnd &le) {
+            auto blank = le.blank;
+            do {
+                os << '\n' << le.line_prefix;
+            } while (blank--);
+            return os;
+        }
+    };
+
     /**
      * Starts a Line, after updating the indentation level by adding
      * `indent_delta` to it.
@@ -65,15 +101,10 @@ protected:
      * line of <<. The order in which indent is updated is basically undefined
      * behavior!
      */
-    std::string sl(utils::Int indent_delta = 0) {
-        utils::StrStrm ss;
+    LineStart sl(utils::Int indent_delta = 0) {
         indent += indent_delta;
         if (indent < 0) indent = 0;
-        auto indent_remain = indent;
-        while (indent_remain-- > 0) {
-            ss << "    ";
-        }
-        return ss.str();
+        return {indent};
     }
 
     /**
@@ -84,14 +115,10 @@ protected:
      * line of <<. The order in which indent is updated is basically undefined
      * behavior!
      */
-    std::string el(utils::UInt blank = 0, utils::Int indent_delta = 0) {
-        utils::StrStrm ss;
+    LineEnd el(utils::UInt blank = 0, utils::Int indent_delta = 0) {
         indent += indent_delta;
         if (indent < 0) indent = 0;
-        do {
-            ss << "\n" << line_prefix;
-        } while (blank--);
-        return ss.str();
+        return {blank, line_prefix};
     }
 
     /**
@@ -104,13 +131,19 @@ protected:
      */
     utils::Map<const void*, utils::Str> unique_names;
 
+    /**
+     * The most recently generated name for an empty node.
+     */
+    utils::Str anonymous_name;
+
     /**
      * Generates a unique, valid identifier for the given node based on the
      * given desired name. Calling this multiple times for the same non-empty
      * node is guaranteed to return the same identifier. Calling this multiple
-     * times for empty nodes will yield unique identifiers.
+     * times for empty nodes will yield unique identifiers. The returned
+     * reference remains valid until the next call for an empty node.
      */
-    utils::Str uniquify(
+    const utils::Str &uniquify(
         const utils::One<Node> &node,
         const utils::Str &desired_name
     ) {
@@ -124,28 +157,43 @@ protected:
             }
         }
 
-        // Make a unique, valid identifier based on the desired name.
-        auto name = std::regex_replace(desired_name, std::regex("[^a-zA-Z0-9_]"), "_");
-        if (!std::regex_match(name, IDENTIFIER_RE)) name = "_" + name;
+        // Make a unique, valid identifier based on the desired name, by
+        // replacing invalid characters with underscores and prefixing an
+        // underscore if the name would otherwise be empty or start with a
+        // digit.
+        utils::Str name;
+        name.reserve(desired_name.size() + 1);
+        if (desired_name.empty() || (desired_name[0] >= '0' && desired_name[0] <= '9')) {
+            name += '_';
+        }
+        for (auto c : desired_name) {
+            if (
+                (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                (c >= '0' && c <= '9') || c == '_'
+            ) {
+                name += c;
+            } else {
+                name += '_';
+            }
+        }
         auto unique_name = name;
         utils::UInt unique_idx = 1;
         while (!names.insert(unique_name).second) {
             unique_name = name + "_" + utils::to_string(unique_idx++);
         }
-        QL_ASSERT(std::regex_match(unique_name, IDENTIFIER_RE));
 
         // Store the uniquified name in the map.
         if (key != nullptr) {
-            unique_names.insert({key, unique_name});
+            return unique_names.insert({key, std::move(unique_name)}).first->second;
         }
-
-        return unique_name;
+        anonymous_name = std::move(unique_name);
+        return anonymous_name;
     }
 
     /**
      * Generates a unique, valid identifier.
      */
-    utils::Str uniquify(const utils::Str &desired_name) {
+    const utils::Str &uniquify(const utils::Str &desired_name) {
         return uniquify({}, desired_name);
     }
 
@@ -240,7 +288,7 @@ public:
         }
 
         // Write the variable name(s).
-        auto name = uniquify(obj, obj->name);
+        const auto &name = uniquify(obj, obj->name);
         os << sl() << "var ";
         if (obj->shape.empty()) {
             os << name;
@@ -426,7 +474,7 @@ public:
             const auto &block = node.blocks[idx];
 
             // Write the block header.
-            auto name = uniquify(block, block->name);
+            const auto &name = uniquify(block, block->name);
             os << el();
             os << sl(-1) << "." << name;
             if (options.include_metadata && name != block->name) {
@@ -848,8 +896,7 @@ public:
         // Accurately printing floating-point values is hard. Half the JSON
         // library is dedicated to it. So why not abuse it for printing
         // literals?
-        utils::Json j{r};
-        os << j[0];
+        os << utils::Json(r);
 
     }
 
@@ -949,19 +996,20 @@ public:
     void visit_reference(Reference &node) override {
 
         // Figure out the name and the way to print.
-        utils::Str name;
+        const char *register_name = nullptr;
+        const utils::Str *name = nullptr;
         auto typecast = node.data_type != node.target->data_type;
         if (node.target == ir->platform->qubits) {
             if (node.data_type->as_bit_type()) {
                 typecast = false;
-                name = "b";
+                register_name = "b";
             } else {
-                name = "q";
+                register_name = "q";
             }
         } else if (node.target->as_physical_object()) {
-            name = node.target->name;
+            name = &node.target->name;
         } else {
-            name = uniquify(node.target.as_mut(), node.target->name);
+            name = &uniquify(node.target.as_mut(), node.target->name);
         }
 
         // Print the typecast function if needed.
@@ -970,7 +1018,11 @@ public:
         }
 
         // Print the name.
-        os << name;
+        if (register_name) {
+            os << register_name;
+        } else {
+            os << *name;
+        }
 
         // Handle indices.
         if (!node.indices.empty()) {
@@ -1104,7 +1156,7 @@ public:
         }
 
         precedence = prev_precedence;
-        if (precedence > op_inf->second.precedence) {
+        if (op_inf != OPERATOR_INFO.end() && precedence > op_inf->second.precedence) {
             os << ")";
         }
     }
@@ -5,7 +5,11 @@
 
 #include "ql/ir/old_to_new.h"
 
+#include <mutex>
+#include <tuple>
+#include "ql/com/options.h"
 #include "ql/ir/ops.h"
+#include "ql/ir/checkpoint.h"
 #include "ql/ir/consistency.h"
 #include "ql/ir/cqasm/read.h"
 #include "ql/rmgr/manager.h"
@@ -246,11 +250,10 @@ static void parse_decomposition_rule(
 }
 
 /**
- * Converts the old platform to the new IR structure.
- *
- * See convert_old_to_new(const compat::ProgramRef&) for details.
+ * Converts the old platform to the new IR structure, without using the
+ * platform cache.
  */
-Ref convert_old_to_new(const compat::PlatformRef &old) {
+static Ref convert_platform(const compat::PlatformRef &old) {
     Ref ir;
     ir.emplace();
 
@@ -936,6 +939,66 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
     return ir;
 }
 
+/**
+ * Converts the old platform to the new IR structure.
+ *
+ * If the platform_cache option is set, the conversion is only done once per
+ * cached old platform and register counts. The latter are part of the key
+ * because each copy of a cached platform that doesn't specify them has its
+ * own (see compat::Platform::cache_template). The result is kept as a
+ * checkpoint, and each call then returns a fresh copy loaded from it, so
+ * passes can modify the returned IR without affecting other programs.
+ *
+ * See convert_old_to_new(const compat::ProgramRef&) for details.
+ */
+Ref convert_old_to_new(const compat::PlatformRef &old) {
+    if (!com::options::global["platform_cache"].as_bool()) {
+        return convert_platform(old);
+    }
+
+    // The cached IR is used as a template when loading the checkpoint, as
+    // the topology, architecture, and resources of the platform are taken
+    // from there. It also keeps the old platform alive, so its address can be
+    // used as the key. For copies of a cached platform, the address of the
+    // cached platform is used, which is never destroyed.
+    struct CachedPlatform {
+        Ref ir;
+        utils::Str checkpoint;
+    };
+    using Key = std::tuple<const compat::Platform*, utils::UInt, utils::UInt>;
+    static utils::Map<Key, CachedPlatform> cache;
+    static std::mutex mutex;
+    CachedPlatform *cached;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const compat::Platform *old_ptr = old->cache_template;
+        if (!old_ptr) {
+            old_ptr = old.get_ptr().get();
+        }
+        cached = &cache.set(Key(old_ptr, old->creg_count, old->breg_count));
+        if (cached->ir.empty()) {
+            cached->ir = convert_platform(old);
+            std::ostringstream ss;
+            checkpoint::write(cached->ir, ss);
+            cached->checkpoint = ss.str();
+        } else {
+            QL_DOUT("using cached new-IR platform for '" << old->name << "'");
+        }
+    }
+
+    // Entries are never removed from the cache, so the entry can be used
+    // without holding the lock.
+    Ref ir;
+    ir.emplace();
+    ir->platform = cached->ir->platform;
+    checkpoint::read(ir, cached->checkpoint, "<platform cache>");
+
+    // The checkpoint refers to the old platform that the cached IR was
+    // converted from, which may be a different copy of the cached platform.
+    ir->platform->set_annotation<compat::PlatformRef>(old);
+    return ir;
+}
+
 /**
  * Converts a classical operand to an expression.
  */
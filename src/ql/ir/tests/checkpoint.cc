@@ -0,0 +1,68 @@
+#include "ql/version.h"
+#include "ql/ir/ir.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/ir/cqasm/write.h"
+#include "ql/ir/checkpoint.h"
+
+using namespace ql;
+
+int main() {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+    auto program = utils::make<ir::compat::Program>("test_prog", plat, 7, 32, 10);
+
+    auto kernel = utils::make<ir::compat::Kernel>("first", plat, 7, 32, 10);
+    kernel->x(0);
+    kernel->cnot(0, 1);
+    kernel->classical(ir::compat::ClassicalRegister(1), 0);
+    program->add(kernel);
+
+    kernel = utils::make<ir::compat::Kernel>("loop", plat, 7, 32, 10);
+    kernel->y(2);
+    kernel->measure(2);
+    program->add_for(kernel, 10);
+
+    auto ir = ir::convert_old_to_new(program);
+    ir::cqasm::WriteOptions write_options;
+    write_options.include_statistics = true;
+    auto expected = ir::cqasm::to_string(ir, ir, write_options);
+
+    // Write the checkpoint, clobber the program, and read it back, both from
+    // a buffer that the reader may take over and from one that it must copy
+    // from.
+    utils::StrStrm ss;
+    ir::checkpoint::write(ir, ss);
+    auto data = ss.str();
+    for (auto owned : {true, false}) {
+        ir->program.reset();
+        if (owned) {
+            ir::checkpoint::read(ir, ss.str());
+        } else {
+            ir::checkpoint::read(ir, data);
+        }
+
+        // The program should be unchanged, including the annotations needed
+        // to convert back to the old IR.
+        QL_ASSERT_EQ(ir::cqasm::to_string(ir, ir, write_options), expected);
+        QL_ASSERT(ir->platform->topology.is_populated());
+        QL_ASSERT(ir->platform->resources.is_populated());
+        QL_ASSERT(ir->program->has_annotation<ir::ObjectUsage>());
+        for (const auto &block : ir->program->blocks) {
+            QL_ASSERT(block->has_annotation<ir::KernelName>());
+        }
+    }
+
+    // Checkpoints written by a different version of OpenQL should be
+    // rejected.
+    auto version_pos = data.find(OPENQL_VERSION_STRING);
+    QL_ASSERT(version_pos != utils::Str::npos);
+    auto other_version = data;
+    other_version[version_pos] = '?';
+    QL_ASSERT_RAISES(ir::checkpoint::read(ir, other_version));
+
+    // Corrupt checkpoints should be rejected.
+    QL_ASSERT_RAISES(ir::checkpoint::read(ir, data.substr(0, data.size() / 2)));
+    data[0] = 'X';
+    QL_ASSERT_RAISES(ir::checkpoint::read(ir, data));
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "ql/utils/filesystem.h"
+#include "ql/ir/ir.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/ir/cqasm/read.h"
+#include "ql/ir/cqasm/write.h"
+
+using namespace ql;
+
+int main() {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+    auto ir = ir::convert_old_to_new(plat);
+
+    // Make a few small programs to read.
+    utils::Vec<utils::Str> inputs;
+    for (utils::UInt i = 0; i < 8; i++) {
+        auto program = utils::make<ir::compat::Program>("prog_" + utils::to_string(i), plat, 7, 32, 10);
+        auto kernel = utils::make<ir::compat::Kernel>("kernel", plat, 7, 32, 10);
+        kernel->x(i % 7);
+        kernel->cnot(i % 7, (i + 1) % 7);
+        kernel->measure(i % 7);
+        program->add_for(kernel, i + 1);
+        auto prog_ir = ir::convert_old_to_new(program);
+        inputs.push_back(ir::cqasm::to_string(prog_ir, prog_ir));
+    }
+
+    // Reading with a reader should give the same result as reading with
+    // read(), also when the reader is reused.
+    ir::cqasm::Reader reader(ir);
+    utils::Vec<utils::Str> expected;
+    for (const auto &input : inputs) {
+        auto ref_ir = utils::make<ir::Root>(ir->platform);
+        ir::cqasm::read(ref_ir, input);
+        expected.push_back(ir::cqasm::to_string(ref_ir, ref_ir));
+        auto reader_ir = utils::make<ir::Root>(ir->platform);
+        reader.read(reader_ir, input);
+        QL_ASSERT_EQ(ir::cqasm::to_string(reader_ir, reader_ir), expected.back());
+    }
+
+    // Same for reading a batch of files in parallel.
+    utils::Vec<utils::Str> fnames;
+    for (utils::UInt i = 0; i < inputs.size(); i++) {
+        fnames.push_back("test_output/cqasm_reader_" + utils::to_string(i) + ".cq");
+        utils::OutFile(fnames.back()) << inputs[i];
+    }
+    // Read them several times, with differing numbers of threads, such that
+    // later calls reuse the analyzers built by earlier ones.
+    for (auto num_threads : {4, 4, 2, 8}) {
+        auto irs = reader.read_files(fnames, num_threads);
+        QL_ASSERT_EQ(irs.size(), inputs.size());
+        for (utils::UInt i = 0; i < irs.size(); i++) {
+            QL_ASSERT(irs[i]->platform.get_ptr() == ir->platform.get_ptr());
+            QL_ASSERT_EQ(ir::cqasm::to_string(irs[i], irs[i]), expected[i]);
+        }
+    }
+
+    // The reader must not be used for other platforms.
+    auto other_ir = ir::convert_old_to_new(plat);
+    QL_ASSERT_RAISES(reader.read(other_ir, inputs[0]));
+
+    return 0;
+}
@@ -8,6 +8,8 @@
 
 #include <fstream>
 #include "ql/utils/json.h"
+#include "ql/utils/map.h"
+#include "ql/utils/set.h"
 #include "common.h"
 #include "image.h"
 
@@ -64,15 +66,14 @@ void visualizeInteractionGraph(const ir::compat::ProgramRef &program, const Visu
         image.fill(white);
 
         // Draw the edges between interacting qubits.
-        Vec<Pair<Int, Int>> drawnEdges;
-        // std::vector<std::pair<int, int>> drawnEdges;
+        Set<Pair<Int, Int>> drawnEdges;
         for (const Pair<Qubit, Position2> &qubit : qubitPositions) {
             const Position2 qubitPosition = qubit.second;
             for (const InteractionsWithQubit &interactionsWithQubit : qubit.first.interactions) {
                 if (isEdgeAlreadyDrawn(drawnEdges, qubit.first.qubitIndex, interactionsWithQubit.qubitIndex))
                     continue;
                 
-                drawnEdges.push_back( {qubit.first.qubitIndex, interactionsWithQubit.qubitIndex } );
+                addDrawnEdge(drawnEdges, qubit.first.qubitIndex, interactionsWithQubit.qubitIndex);
 
                 // Draw the edge.
                 const Real theta = interactionsWithQubit.qubitIndex * thetaSpacing;
@@ -136,13 +137,12 @@ void generateAndSaveDOTFile(const Str &output_prefix, const Vec<Qubit> &qubits)
         output << "graph qubit_interaction_graph {\n";
         output << "    node [shape=circle];\n";
 
-        Vec<Pair<Int, Int>> drawnEdges;
-        // std::vector<std::pair<int, int>> drawnEdges;
+        Set<Pair<Int, Int>> drawnEdges;
         for (const Qubit &qubit : qubits) {
             for (const InteractionsWithQubit &target : qubit.interactions) {
                 if (isEdgeAlreadyDrawn(drawnEdges, qubit.qubitIndex, target.qubitIndex))
                     continue;
-                drawnEdges.push_back( {qubit.qubitIndex, target.qubitIndex } );
+                addDrawnEdge(drawnEdges, qubit.qubitIndex, target.qubitIndex);
 
                 output << "    " << qubit.qubitIndex << " -- " << target.qubitIndex << " [label=" << target.amountOfInteractions << "];\n";
             }
@@ -238,6 +238,10 @@ Vec<Qubit> findQubitInteractions(const Vec<GateProperties> &gates, const Int amo
         qubits[qubitIndex] = qubit;
     }
 
+    // Index of the interactions with each other qubit in the interaction list
+    // of each qubit, to avoid searching through the list for every gate.
+    Vec<Map<Int, UInt>> interactionIndices(amountOfQubits);
+
     for (const GateProperties &gate : gates) {
         const Vec<GateOperand> operands = getGateOperands(gate);
         if (operands.size() > 1) {
@@ -255,16 +259,14 @@ Vec<Qubit> findQubitInteractions(const Vec<GateProperties> &gates, const Int amo
                     // Do not add an interaction between a qubit and itself.
                     if (i != j) {
                         Vec<InteractionsWithQubit> &interactions = qubits[qubitIndices[i]].interactions;
+                        Map<Int, UInt> &indices = interactionIndices[qubitIndices[i]];
                         // Find the existing interaction count with the current qubit if it exists.
-                        Bool found = false;
-                        for (InteractionsWithQubit &interactionsWithQubit : interactions) {
-                            if (interactionsWithQubit.qubitIndex == qubitIndices[j]) {
-                                found = true;
-                                interactionsWithQubit.amountOfInteractions++;
-                            }
-                        }
-                        // If the interaction count does not yet exist, add a new one.
-                        if (!found) {
+                        auto it = indices.find(qubitIndices[j]);
+                        if (it != indices.end()) {
+                            interactions[it->second].amountOfInteractions++;
+                        } else {
+                            // If the interaction count does not yet exist, add a new one.
+                            indices.set(qubitIndices[j]) = interactions.size();
                             interactions.push_back( {qubitIndices[j], 1} );
                         }
                     }
@@ -276,15 +278,13 @@ Vec<Qubit> findQubitInteractions(const Vec<GateProperties> &gates, const Int amo
     return qubits;
 }
 
-Bool isEdgeAlreadyDrawn(const Vec<Pair<Int, Int>> &drawnEdges, const Int first, const Int second) {
-    // Check if the edge already exists.
-    for (const Pair<Int, Int> &drawnEdge : drawnEdges) {
-        if ((drawnEdge.first == first && drawnEdge.second == second) || (drawnEdge.first == second && drawnEdge.second == first)) {
-            return true;
-        }
-    }
+Bool isEdgeAlreadyDrawn(const Set<Pair<Int, Int>> &drawnEdges, const Int first, const Int second) {
+    // Check if the edge already exists. Edges are stored with the lowest qubit index first.
+    return drawnEdges.count( {min(first, second), max(first, second)} ) > 0;
+}
 
-    return false;
+void addDrawnEdge(Set<Pair<Int, Int>> &drawnEdges, const Int first, const Int second) {
+    drawnEdges.insert( {min(first, second), max(first, second)} );
 }
 
 void printInteractionList(const Vec<Qubit> &qubits) {
@@ -10,6 +10,7 @@
 #include "ql/utils/str.h"
 #include "ql/utils/pair.h"
 #include "ql/utils/vec.h"
+#include "ql/utils/set.h"
 #include "types.h"
 
 namespace ql {
@@ -40,8 +41,8 @@ utils::Real calculateQubitCircleRadius(utils::Int qubitRadius, const utils::Real
 Position2 calculatePositionOnCircle(utils::Int radius, utils::Real theta, const Position2 &center);
 utils::Vec<Qubit> findQubitInteractions(const utils::Vec<GateProperties> &gates, utils::Int amountOfQubits);
 
-// bool isEdgeAlreadyDrawn(const std::vector<std::pair<int, int>> &drawnEdges, const int first, const int second);
-utils::Bool isEdgeAlreadyDrawn(const utils::Vec<utils::Pair<utils::Int, utils::Int>> &drawnEdges, utils::Int first, utils::Int second);
+utils::Bool isEdgeAlreadyDrawn(const utils::Set<utils::Pair<utils::Int, utils::Int>> &drawnEdges, utils::Int first, utils::Int second);
+void addDrawnEdge(utils::Set<utils::Pair<utils::Int, utils::Int>> &drawnEdges, utils::Int first, utils::Int second);
 
 void printInteractionList(const utils::Vec<Qubit> &qubits);
 
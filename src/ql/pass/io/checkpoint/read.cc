@@ -0,0 +1,70 @@
+/** \file
+ * Defines the IR checkpoint reader pass.
+ */
+
+#include "ql/pass/io/checkpoint/read.h"
+
+#include "ql/ir/checkpoint.h"
+
+namespace ql {
+namespace pass {
+namespace io {
+namespace checkpoint {
+namespace read {
+
+/**
+ * Dumps docs for the IR checkpoint reader.
+ */
+void ReadCheckpointPass::dump_docs(
+    std::ostream &os,
+    const utils::Str &line_prefix
+) const {
+    utils::dump_str(os, line_prefix, R"(
+    This pass completely discards the incoming program and replaces it with
+    the program stored in the given checkpoint file, as written by the
+    `io.checkpoint.Write` pass. The platform is also replaced with the one in
+    the checkpoint, since passes may have added instruction types to it, but
+    the checkpoint must have been written for the same platform configuration
+    as the current one, by the same version of OpenQL. Subsequent passes
+    continue exactly where compilation stopped when the checkpoint was
+    written.
+    )");
+}
+
+/**
+ * Returns a user-friendly type name for this pass.
+ */
+utils::Str ReadCheckpointPass::get_friendly_type() const {
+    return "IR checkpoint reader";
+}
+
+/**
+ * Constructs an IR checkpoint reader.
+ */
+ReadCheckpointPass::ReadCheckpointPass(
+    const utils::Ptr<const pmgr::Factory> &pass_factory,
+    const utils::Str &instance_name,
+    const utils::Str &type_name
+) : pmgr::pass_types::Transformation(pass_factory, instance_name, type_name) {
+    options.add_str(
+        "checkpoint_file",
+        "Checkpoint file to read. Mandatory."
+    );
+}
+
+/**
+ * Runs the IR checkpoint reader.
+ */
+utils::Int ReadCheckpointPass::run(
+    const ir::Ref &ir,
+    const pmgr::pass_types::Context &context
+) const {
+    ir::checkpoint::read_file(ir, options["checkpoint_file"].as_str());
+    return 0;
+}
+
+} // namespace read
+} // namespace checkpoint
+} // namespace io
+} // namespace pass
+} // namespace ql
@@ -0,0 +1,75 @@
+/** \file
+ * Defines the IR checkpoint writer pass.
+ */
+
+#include "ql/pass/io/checkpoint/write.h"
+
+#include "ql/ir/checkpoint.h"
+
+namespace ql {
+namespace pass {
+namespace io {
+namespace checkpoint {
+namespace write {
+
+/**
+ * Dumps docs for the IR checkpoint writer.
+ */
+void WriteCheckpointPass::dump_docs(
+    std::ostream &os,
+    const utils::Str &line_prefix
+) const {
+    utils::dump_str(os, line_prefix, R"(
+    This pass writes the complete IR (platform and program) to a binary
+    checkpoint file. Unlike a cQASM file, a checkpoint represents the IR
+    exactly, and can be loaded again much faster using the `io.checkpoint.Read`
+    pass. This allows compilation to be resumed after an expensive pass, such
+    as mapping, without running the pass again.
+
+    The checkpoint can only be loaded with a platform built from the same
+    platform configuration, and only by the same version of OpenQL that wrote
+    it. It is not intended as an exchange format.
+    )");
+}
+
+/**
+ * Returns a user-friendly type name for this pass.
+ */
+utils::Str WriteCheckpointPass::get_friendly_type() const {
+    return "IR checkpoint writer";
+}
+
+/**
+ * Constructs an IR checkpoint writer.
+ */
+WriteCheckpointPass::WriteCheckpointPass(
+    const utils::Ptr<const pmgr::Factory> &pass_factory,
+    const utils::Str &instance_name,
+    const utils::Str &type_name
+) : pmgr::pass_types::Analysis(pass_factory, instance_name, type_name) {
+    options.add_str(
+        "output_suffix",
+        "Suffix to use for the output filename.",
+        ".qlir"
+    );
+}
+
+/**
+ * Runs the IR checkpoint writer.
+ */
+utils::Int WriteCheckpointPass::run(
+    const ir::Ref &ir,
+    const pmgr::pass_types::Context &context
+) const {
+    ir::checkpoint::write_file(
+        ir,
+        context.output_prefix + options["output_suffix"].as_str()
+    );
+    return 0;
+}
+
+} // namespace write
+} // namespace checkpoint
+} // namespace io
+} // namespace pass
+} // namespace ql
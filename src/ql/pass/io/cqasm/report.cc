@@ -129,7 +129,8 @@ ReportCQasmPass::ReportCQasmPass(
 ) : pmgr::pass_types::Analysis(pass_factory, instance_name, type_name) {
     options.add_str(
         "output_suffix",
-        "Suffix to use for the output filename.",
+        "Suffix to use for the output filename. If it ends in `.gz`, the "
+        "file is gzip-compressed, which requires OpenQL to be built with zlib.",
         ".cq"
     );
     options.add_enum(
@@ -191,7 +192,7 @@ utils::Int ReportCQasmPass::run(
     const ir::Ref &ir,
     const pmgr::pass_types::Context &context
 ) const {
-    utils::OutFile file{context.output_prefix + options["output_suffix"].as_str()};
+    auto filename = context.output_prefix + options["output_suffix"].as_str();
 
     ir::cqasm::WriteOptions write_options;
 
@@ -224,7 +225,14 @@ utils::Int ReportCQasmPass::run(
 
     write_options.include_timing = options["with_timing"].as_bool();
 
-    ir::cqasm::write(ir, write_options, file.unwrap());
+    if (utils::ends_with(filename, ".gz")) {
+        utils::GzOutFile file{filename};
+        ir::cqasm::write(ir, write_options, file.unwrap());
+        file.close();
+    } else {
+        utils::OutFile file{filename};
+        ir::cqasm::write(ir, write_options, file.unwrap());
+    }
 
     return 0;
 }
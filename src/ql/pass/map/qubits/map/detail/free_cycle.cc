@@ -4,6 +4,8 @@
 
 #include "free_cycle.h"
 
+#include <atomic>
+
 // uncomment next line to enable multi-line dumping
 // #define MULTI_LINE_LOG_DEBUG
 
@@ -31,10 +33,26 @@ void FreeCycle::initialize(const ir::compat::PlatformRef &p, const OptionsRef &o
     fcv.clear();
     fcv.resize(nq+nb, 1);   // this 1 implies that cycle of first gate will be 1 and not 0; OpenQL convention!?!?
     QL_DOUT("... about to copy FreeCycle initialize local resource_manager to FreeCycle member rm");
-    rs = rm.build(rmgr::Direction::FORWARD);
+    rs.emplace(rm.build(rmgr::Direction::FORWARD));
     QL_DOUT("... done copy FreeCycle initialize local resource_manager to FreeCycle member rm");
 }
 
+/**
+ * Makes sure that rs is not shared with any other FreeCycle map, cloning
+ * it if necessary, such that it can be modified.
+ */
+void FreeCycle::make_rs_unique() {
+    if (rs.unwrap().use_count() > 1) {
+        rs.emplace(*rs);
+    } else {
+
+        // Synchronize with the release of the last other reference, which may
+        // have happened on another thread.
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+    }
+}
+
 /**
  * Returns the depth of the FreeCycle map. Equals the max of all entries
  * minus the min of all entries not used yet; would be used to compute the
@@ -224,6 +242,7 @@ void FreeCycle::add(const ir::compat::GateRef &g, utils::UInt start_cycle) {
     add_no_rc(g, start_cycle);
 
     if (options->heuristic == Heuristic::BASE_RC || options->heuristic == Heuristic::MIN_EXTEND_RC) {
+        make_rs_unique();
         rs->reserve(start_cycle, g);
     }
 }
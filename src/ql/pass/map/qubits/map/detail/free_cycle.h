@@ -7,7 +7,7 @@
 #include "ql/utils/num.h"
 #include "ql/utils/str.h"
 #include "ql/utils/vec.h"
-#include "ql/utils/opt.h"
+#include "ql/utils/ptr.h"
 #include "ql/ir/compat/compat.h"
 #include "ql/rmgr/manager.h"
 #include "ql/com/map/qubit_mapping.h"
@@ -78,9 +78,20 @@ private:
     utils::Vec<utils::UInt> fcv;
 
     /**
-     * Actual resources occupied by scheduled gates, if resource-aware.
+     * Actual resources occupied by scheduled gates, if resource-aware. Copies
+     * of a FreeCycle map share this state until one of them reserves
+     * resources for a gate, at which point it clones the state (see
+     * make_rs_unique()). This makes copying a FreeCycle map cheap, which
+     * matters because one is copied for every alternative the mapper
+     * considers.
      */
-    utils::Opt<rmgr::State> rs;
+    utils::Ptr<rmgr::State> rs;
+
+    /**
+     * Makes sure that rs is not shared with any other FreeCycle map, cloning
+     * it if necessary, such that it can be modified.
+     */
+    void make_rs_unique();
 
 public:
 
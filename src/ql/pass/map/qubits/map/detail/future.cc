@@ -31,9 +31,21 @@ void Future::set_kernel(const ir::compat::KernelRef &kernel, const utils::Ptr<Sc
     approx_gates_total = kernel->gates.size();
     approx_gates_remaining = approx_gates_total;
     scheduler = sched;
+
+    // Copy the input circuit, such that the kernel's gate list can be used
+    // for output.
+    auto gates = utils::Ptr<utils::Vec<ir::compat::GateRef>>::make();
+    for (const auto &gp : kernel->gates) {
+        gates->push_back(gp);
+    }
+    input_gates = gates.as_const();
+    input_gate_index = 0;
+    completed_indices.clear();
+    num_scheduled_preds.clear();
+    avlist.clear();
+
     if (options->lookahead_mode == LookaheadMode::DISABLED) {
-        input_gatepv = kernel->gates;                           // copy to free original circuit to allow outputing to
-        input_gatepp = input_gatepv.begin();                    // iterator set to start of input circuit copy
+        first_remaining_index = input_gates->size();            // remaining gates are not tracked
     } else {
         scheduler->init(
             kernel,
@@ -43,14 +55,13 @@ void Future::set_kernel(const ir::compat::KernelRef &kernel, const utils::Ptr<Sc
             options->enable_criticality
         );
 
-        // and so also the original circuit can be output to after this
-        for (auto &gp : kernel->gates) {
-            scheduled.set(gp) = false;   // none were scheduled
-            remaining_gates.push_back(gp);
+        // Index the input circuit to keep track of the remaining gates.
+        auto indices = utils::Ptr<utils::Map<ir::compat::GateRef, utils::UInt>>::make();
+        for (utils::UInt i = 0; i < input_gates->size(); i++) {
+            indices->set(input_gates->at(i)) = i;
         }
-        scheduled.set(scheduler->instruction[scheduler->s]) = false;      // also the dummy nodes not
-        scheduled.set(scheduler->instruction[scheduler->t]) = false;
-        avlist.clear();
+        input_gate_indices = indices.as_const();
+        first_remaining_index = 0;
         avlist.push_back(scheduler->s);
         scheduler->set_remaining(rmgr::Direction::FORWARD);          // to know criticality
 
@@ -64,6 +75,13 @@ void Future::set_kernel(const ir::compat::KernelRef &kernel, const utils::Ptr<Sc
             QL_IOUT("writing " << "mapper" << " dependence graph dot file to '" << fname.str() << "' ...");
             utils::OutFile(fname.str()).write(map_dot);
         }
+
+        // Assign the ASAP cycles that the scheduler used to assign one
+        // by one as gates became available. They only depend on the
+        // dependency graph, so they are computed once here, such that the
+        // gates (which are shared by all copies of this Future) aren't
+        // modified during speculation.
+        scheduler->set_cycle(rmgr::Direction::FORWARD);
     }
     QL_DOUT("Future::set_kernel [DONE]");
 }
@@ -76,8 +94,8 @@ void Future::set_kernel(const ir::compat::KernelRef &kernel, const utils::Ptr<Sc
 utils::Bool Future::get_non_quantum_gates(utils::List<ir::compat::GateRef> &nonqlg) const {
     nonqlg.clear();
     if (options->lookahead_mode == LookaheadMode::DISABLED) {
-        ir::compat::GateRef gate = *input_gatepp;
-        if (ir::compat::GateRefs::const_iterator(input_gatepp) != input_gatepv.end()) {
+        if (input_gate_index < input_gates->size()) {
+            const auto &gate = input_gates->at(input_gate_index);
             if (
                 gate->type() == ir::compat::GateType::CLASSICAL
                 || gate->type() == ir::compat::GateType::DUMMY
@@ -105,8 +123,8 @@ utils::Bool Future::get_non_quantum_gates(utils::List<ir::compat::GateRef> &nonq
 utils::Bool Future::get_gates(utils::List<ir::compat::GateRef> &qlg) const {
     qlg.clear();
     if (options->lookahead_mode == LookaheadMode::DISABLED) {
-        if (input_gatepp != input_gatepv.end()) {
-            ir::compat::GateRef gp = *input_gatepp;
+        if (input_gate_index < input_gates->size()) {
+            const auto &gp = input_gates->at(input_gate_index);
             if (gp->operands.size() > 2) {
                 QL_FATAL(" gate: " << gp->qasm() << " has more than 2 operand qubits; please decompose such gates first before mapping.");
             }
@@ -124,6 +142,50 @@ utils::Bool Future::get_gates(utils::List<ir::compat::GateRef> &qlg) const {
     return !qlg.empty();
 }
 
+/**
+ * Inserts the given node into avlist, which is kept ordered by
+ * criticality, most critical first. Nodes with equal criticality are
+ * kept in the order in which they became available.
+ */
+void Future::make_available(lemon::ListDigraph::Node n) {
+    auto it = avlist.begin();
+    for (; it != avlist.end(); ++it) {
+        if (scheduler->criticality_lessthan(*it, n, rmgr::Direction::FORWARD)) {
+            break;
+        }
+    }
+    avlist.insert(it, n);
+}
+
+/**
+ * Takes the given node out of avlist, and makes those successors
+ * available for which all predecessors have now been mapped.
+ */
+void Future::take_available(lemon::ListDigraph::Node n) {
+    const auto &graph = scheduler->graph;
+    avlist.remove(n);
+
+    // Count the arcs from n for each successor. There may be multiple arcs
+    // between the same pair of nodes.
+    for (lemon::ListDigraph::OutArcIt arc(graph, n); arc != lemon::INVALID; ++arc) {
+        num_scheduled_preds.set(graph.target(arc))++;
+    }
+
+    // Successors for which all incoming arcs are now accounted for become
+    // available, in the order of the arcs.
+    for (lemon::ListDigraph::OutArcIt arc(graph, n); arc != lemon::INVALID; ++arc) {
+        auto succ = graph.target(arc);
+        auto it = num_scheduled_preds.find(succ);
+        if (it == num_scheduled_preds.end()) {
+            continue; // already made available via a parallel arc
+        }
+        if (it->second == (utils::UInt)lemon::countInArcs(graph, succ)) {
+            num_scheduled_preds.erase(succ);
+            make_available(succ);
+        }
+    }
+}
+
 /**
  * Indicates that a gate currently in avlist has been mapped, can be
  * taken out of the avlist, and that its successors can be made available.
@@ -135,18 +197,23 @@ void Future::completed_gate(const ir::compat::GateRef &gate) {
         approx_gates_remaining--;
     }
     if (options->lookahead_mode == LookaheadMode::DISABLED) {
-        input_gatepp = std::next(input_gatepp);
+        input_gate_index++;
     } else {
-        scheduler->take_available(scheduler->node.at(gate), avlist, scheduled, rmgr::Direction::FORWARD);
-        
-        std::list<ql::ir::compat::GateRef>::iterator it = remaining_gates.begin();
-        for(auto &i : remaining_gates){
-                if(i==gate){
-                   remaining_gates.erase(it);
-                   break;
+        take_available(scheduler->node.at(gate));
+
+        // Update the set of remaining gates. The SOURCE and SINK gates are not
+        // part of the input circuit.
+        auto it = input_gate_indices->find(gate);
+        if (it != input_gate_indices->end()) {
+            if (it->second == first_remaining_index) {
+                first_remaining_index++;
+                while (completed_indices.erase(first_remaining_index)) {
+                    first_remaining_index++;
                 }
-                it++;
+            } else {
+                completed_indices.insert(it->second);
             }
+        }
     }
 }
 
@@ -163,6 +230,42 @@ ir::compat::GateRef Future::get_most_critical(const utils::List<ir::compat::Gate
     }
 }
 
+/**
+ * Returns the gates that have not been mapped yet, in input order. Only
+ * supported when lookahead is enabled; returns an empty list otherwise.
+ */
+void Future::get_remaining_gates(utils::List<ir::compat::GateRef> &gates) const {
+    gates.clear();
+    for (utils::UInt i = first_remaining_index; i < input_gates->size(); i++) {
+        if (!completed_indices.count(i)) {
+            gates.push_back(input_gates->at(i));
+        }
+    }
+}
+
+/**
+ * Returns the first max_gates gates with more than one operand that have not
+ * been mapped yet, in input order. Unlike get_remaining_gates(), the cost does
+ * not depend on the total number of remaining gates. Only supported when
+ * lookahead is enabled; returns an empty list otherwise.
+ */
+void Future::get_lookahead_gates(
+    utils::List<ir::compat::GateRef> &gates,
+    utils::UInt max_gates
+) const {
+    gates.clear();
+    for (
+        utils::UInt i = first_remaining_index;
+        i < input_gates->size() && gates.size() < max_gates;
+        i++
+    ) {
+        const auto &gate = input_gates->at(i);
+        if (gate->operands.size() > 1 && !completed_indices.count(i)) {
+            gates.push_back(gate);
+        }
+    }
+}
+
 } // namespace detail
 } // namespace map
 } // namespace qubits
@@ -8,6 +8,7 @@
 #include "ql/utils/str.h"
 #include "ql/utils/ptr.h"
 #include "ql/utils/map.h"
+#include "ql/utils/set.h"
 #include "ql/utils/vec.h"
 #include "ql/utils/list.h"
 #include "ql/ir/compat/compat.h"
@@ -61,8 +62,16 @@ using Scheduler = pass::sch::schedule::detail::Scheduler;
  * Later implementations may become more sophisticated.
  *
  * With the lookahead_mode option disabled, the future window's dependency
- * graphs (scheduled and avlist) are not used. Instead, a copy of the input
- * circuit (input_gatepv) is created and iterated over (input_gatepp).
+ * graphs (num_scheduled_preds and avlist) are not used. Instead, a copy of the
+ * input circuit (input_gates) is created and iterated over (input_gate_index).
+ *
+ * A Future is copied for every alternative that the mapper speculates on, so
+ * its state is kept small: the dependency graph and the input circuit are
+ * shared between all copies, and the per-copy state only describes the
+ * frontier of the dependency graph (the available gates and the gates of
+ * which some but not all predecessors have been mapped) and the set of gates
+ * that have been mapped out of input order. Copying a Future thus costs time
+ * proportional to the width of the circuit rather than its length.
  */
 class Future {
 public:
@@ -83,14 +92,22 @@ public:
     utils::Ptr<Scheduler> scheduler;
 
     /**
-     * Input circuit when not using scheduler based avlist.
+     * Copy of the input circuit, shared between all copies of this Future.
+     */
+    utils::Ptr<const utils::Vec<ir::compat::GateRef>> input_gates;
+
+    /**
+     * Index of each gate in input_gates, shared between all copies of this
+     * Future. Only used when lookahead is enabled.
      */
-    ir::compat::GateRefs input_gatepv;
+    utils::Ptr<const utils::Map<ir::compat::GateRef, utils::UInt>> input_gate_indices;
 
     /**
-     * State: has gate been scheduled, here: done from future?
+     * State: for each node in the dependency graph of which some but not all
+     * predecessors have been mapped, the number of incoming arcs from mapped
+     * predecessors. Nodes that are available or mapped are not in this map.
      */
-    utils::Map<ir::compat::GateRef, utils::Bool> scheduled;
+    utils::Map<lemon::ListDigraph::Node, utils::UInt> num_scheduled_preds;
 
     /**
      * State: the nodes/gates which are available for mapping now.
@@ -98,9 +115,9 @@ public:
     utils::List<lemon::ListDigraph::Node> avlist;
 
     /**
-     * State: alternative iterator in input_gatepv.
+     * State: index of the next gate in input_gates when lookahead is disabled.
      */
-    ir::compat::GateRefs::iterator input_gatepp;
+    utils::UInt input_gate_index;
 
     /**
      * Approximate total number of gates to begin with.
@@ -113,9 +130,33 @@ public:
     utils::UInt approx_gates_remaining;
 
     /**
-     * List of total number of gates remaining.
+     * State: all gates in input_gates before this index have been mapped.
+     * Only maintained when lookahead is enabled.
+     */
+    utils::UInt first_remaining_index;
+
+    /**
+     * State: indices into input_gates at or beyond first_remaining_index of
+     * gates that have already been mapped.
+     */
+    utils::Set<utils::UInt> completed_indices;
+
+private:
+
+    /**
+     * Inserts the given node into avlist, which is kept ordered by
+     * criticality, most critical first. Nodes with equal criticality are
+     * kept in the order in which they became available.
      */
-    utils::List<ir::compat::GateRef> remaining_gates;
+    void make_available(lemon::ListDigraph::Node n);
+
+    /**
+     * Takes the given node out of avlist, and makes those successors
+     * available for which all predecessors have now been mapped.
+     */
+    void take_available(lemon::ListDigraph::Node n);
+
+public:
 
     /**
      * Program-wide initialization function.
@@ -152,6 +193,23 @@ public:
      */
     ir::compat::GateRef get_most_critical(const utils::List<ir::compat::GateRef> &lag) const;
 
+    /**
+     * Returns the gates that have not been mapped yet, in input order. Only
+     * supported when lookahead is enabled; returns an empty list otherwise.
+     */
+    void get_remaining_gates(utils::List<ir::compat::GateRef> &gates) const;
+
+    /**
+     * Returns the first max_gates gates with more than one operand that have
+     * not been mapped yet, in input order. Unlike get_remaining_gates(), the
+     * cost does not depend on the total number of remaining gates. Only
+     * supported when lookahead is enabled; returns an empty list otherwise.
+     */
+    void get_lookahead_gates(
+        utils::List<ir::compat::GateRef> &gates,
+        utils::UInt max_gates
+    ) const;
+
 };
 
 } // namespace detail
@@ -0,0 +1,162 @@
+/** \file
+ * GateChain implementation.
+ */
+
+#include "gate_chain.h"
+
+#include "ql/utils/vec.h"
+
+namespace ql {
+namespace pass {
+namespace map {
+namespace qubits {
+namespace map {
+namespace detail {
+
+/**
+ * Releases the given reference to a chain of nodes. Nodes that are no longer
+ * referenced are destroyed iteratively, to avoid recursing once for every
+ * node in the chain.
+ */
+void GateChain::release(utils::Ptr<const Node> &node) {
+    while (node.has_value() && node.unwrap().use_count() == 1) {
+        auto prev = node->prev;
+        node = prev;
+    }
+    node.reset();
+}
+
+/**
+ * Copy constructor. The nodes are shared with the source.
+ */
+GateChain::GateChain(const GateChain &src) : back(src.back), count(src.count) {
+}
+
+/**
+ * Copy assignment operator. The nodes are shared with the source.
+ */
+GateChain &GateChain::operator=(const GateChain &src) {
+    if (this != &src) {
+        auto src_back = src.back;
+        release(back);
+        back = src_back;
+        count = src.count;
+    }
+    return *this;
+}
+
+/**
+ * Destructor.
+ */
+GateChain::~GateChain() {
+    release(back);
+}
+
+/**
+ * Returns whether the list is empty.
+ */
+utils::Bool GateChain::empty() const {
+    return count == 0;
+}
+
+/**
+ * Returns the number of gates in the list.
+ */
+utils::UInt GateChain::size() const {
+    return count;
+}
+
+/**
+ * Removes all gates from the list.
+ */
+void GateChain::clear() {
+    release(back);
+    count = 0;
+}
+
+/**
+ * Appends the given gate to the back of the list.
+ */
+void GateChain::push_back(const ir::compat::GateRef &gate, utils::UInt cycle) {
+    auto node = utils::Ptr<Node>::make();
+    node->gate = gate;
+    node->cycle = cycle;
+    node->prev = back;
+    back = node.as_const();
+    count++;
+}
+
+/**
+ * Inserts the given gate such that the list remains ordered by cycle,
+ * placing it after all gates with a cycle less than or equal to the given
+ * cycle. Requires the list to be ordered by cycle already. The cost is
+ * proportional to the number of gates with a later cycle.
+ */
+void GateChain::insert_ordered(const ir::compat::GateRef &gate, utils::UInt cycle) {
+
+    // Find the nodes that must end up after the new gate. These nodes may be
+    // shared with other chains, so they can't be relinked; they are recreated
+    // on top of the new node instead.
+    utils::Vec<utils::Ptr<const Node>> later;
+    auto insert_after = back;
+    while (insert_after.has_value() && insert_after->cycle > cycle) {
+        later.push_back(insert_after);
+        insert_after = insert_after->prev;
+    }
+
+    // Build the new tail of the list. The nodes in later are kept alive by
+    // the vector until they have been recreated.
+    back = insert_after;
+    count -= later.size();
+    push_back(gate, cycle);
+    for (auto it = later.rbegin(); it != later.rend(); ++it) {
+        push_back((*it)->gate, (*it)->cycle);
+    }
+
+}
+
+/**
+ * Appends all gates in this list to the back of the given list, front to
+ * back.
+ */
+void GateChain::get_gates(utils::List<ir::compat::GateRef> &gates) const {
+    auto it = gates.end();
+    for (auto node = back; node.has_value(); node = node->prev) {
+        it = gates.insert(it, node->gate);
+    }
+}
+
+/**
+ * Appends all gates in this list to the back of the given chain, front to
+ * back, retaining their cycles.
+ */
+void GateChain::append_to(GateChain &chain) const {
+    utils::Vec<utils::RawPtr<const Node>> nodes;
+    nodes.reserve(count);
+    for (auto node = back; node.has_value(); node = node->prev) {
+        nodes.push_back(&*node);
+    }
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+        chain.push_back((*it)->gate, (*it)->cycle);
+    }
+}
+
+/**
+ * Dumps the gates in this list with their cycles using debug logging.
+ */
+void GateChain::debug_print() const {
+    utils::Vec<utils::RawPtr<const Node>> nodes;
+    for (auto node = back; node.has_value(); node = node->prev) {
+        nodes.push_back(&*node);
+    }
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+        QL_DOUT("[" << (*it)->cycle << "] " << (*it)->gate->qasm());
+    }
+}
+
+} // namespace detail
+} // namespace map
+} // namespace qubits
+} // namespace map
+} // namespace pass
+} // namespace ql
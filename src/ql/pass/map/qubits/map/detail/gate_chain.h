@@ -0,0 +1,147 @@
+/** \file
+ * GateChain implementation.
+ */
+
+#pragma once
+
+#include "ql/utils/num.h"
+#include "ql/utils/ptr.h"
+#include "ql/utils/list.h"
+#include "ql/ir/compat/compat.h"
+
+namespace ql {
+namespace pass {
+namespace map {
+namespace qubits {
+namespace map {
+namespace detail {
+
+/**
+ * GateChain: persistent list of gates annotated with their start cycle.
+ *
+ * Each Alter that is evaluated by the mapper starts off as a copy of the Past
+ * it extends, and only adds a couple of swaps and the target gate to it. To
+ * avoid that every such copy costs time proportional to the number of gates
+ * that have been mapped so far, the gate lists of Past are stored as a chain
+ * of immutable nodes linked from the back of the list to the front. Copies of
+ * a chain share all nodes; modifying a copy only replaces the nodes between
+ * the back of the list and the modification, which is cheap because gates are
+ * always added at or near the back.
+ */
+class GateChain {
+private:
+
+    /**
+     * A node in the chain. Nodes are never modified after construction.
+     */
+    struct Node {
+
+        /**
+         * The gate.
+         */
+        ir::compat::GateRef gate;
+
+        /**
+         * The cycle associated with the gate.
+         */
+        utils::UInt cycle;
+
+        /**
+         * The node preceding this one, or empty for the front of the list.
+         */
+        utils::Ptr<const Node> prev;
+
+    };
+
+    /**
+     * The node at the back of the list, or empty if the list is empty.
+     */
+    utils::Ptr<const Node> back;
+
+    /**
+     * The number of gates in the list.
+     */
+    utils::UInt count = 0;
+
+    /**
+     * Releases the given reference to a chain of nodes. Nodes that are no
+     * longer referenced are destroyed iteratively, to avoid recursing once for
+     * every node in the chain.
+     */
+    static void release(utils::Ptr<const Node> &node);
+
+public:
+
+    /**
+     * Constructs an empty list.
+     */
+    GateChain() = default;
+
+    /**
+     * Copy constructor. The nodes are shared with the source.
+     */
+    GateChain(const GateChain &src);
+
+    /**
+     * Copy assignment operator. The nodes are shared with the source.
+     */
+    GateChain &operator=(const GateChain &src);
+
+    /**
+     * Destructor.
+     */
+    ~GateChain();
+
+    /**
+     * Returns whether the list is empty.
+     */
+    utils::Bool empty() const;
+
+    /**
+     * Returns the number of gates in the list.
+     */
+    utils::UInt size() const;
+
+    /**
+     * Removes all gates from the list.
+     */
+    void clear();
+
+    /**
+     * Appends the given gate to the back of the list.
+     */
+    void push_back(const ir::compat::GateRef &gate, utils::UInt cycle);
+
+    /**
+     * Inserts the given gate such that the list remains ordered by cycle,
+     * placing it after all gates with a cycle less than or equal to the given
+     * cycle. Requires the list to be ordered by cycle already. The cost is
+     * proportional to the number of gates with a later cycle.
+     */
+    void insert_ordered(const ir::compat::GateRef &gate, utils::UInt cycle);
+
+    /**
+     * Appends all gates in this list to the back of the given list, front to
+     * back.
+     */
+    void get_gates(utils::List<ir::compat::GateRef> &gates) const;
+
+    /**
+     * Appends all gates in this list to the back of the given chain, front to
+     * back, retaining their cycles.
+     */
+    void append_to(GateChain &chain) const;
+
+    /**
+     * Dumps the gates in this list with their cycles using debug logging.
+     */
+    void debug_print() const;
+
+};
+
+} // namespace detail
+} // namespace map
+} // namespace qubits
+} // namespace map
+} // namespace pass
+} // namespace ql
@@ -0,0 +1,98 @@
+/** \file
+ * InteractionWeights implementation.
+ */
+
+#include "interaction_weights.h"
+
+#include <cmath>
+
+namespace ql {
+namespace pass {
+namespace map {
+namespace qubits {
+namespace map {
+namespace detail {
+
+/**
+ * Adds the given weight to the given pair of qubits, symmetrically.
+ */
+void InteractionWeights::add(utils::UInt a, utils::UInt b, float weight) {
+    rows.set(a).set(b) += weight;
+    rows.set(b).set(a) += weight;
+}
+
+/**
+ * Replaces the weights with those for routing the given two-qubit gate,
+ * given the remaining gates with more than one operand in input order. gate
+ * itself may or may not be part of lookahead; only the first LOOKAHEAD other
+ * gates are used. Costs O(LOOKAHEAD log LOOKAHEAD), regardless of the number
+ * of qubits.
+ */
+void InteractionWeights::build(
+    const ir::compat::GateRef &gate,
+    const utils::List<ir::compat::GateRef> &lookahead
+) {
+    rows.clear();
+
+    // The gate being routed must end up in a single core.
+    const auto &q = gate->operands;
+    add(q[0], q[1], std::pow(2.0f, 16.0f));
+    add(q[0], q[1], std::pow(2.0f, -1.0f));
+
+    // Upcoming gates pull their qubits together with exponentially decreasing
+    // weight.
+    utils::Int n = 2;
+    for (const auto &next : lookahead) {
+        if (n > (utils::Int)LOOKAHEAD + 1) {
+            break;
+        }
+        if (next == gate || next->operands.size() < 2) {
+            continue;
+        }
+        add(next->operands[0], next->operands[1], std::pow(2.0, -n));
+        n++;
+    }
+
+}
+
+/**
+ * Returns the weight of the given pair of qubits.
+ */
+float InteractionWeights::get(utils::UInt a, utils::UInt b) const {
+    auto row = rows.find(a);
+    if (row == rows.end()) {
+        return 0.0f;
+    }
+    return row->second.get(b, 0.0f);
+}
+
+/**
+ * Returns the nonzero weights involving the given qubit, ordered by the other
+ * qubit.
+ */
+const InteractionWeights::Row &InteractionWeights::get_row(utils::UInt q) const {
+    static const Row EMPTY;
+    auto row = rows.find(q);
+    if (row == rows.end()) {
+        return EMPTY;
+    }
+    return row->second;
+}
+
+/**
+ * Returns the qubits involved in at least one nonzero weight, in ascending
+ * order.
+ */
+void InteractionWeights::get_qubits(utils::Vec<utils::UInt> &qubits) const {
+    qubits.clear();
+    for (const auto &row : rows) {
+        qubits.push_back(row.first);
+    }
+}
+
+} // namespace detail
+} // namespace map
+} // namespace qubits
+} // namespace map
+} // namespace pass
+} // namespace ql
@@ -0,0 +1,97 @@
+/** \file
+ * InteractionWeights implementation.
+ */
+
+#pragma once
+
+#include "ql/utils/num.h"
+#include "ql/utils/list.h"
+#include "ql/utils/vec.h"
+#include "ql/utils/map.h"
+#include "ql/ir/compat/compat.h"
+
+namespace ql {
+namespace pass {
+namespace map {
+namespace qubits {
+namespace map {
+namespace detail {
+
+/**
+ * InteractionWeights: sparse, symmetric qubit interaction weights used by the
+ * multi-core lookahead partitioner (Mapper::chong).
+ *
+ * The pair of qubits of the gate being routed receives a weight of 2^16 + 2^-1,
+ * and the k-th upcoming two-qubit gate after it adds 2^-(k+1) to the weight of
+ * its pair. Weights are accumulated in single precision, so gates more than
+ * LOOKAHEAD positions ahead underflow to zero and need not be considered at
+ * all. Hence only a bounded window of upcoming gates is needed to reconstruct
+ * the weights after a gate has been consumed, and only the pairs that
+ * actually interact in that window are stored.
+ */
+class InteractionWeights {
+public:
+
+    /**
+     * The number of upcoming two-qubit gates (excluding the gate being
+     * routed) that can contribute a nonzero weight.
+     */
+    static const utils::UInt LOOKAHEAD = 148;
+
+    /**
+     * A row of the weight matrix, mapping the other qubit of each pair to the
+     * weight of the pair. Zero weights are not stored.
+     */
+    using Row = utils::Map<utils::UInt, float>;
+
+private:
+
+    /**
+     * The nonzero rows of the weight matrix, indexed by virtual qubit.
+     */
+    utils::Map<utils::UInt, Row> rows;
+
+    /**
+     * Adds the given weight to the given pair of qubits, symmetrically.
+     */
+    void add(utils::UInt a, utils::UInt b, float weight);
+
+public:
+
+    /**
+     * Replaces the weights with those for routing the given two-qubit gate,
+     * given the remaining gates with more than one operand in input order.
+     * gate itself may or may not be part of lookahead; only the first
+     * LOOKAHEAD other gates are used. Costs O(LOOKAHEAD log LOOKAHEAD),
+     * regardless of the number of qubits.
+     */
+    void build(
+        const ir::compat::GateRef &gate,
+        const utils::List<ir::compat::GateRef> &lookahead
+    );
+
+    /**
+     * Returns the weight of the given pair of qubits.
+     */
+    float get(utils::UInt a, utils::UInt b) const;
+
+    /**
+     * Returns the nonzero weights involving the given qubit, ordered by the
+     * other qubit.
+     */
+    const Row &get_row(utils::UInt q) const;
+
+    /**
+     * Returns the qubits involved in at least one nonzero weight, in
+     * ascending order.
+     */
+    void get_qubits(utils::Vec<utils::UInt> &qubits) const;
+
+};
+
+} // namespace detail
+} // namespace map
+} // namespace qubits
+} // namespace map
+} // namespace pass
+} // namespace ql
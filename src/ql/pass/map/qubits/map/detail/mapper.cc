@@ -21,207 +21,24 @@ namespace qubits {
 namespace map {
 namespace detail {
 
-/**
- * String conversion for PathStrategy.
- */
-std::ostream &operator<<(std::ostream &os, PathStrategy p) {
-    switch (p) {
-        case PathStrategy::ALL:        os << "all";        break;
-        case PathStrategy::LEFT:       os << "left";       break;
-        case PathStrategy::RIGHT:      os << "right";      break;
-        case PathStrategy::LEFT_RIGHT: os << "left-right"; break;
-        case PathStrategy::RANDOM:     os << "random";     break;
-    }
-    return os;
-}
-
-
 using namespace utils;
 using namespace com;
 
-/**
- * Find shortest paths between src and tgt in the grid, bounded by a
- * particular strategy. path is a linked-list node representing the complete
- * path from the initial src qubit to src in reverse order, not including src;
- * it will be null for the initial call. budget is the maximum number of hops
- * allowed in the path from src and is at least distance to tgt, but can be
- * higher when not all hops qualify for doing a two-qubit gate or to find
- * more than just the shortest paths. This recursively calls itself with src
- * replaced with its neighbors (and additional bookkeeping) until src equals
- * tgt, adding all alternatives to the alters list as it goes. For each path,
- * the alters are further split into all feasible alternatives for the
- * location of the non-nearest-neighbor two-qubit gate that started the
- * routing request. If max_alters is nonzero, recursion will stop once the
- * total number of entries in alters reaches or surpasses the limit (it may
- * surpass due to the checks only happening before splitting).
- */
-void Mapper::gen_shortest_paths(
-    const ir::compat::GateRef &gate,
-    RawPtr<Path> path,
-    UInt src,
-    UInt tgt,
-    UInt budget,
-    List<Alter> &alters,
-    UInt max_alters,
-    PathStrategy strategy
-) {
-
-    // List that will get the result of a recursive gen_shortest_paths() call.
-    List<Alter> sub_alters;
-
-    QL_DOUT("gen_shortest_paths: src=" << src << " tgt=" << tgt << " budget=" << budget << " which=" << strategy);
-    QL_ASSERT(alters.empty());
-
-    if (src == tgt) {
-
-        // Found target qubit. Create a virgin Alter and initialize it to become
-        // an empty path, then add src to this path (so that it becomes a
-        // distance 0 path with one qubit, src) and add the Alter to the result
-        // list.
-        Alter a;
-        a.initialize(kernel, options);
-        a.target_gate = gate;
-        a.add_to_front(src);
-        while (path) {
-            a.add_to_front(path->qubit);
-            path = path->prev;
-        }
-        a.split(alters);
-        a.debug_print("... empty path after adding to result list");
-        Alter::debug_print("... result list after adding empty path", alters);
-        QL_DOUT("... will return now");
-        return;
-    }
-
-    Path sub_path_node = {src, path};
-    RawPtr<Path> sub_path = &sub_path_node;
-
-    // Start looking around at neighbors for serious paths.
-    UInt d = platform->topology->get_distance(src, tgt);
-    QL_DOUT("gen_shortest_paths: distance(src=" << src << ", tgt=" << tgt << ") = " << d);
-    QL_ASSERT(d >= 1);
-
-    // Reduce neighbors nbs to those n continuing a path within budget.
-    // src=>tgt is distance d, budget>=d is allowed, attempt src->n=>tgt
-    // src->n is one hop, budget from n is one less so distance(n,tgt) <= budget-1 (i.e. distance < budget)
-    // when budget==d, this defaults to distance(n,tgt) <= d-1
-    auto neighbors = platform->topology->get_neighbors(src);
-#ifdef MULTI_LINE_LOG_DEBUG
-    QL_IF_LOG_DEBUG {
-        QL_DOUT("gen_shortest_path, neighbor relations after normalizing, before iterating");
-        for (auto dn : neighbors) {
-            QL_DOUT("..." << dn << " ");
-        }
-    }
-#else
-    QL_DOUT("gen_shortest_path, neighbor relations after normalizing, before iterating (disabled)");
-#endif
-    neighbors.remove_if([this,budget,tgt](const UInt& n) { return platform->topology->get_distance(n, tgt) >= budget; });
-#ifdef MULTI_LINE_LOG_DEBUG
-    QL_IF_LOG_DEBUG {
-        QL_DOUT("gen_shortest_paths: ... after reducing to steps within budget, nbl: ");
-        for (auto dn : neighbors) {
-            QL_DOUT("..." << dn << " ");
-        }
-    }
-#else
-    QL_DOUT("gen_shortest_paths: ... after reducing to steps within budget, nbl (disabled) ");
-#endif
-
-    // Update the neighbor list according to the path strategy.
-    if (strategy == PathStrategy::RANDOM) {
-
-        // Shuffle the neighbor list. We have to go through a vector to do that,
-        // otherwise std::shuffle doesn't work.
-        utils::Vec<utils::UInt> neighbors_vec{neighbors.begin(), neighbors.end()};
-        std::shuffle(neighbors_vec.begin(), neighbors_vec.end(), rng);
-        neighbors.clear();
-        neighbors.insert(neighbors.begin(), neighbors_vec.begin(), neighbors_vec.end());
-
-    } else {
-
-        // Rotate neighbor list nbl such that largest difference between angles
-        // of adjacent elements is beyond back(). This only makes sense when
-        // there is an underlying xy grid; when not, only the ALL strategy is
-        // supported.
-        QL_ASSERT(platform->topology->has_coordinates() || strategy == PathStrategy::ALL);
-        platform->topology->sort_neighbors_by_angle(src, neighbors);
-
-        // Select the subset of those neighbors that continue in direction(s) we
-        // want.
-        if (strategy == PathStrategy::LEFT) {
-            neighbors.remove_if([neighbors](const UInt &n) { return n != neighbors.front(); } );
-        } else if (strategy == PathStrategy::RIGHT) {
-            neighbors.remove_if([neighbors](const UInt &n) { return n != neighbors.back(); } );
-        } else if (strategy == PathStrategy::LEFT_RIGHT) {
-            neighbors.remove_if([neighbors](const UInt &n) { return n != neighbors.front() && n != neighbors.back(); } );
-        }
-
-    }
-
-#ifdef MULTI_LINE_LOG_DEBUG
-    QL_IF_LOG_DEBUG {
-        QL_DOUT("gen_shortest_path, neighbor relations after normalizing, before iterating");
-        for (auto dn : neighbors) {
-            QL_DOUT("..." << dn << " ");
-        }
-    }
-#else
-    QL_DOUT("gen_shortest_path, neighbor relations after normalizing, before iterating (disabled)");
-#endif
-
-    // For all resulting neighbors, find all continuations of a shortest path by
-    // recursively calling ourselves.
-    for (auto &n : neighbors) {
-        PathStrategy new_strategy = strategy;
-
-        // For each neighbor, only look in desired direction, if any.
-        if (strategy == PathStrategy::LEFT_RIGHT && neighbors.size() != 1) {
-            // When looking both left and right still, and there is a choice
-            // now, split into left and right.
-            if (n == neighbors.front()) {
-                new_strategy = PathStrategy::LEFT;
-            } else {
-                new_strategy = PathStrategy::RIGHT;
-            }
-        }
-
-        // Select maximum number of sub-alternatives to build. If our incoming
-        // max_alters is 0 there is no limit.
-        UInt max_sub_alters = 0;
-        if (max_alters > 0) {
-            QL_ASSERT(max_alters > alters.size());
-            max_sub_alters = max_alters - alters.size();
-        }
-
-        // Get list of possible paths in budget-1 from n to tgt in sub_alters.
-        gen_shortest_paths(gate, sub_path, n, tgt, budget - 1, sub_alters, max_sub_alters, new_strategy);
-
-        // Move all of sub_alters to alters, and make sub_alters empty.
-        alters.splice(alters.end(), sub_alters);
-
-        // Check whether we've found enough alternatives already.
-        if (max_alters && alters.size() >= max_alters) {
-            break;
-        }
-
-    }
-
-    QL_DOUT("... gen_shortest_paths: returning from call of: " << "src=" << src << " tgt=" << tgt << " budget=" << budget << " which=" << strategy);
-}
-
 /**
  * Find shortest paths in the grid for making the given gate
  * nearest-neighbor, from qubit src to qubit tgt, with an alternative for
- * each one. This starts off the recursion done by the above overload of
- * gen_shortest_paths(), and then generates new alternatives for each
- * possible "split" of each path.
+ * each one. The paths are enumerated lazily by a PathEnumerator, and new
+ * alternatives are generated for each possible "split" of each path.
  *
  * Steps:
  *  - Compute budget. Usually it is distance but it can be higher such as
  *    for multi-core.
  *  - Reduce the number of paths depending on the path selection option.
- *  - When not all shortest paths found are valid, take these out.
+ *    If max_alters is nonzero, path generation stops once the number of
+ *    alternatives reaches or surpasses it (it may surpass due to the
+ *    splitting). For random path selection, the paths are then sampled
+ *    uniformly from all paths using reservoir sampling, skipping over the
+ *    paths that are not selected without generating them.
  *  - Paths are further split because each split may give rise to a separate
  *    alternative. A split is a hop where the two-qubit gate is assumed to
  *    be done. After splitting each alternative contains two lists, one
@@ -232,25 +49,69 @@ void Mapper::gen_shortest_paths(
  * The end result is a list of alternatives (in alters) suitable for being
  * evaluated for any routing metric.
  */
-void Mapper::gen_shortest_paths(const ir::compat::GateRef &gate, UInt src, UInt tgt, List<Alter> &alters) {
+void Mapper::gen_shortest_paths(
+    const ir::compat::GateRef &gate,
+    UInt src,
+    UInt tgt,
+    List<Alter> &alters,
+    std::mt19937 &rng
+) {
 
     // Compute budget.
     UInt budget = platform->topology->get_min_hops(src, tgt);
 
-    // Generate paths using the configured path selection strategy.
+    // Determine the path strategy from the configured path selection mode.
+    PathStrategy strategy;
     if (options->path_selection_mode == PathSelectionMode::ALL) {
-        gen_shortest_paths(gate, nullptr, src, tgt, budget, alters, options->max_alters, PathStrategy::ALL);
+        strategy = PathStrategy::ALL;
     } else if (options->path_selection_mode == PathSelectionMode::BORDERS) {
-        gen_shortest_paths(gate, nullptr, src, tgt, budget, alters, options->max_alters, PathStrategy::LEFT_RIGHT);
+        strategy = PathStrategy::LEFT_RIGHT;
     } else if (options->path_selection_mode == PathSelectionMode::RANDOM) {
-        gen_shortest_paths(gate, nullptr, src, tgt, budget, alters, options->max_alters, PathStrategy::RANDOM);
+        strategy = PathStrategy::RANDOM;
     } else {
         QL_FATAL("Unknown value of path selection mode option " << options->path_selection_mode);
     }
+    QL_DOUT("gen_shortest_paths: src=" << src << " tgt=" << tgt << " budget=" << budget << " which=" << strategy);
+    PathEnumerator paths(*platform->topology, src, tgt, budget, strategy, rng);
+    UInt max_alters = options->max_alters;
+
+    // Creates the alternatives for a path, by splitting it in all feasible
+    // ways, and returns whether enough alternatives have been found.
+    auto add_path = [&](const Vec<UInt> &path) {
+        Alter a;
+        a.initialize(kernel, options);
+        a.target_gate = gate;
+        a.total = path;
+        a.split(alters);
+        return max_alters && alters.size() >= max_alters;
+    };
+
+    Vec<UInt> path;
+    if (strategy != PathStrategy::RANDOM || !max_alters) {
+
+        // Take the paths in order until we have enough.
+        while (paths.next(path)) {
+            if (add_path(path)) {
+                break;
+            }
+        }
+
+    } else {
+
+        // Take a uniform sample of max_alters paths from all paths.
+        auto reservoir = paths.sample(max_alters);
 
-    // Note: path split used to be here. Now it's done greedily by
-    // gen_shortest_paths().
+        // The paths in the reservoir are in no particular order; take them
+        // until we have enough alternatives.
+        for (const auto &sample : reservoir) {
+            if (add_path(sample)) {
+                break;
+            }
+        }
 
+    }
+
+    QL_DOUT("gen_shortest_paths: " << alters.size() << " alternatives generated");
 }
 
 /**
@@ -259,7 +120,12 @@ void Mapper::gen_shortest_paths(const ir::compat::GateRef &gate, UInt src, UInt
  * return the found variations by appending them to the given list of
  * Alters.
  */
-void Mapper::gen_alters_gate(const ir::compat::GateRef &gate, List<Alter> &alters, Past &past) {
+void Mapper::gen_alters_gate(
+    const ir::compat::GateRef &gate,
+    List<Alter> &alters,
+    Past &past,
+    std::mt19937 &rng
+) {
 
     // Interpret virtual operands in past's current map.
     auto &q = gate->operands;
@@ -271,7 +137,7 @@ void Mapper::gen_alters_gate(const ir::compat::GateRef &gate, List<Alter> &alter
     past.debug_print_fc();
 
     // Find shortest paths from src to tgt, and split these.
-    gen_shortest_paths(gate, src, tgt, alters);
+    gen_shortest_paths(gate, src, tgt, alters, rng);
     QL_ASSERT(!alters.empty());
     // Alter::DPRINT("... after GenShortestPaths", la);
 
@@ -287,7 +153,8 @@ void Mapper::gen_alters_gate(const ir::compat::GateRef &gate, List<Alter> &alter
 void Mapper::gen_alters(
     const utils::List<ir::compat::GateRef> &gates,
     List<Alter> &alters,
-    Past &past
+    Past &past,
+    std::mt19937 &rng
 ) {
     if (options->lookahead_mode == LookaheadMode::ALL) {
 
@@ -298,7 +165,7 @@ void Mapper::gen_alters(
             // Generate all possible variations to make gate nearest-neighbor
             // in current v2r mapping ("past").
             QL_DOUT("gen_alters: create alternatives for: " << gate->qasm());
-            gen_alters_gate(gate, alters, past);
+            gen_alters_gate(gate, alters, past, rng);
 
         }
 
@@ -311,15 +178,20 @@ void Mapper::gen_alters(
         // Generate all possible variations to make gate nearest-neighbor, in
         // current v2r mapping ("past").
         QL_DOUT("gen_alters, " << gates.size() << " 2q gates; take first: " << gate->qasm());
-        gen_alters_gate(gate, alters, past);
+        gen_alters_gate(gate, alters, past, rng);
 
     }
 }
 
 /**
- * Seeds the random number generator with the current time in microseconds.
+ * Seeds the random number generator with the random_seed option, or with the
+ * current time in microseconds if that is 0.
  */
 void Mapper::random_init() {
+    if (options->random_seed) {
+        rng.seed(options->random_seed);
+        return;
+    }
     auto ts = std::chrono::duration_cast<std::chrono::microseconds>(
         std::chrono::system_clock::now().time_since_epoch()
     ).count();
@@ -327,11 +199,29 @@ void Mapper::random_init() {
     rng.seed(ts);
 }
 
+/**
+ * Calls function for each index in [0, count), concurrently if a thread pool
+ * was configured, or serially in index order otherwise.
+ */
+void Mapper::parallel_for(UInt count, const std::function<void(UInt)> &function) {
+    if (thread_pool.has_value()) {
+        thread_pool->parallel_for(count, function);
+    } else {
+        for (UInt i = 0; i < count; i++) {
+            function(i);
+        }
+    }
+}
+
 /**
  * Chooses an Alter from the list based on the configured tie-breaking
- * strategy.
+ * strategy, using rng for the RANDOM strategy.
  */
-Alter Mapper::tie_break_alter(List<Alter> &alters, Future &future) {
+Alter Mapper::tie_break_alter(
+    List<Alter> &alters,
+    Future &future,
+    std::mt19937 &rng
+) {
     QL_ASSERT(!alters.empty());
 
     if (alters.size() == 1) {
@@ -482,7 +372,10 @@ Bool Mapper::map_mappable_gates(
         if (future.approx_gates_total) {
             progress -= ((Real)future.approx_gates_remaining / (Real)future.approx_gates_total);
         }
-        routing_progress.feed(progress);
+        {
+            std::lock_guard<std::mutex> lock(routing_progress_mutex);
+            routing_progress.feed(progress);
+        }
 
         // Handle non-quantum gates that need to be done first.
         if (future.get_non_quantum_gates(av_non_quantum_gates)) {
@@ -623,6 +516,12 @@ Bool Mapper::map_mappable_gates(
  *
  * For recursion, past is the speculative past, and base_past is the past
  * we've already committed to, and should thus measure fitness against.
+ *
+ * The good alternatives of a recursion step are independent of each
+ * other, so they are evaluated on the thread pool when one exists. rng
+ * is only used on the calling thread; each alternative receives its own
+ * generator, seeded from rng in list order before the alternatives are
+ * evaluated.
  */
 void Mapper::select_alter(
     List<Alter> &alters,
@@ -630,7 +529,8 @@ void Mapper::select_alter(
     Future &future,
     Past &past,
     Past &base_past,
-    UInt recursion_depth
+    UInt recursion_depth,
+    std::mt19937 &rng
 ) {
     // alters are all alternatives we enter with. There must be at least one.
     QL_ASSERT(!alters.empty());
@@ -642,7 +542,7 @@ void Mapper::select_alter(
     if (options->heuristic == Heuristic::BASE || options->heuristic == Heuristic::BASE_RC) {
         Alter::debug_print(
             "... select_alter base (equally good/best) alternatives:", alters);
-        result = tie_break_alter(alters, future);
+        result = tie_break_alter(alters, future, rng);
         result.debug_print("... the selected Alter is");
         // QL_DOUT("SelectAlter DONE level=" << level << " from " << la.size() << " alternatives");
         return;
@@ -655,12 +555,18 @@ void Mapper::select_alter(
     );
 
     // Compute a score for each alternative relative to base_past, and sort the
-    // alternatives based on it, minimum first.
+    // alternatives based on it, minimum first. Each alternative clones past
+    // and only modifies its own clone, so this can be done concurrently.
+    Vec<utils::RawPtr<Alter>> alter_ptrs;
     for (auto &a : alters) {
+        alter_ptrs.push_back(&a);
+    }
+    parallel_for(alter_ptrs.size(), [&alter_ptrs, &past, &base_past](UInt i) {
+        Alter &a = *alter_ptrs[i];
         a.debug_print("Considering extension by alternative: ...");
         a.extend(past, base_past);           // locally here, past will be cloned and kept in alter
         // and the extension stored into the a.score
-    }
+    });
     alters.sort([this](const Alter &a1, const Alter &a2) { return a1.score < a2.score; });
     Alter::debug_print(
         "... select_alter sorted all entry alternatives after extension:", alters);
@@ -703,7 +609,7 @@ void Mapper::select_alter(
         Alter::debug_print(
             "... select_alter reduced to best alternatives to choose result from:",
             best_alters);
-        result = tie_break_alter(best_alters, future);
+        result = tie_break_alter(best_alters, future, rng);
         result.debug_print("... the selected Alter (STOPPING RECURSION) is");
         // QL_DOUT("SelectAlter DONE level=" << level << " from " << bla.size() << " best alternatives");
         return;
@@ -731,7 +637,21 @@ void Mapper::select_alter(
     // recursion always goes to the maximum depth or to the end of the circuit.
     // This anomaly may need correction.
     // QL_DOUT("... SelectAlter level=" << level << " entering recursion with " << gla.size() << " good alternatives");
+    //
+    // The good alternatives are evaluated independently, each on its own
+    // copies of future and past, so this is done concurrently when a thread
+    // pool is available. To make the result independent of evaluation order,
+    // each alternative gets its own random-number generator, seeded here in
+    // list order.
+    Vec<utils::RawPtr<Alter>> good_alter_ptrs;
+    Vec<std::mt19937::result_type> seeds;
     for (auto &a : good_alters) {
+        good_alter_ptrs.push_back(&a);
+        seeds.push_back(rng());
+    }
+    parallel_for(good_alter_ptrs.size(), [&](UInt i) {
+        Alter &a = *good_alter_ptrs[i];
+        std::mt19937 sub_rng(seeds[i]);
         a.debug_print("... ... considering alternative:");
         Future sub_future = future; // copy!
         Past sub_past = past;       // copy!
@@ -779,12 +699,12 @@ void Mapper::select_alter(
 
             // Generate the next set of alternative routing actions.
             List<Alter> sub_alters;
-            gen_alters(gates, sub_alters, sub_past);
+            gen_alters(gates, sub_alters, sub_past, sub_rng);
             QL_DOUT("... ... select_alter level=" << recursion_depth << ", generated for these 2q gates " << sub_alters.size() << " alternatives; RECURSE ... ");
 
             // Select the best alternative from the list by recursion.
             Alter sub_result;
-            select_alter(sub_alters, sub_result, sub_future, sub_past, base_past, recursion_depth + 1);
+            select_alter(sub_alters, sub_result, sub_future, sub_past, base_past, recursion_depth + 1, sub_rng);
             sub_result.debug_print("... ... select_alter, generated for these 2q gates ... ; RECURSE DONE; resulting alternative ");
 
             // The extension of deep recursion is treated as extension at the
@@ -808,7 +728,7 @@ void Mapper::select_alter(
 
         }
         a.debug_print("... ... DONE considering alternative:");
-    }
+    });
 
     // Sort list of good alternatives on score resulting after recursion.
     good_alters.sort([this](const Alter &a1, const Alter &a2) { return a1.score < a2.score; });
@@ -820,242 +740,299 @@ void Mapper::select_alter(
     List<Alter> best_alters = good_alters;
     best_alters.remove_if([this,good_alters](const Alter& a) { return a.score != good_alters.front().score; });
     Alter::debug_print("... select_alter equally best alternatives on return of RECURSION:", best_alters);
-    result = tie_break_alter(best_alters, future);
+    result = tie_break_alter(best_alters, future, rng);
     result.debug_print("... the selected Alter is");
     // QL_DOUT("... SelectAlter level=" << level << " selecting from " << bla.size() << " equally good alternatives above DONE");
     QL_DOUT("select_alter DONE level=" << recursion_depth << " from " << alters.size() << " alternatives");
 
 }
 
-void Mapper::chong(
-    List<ir::compat::GateRef> &gates, 
-    List<ir::compat::GateRef> &remaining_gates,
-    Future &future,
-    Past &past,
-    Past &base_past
-    ){
-
-    UInt partitions = platform->topology->get_num_cores();
-    UInt n_qubits = platform->topology->get_num_qubits();
-
-    std::vector<utils::UInt> part(n_qubits);
-
-    std::vector<utils::UInt> C;  
-    com::map::QubitMapping v2r;
-
-    for (auto &gate : gates){
-
-        std::vector<utils::UInt> q1;
-        std::vector<utils::UInt> q2;
-        
-        auto &q = gate->operands;
-
-        past.map_qubit(q[0]);
-        past.map_qubit(q[1]);
+/**
+ * Runs the relaxed overall extreme exchange (ROEE) heuristic to repartition
+ * the qubits over the cores such that qubits qa and qb end up in the same
+ * core. part maps each virtual qubit to its current core index, and is
+ * updated in place; the pairs of virtual qubits to exchange are appended to
+ * q1 and q2. Qubits that are not mapped to a core are never exchanged.
+ * Returns whether a valid partition was found.
+ *
+ * Only the qubits with a nonzero interaction weight can have a nonzero row in
+ * the gain matrix D. All other qubits are idle and are interchangeable within
+ * their core, so only the first two idle qubits of each core (the ones that
+ * would be the first to attain the maximum gain) need to be considered as
+ * exchange candidates. Once no weighted candidates remain, all further gains
+ * are zero and cannot affect the exchange, so the pass stops there. Thus the
+ * cost per pass only depends on the number of weighted qubits and cores, and
+ * is linear in the total number of qubits.
+ */
+static Bool roee(
+    const InteractionWeights &weights,
+    UInt qa,
+    UInt qb,
+    UInt partitions,
+    Vec<UInt> &part,
+    Vec<UInt> &q1,
+    Vec<UInt> &q2
+) {
 
-        bool val;
-        float inf = pow(2,16);
+    // A candidate for exchange: the virtual qubit and its index in active, or
+    // -1 for idle qubits.
+    struct Candidate {
+        UInt qubit;
+        Int index;
+    };
 
-        // --------- Partition and weight matrix -----------
+    Vec<UInt> active;
+    weights.get_qubits(active);
+    UInt n_active = active.size();
 
-        List<ir::compat::GateRef> remaining_gates_aux(remaining_gates);
-        std::list<ql::ir::compat::GateRef>::iterator it = remaining_gates_aux.begin();
-        float w_matrix[n_qubits][n_qubits] = {};
-        float w_aux[n_qubits][n_qubits] = {};
+    // Step 7
+    float g_max = 1;
+    while (g_max > 0) {
+        if (part[qa] == part[qb]) {
+            return true;
+        }
 
-        // Create weight matrix
-        if(remaining_gates_aux.size() == 1){
-            if(remaining_gates_aux.front() == gate)
-                remaining_gates_aux.pop_front();
-        } else {
-            for(auto &i : remaining_gates_aux){
-                if(i==gate){
-                   remaining_gates_aux.erase(it);
-                   break;
-                } 
-                it++;
+        // Step 1
+        Vec<Bool> active_in_c(n_active, true);
+        UInt n_active_in_c = n_active;
+        Vec<List<UInt>> idle(partitions);
+        UInt ai = 0;
+        for (UInt i = 0; i < part.size(); i++) {
+            if (ai < n_active && active[ai] == i) {
+                ai++;
+            } else if (part[i] < partitions) {
+                idle[part[i]].push_back(i);
             }
         }
 
-        w_matrix[q[0]][q[1]] = 1*inf;
-        w_matrix[q[1]][q[0]] = 1*inf;
-        w_aux[q[0]][q[1]] = 1*pow(2,-1);
-        w_aux[q[1]][q[0]] = 1*pow(2,-1);
-
-        for (int i = 0; i < n_qubits; i++){
-            for (int j = 0; j < n_qubits; j++)
-                 w_matrix[i][j] += w_aux[i][j];
-        }
-        w_aux[q[0]][q[1]] = 0;
-        w_aux[q[1]][q[0]] = 0;
-
-        Int n = 2;
-        for(const auto &gate :remaining_gates_aux){
-            auto &p = gate->operands;
-            if(p.size() > 1){
-                past.map_qubit(p[0]);
-                past.map_qubit(p[1]);
-                w_aux[p[0]][p[1]] = 1*pow(2,-n);
-                w_aux[p[1]][p[0]] = 1*pow(2,-n);
-                for (int i = 0; i < n_qubits; i++){
-                    for (int j = 0; j < n_qubits; j++)
-                         w_matrix[i][j] += w_aux[i][j];
+        // Calculating D(i,l) = W(i,l)-W[i,col(i)]
+        Vec<Vec<float>> D(n_active, Vec<float>(partitions, 0.0f));
+        Vec<float> W(partitions);
+        for (ai = 0; ai < n_active; ai++) {
+            std::fill(W.begin(), W.end(), 0.0f);
+            for (const auto &w : weights.get_row(active[ai])) {
+                if (part[w.first] < partitions) {
+                    W[part[w.first]] += w.second;
                 }
-                w_aux[p[0]][p[1]] = 0;
-                w_aux[p[1]][p[0]] = 0;
-                n++;
+            }
+            for (UInt l = 0; l < partitions; l++) {
+                D[ai][l] = W[l] - W[part[active[ai]]];
             }
         }
-        // v2r[i]/partitions
-        past.export_mapping(v2r);
-        for(int i = 0; i < n_qubits; i++)
-            part[i] = platform->topology->get_core_index(v2r[i]);
-
-        // --------- End partition and weight matrix -----------
-
-        // --------------------- ROEE --------------------------
-        // If they are equal qubits are already in same partition
-        if (part[q[0]] != part[q[1]]){
-        float g_max = 1;
-        // Step 7
-        val = 1;
-        while(g_max > 0 && val == 1){
-                
-            if(part[q[0]] == part[q[1]]){
-                val = 0;
+        auto d = [&D](const Candidate &c, UInt l) {
+            return c.index < 0 ? 0.0f : D[c.index][l];
+        };
+
+        Vec<float> g;
+        Vec<Candidate> a;
+        Vec<Candidate> b;
+
+        // Step 4
+        Vec<Candidate> c;
+        while (n_active_in_c > 0) {
+
+            // Gather the candidates in ascending qubit order.
+            c.clear();
+            for (ai = 0; ai < n_active; ai++) {
+                if (active_in_c[ai]) {
+                    c.push_back({active[ai], (Int)ai});
+                }
+            }
+            for (const auto &core : idle) {
+                auto it = core.begin();
+                for (UInt k = 0; k < 2 && it != core.end(); k++, ++it) {
+                    c.push_back({*it, -1});
+                }
+            }
+            if (c.size() < 2) {
                 break;
             }
-            // Step 1
-            utils::UInt index = 0;
-            C.clear();
-
-            for(int i = 0; i < n_qubits; ++i)
-                C.push_back(i);
-            // Calculating W_(i,l)
-            float W[n_qubits][partitions] = {};
-            for(int i = 0; i < n_qubits; i++){
-                for(int j = 0; j < partitions; j++){
-                    for(int p = 0; p < n_qubits; p++){
-
-                        // p is the qubit index in that core
-                        if(part[p] == j){
-                            W[i][j] += w_matrix[i][p];
-                        }
+            std::sort(c.begin(), c.end(), [](const Candidate &x, const Candidate &y) {
+                return x.qubit < y.qubit;
+            });
+
+            // Step 2
+            // Find max g(i,l). The gain is symmetric, so the first pair that
+            // attains the maximum always has i < j.
+            float g_best = -INFINITY;
+            Candidate a_aux = c[0];
+            Candidate b_aux = c[1];
+            for (UInt i = 0; i < c.size(); i++) {
+                const auto &row = weights.get_row(c[i].qubit);
+                for (UInt j = i + 1; j < c.size(); j++) {
+                    float w = c[i].index < 0 ? 0.0f : row.get(c[j].qubit, 0.0f);
+                    float aux = d(c[i], part[c[j].qubit]) + d(c[j], part[c[i].qubit]) - 2*w;
+                    if (aux > g_best) {
+                        g_best = aux;
+                        a_aux = c[i];
+                        b_aux = c[j];
                     }
                 }
             }
 
-            // Calculating D(i,l) = W(i,l)-W[i,col(i)]
-            float D[n_qubits][partitions] = {};
-            for(int i = 0; i < n_qubits; i++){
-                for(int j = 0; j < partitions; j++)
-                    D[i][j] = W[i][j] - W[i][part[i]];
-            }
-
-            std::vector<float> g(C.size(), -INFINITY);
-            std::vector<int> a(C.size(), 0);
-            std::vector<int> b(C.size(), 0);
-
-            // Step 4
-            while(C.size() > 1){
-                // Step 2
-
-                // Find max g(i,l)
-                float aux= -1;
-                int a_aux = 0;
-                int b_aux = 0;
-
-                for(auto &i : C){
-                    for(auto &j : C){
-                        if( i != j ){
-                            aux = D[i][part[j]] + D[j][part[i]] - 2*w_matrix[i][j];
-                            if(aux > g[index]){
-                                g[index] = aux;
-                                a_aux = i;
-                                b_aux = j;
-                            }
-                        }
+            // Delete a, b from C
+            for (const auto &x : {a_aux, b_aux}) {
+                if (x.index >= 0) {
+                    active_in_c[x.index] = false;
+                    n_active_in_c--;
+                } else {
+                    auto &core = idle[part[x.qubit]];
+                    if (core.front() == x.qubit) {
+                        core.pop_front();
+                    } else {
+                        core.erase(std::next(core.begin()));
                     }
                 }
+            }
 
-                // Delete a, b from C
-                C.erase(std::remove(C.begin(),C.end(),a_aux),C.end());
-                C.erase(std::remove(C.begin(),C.end(),b_aux),C.end());
-
-                    // Step 3
-                for(auto &i : C){
-                    for (int l = 0; l < partitions; l++){
-                        if(l == part[a_aux]){
-                            if(part[i] != part[a_aux] && part[i] != part[b_aux])
-                                D[i][l] = D[i][l] + w_matrix[i][b_aux] - w_matrix[i][a_aux];
-                            if(part[i] == part[b_aux])
-                                D[i][l] = D[i][l] + 2*w_matrix[i][b_aux] - 2*w_matrix[i][a_aux];
-                        } else if (l == part[b_aux]) {
-                            if(part[i] != part[a_aux] && part[i] != part[b_aux])
-                                D[i][l] = D[i][l] + w_matrix[i][a_aux] - w_matrix[i][b_aux];
-                            if(part[i] == part[a_aux])
-                                D[i][l] = D[i][l] + 2*w_matrix[i][a_aux] - 2*w_matrix[i][b_aux];
-                        } else {
-                            if(part[i] == part[a_aux]){
-                                D[i][l] = D[i][l] + w_matrix[i][a_aux] - w_matrix[i][b_aux];
-                            } else if(part[i] == part[b_aux]){
-                                D[i][l] = D[i][l] + w_matrix[i][b_aux] - w_matrix[i][a_aux];
-                            }    
+            // Step 3
+            UInt pa = part[a_aux.qubit];
+            UInt pb = part[b_aux.qubit];
+            for (ai = 0; ai < n_active; ai++) {
+                if (!active_in_c[ai]) {
+                    continue;
+                }
+                UInt i = active[ai];
+                const auto &row = weights.get_row(i);
+                float wa = row.get(a_aux.qubit, 0.0f);
+                float wb = row.get(b_aux.qubit, 0.0f);
+                for (UInt l = 0; l < partitions; l++) {
+                    if (l == pa) {
+                        if (part[i] != pa && part[i] != pb)
+                            D[ai][l] = D[ai][l] + wb - wa;
+                        if (part[i] == pb)
+                            D[ai][l] = D[ai][l] + 2*wb - 2*wa;
+                    } else if (l == pb) {
+                        if (part[i] != pa && part[i] != pb)
+                            D[ai][l] = D[ai][l] + wa - wb;
+                        if (part[i] == pa)
+                            D[ai][l] = D[ai][l] + 2*wa - 2*wb;
+                    } else {
+                        if (part[i] == pa) {
+                            D[ai][l] = D[ai][l] + wa - wb;
+                        } else if (part[i] == pb) {
+                            D[ai][l] = D[ai][l] + wb - wa;
                         }
                     }
                 }
-                a[index] = a_aux;
-                b[index] = b_aux;
-
-                index++;
             }
-            // Step 5
-            // Calculate g_max
-            float g_aux = 0;
-            float g_max_idx = -1;
 
-            for(int i = 0; i < g.size(); i++ ){
-                if(g[i]==-INFINITY) 
-                    break;
-                if(g_aux+g[i] > g_aux){
-                    g_max_idx = i;
-                    g_max = g_aux+g[i];
-                }
-                g_aux += g[i];
+            g.push_back(g_best);
+            a.push_back(a_aux);
+            b.push_back(b_aux);
+        }
+
+        // Step 5
+        // Calculate g_max
+        float g_aux = 0;
+        Int g_max_idx = -1;
+        for (UInt i = 0; i < g.size(); i++) {
+            if (g_aux + g[i] > g_aux) {
+                g_max_idx = i;
+                g_max = g_aux + g[i];
             }
+            g_aux += g[i];
+        }
 
-            // Step 6
-            // Exchange firstg m pairs
-            int tmp = 0;
+        // Without any exchange, the next pass would be identical to this one.
+        if (g_max_idx < 0) {
+            return false;
+        }
 
-            for(int i = 0; i < g_max_idx+1 && val == 1; i++ ){
-                tmp = part[a[i]];
-                part[a[i]] = part[b[i]];
-                part[b[i]] = tmp;
+        // Step 6
+        // Exchange first g_max_idx + 1 pairs
+        for (Int i = 0; i <= g_max_idx; i++) {
+            std::swap(part[a[i].qubit], part[b[i].qubit]);
+            q1.push_back(a[i].qubit);
+            q2.push_back(b[i].qubit);
+            if (part[qa] == part[qb]) {
+                return true;
+            }
+        }
 
-                q1.push_back(a[i]);
-                q2.push_back(b[i]);
+    }
 
-                if(part[q[0]] == part[q[1]]){
-                    val = 0;
-                }
+    return part[qa] == part[qb];
+}
 
-            }
+/**
+ * Gives a location to all virtual qubits that are still going to interact,
+ * i.e. the operands of the given non-mappable gates and of all remaining
+ * two-qubit gates, in that order. The multi-core partitioner needs a location
+ * for all of these, not just for those within the lookahead window of the
+ * interaction weights. Qubits stay mapped once they are, so this is done only
+ * once per kernel, before the partitioner is first used.
+ */
+void Mapper::map_interacting_qubits(
+    const List<ir::compat::GateRef> &gates,
+    const Future &future,
+    Past &past
+) {
+    if (gates.empty()) {
+        return;
+    }
+    past.map_qubit(gates.front()->operands[0]);
+    past.map_qubit(gates.front()->operands[1]);
+    List<ir::compat::GateRef> remaining;
+    future.get_remaining_gates(remaining);
+    for (const auto &next : remaining) {
+        if (next->operands.size() > 1) {
+            past.map_qubit(next->operands[0]);
+            past.map_qubit(next->operands[1]);
         }
+    }
+}
+
+/**
+ * Routes the given non-mappable two-qubit gates for multi-core platforms with
+ * full connectivity within the cores, by repartitioning the qubits over the
+ * cores such that the operands of each gate end up in the same core. The
+ * partitioning is driven by the interaction weights of the gate and the
+ * upcoming two-qubit gates that have not been mapped yet, so gates routed
+ * earlier on no longer contribute. The weights only look a fixed number of
+ * gates ahead; map_interacting_qubits() must have been called before to give
+ * all qubits that are still going to interact a location.
+ */
+void Mapper::chong(
+    List<ir::compat::GateRef> &gates,
+    Future &future,
+    Past &past,
+    Past &base_past
+) {
+
+    UInt partitions = platform->topology->get_num_cores();
+    UInt n_qubits = platform->topology->get_num_qubits();
 
-        // --------------------- End ROEE --------------------------
+    InteractionWeights weights;
+    List<ir::compat::GateRef> lookahead;
+    Vec<UInt> part(n_qubits);
+    com::map::QubitMapping v2r;
 
-        // --------------------- Mapping qubits -------------------
-        if(val == 1){
-            fprintf(stderr, "Valid partition not found\n");
-            exit(EXIT_FAILURE);
+    for (auto &gate : gates) {
+        auto &q = gate->operands;
+
+        // --------- Partition and weight matrix -----------
+
+        future.get_lookahead_gates(lookahead, InteractionWeights::LOOKAHEAD + 1);
+        weights.build(gate, lookahead);
+
+        past.export_mapping(v2r);
+        for (UInt i = 0; i < n_qubits; i++) {
+            part[i] = platform->topology->get_core_index(v2r[i]);
         }
 
-        for(int i=0; i < q1.size(); i++){
-            if (q1[i] != q2[i])
-                past.add_swap(past.map_qubit(q1[i]), past.map_qubit(q2[i]));
+        // --------------------- ROEE --------------------------
+        // If they are equal qubits are already in same partition
+        Vec<UInt> q1;
+        Vec<UInt> q2;
+        if (!roee(weights, q[0], q[1], partitions, part, q1, q2)) {
+            QL_FATAL("multi-core partitioner failed to find a valid partition for " << gate->qasm());
+        }
+
+        // --------------------- Mapping qubits -------------------
+        for (UInt i = 0; i < q1.size(); i++) {
+            past.add_swap(past.map_qubit(q1[i]), past.map_qubit(q2[i]));
         }
-        } 
 
         map_routed_gate(gate, past);
         future.completed_gate(gate);
@@ -1082,13 +1059,22 @@ void Mapper::map_gates(Future &future, Past &past, Past &base_past) {
 
     routing_progress = Progress("router", 1000);
 
+    // Whether the multi-core partitioner is used, and whether the qubits it
+    // needs have been given a location yet.
+    Bool use_partitioner = platform->topology->get_num_cores() > 1
+        && platform->topology->get_connectivity() == GridConnectivity::FULL;
+    Bool interacting_qubits_mapped = false;
+
     // Handle all the gates one by one. map_mappable_gates returns false when no
     // gates remain.
     while (map_mappable_gates(future, past, gates, also_nn_two_qubit_gates)) {
-        if(platform->topology->get_num_cores() > 1 &&
-            platform->topology->get_connectivity() == GridConnectivity::FULL){
-            chong(gates, future.remaining_gates,future,past,base_past);
-       
+        if (use_partitioner) {
+            if (!interacting_qubits_mapped) {
+                map_interacting_qubits(gates, future, past);
+                interacting_qubits_mapped = true;
+            }
+            chong(gates, future, past, base_past);
+
         } else {
             // All gates in the gates list are two-qubit quantum gates that cannot
             // be mapped yet. Select which one(s) to (partially) route, according to
@@ -1097,11 +1083,11 @@ void Mapper::map_gates(Future &future, Past &past, Past &base_past) {
 
             // Generate all alternative routes.
             List<Alter> alters;
-            gen_alters(gates, alters, past);
+            gen_alters(gates, alters, past, rng);
 
             // Select the best one based on the configured strategy.
             Alter alter;
-            select_alter(alters, alter, future, past, base_past, 0);
+            select_alter(alters, alter, future, past, base_past, 0, rng);
 
             // Commit to selected alternative. This adds all or just one swap
             // (depending on configuration) to THIS past, and schedules them/it in.
@@ -1256,6 +1242,10 @@ void Mapper::initialize(const ir::compat::PlatformRef &p, const OptionsRef &opt)
     nc = p->creg_count;
     nb = p->breg_count;
     random_init();
+    if (options->recursion_threads != 1) {
+        thread_pool = utils::Ptr<utils::ThreadPool>::make(options->recursion_threads);
+        QL_DOUT("... using " << thread_pool->get_num_threads() << " threads for recursion");
+    }
     // QL_DOUT("... platform/real number of qubits=" << nq << ");
     cycle_time = p->cycle_time;
 
@@ -5,12 +5,14 @@
 #pragma once
 
 #include <random>
+#include <mutex>
 #include "ql/utils/num.h"
 #include "ql/utils/str.h"
 #include "ql/utils/vec.h"
 #include "ql/utils/list.h"
 #include "ql/utils/map.h"
 #include "ql/utils/progress.h"
+#include "ql/utils/thread_pool.h"
 #include "ql/ir/compat/compat.h"
 #include "ql/com/map/qubit_mapping.h"
 #include "options.h"
@@ -18,6 +20,8 @@
 #include "past.h"
 #include "alter.h"
 #include "future.h"
+#include "path_enumerator.h"
+#include "interaction_weights.h"
 
 namespace ql {
 namespace pass {
@@ -40,48 +44,6 @@ namespace detail {
 // Construction of skeleton objects requires the used classes to provide such
 // (non-parameterized) constructors.
 
-/**
- * Strategy options for finding routing paths.
- */
-enum class PathStrategy {
-
-    /**
-     * Consider all shortest path alternatives.
-     */
-    ALL,
-
-    /**
-     * Only consider the shortest path along the left side of the rectangle of
-     * the source and target qubit.
-     */
-    LEFT,
-
-    /**
-     * Only consider the shortest path along the right side of the rectangle of
-     * the source and target qubit.
-     */
-    RIGHT,
-
-    /**
-     * Consider the shortest paths along both the left and right side of the
-     * rectangle of the source and target qubit.
-     */
-    LEFT_RIGHT,
-
-    /**
-     * Consider all path alternatives, but randomize the order of the generated
-     * paths. This is useful when the amount of generated alternative paths
-     * needs to be limited for scalability.
-     */
-    RANDOM
-
-};
-
-/**
- * String conversion for PathStrategy.
- */
-std::ostream &operator<<(std::ostream &os, PathStrategy p);
-
 /**
  * Mapper: map operands of gates and insert swaps so that two-qubit gate
  * operands are nearest-neighbor (NN).
@@ -252,15 +214,30 @@ private:
     utils::UInt cycle_time;
 
     /**
-     * Random-number generator for the "random" tie-breaking option.
+     * Random-number generator for the "random" tie-breaking option. During
+     * recursion, each alternative gets its own generator seeded from this
+     * one, so the result does not depend on the order in which alternatives
+     * are evaluated.
      */
     std::mt19937 rng;
 
+    /**
+     * Thread pool used to evaluate alternatives concurrently during
+     * recursion, or empty when the recursion_threads option is 1.
+     */
+    utils::Ptr<utils::ThreadPool> thread_pool;
+
     /**
      * Routing progress tracker.
      */
     utils::Progress routing_progress;
 
+    /**
+     * Mutex protecting routing_progress, which may be fed from multiple
+     * threads during concurrent recursion.
+     */
+    std::mutex routing_progress_mutex;
+
     /**
      * Number of swaps added (including moves) to the most recently mapped
      * kernel, set by map_kernel().
@@ -288,50 +265,21 @@ private:
      */
     com::map::QubitMapping v2r_out;
 
-    struct Path {
-        utils::UInt qubit;
-        utils::RawPtr<Path> prev;
-    };
-
-    /**
-     * Find shortest paths between src and tgt in the grid, bounded by a
-     * particular strategy. path is a linked-list node representing the complete
-     * path from the initial src qubit to src in reverse order, not including src;
-     * it will be null for the initial call. budget is the maximum number of hops
-     * allowed in the path from src and is at least distance to tgt, but can be
-     * higher when not all hops qualify for doing a two-qubit gate or to find
-     * more than just the shortest paths. This recursively calls itself with src
-     * replaced with its neighbors (and additional bookkeeping) until src equals
-     * tgt, adding all alternatives to the alters list as it goes. For each path,
-     * the alters are further split into all feasible alternatives for the
-     * location of the non-nearest-neighbor two-qubit gate that started the
-     * routing request. If max_alters is nonzero, recursion will stop once the
-     * total number of entries in alters reaches or surpasses the limit (it may
-     * surpass due to the checks only happening before splitting).
-     */
-    void gen_shortest_paths(
-        const ir::compat::GateRef &gate,
-        utils::RawPtr<Path> path,
-        utils::UInt src,
-        utils::UInt tgt,
-        utils::UInt budget,
-        utils::List<Alter> &alters,
-        utils::UInt max_alters,
-        PathStrategy strategy
-    );
-
     /**
      * Find shortest paths in the grid for making the given gate
      * nearest-neighbor, from qubit src to qubit tgt, with an alternative for
-     * each one. This starts off the recursion done by the above overload of
-     * gen_shortest_paths(), and then generates new alternatives for each
-     * possible "split" of each path.
+     * each one. The paths are enumerated lazily by a PathEnumerator, and new
+     * alternatives are generated for each possible "split" of each path.
      *
      * Steps:
      *  - Compute budget. Usually it is distance but it can be higher such as
      *    for multi-core.
      *  - Reduce the number of paths depending on the path selection option.
-     *  - When not all shortest paths found are valid, take these out.
+     *    If max_alters is nonzero, path generation stops once the number of
+     *    alternatives reaches or surpasses it (it may surpass due to the
+     *    splitting). For random path selection, the paths are then sampled
+     *    uniformly from all paths using reservoir sampling, skipping over the
+     *    paths that are not selected without generating them.
      *  - Paths are further split because each split may give rise to a separate
      *    alternative. A split is a hop where the two-qubit gate is assumed to
      *    be done. After splitting each alternative contains two lists, one
@@ -346,7 +294,8 @@ private:
         const ir::compat::GateRef &gate,
         utils::UInt src,
         utils::UInt tgt,
-        utils::List<Alter> &alters
+        utils::List<Alter> &alters,
+        std::mt19937 &rng
     );
 
     /**
@@ -358,7 +307,8 @@ private:
     void gen_alters_gate(
         const ir::compat::GateRef &gate,
         utils::List<Alter> &alters,
-        Past &past
+        Past &past,
+        std::mt19937 &rng
     );
 
     /**
@@ -371,19 +321,31 @@ private:
     void gen_alters(
         const utils::List<ir::compat::GateRef> &gates,
         utils::List<Alter> &alters,
-        Past &past
+        Past &past,
+        std::mt19937 &rng
     );
 
     /**
-     * Seeds the random number generator with the current time in microseconds.
+     * Seeds the random number generator with the random_seed option, or with
+     * the current time in microseconds if that is 0.
      */
     void random_init();
 
+    /**
+     * Calls function for each index in [0, count), concurrently if a thread
+     * pool was configured, or serially in index order otherwise.
+     */
+    void parallel_for(utils::UInt count, const std::function<void(utils::UInt)> &function);
+
     /**
      * Chooses an Alter from the list based on the configured tie-breaking
-     * strategy.
+     * strategy, using rng for the RANDOM strategy.
      */
-    Alter tie_break_alter(utils::List<Alter> &alters, Future &future);
+    Alter tie_break_alter(
+        utils::List<Alter> &alters,
+        Future &future,
+        std::mt19937 &rng
+    );
 
     /**
      * Map the gate/operands of a gate that has been routed or doesn't require
@@ -446,6 +408,12 @@ private:
      *
      * For recursion, past is the speculative past, and base_past is the past
      * we've already committed to, and should thus measure fitness against.
+     *
+     * The good alternatives of a recursion step are independent of each
+     * other, so they are evaluated on the thread pool when one exists. rng
+     * is only used on the calling thread; each alternative receives its own
+     * generator, seeded from rng in list order before the alternatives are
+     * evaluated.
      */
     void select_alter(
         utils::List<Alter> &alters,
@@ -453,7 +421,8 @@ private:
         Future &future,
         Past &past,
         Past &base_past,
-        utils::UInt recursion_depth
+        utils::UInt recursion_depth,
+        std::mt19937 &rng
     );
 
     /**
@@ -507,9 +476,28 @@ private:
      */
     void map_kernel(const ir::compat::KernelRef &k);
 
+    /**
+     * Gives a location to all virtual qubits that are still going to
+     * interact, i.e. the operands of the given non-mappable gates and of all
+     * remaining two-qubit gates. Done once per kernel, before chong() is
+     * first used.
+     */
+    void map_interacting_qubits(
+        const utils::List<ir::compat::GateRef> &gates,
+        const Future &future,
+        Past &past);
+
+    /**
+     * Routes the given non-mappable two-qubit gates for multi-core platforms
+     * with full connectivity within the cores, by repartitioning the qubits
+     * over the cores such that the operands of each gate end up in the same
+     * core. The partitioning is driven by the interaction weights of the gate
+     * and the upcoming two-qubit gates that have not been mapped yet, so gates
+     * routed earlier on no longer contribute. map_interacting_qubits() must
+     * have been called first.
+     */
     void chong(
         utils::List<ir::compat::GateRef> &gates,
-        utils::List<ir::compat::GateRef> &remaining_gates,
         Future &future,
         Past &past,
         Past &base_past);
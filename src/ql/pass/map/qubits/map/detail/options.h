@@ -236,6 +236,12 @@ struct Options {
      */
     TieBreakMethod tie_break_method = TieBreakMethod::RANDOM;
 
+    /**
+     * Seed for the random number generator used for random tie-breaking and
+     * path selection. 0 means seeding from the current time.
+     */
+    utils::UInt random_seed = 0;
+
     /**
      * Controls the strategy for selecting the next gate(s) to map.
      */
@@ -274,6 +280,13 @@ struct Options {
      */
     utils::Real recursion_width_exponent = 1.0;
 
+    /**
+     * Number of threads used to evaluate the good alternatives of a recursion
+     * step concurrently. 1 means serial evaluation, 0 means as many threads as
+     * the hardware supports.
+     */
+    utils::UInt recursion_threads = 1;
+
     /**
      * Whether to use move gates if possible, instead of always using swap.
      */
@@ -5,6 +5,7 @@
 #include "past.h"
 
 #include "ql/utils/filesystem.h"
+#include "ql/utils/set.h"
 #include "ql/pass/map/qubits/place_mip/detail/algorithm.h"
 
 // uncomment next line to enable multi-line dumping
@@ -24,6 +25,7 @@ void Past::initialize(const ir::compat::KernelRef &k, const OptionsRef &opt) {
     QL_DOUT("Past::initialize");
     platform = k->platform;
     kernel = k;
+    kernel_mutex = std::make_shared<std::mutex>();
     options = opt;
 
     nq = platform->qubit_count;
@@ -42,7 +44,6 @@ void Past::initialize(const ir::compat::KernelRef &k, const OptionsRef &opt) {
     output_gates.clear();             // no gates output yet by flushing from or bypassing this past
     num_swaps_added = 0;              // no swaps or moves added yet to this past; AddSwap adds one here
     num_moves_added = 0;              // no moves added yet to this past; AddSwap may add one here
-    cycle.clear();                    // no gates have cycles assigned in this past; scheduling gate updates this
 }
 
 /**
@@ -89,19 +90,17 @@ void Past::print(const utils::Str &s) const {
     v2r.dump_state();
     fc.print("");
     // QL_DOUT("... list of gates in past");
-    for (auto &gp : gates) {
-        QL_DOUT("[" << cycle.at(gp) << "] " << gp->qasm());
-    }
+    gates.debug_print();
 }
 
 /**
- * Schedules all waiting gates into the main gates list. Note that these
- * gates all are mapped and so have real operand qubit indices. The
- * FreeCycle map reflects for each qubit the first free cycle. All new
- * gates, now in waitinglist, get such a cycle assigned below, increased
- * gradually, until definitive.
+ * Schedules all waiting gates into the main gates list for the
+ * resource-constrained heuristics. Resource availability is not local to the
+ * operands of a gate, so each gate is evaluated against a trial FreeCycle map
+ * in which all gates ahead of it in the waiting list have been tentatively
+ * scheduled.
  */
-void Past::schedule() {
+void Past::schedule_with_trial_map() {
     // the copy includes the resource manager.
     // QL_DOUT("Schedule ...");
 
@@ -142,42 +141,162 @@ void Past::schedule() {
         // assignment).
         // QL_DOUT("... add " << gp->qasm() << " startcycle=" << startCycle << " cycles=" << ((gp->duration+ct-1)/ct) );
         fc.add(gate, start_cycle);
-        cycle.set(gate) = start_cycle; // cycle[gp] is private to this past but gp->cycle is private to gp
         gate->cycle = start_cycle; // so gp->cycle gets assigned for each alter' Past and finally definitively for mainPast
         // QL_DOUT("... set " << gp->qasm() << " at cycle " << startCycle);
 
-        // Insert gate into the list of gates, in cycle[gp] order, and inside
-        // this order, as late as possible.
-        //
-        // Reverse iterate because the insertion is near the end of the list.
-        // Insert so that cycle values are in order afterwards and the new one
-        // is nearest to the end.
-        auto rigp = gates.rbegin();
-        utils::Bool inserted = false;
-        for (; rigp != gates.rend(); rigp++) {
-            if (cycle.at(*rigp) <= start_cycle) {
-
-                // rigp.base() because insert doesn't work with reverse iteration
-                // rigp.base points after the element that rigp is pointing at
-                // which is lucky because insert only inserts before the given
-                // element. The net result is inserting after rigp.
-                gates.insert(rigp.base(), gate);
-
-                inserted = true;
-                break;
+        // Insert gate into the list of gates, in cycle order, and inside
+        // this order, as late as possible. The cycle stored in the list is
+        // private to this past, whereas gp->cycle is private to gp. The
+        // insertion is near the end of the list, which is where GateChain
+        // insertion is cheap.
+        gates.insert_ordered(gate, start_cycle);
+
+        // Having added it to the main list, remove it from the waiting list.
+        waiting_gates.erase(gate_it);
+    }
+}
+
+/**
+ * Schedules all waiting gates into the main gates list for the heuristics
+ * without resource constraints, in an event-driven fashion: gates become ready
+ * when all gates ahead of them in the waiting list that write one of their
+ * operands have been scheduled, and the ready gate with the lowest start cycle
+ * is scheduled first.
+ *
+ * This yields exactly the same schedule as schedule_with_trial_map() would.
+ * The gate picked there is the first one in the waiting list with the lowest
+ * trial start cycle. A gate that is not ready starts no earlier than the gate
+ * ahead of it that it depends on, so that gate is always ready; and without
+ * resource constraints, the start cycle of a ready gate only depends on the
+ * FreeCycle map entries of its own operands, which the gates ahead of it do
+ * not write. Hence it suffices to keep the ready gates ordered by their start
+ * cycle and waiting list position, and to recompute the start cycle of only
+ * those ready gates that read an operand written by the gate just scheduled.
+ */
+void Past::schedule_with_ready_set() {
+    utils::Vec<ir::compat::GateRef> waiting(waiting_gates.begin(), waiting_gates.end());
+    utils::UInt num_waiting = waiting.size();
+
+    // Determine the FreeCycle map entries read and written by each gate;
+    // qubits first, then bregs, like in FreeCycle.
+    utils::Vec<utils::Vec<utils::UInt>> reads(num_waiting);
+    utils::Vec<utils::Vec<utils::UInt>> writes(num_waiting);
+    for (utils::UInt i = 0; i < num_waiting; i++) {
+        const auto &gate = waiting[i];
+        for (auto qreg : gate->operands) {
+            writes[i].push_back(qreg);
+        }
+        for (auto breg : gate->breg_operands) {
+            writes[i].push_back(nq + breg);
+        }
+        reads[i] = writes[i];
+        if (gate->is_conditional()) {
+            for (auto breg : gate->cond_operands) {
+                reads[i].push_back(nq + breg);
             }
         }
+    }
 
-        // When list was empty or no element was found, just put it in front.
-        if (!inserted) {
-            gates.push_front(gate);
+    // Build the dependency graph. A gate depends on the last gate ahead of it
+    // that writes an entry it reads; earlier writers of that entry are
+    // ancestors of that gate already, because a gate reads all entries it
+    // writes.
+    utils::Vec<utils::UInt> num_preds(num_waiting, 0);
+    utils::Vec<utils::Vec<utils::UInt>> succs(num_waiting);
+    utils::Map<utils::UInt, utils::UInt> last_writer;
+    for (utils::UInt i = 0; i < num_waiting; i++) {
+        utils::Set<utils::UInt> preds;
+        for (auto entry : reads[i]) {
+            auto it = last_writer.find(entry);
+            if (it != last_writer.end()) {
+                preds.insert(it->second);
+            }
+        }
+        for (auto pred : preds) {
+            succs[pred].push_back(i);
+            num_preds[i]++;
+        }
+        for (auto entry : writes[i]) {
+            last_writer.set(entry) = i;
+        }
+    }
+
+    // The ready set, ordered by start cycle and then by position in the
+    // waiting list, along with an index from FreeCycle map entry to the
+    // ready gates that read it.
+    utils::Vec<utils::UInt> start_cycle(num_waiting, 0);
+    utils::Set<std::pair<utils::UInt, utils::UInt>> ready;
+    utils::Map<utils::UInt, utils::Set<utils::UInt>> readers;
+    auto make_ready = [&](utils::UInt i) {
+        start_cycle[i] = fc.get_start_cycle(waiting[i]);
+        ready.insert({start_cycle[i], i});
+        for (auto entry : reads[i]) {
+            readers.set(entry).insert(i);
+        }
+    };
+    for (utils::UInt i = 0; i < num_waiting; i++) {
+        if (!num_preds[i]) {
+            make_ready(i);
+        }
+    }
+
+    utils::UInt num_scheduled = 0;
+    while (!ready.empty()) {
+        utils::UInt i = ready.begin()->second;
+        ready.erase(ready.begin());
+        for (auto entry : reads[i]) {
+            readers.set(entry).erase(i);
+        }
+        const auto &gate = waiting[i];
+
+        // Add this gate to the maps, scheduling the gate (doing the cycle
+        // assignment), and insert it into the list of gates in cycle order,
+        // as late as possible within its cycle; see schedule_with_trial_map().
+        fc.add(gate, start_cycle[i]);
+        gate->cycle = start_cycle[i];
+        gates.insert_ordered(gate, start_cycle[i]);
+        num_scheduled++;
+
+        // Ready gates reading an entry this gate wrote may now start later.
+        for (auto entry : writes[i]) {
+            auto it = readers.find(entry);
+            if (it == readers.end()) {
+                continue;
+            }
+            for (auto reader : it->second) {
+                ready.erase({start_cycle[reader], reader});
+                start_cycle[reader] = fc.get_start_cycle(waiting[reader]);
+                ready.insert({start_cycle[reader], reader});
+            }
+        }
+
+        // Release the gates that depend on this one.
+        for (auto succ : succs[i]) {
+            if (!--num_preds[succ]) {
+                make_ready(succ);
+            }
         }
 
-        // Having added it to the main list, remove it from the waiting list.
-        waiting_gates.erase(gate_it);
     }
+    QL_ASSERT(num_scheduled == num_waiting);
 
-    // DPRINT("Schedule:");
+    waiting_gates.clear();
+}
+
+/**
+ * Schedules all waiting gates into the main gates list. Note that these
+ * gates all are mapped and so have real operand qubit indices. The
+ * FreeCycle map reflects for each qubit the first free cycle. All new
+ * gates, now in waitinglist, get such a cycle assigned below, increased
+ * gradually, until definitive. Gates are scheduled in order of their start
+ * cycle; ties are broken by the order of the waiting list.
+ */
+void Past::schedule() {
+    if (options->heuristic == Heuristic::BASE_RC || options->heuristic == Heuristic::MIN_EXTEND_RC) {
+        schedule_with_trial_map();
+    } else {
+        schedule_with_ready_set();
+    }
 }
 
 /**
@@ -237,6 +356,10 @@ void Past::add(const ir::compat::GateRef &gate) {
  * the dependence graph or copied to a local circuit, and in
  * Mapper::route, a temporary local output circuit is used, which is
  * written to kernel.c only at the very end.
+ *
+ * Because the kernel is shared by all copies of this Past, including those of
+ * alternatives that are evaluated concurrently, the kludge is protected by
+ * the mutex they share.
  */
 utils::Bool Past::new_gate(
     ir::compat::GateRefs &circ,
@@ -249,6 +372,7 @@ utils::Bool Past::new_gate(
     ir::compat::ConditionType gcond,
     const utils::Vec<utils::UInt> &gcondregs
 ) const {
+    std::lock_guard<std::mutex> lock(*kernel_mutex);
     utils::Bool added;
     QL_ASSERT(circ.empty());
     QL_ASSERT(kernel->gates.empty());
@@ -679,9 +803,7 @@ utils::UInt Past::get_max_free_cycle() const {
  * optimization and can be taken out to someplace else.
  */
 void Past::flush_all() {
-    for (const auto &gate : gates) {
-        output_gates.push_back(gate);
-    }
+    gates.append_to(output_gates);
     gates.clear();         // so effectively, lg's content was moved to outlg
 
     // fc.Init(platformp, nb); // needed?
@@ -697,14 +819,16 @@ void Past::bypass(const ir::compat::GateRef &gate) {
     if (!gates.empty()) {
         flush_all();
     }
-    output_gates.push_back(gate);
+    output_gates.push_back(gate, gate->cycle);
 }
 
 /**
  * Flushes the output gate list to the given circuit.
  */
 void Past::flush_to_circuit(ir::compat::GateRefs &output_circuit) {
-    for (const auto &gate : output_gates) {
+    utils::List<ir::compat::GateRef> gates_to_flush;
+    output_gates.get_gates(gates_to_flush);
+    for (const auto &gate : gates_to_flush) {
         output_circuit.add(gate);
     }
     output_gates.clear();
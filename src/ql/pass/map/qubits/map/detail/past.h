@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include "ql/utils/num.h"
 #include "ql/utils/str.h"
 #include "ql/utils/list.h"
@@ -13,6 +15,7 @@
 #include "ql/com/map/qubit_mapping.h"
 #include "options.h"
 #include "free_cycle.h"
+#include "gate_chain.h"
 
 namespace ql {
 namespace pass {
@@ -40,6 +43,13 @@ namespace detail {
  * alternatives, a clone is made of the main past, to insert swaps and evaluate
  * the latency effects; note that inserting swaps changes the mapping.
  *
+ * Because cloning happens for every alternative at every recursion level,
+ * copying a Past is made cheap: the gate lists are persistent GateChains that
+ * share their contents with the original, and the resource state in the
+ * FreeCycle map is only cloned when the copy schedules a gate. The cost of a
+ * clone is thus proportional to the number of qubits rather than to the
+ * number of gates mapped so far.
+ *
  * On arrival of a quantum gate(s):
  *  - [isempty(waiting_gates)]
  *  - if 2q nonNN clone mult. pasts, in each clone add swap/move gates,
@@ -92,6 +102,12 @@ private:
      */
     ir::compat::KernelRef kernel;
 
+    /**
+     * Mutex protecting the gate creation kludge in new_gate(), which uses the
+     * kernel. Shared by all copies of this Past, as they share the kernel.
+     */
+    std::shared_ptr<std::mutex> kernel_mutex;
+
     /**
      * Parsed options record for the whole mapper pass.
      */
@@ -119,10 +135,13 @@ public:
 
     /**
      * State: list of q gates in this Past, scheduled by their (start) cycle
-     * values. So this is the result list of this Past, to compare with other
-     * Alters.
+     * values, which are stored along with the gates. So this is the result
+     * list of this Past, to compare with other Alters. cycle[gp] can be
+     * different for each gp for each past. gp->cycle is not used by
+     * map_gates, although updated by set_cycle called from
+     * MakeAvailable/TakeAvailable.
      */
-    utils::List<ir::compat::GateRef> gates;
+    GateChain gates;
 
 private:
 
@@ -130,15 +149,7 @@ private:
      * List of gates flushed out of this Past, not yet put in outCirc when
      * evaluating alternatives. output_gates stays constant; so no state.
      */
-    utils::List<ir::compat::GateRef> output_gates;
-
-    /**
-     * State: gate to cycle map, startCycle value of each past gatecycle[gp].
-     * cycle[gp] can be different for each gp for each past. gp->cycle is not
-     * used by map_gates, although updated by set_cycle called from
-     * MakeAvailable/TakeAvailable.
-     */
-    utils::Map<ir::compat::GateRef, utils::UInt> cycle;
+    GateChain output_gates;
 
     /**
      * Number of swaps (including moves) added to this past.
@@ -150,6 +161,24 @@ private:
      */
     utils::UInt num_moves_added;
 
+    /**
+     * Schedules all waiting gates into the main gates list for the
+     * resource-constrained heuristics. Resource availability is not local to
+     * the operands of a gate, so each gate is evaluated against a trial
+     * FreeCycle map in which all gates ahead of it in the waiting list have
+     * been tentatively scheduled.
+     */
+    void schedule_with_trial_map();
+
+    /**
+     * Schedules all waiting gates into the main gates list for the heuristics
+     * without resource constraints, in an event-driven fashion: gates become
+     * ready when all gates ahead of them in the waiting list that write one
+     * of their operands have been scheduled, and the ready gate with the
+     * lowest start cycle is scheduled first.
+     */
+    void schedule_with_ready_set();
+
 public:
 
     /**
@@ -188,7 +217,8 @@ public:
      * gates all are mapped and so have real operand qubit indices. The
      * FreeCycle map reflects for each qubit the first free cycle. All new
      * gates, now in waitinglist, get such a cycle assigned below, increased
-     * gradually, until definitive.
+     * gradually, until definitive. Gates are scheduled in order of their
+     * start cycle; ties are broken by the order of the waiting list.
      */
     void schedule();
 
@@ -0,0 +1,254 @@
+/** \file
+ * PathEnumerator implementation.
+ */
+
+#include "path_enumerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ql {
+namespace pass {
+namespace map {
+namespace qubits {
+namespace map {
+namespace detail {
+
+/**
+ * String conversion for PathStrategy.
+ */
+std::ostream &operator<<(std::ostream &os, PathStrategy p) {
+    switch (p) {
+        case PathStrategy::ALL:        os << "all";        break;
+        case PathStrategy::LEFT:       os << "left";       break;
+        case PathStrategy::RIGHT:      os << "right";      break;
+        case PathStrategy::LEFT_RIGHT: os << "left-right"; break;
+        case PathStrategy::RANDOM:     os << "random";     break;
+    }
+    return os;
+}
+
+/**
+ * Pushes a frame for the given qubit onto the stack, determining the qubits
+ * the path can continue to.
+ */
+void PathEnumerator::push(utils::UInt qubit, utils::UInt budget, PathStrategy strategy) {
+    stack.push_back({qubit, budget, strategy, {}, 0});
+    if (qubit == tgt) {
+        return;
+    }
+    QL_ASSERT(topology.get_distance(qubit, tgt) >= 1);
+
+    // Reduce the neighbors to those continuing a path within budget. The
+    // distance from qubit to tgt is at most budget, and the hop to the
+    // neighbor costs one, so the distance from the neighbor to tgt must be
+    // less than budget.
+    auto neighbors = topology.get_neighbors(qubit);
+    neighbors.remove_if([this, budget](const utils::UInt &n) {
+        return topology.get_distance(n, tgt) >= budget;
+    });
+
+    // Update the neighbor list according to the path strategy.
+    auto &next_qubits = stack.back().next_qubits;
+    if (strategy == PathStrategy::RANDOM) {
+
+        // Shuffle the neighbor list.
+        next_qubits.assign(neighbors.begin(), neighbors.end());
+        std::shuffle(next_qubits.begin(), next_qubits.end(), rng);
+
+    } else {
+
+        // Rotate neighbor list such that largest difference between angles of
+        // adjacent elements is beyond back(). This only makes sense when there
+        // is an underlying xy grid; when not, only the ALL strategy is
+        // supported.
+        QL_ASSERT(topology.has_coordinates() || strategy == PathStrategy::ALL);
+        topology.sort_neighbors_by_angle(qubit, neighbors);
+
+        // Select the subset of those neighbors that continue in direction(s)
+        // we want.
+        for (auto n : neighbors) {
+            if (
+                strategy == PathStrategy::ALL
+                || (strategy == PathStrategy::LEFT && n == neighbors.front())
+                || (strategy == PathStrategy::RIGHT && n == neighbors.back())
+                || (strategy == PathStrategy::LEFT_RIGHT && (n == neighbors.front() || n == neighbors.back()))
+            ) {
+                next_qubits.push_back(n);
+            }
+        }
+
+    }
+}
+
+/**
+ * Returns the strategy for continuing the path beyond the given continuation
+ * of the frame at the top of the stack.
+ */
+PathStrategy PathEnumerator::get_next_strategy(utils::UInt next_qubit) const {
+    const auto &top = stack.back();
+
+    // When looking both left and right still, and there is a choice now,
+    // split into left and right.
+    if (top.strategy == PathStrategy::LEFT_RIGHT && top.next_qubits.size() != 1) {
+        if (next_qubit == top.next_qubits.front()) {
+            return PathStrategy::LEFT;
+        } else {
+            return PathStrategy::RIGHT;
+        }
+    }
+    return top.strategy;
+}
+
+/**
+ * Returns the number of paths for the RANDOM strategy from the given qubit to
+ * the target within the given budget, saturating at utils::MAX.
+ */
+utils::UInt PathEnumerator::count(utils::UInt qubit, utils::UInt budget) {
+    if (qubit == tgt) {
+        return 1;
+    }
+    auto it = counts.find({qubit, budget});
+    if (it != counts.end()) {
+        return it->second;
+    }
+    utils::UInt result = 0;
+    for (auto n : topology.get_neighbors(qubit)) {
+        if (topology.get_distance(n, tgt) < budget) {
+            auto num_sub_paths = count(n, budget - 1);
+            if (num_sub_paths > utils::MAX - result) {
+                result = utils::MAX;
+            } else {
+                result += num_sub_paths;
+            }
+        }
+    }
+    counts.set({qubit, budget}) = result;
+    return result;
+}
+
+/**
+ * Constructs an enumerator for the paths from src to tgt within the given
+ * budget, which must be at least the distance between them.
+ */
+PathEnumerator::PathEnumerator(
+    const com::Topology &topology,
+    utils::UInt src,
+    utils::UInt tgt,
+    utils::UInt budget,
+    PathStrategy strategy,
+    std::mt19937 &rng
+) : topology(topology), tgt(tgt), rng(rng) {
+    push(src, budget, strategy);
+}
+
+/**
+ * Produces the next path, including the source and target qubits. Returns
+ * false when all paths have been produced.
+ */
+utils::Bool PathEnumerator::next(utils::Vec<utils::UInt> &path) {
+    while (!stack.empty()) {
+        auto &top = stack.back();
+
+        // Produce the path when the target has been reached.
+        if (top.qubit == tgt) {
+            path.clear();
+            for (const auto &frame : stack) {
+                path.push_back(frame.qubit);
+            }
+            stack.pop_back();
+            return true;
+        }
+
+        // Backtrack when all continuations have been explored.
+        if (top.next_index == top.next_qubits.size()) {
+            stack.pop_back();
+            continue;
+        }
+
+        // Explore the next continuation.
+        auto qubit = top.next_qubits[top.next_index++];
+        auto budget = top.budget - 1;
+        push(qubit, budget, get_next_strategy(qubit));
+
+    }
+    return false;
+}
+
+/**
+ * Skips the given number of paths without producing them, or all remaining
+ * paths if fewer remain. Only supported for the RANDOM strategy.
+ */
+void PathEnumerator::skip(utils::UInt num_paths) {
+    while (num_paths && !stack.empty()) {
+        auto &top = stack.back();
+        QL_ASSERT(top.strategy == PathStrategy::RANDOM);
+
+        // Skip the path that ends here.
+        if (top.qubit == tgt) {
+            stack.pop_back();
+            num_paths--;
+            continue;
+        }
+
+        // Backtrack when all continuations have been explored.
+        if (top.next_index == top.next_qubits.size()) {
+            stack.pop_back();
+            continue;
+        }
+
+        // Skip all paths through the next continuation if that does not skip
+        // too many, otherwise descend into it.
+        auto qubit = top.next_qubits[top.next_index++];
+        auto budget = top.budget - 1;
+        auto num_sub_paths = count(qubit, budget);
+        if (num_sub_paths <= num_paths) {
+            num_paths -= num_sub_paths;
+        } else {
+            push(qubit, budget, PathStrategy::RANDOM);
+        }
+
+    }
+}
+
+/**
+ * Takes a uniform random sample of num_paths paths from the remaining paths,
+ * or all remaining paths if fewer remain, in no particular order. This uses
+ * reservoir sampling with geometrically distributed skips (Li's algorithm L),
+ * such that the number of paths that are actually generated only grows
+ * logarithmically with the total. Only supported for the RANDOM strategy.
+ */
+utils::Vec<utils::Vec<utils::UInt>> PathEnumerator::sample(utils::UInt num_paths) {
+    utils::Vec<utils::Vec<utils::UInt>> reservoir;
+    if (!num_paths) {
+        return reservoir;
+    }
+    std::uniform_real_distribution<utils::Real> unit(0.0, 1.0);
+    auto uniform = [&unit, this]() { return 1.0 - unit(rng); };
+    std::uniform_int_distribution<utils::UInt> slot(0, num_paths - 1);
+    utils::Vec<utils::UInt> path;
+    while (reservoir.size() < num_paths && next(path)) {
+        reservoir.push_back(path);
+    }
+    utils::Real w = std::exp(std::log(uniform()) / num_paths);
+    while (reservoir.size() == num_paths && w < 1.0) {
+        utils::Real num_skip = std::floor(std::log(uniform()) / std::log(1.0 - w));
+        if (num_skip >= (utils::Real)utils::MAX) {
+            break;
+        }
+        skip((utils::UInt)num_skip);
+        if (!next(path)) {
+            break;
+        }
+        reservoir[slot(rng)] = path;
+        w *= std::exp(std::log(uniform()) / num_paths);
+    }
+    return reservoir;
+}
+
+} // namespace detail
+} // namespace map
+} // namespace qubits
+} // namespace map
+} // namespace pass
+} // namespace ql
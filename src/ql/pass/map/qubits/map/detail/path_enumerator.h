@@ -0,0 +1,197 @@
+/** \file
+ * PathEnumerator implementation.
+ */
+
+#pragma once
+
+#include <random>
+#include "ql/utils/num.h"
+#include "ql/utils/pair.h"
+#include "ql/utils/vec.h"
+#include "ql/utils/map.h"
+#include "ql/com/topology.h"
+
+namespace ql {
+namespace pass {
+namespace map {
+namespace qubits {
+namespace map {
+namespace detail {
+
+/**
+ * Strategy options for finding routing paths.
+ */
+enum class PathStrategy {
+
+    /**
+     * Consider all shortest path alternatives.
+     */
+    ALL,
+
+    /**
+     * Only consider the shortest path along the left side of the rectangle of
+     * the source and target qubit.
+     */
+    LEFT,
+
+    /**
+     * Only consider the shortest path along the right side of the rectangle of
+     * the source and target qubit.
+     */
+    RIGHT,
+
+    /**
+     * Consider the shortest paths along both the left and right side of the
+     * rectangle of the source and target qubit.
+     */
+    LEFT_RIGHT,
+
+    /**
+     * Consider all path alternatives, but randomize the order of the generated
+     * paths. This is useful when the amount of generated alternative paths
+     * needs to be limited for scalability.
+     */
+    RANDOM
+
+};
+
+/**
+ * String conversion for PathStrategy.
+ */
+std::ostream &operator<<(std::ostream &os, PathStrategy p);
+
+/**
+ * PathEnumerator: lazily enumerates the paths between a source and target
+ * qubit, bounded by a hop budget and a particular strategy.
+ *
+ * From each qubit, the path continues to the neighbors that leave the target
+ * within the remaining budget, restricted by the strategy. The paths are
+ * produced one at a time in depth-first order, so the cost of obtaining the
+ * first N paths does not depend on the total number of paths, which grows
+ * combinatorially with the distance on grids. For the RANDOM strategy, the
+ * neighbors are shuffled as they are visited, and whole subtrees of paths
+ * can be skipped without visiting them, which makes sampling from all paths
+ * possible in time proportional to the sample size.
+ */
+class PathEnumerator {
+private:
+
+    /**
+     * A qubit on the path currently being explored.
+     */
+    struct Frame {
+
+        /**
+         * The qubit.
+         */
+        utils::UInt qubit;
+
+        /**
+         * The number of hops remaining from this qubit.
+         */
+        utils::UInt budget;
+
+        /**
+         * The strategy used for continuing the path from this qubit.
+         */
+        PathStrategy strategy;
+
+        /**
+         * The qubits the path can continue to, in order of exploration.
+         */
+        utils::Vec<utils::UInt> next_qubits;
+
+        /**
+         * Index of the next entry of next_qubits to explore.
+         */
+        utils::UInt next_index;
+
+    };
+
+    /**
+     * The topology to route through.
+     */
+    const com::Topology &topology;
+
+    /**
+     * The target qubit.
+     */
+    utils::UInt tgt;
+
+    /**
+     * The random number generator used to shuffle neighbors for the RANDOM
+     * strategy.
+     */
+    std::mt19937 &rng;
+
+    /**
+     * The path currently being explored, from source to the qubit whose
+     * continuations are explored next.
+     */
+    utils::Vec<Frame> stack;
+
+    /**
+     * Memoized results of count(), indexed by qubit and budget.
+     */
+    utils::Map<utils::Pair<utils::UInt, utils::UInt>, utils::UInt> counts;
+
+    /**
+     * Pushes a frame for the given qubit onto the stack, determining the
+     * qubits the path can continue to.
+     */
+    void push(utils::UInt qubit, utils::UInt budget, PathStrategy strategy);
+
+    /**
+     * Returns the strategy for continuing the path beyond the given
+     * continuation of the frame at the top of the stack.
+     */
+    PathStrategy get_next_strategy(utils::UInt next_qubit) const;
+
+    /**
+     * Returns the number of paths for the RANDOM strategy from the given qubit
+     * to the target within the given budget, saturating at utils::MAX.
+     */
+    utils::UInt count(utils::UInt qubit, utils::UInt budget);
+
+public:
+
+    /**
+     * Constructs an enumerator for the paths from src to tgt within the given
+     * budget, which must be at least the distance between them.
+     */
+    PathEnumerator(
+        const com::Topology &topology,
+        utils::UInt src,
+        utils::UInt tgt,
+        utils::UInt budget,
+        PathStrategy strategy,
+        std::mt19937 &rng
+    );
+
+    /**
+     * Produces the next path, including the source and target qubits.
+     * Returns false when all paths have been produced.
+     */
+    utils::Bool next(utils::Vec<utils::UInt> &path);
+
+    /**
+     * Skips the given number of paths without producing them, or all
+     * remaining paths if fewer remain. Only supported for the RANDOM strategy.
+     */
+    void skip(utils::UInt num_paths);
+
+    /**
+     * Takes a uniform random sample of num_paths paths from the remaining
+     * paths, or all remaining paths if fewer remain, in no particular order.
+     * Only supported for the RANDOM strategy.
+     */
+    utils::Vec<utils::Vec<utils::UInt>> sample(utils::UInt num_paths);
+
+};
+
+} // namespace detail
+} // namespace map
+} // namespace qubits
+} // namespace map
+} // namespace pass
+} // namespace ql
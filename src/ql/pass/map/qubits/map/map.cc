@@ -234,6 +234,15 @@ MapQubitsPass::MapQubitsPass(
         {"first", "last", "random", "critical"}
     );
 
+    options.add_int(
+        "random_seed",
+        "Seed for the random number generator used by the `random` "
+        "tie-breaking method and path selection mode. `0` seeds it from the "
+        "current time, so the result may differ from run to run.",
+        "0",
+        0, utils::MAX
+    );
+
     options.add_enum(
         "lookahead_mode",
         "Controls the strategy for selecting the next gate(s) to map. When `no`, "
@@ -267,7 +276,8 @@ MapQubitsPass::MapQubitsPass(
         "planar coordinates in the topology section of the platform "
         "configuration file. Both `all` and `random` consider all paths, but "
         "for the latter the order in which the paths are generated is shuffled, "
-        "which is useful to reduce bias when `max_alternative_routes` is used.",
+        "and when `max_alternative_routes` is used, the paths are sampled "
+        "uniformly from all paths rather than taking the first ones found.",
         "all",
         {"all", "borders", "random"}
     );
@@ -328,6 +338,21 @@ MapQubitsPass::MapQubitsPass(
         0.0, 1.0
     );
 
+    options.add_int(
+        "recursion_threads",
+        "Number of threads used to evaluate the good alternatives of a "
+        "recursion step concurrently when one of the `minextend` heuristics "
+        "is used. `1` evaluates them serially on the calling thread, `0` "
+        "uses as many threads as the hardware supports. The mapping result "
+        "does not depend on the number of threads. To ensure this, each "
+        "alternative draws random numbers from its own generator, seeded from "
+        "the main generator in list order, also when evaluating serially; "
+        "random tie-breaking therefore makes different (but equally valid) "
+        "choices during recursion than before this option existed.",
+        "1",
+        0, utils::MAX
+    );
+
     options.add_int(
         "use_moves",
         "Controls if/when the mapper inserts move gates rather than swap gates "
@@ -422,6 +447,7 @@ pmgr::pass_types::NodeType MapQubitsPass::on_construct(
     }
 
     parsed_options->max_alters = options["max_alternative_routes"].as_uint();
+    parsed_options->random_seed = options["random_seed"].as_uint();
 
     auto tie_break_method = options["tie_break_method"].as_str();
     if (tie_break_method == "first") {
@@ -481,6 +507,7 @@ pmgr::pass_types::NodeType MapQubitsPass::on_construct(
 
     parsed_options->recursion_width_factor = options["recursion_width_factor"].as_real();
     parsed_options->recursion_width_exponent = options["recursion_width_exponent"].as_real();
+    parsed_options->recursion_threads = options["recursion_threads"].as_uint();
 
     auto use_moves = options["use_moves"].as_str();
     if (use_moves == "no") {
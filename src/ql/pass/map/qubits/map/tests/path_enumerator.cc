@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <random>
+
+#include "ql/utils/num.h"
+#include "ql/utils/vec.h"
+#include "ql/utils/set.h"
+#include "ql/utils/map.h"
+#include "ql/com/topology.h"
+#include "../detail/path_enumerator.h"
+
+using namespace ql::utils;
+using namespace ql::com;
+using namespace ql::pass::map::qubits::map::detail;
+
+using Path = Vec<UInt>;
+
+/**
+ * Builds an XY topology for a width x height grid with bidirectional
+ * nearest-neighbor edges.
+ */
+static Json grid_json(UInt width, UInt height) {
+    Json json;
+    json["form"] = "xy";
+    json["x_size"] = width;
+    json["y_size"] = height;
+    json["qubits"] = Json::array();
+    json["connectivity"] = "specified";
+    json["edges"] = Json::array();
+    auto add = [&json](UInt a, UInt b) {
+        json["edges"].push_back({{"src", a}, {"dst", b}});
+        json["edges"].push_back({{"src", b}, {"dst", a}});
+    };
+    for (UInt y = 0; y < height; y++) {
+        for (UInt x = 0; x < width; x++) {
+            UInt q = y * width + x;
+            json["qubits"].push_back({{"id", q}, {"x", x}, {"y", y}});
+            if (x + 1 < width) add(q, q + 1);
+            if (y + 1 < height) add(q, q + width);
+        }
+    }
+    return json;
+}
+
+/**
+ * Enumerates all paths from src to tgt the way the mapper did before the
+ * PathEnumerator was introduced: eagerly and recursively, shuffling the
+ * neighbors of each qubit for the RANDOM strategy as it is visited.
+ */
+static void eager_paths(
+    const Topology &top,
+    Path &prefix,
+    UInt src,
+    UInt tgt,
+    UInt budget,
+    PathStrategy strategy,
+    std::mt19937 &rng,
+    Vec<Path> &paths
+) {
+    prefix.push_back(src);
+    if (src == tgt) {
+        paths.push_back(prefix);
+        prefix.pop_back();
+        return;
+    }
+    auto neighbors = top.get_neighbors(src);
+    neighbors.remove_if([&top, budget, tgt](const UInt &n) { return top.get_distance(n, tgt) >= budget; });
+    if (strategy == PathStrategy::RANDOM) {
+        Vec<UInt> neighbors_vec{neighbors.begin(), neighbors.end()};
+        std::shuffle(neighbors_vec.begin(), neighbors_vec.end(), rng);
+        neighbors.clear();
+        neighbors.insert(neighbors.begin(), neighbors_vec.begin(), neighbors_vec.end());
+    } else {
+        top.sort_neighbors_by_angle(src, neighbors);
+        if (strategy == PathStrategy::LEFT) {
+            neighbors.remove_if([neighbors](const UInt &n) { return n != neighbors.front(); } );
+        } else if (strategy == PathStrategy::RIGHT) {
+            neighbors.remove_if([neighbors](const UInt &n) { return n != neighbors.back(); } );
+        } else if (strategy == PathStrategy::LEFT_RIGHT) {
+            neighbors.remove_if([neighbors](const UInt &n) { return n != neighbors.front() && n != neighbors.back(); } );
+        }
+    }
+    for (auto n : neighbors) {
+        PathStrategy new_strategy = strategy;
+        if (strategy == PathStrategy::LEFT_RIGHT && neighbors.size() != 1) {
+            new_strategy = (n == neighbors.front()) ? PathStrategy::LEFT : PathStrategy::RIGHT;
+        }
+        eager_paths(top, prefix, n, tgt, budget - 1, new_strategy, rng, paths);
+    }
+    prefix.pop_back();
+}
+
+/**
+ * Checks that lazily enumerating all paths gives the same paths in the same
+ * order as the eager enumeration, and consumes the same random numbers.
+ */
+static void check_enumeration(const Topology &top, UInt src, UInt tgt, PathStrategy strategy) {
+    UInt budget = top.get_distance(src, tgt);
+
+    std::mt19937 eager_rng(42);
+    Vec<Path> expected;
+    Path prefix;
+    eager_paths(top, prefix, src, tgt, budget, strategy, eager_rng, expected);
+
+    std::mt19937 lazy_rng(42);
+    PathEnumerator paths(top, src, tgt, budget, strategy, lazy_rng);
+    Vec<Path> actual;
+    Path path;
+    while (paths.next(path)) {
+        actual.push_back(path);
+    }
+
+    QL_ASSERT(!actual.empty());
+    QL_ASSERT(actual == expected);
+    QL_ASSERT(lazy_rng() == eager_rng());
+}
+
+/**
+ * Checks that a sample of the given size consists of that many distinct
+ * valid paths, or of all paths if there are fewer.
+ */
+static void check_sample(const Topology &top, UInt src, UInt tgt, UInt num_paths) {
+    UInt budget = top.get_distance(src, tgt);
+
+    std::mt19937 rng(1);
+    Vec<Path> all;
+    Path prefix;
+    eager_paths(top, prefix, src, tgt, budget, PathStrategy::ALL, rng, all);
+    Set<Path> all_set(all.begin(), all.end());
+
+    std::mt19937 sample_rng(42);
+    auto sample = PathEnumerator(top, src, tgt, budget, PathStrategy::RANDOM, sample_rng).sample(num_paths);
+    Set<Path> sample_set(sample.begin(), sample.end());
+    QL_ASSERT(sample.size() == std::min<UInt>(num_paths, all.size()));
+    QL_ASSERT(sample_set.size() == sample.size());
+    for (const auto &path : sample) {
+        QL_ASSERT(all_set.count(path));
+    }
+    if (num_paths >= all.size()) {
+        QL_ASSERT(sample_set == all_set);
+    }
+
+    // The same seed must give the same sample.
+    std::mt19937 same_rng(42);
+    auto same = PathEnumerator(top, src, tgt, budget, PathStrategy::RANDOM, same_rng).sample(num_paths);
+    QL_ASSERT(same == sample);
+}
+
+int main() {
+    Topology top(36, grid_json(6, 6));
+
+    // Without a limit, the lazy enumeration must match the eager one for all
+    // strategies, for corner-to-corner, straight, and short paths.
+    for (auto strategy : {PathStrategy::ALL, PathStrategy::LEFT_RIGHT, PathStrategy::RANDOM}) {
+        check_enumeration(top, 0, 35, strategy);
+        check_enumeration(top, 35, 0, strategy);
+        check_enumeration(top, 7, 22, strategy);
+        check_enumeration(top, 2, 32, strategy);
+        check_enumeration(top, 14, 15, strategy);
+        check_enumeration(top, 14, 14, strategy);
+    }
+
+    // Corner to corner there are 10 choose 5 = 252 shortest paths. Samples
+    // must be capped at the requested size, and include everything when the
+    // cap does not apply.
+    for (auto num_paths : {1, 2, 10, 100, 251, 252, 253, 1000}) {
+        check_sample(top, 0, 35, num_paths);
+    }
+    check_sample(top, 7, 22, 3);
+    check_sample(top, 14, 15, 3);
+
+    // Samples of a single path must be roughly uniform over all paths, also
+    // when most of them are skipped without being generated. With 100
+    // expected hits per path, the bounds are more than five standard
+    // deviations away.
+    std::mt19937 rng(42);
+    Map<Path, UInt> hits;
+    for (UInt i = 0; i < 25200; i++) {
+        auto sample = PathEnumerator(top, 0, 35, 10, PathStrategy::RANDOM, rng).sample(1);
+        QL_ASSERT(sample.size() == 1);
+        hits.set(sample[0])++;
+    }
+    QL_ASSERT(hits.size() == 252);
+    for (const auto &it : hits) {
+        QL_ASSERT(it.second > 50 && it.second < 150);
+    }
+
+    return 0;
+}
@@ -4,7 +4,9 @@
 
 #include "ql/pass/sch/list_schedule/list_schedule.h"
 
+#include <mutex>
 #include "ql/utils/filesystem.h"
+#include "ql/utils/thread_pool.h"
 #include "ql/ir/old_to_new.h"
 #include "ql/com/ddg/build.h"
 #include "ql/com/ddg/ops.h"
@@ -30,7 +32,8 @@ void ListSchedulePass::dump_docs(
     utils::dump_str(os, line_prefix, R"(
     This pass analyzes the data dependencies between statements and applies
     quantum cycle numbers to them using optionally resource-constrained ASAP or
-    ALAP list scheduling. All blocks in the program are scheduled independently.
+    ALAP list scheduling. All blocks in the program are scheduled independently,
+    and can thus be scheduled concurrently using the `block_threads` option.
     )");
 }
 
@@ -114,20 +117,28 @@ ListSchedulePass::ListSchedulePass(
         false
     );
 
+    options.add_int(
+        "block_threads",
+        "Number of threads used to schedule the blocks of the program "
+        "concurrently. The sub-blocks of structured control-flow statements "
+        "are scheduled concurrently as well, after the block containing them. "
+        "`1` schedules all blocks serially on the calling thread, `0` uses as "
+        "many threads as the hardware supports. The result does not depend on "
+        "the number of threads.",
+        "1",
+        0, utils::MAX
+    );
+
 }
 
 /**
- * Runs the scheduler on the given block.
+ * Returns a name based on name_path that is not in used_names yet, and adds
+ * it to used_names.
  */
-void ListSchedulePass::run_on_block(
-    const ir::Ref &ir,
-    const ir::BlockBaseRef &block,
+static utils::Str make_unique_name(
     const utils::Str &name_path,
-    utils::Set<utils::Str> &used_names,
-    const pmgr::pass_types::Context &context
+    utils::Set<utils::Str> &used_names
 ) {
-
-    // Figure out a unique name for this block.
     utils::Str name = name_path;
     if (!used_names.insert(name).second) {
         utils::UInt i = 1;
@@ -135,6 +146,48 @@ void ListSchedulePass::run_on_block(
             name = name_path + "_" + utils::to_string(i++);
         } while (!used_names.insert(name).second);
     }
+    return name;
+}
+
+/**
+ * Returns the sub-blocks of the structured control-flow statements in the
+ * given block in statement order, along with the suffix for their name.
+ */
+static utils::Vec<utils::Pair<ir::BlockBaseRef, utils::Str>> get_sub_blocks(
+    const ir::BlockBaseRef &block
+) {
+    utils::Vec<utils::Pair<ir::BlockBaseRef, utils::Str>> sub_blocks;
+    for (const auto &statement : block->statements) {
+        if (auto if_else = statement->as_if_else()) {
+            for (const auto &branch : if_else->branches) {
+                sub_blocks.push_back({branch->body, "_if"});
+            }
+            if (!if_else->otherwise.empty()) {
+                sub_blocks.push_back({if_else->otherwise, "_else"});
+            }
+        } else if (auto loop = statement->as_loop()) {
+            sub_blocks.push_back({loop->body, "_loop"});
+        }
+    }
+    return sub_blocks;
+}
+
+/**
+ * Schedules the statements in the given block, not including those in its
+ * sub-blocks. The name is only used for logging. Returns the dot
+ * representation of the data dependency graph and schedule if the
+ * write_dot_graphs option is set, or an empty string otherwise.
+ *
+ * This only touches the given block, so it may be called concurrently for
+ * different blocks, as long as it isn't called for a sub-block while its
+ * parent block is being scheduled.
+ */
+static utils::Str schedule_block(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block,
+    const utils::Str &name,
+    const pmgr::pass_types::Context &context
+) {
 
     // Build a data dependency graph for the block.
     com::ddg::build(
@@ -222,11 +275,10 @@ void ListSchedulePass::run_on_block(
     QL_DOUT("dumping dot file (disabled)");
 #endif
 
-    // Write the schedule as a dot file if requested.
+    // Render the schedule as a dot graph if requested.
+    utils::StrStrm dot;
     if (context.options["write_dot_graphs"].as_bool()) {
-        auto filename = context.output_prefix + "_" + name + ".dot";
-        QL_DOUT("writing dot output to " << filename);
-        com::ddg::dump_dot(block, utils::OutFile(filename).unwrap());
+        com::ddg::dump_dot(block, dot);
     }
 
     // Clean up the DDG.
@@ -236,20 +288,113 @@ void ListSchedulePass::run_on_block(
     // the corresponding kernel when new-to-old conversion is applied.
     block->set_annotation<ir::KernelCyclesValid>({true});
 
+    return dot.str();
+}
+
+/**
+ * Writes the given dot graph for the block with the given unique name, if
+ * dot graphs were requested.
+ */
+static void write_dot_graph(
+    const utils::Str &dot,
+    const utils::Str &name,
+    const pmgr::pass_types::Context &context
+) {
+    if (context.options["write_dot_graphs"].as_bool()) {
+        auto filename = context.output_prefix + "_" + name + ".dot";
+        QL_DOUT("writing dot output to " << filename);
+        utils::OutFile(filename) << dot;
+    }
+}
+
+/**
+ * Runs the scheduler on the given block.
+ */
+void ListSchedulePass::run_on_block(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block,
+    const utils::Str &name_path,
+    utils::Set<utils::Str> &used_names,
+    const pmgr::pass_types::Context &context
+) {
+
+    // Figure out a unique name for this block.
+    auto name = make_unique_name(name_path, used_names);
+
+    // Schedule the block and write the schedule as a dot file if requested.
+    write_dot_graph(schedule_block(ir, block, name, context), name, context);
+
     // Recurse into structured control-flow sub-blocks.
-    for (const auto &statement : block->statements) {
-        if (auto if_else = statement->as_if_else()) {
-            for (const auto &branch : if_else->branches) {
-                run_on_block(ir, branch->body, name + "_if", used_names, context);
-            }
-            if (!if_else->otherwise.empty()) {
-                run_on_block(ir, if_else->otherwise, name + "_else", used_names, context);
-            }
-        } else if (auto loop = statement->as_loop()) {
-            run_on_block(ir, loop->body, name + "_loop", used_names, context);
-        }
+    for (const auto &sub_block : get_sub_blocks(block)) {
+        run_on_block(ir, sub_block.first, name + sub_block.second, used_names, context);
+    }
+
+}
+
+/**
+ * Dot graphs rendered by concurrent scheduling, to be written once all
+ * blocks have been scheduled and named.
+ */
+struct DotGraphs {
+
+    /**
+     * The dot graph for each block.
+     */
+    utils::Map<ir::BlockBaseRef, utils::Str> graphs;
+
+    /**
+     * Mutex protecting graphs.
+     */
+    std::mutex mutex;
+
+};
+
+/**
+ * Schedules the given block on the calling thread, and then its sub-blocks
+ * concurrently using the given thread pool. The name path is only used for
+ * logging; blocks are only given a unique name afterwards by name_blocks(),
+ * because that depends on the order of the statements in the parent block
+ * after scheduling.
+ */
+static void schedule_blocks(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block,
+    const utils::Str &name_path,
+    const pmgr::pass_types::Context &context,
+    utils::ThreadPool &pool,
+    DotGraphs &dot_graphs
+) {
+    auto dot = schedule_block(ir, block, name_path, context);
+    if (!dot.empty()) {
+        std::lock_guard<std::mutex> lock(dot_graphs.mutex);
+        dot_graphs.graphs.set(block) = std::move(dot);
     }
+    auto sub_blocks = get_sub_blocks(block);
+    pool.parallel_for(sub_blocks.size(), [&](utils::UInt i) {
+        schedule_blocks(
+            ir, sub_blocks[i].first, name_path + sub_blocks[i].second,
+            context, pool, dot_graphs
+        );
+    });
+}
 
+/**
+ * Names the given block and its sub-blocks after concurrent scheduling in the
+ * same order as run_on_block() does, and writes their dot graphs if
+ * requested.
+ */
+static void name_blocks(
+    const ir::BlockBaseRef &block,
+    const utils::Str &name_path,
+    utils::Set<utils::Str> &used_names,
+    const pmgr::pass_types::Context &context,
+    const DotGraphs &dot_graphs
+) {
+    auto name = make_unique_name(name_path, used_names);
+    write_dot_graph(dot_graphs.graphs.get(block, ""), name, context);
+    for (const auto &sub_block : get_sub_blocks(block)) {
+        name_blocks(sub_block.first, name + sub_block.second, used_names, context, dot_graphs);
+    }
 }
 
 /**
@@ -259,11 +404,24 @@ utils::Int ListSchedulePass::run(
     const ir::Ref &ir,
     const pmgr::pass_types::Context &context
 ) const {
+    if (ir->program.empty()) {
+        return 0;
+    }
     utils::Set<utils::Str> used_names;
-    if (!ir->program.empty()) {
+    utils::ThreadPool pool(context.options["block_threads"].as_uint());
+    if (pool.get_num_threads() == 1) {
         for (const auto &block : ir->program->blocks) {
             run_on_block(ir, block, block->name, used_names, context);
         }
+    } else {
+        DotGraphs dot_graphs;
+        const auto &blocks = ir->program->blocks;
+        pool.parallel_for(blocks.size(), [&](utils::UInt i) {
+            schedule_blocks(ir, blocks[i], blocks[i]->name, context, pool, dot_graphs);
+        });
+        for (const auto &block : blocks) {
+            name_blocks(block, block->name, used_names, context, dot_graphs);
+        }
     }
     return 0;
 }
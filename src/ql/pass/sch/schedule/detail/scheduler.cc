@@ -864,22 +864,82 @@ ir::compat::GateRef Scheduler::find_mostcritical(const List<ir::compat::GateRef>
     return most_critical_gate;
 }
 
+// ordered from high to low deep-criticality, see criticality_lessthan;
+// nodes of equal criticality are ordered on the order in which they were made available,
+// which is where make_available inserted them in the plain avlist
+Bool Scheduler::AvailableNode::operator<(const AvailableNode &other) const {
+    if (remaining != other.remaining) return remaining > other.remaining;
+    if (depending != other.depending) return depending > other.depending;
+    if (order != other.order) return order < other.order;
+    return sequence < other.sequence;
+}
+
+Scheduler::AvailableList::AvailableList(const ListDigraph &graph) :
+    unscheduled(graph, 0),
+    available(graph, false)
+{}
+
+// put a node of which the dependences have completed in the right ready set
+void Scheduler::AvailableList::insert_ready(const AvailableNode &an) {
+    if (an.zero_duration) {
+        ready_zero_duration.insert(an);
+    } else {
+        ready.insert(an);
+    }
+}
+
+// move the nodes in the buckets up to and including the given one to the ready sets
+void Scheduler::AvailableList::make_ready(AvailableBuckets &buckets, Int key) {
+    while (!buckets.empty() && buckets.begin()->first <= key) {
+        for (const auto &an : buckets.begin()->second) {
+            insert_ready(an);
+        }
+        buckets.erase(buckets.begin());
+    }
+}
+
+// the key of the first bucket, when the ready sets are empty
+Int Scheduler::AvailableList::get_next_key() const {
+    QL_ASSERT(ready_zero_duration.empty() && ready.empty());
+    if (waiting.empty()) {
+        return blocked.begin()->first;
+    } else if (blocked.empty()) {
+        return waiting.begin()->first;
+    } else {
+        return min(waiting.begin()->first, blocked.begin()->first);
+    }
+}
+
 // Set the curr_cycle of the scheduling algorithm to start at the appropriate end as well;
 // note that the cycle attributes will be shifted down to start at 1 after backward scheduling.
 void Scheduler::init_available(
-    List<ListDigraph::Node> &avlist,
+    AvailableList &avlist,
     rmgr::Direction dir,
     UInt &curr_cycle
 ) {
-    avlist.clear();
+    // count the number of depending nodes that must be scheduled before each node becomes available
+    for (ListDigraph::NodeIt n(graph); n != lemon::INVALID; ++n) {
+        UInt count = 0;
+        if (dir == rmgr::Direction::FORWARD) {
+            for (ListDigraph::InArcIt arc(graph, n); arc != lemon::INVALID; ++arc) {
+                count++;
+            }
+        } else {
+            for (ListDigraph::OutArcIt arc(graph, n); arc != lemon::INVALID; ++arc) {
+                count++;
+            }
+        }
+        avlist.unscheduled[n] = count;
+    }
+
+    // set_cycle_gate sets the cycle of SOURCE to 0 when forward scheduling,
+    // and that of SINK to ALAP_SINK_CYCLE when backward scheduling
     if (dir == rmgr::Direction::FORWARD) {
         curr_cycle = 0;
-        instruction[s]->cycle = curr_cycle;
-        avlist.push_back(s);
+        make_available(s, avlist, dir);
     } else {
         curr_cycle = ALAP_SINK_CYCLE;
-        instruction[t]->cycle = curr_cycle;
-        avlist.push_back(t);
+        make_available(t, avlist, dir);
     }
 }
 
@@ -972,72 +1032,41 @@ Bool Scheduler::criticality_lessthan(
 //  all its successors were scheduled (backward scheduling)
 // update its cycle attribute to reflect these dependencies;
 // avlist is initialized with s or t as first element by init_available
-// avlist is kept ordered on deep-criticality, non-increasing (i.e. highest deep-criticality first)
+// avlist is kept ordered on deep-criticality, non-increasing (i.e. highest deep-criticality first);
+// the keys for that are computed here once, instead of for every comparison as criticality_lessthan does;
+// this is equivalent because the dependency graph and the remaining values don't change while scheduling
 void Scheduler::make_available(
     ListDigraph::Node n,
-    utils::List<lemon::ListDigraph::Node> &avlist,
+    AvailableList &avlist,
     rmgr::Direction dir
 ) {
-    Bool already_in_avlist = false;  // check whether n is already in avlist
-    // originates from having multiple arcs between pair of nodes
-    List<ListDigraph::Node>::iterator first_lower_criticality_inp; // for keeping avlist ordered
-    Bool first_lower_criticality_found = false;                          // for keeping avlist ordered
-
-#ifdef MULTI_LINE_LOG_DEBUG
-    QL_IF_LOG_DEBUG {
-        QL_DOUT(".... making available node " << name[n] << " remaining: " << remaining.dbg(n));
-        for (const auto &avlist_node : avlist) {
-            QL_DOUT("..... existing avlist member, remaining=" << remaining.at(avlist_node) << ": " << name[avlist_node]);
-        }
-    }
-#else
-    QL_DOUT(".... making available node " << name[n] << " remaining (disabled)");
-#endif
-    for (auto inp = avlist.begin(); inp != avlist.end(); inp++) {
-        // as soon as: n is found in avlist or a lower critical node is found, break this loop
-        if (*inp == n) {
-            already_in_avlist = true;
-            QL_DOUT("...... node is already available: " << name[n]);
-            return;
-        } else {
-            // scanning avlist from front to back (avlist is ordered from high to low criticality)
-            // when encountering first node *inp with less criticality,
-            // that is where new node n should be inserted just before,
-            // to keep avlist in desired order
-            //
-            // consequence is that
-            // when a node has same criticality as n, new node n is put after it, as last one of set of same criticality,
-            // so order of calling MakeAvailable (and probably original circuit, and running other scheduler first) matters,
-            // also when all dependency sets (and so remaining values) are identical!
-            QL_DOUT("...... node to be made availabe is criticality checked with: " << name[*inp]);
-            if (criticality_lessthan(*inp, n, dir) && !first_lower_criticality_found) {
-                QL_DOUT("...... first lower critical node found: " << name[*inp]);
-                first_lower_criticality_inp = inp;
-                first_lower_criticality_found = true;
-                break;
-            }
-            QL_DOUT("...... first lower critical not yet found, continuing checking");
-        }
-    }
-    if (!already_in_avlist) {
-        // n not already in avlist OR avlist is empty OR no lower critical node in avlist
-        QL_DOUT(".... node to be made available " << name[n] << " gets its cycle set");
-        set_cycle_gate(instruction[n], dir);        // for the schedulers to inspect whether gate has completed
-        if (first_lower_criticality_found) {
-            // add n to avlist just before the first with lower criticality
-            QL_DOUT(".... node to be made available " << name[n] << " is put in front of found lower critical one");
-            avlist.insert(first_lower_criticality_inp, n);
-        } else {
-            // add n to end of avlist, if none found with less criticality
-            QL_DOUT(".... node to be made available " << name[n] << " is put at end of avlist, as most critical one");
-            avlist.push_back(n);
-        }
-        QL_DOUT("...... made available node(@" << instruction[n]->cycle << "): " << name[n] << " remaining: " << remaining.dbg(n));
+    QL_DOUT(".... making available node " << name[n] << " remaining: " << remaining.dbg(n));
+    avlist.available[n] = true;
+    set_cycle_gate(instruction[n], dir);        // for the schedulers to inspect whether gate has completed
+
+    AvailableNode an;
+    an.remaining = remaining.at(n);
+    an.depending = 0;
+    an.order = 0;
+    if (enable_criticality) {
+        List<ListDigraph::Node> ln;
+        get_depending_nodes(n, dir, ln);
+        an.depending = ln.size();
+        an.order = order[n];
     }
+    an.sequence = avlist.sequence++;
+    an.zero_duration = instruction[n]->duration == 0;
+    an.node = n;
+
+    // the node can't be scheduled before its dependencies have completed,
+    // so it waits in the bucket for that cycle until curr_cycle gets there
+    Int cycle = instruction[n]->cycle;
+    avlist.waiting.set(dir == rmgr::Direction::FORWARD ? cycle : -cycle).push_back(an);
+    avlist.size++;
+    QL_DOUT("...... made available node(@" << instruction[n]->cycle << "): " << name[n] << " remaining: " << remaining.dbg(n));
 }
 
 // take node n out of avlist because it has been scheduled;
-// reflect that the node has been scheduled in the scheduled vector;
 // having scheduled it means that its depending nodes might become available:
 // such a depending node becomes available when all its dependent nodes have been scheduled now
 //
@@ -1054,46 +1083,36 @@ void Scheduler::make_available(
 // because from then on that value is compared to the curr_cycle to check
 // whether a node has completed execution and thus is available for scheduling in curr_cycle
 void Scheduler::take_available(
-    ListDigraph::Node n,
-    utils::List<lemon::ListDigraph::Node> &avlist,
-    utils::Map<ir::compat::GateRef, utils::Bool> &scheduled,
+    const AvailableNode &an,
+    AvailableList &avlist,
     rmgr::Direction dir
 ) {
-    scheduled.set(instruction[n]) = true;
-    avlist.remove(n);
+    auto n = an.node;
+    avlist.size--;
     QL_DOUT("...... take_available: taken from avlist: " << name[n] );
 
+    // first count down the unscheduled depending nodes for all arcs (there may be multiple arcs
+    // between the same pair of nodes), and only then make the nodes available in the order of the arcs,
+    // such that equally critical nodes end up in the same order as before
     if (dir == rmgr::Direction::FORWARD) {
+        for (ListDigraph::OutArcIt succ_arc(graph, n); succ_arc != lemon::INVALID; ++succ_arc) {
+            avlist.unscheduled[graph.target(succ_arc)]--;
+        }
         for (ListDigraph::OutArcIt succ_arc(graph, n); succ_arc != lemon::INVALID; ++succ_arc) {
             auto succ_node = graph.target(succ_arc);
-            QL_DOUT("....... successor node that could become available: " << name[succ_node] );
-            Bool schedulable = true;
-            for (ListDigraph::InArcIt pred_arc(graph, succ_node); pred_arc != lemon::INVALID; ++pred_arc) {
-                ListDigraph::Node predNode = graph.source(pred_arc);
-                if (!scheduled.at(instruction[predNode])) {
-                    schedulable = false;
-                    break;
-                }
-            }
-            if (schedulable) {
+            if (avlist.unscheduled[succ_node] == 0 && !avlist.available[succ_node]) {
                 QL_DOUT("....... successor node is to be made available (all predecessors were scheduled): " << name[succ_node] );
                 make_available(succ_node, avlist, dir);
             }
         }
     } else {
+        for (ListDigraph::InArcIt pred_arc(graph, n); pred_arc != lemon::INVALID; ++pred_arc) {
+            avlist.unscheduled[graph.source(pred_arc)]--;
+        }
         for (ListDigraph::InArcIt pred_arc(graph, n); pred_arc != lemon::INVALID; ++pred_arc) {
             auto pred_node = graph.source(pred_arc);
-            QL_DOUT("....... predecessor node that could become available: " << name[pred_node] );
-            Bool schedulable = true;
-            for (ListDigraph::OutArcIt succ_arc(graph, pred_node); succ_arc != lemon::INVALID; ++succ_arc) {
-                auto succ_node = graph.target(succ_arc);
-                if (!scheduled.at(instruction[succ_node])) {
-                    schedulable = false;
-                    break;
-                }
-            }
-            if (schedulable) {
-                QL_DOUT("....... predecessor node is to be made available (all predecessors were scheduled): " << name[pred_node] );
+            if (avlist.unscheduled[pred_node] == 0 && !avlist.available[pred_node]) {
+                QL_DOUT("....... predecessor node is to be made available (all successors were scheduled): " << name[pred_node] );
                 make_available(pred_node, avlist, dir);
             }
         }
@@ -1101,97 +1120,79 @@ void Scheduler::take_available(
     QL_DOUT("...... take_available: taken from avlist: " << name[n] << " [DONE]" );
 }
 
-// advance curr_cycle
-// when no node was selected from the avlist, advance to the next cycle
-// and try again; this makes nodes/instructions to complete execution for one more cycle,
-// and makes resources finally available in case of resource constrained scheduling
-// so it contributes to proceeding and to finally have an empty avlist
-void Scheduler::advance_curr_cycle(rmgr::Direction dir, UInt &curr_cycle) {
-    if (dir == rmgr::Direction::FORWARD) {
-        curr_cycle++;
-    } else {
-        curr_cycle--;
-    }
-}
-
 // a gate must wait until all its operand are available, i.e. the gates having computed them have completed,
 // and must wait until all resources required for the gate's execution are available;
-// return true when immediately schedulable
-// when returning false, isres indicates whether resource occupation was the reason or operand completion (for debugging)
-Bool Scheduler::immediately_schedulable(
+// the former is guaranteed by the AvailableList for the nodes in its ready sets,
+// so this returns the first cycle from curr_cycle onward at which the resources may be available:
+// curr_cycle itself when the node is immediately schedulable
+UInt Scheduler::next_schedulable_cycle(
     ListDigraph::Node n,
-    rmgr::Direction dir,
     const UInt curr_cycle,
-    rmgr::State &rs,
-    Bool &isres
+    rmgr::State &rs
 ) {
     ir::compat::GateRef gp = instruction[n];
-    isres = true;
-    // have dependent gates completed at curr_cycle?
     if (
-        (dir == rmgr::Direction::FORWARD && gp->cycle <= curr_cycle)
-        || (dir == rmgr::Direction::BACKWARD && curr_cycle <= gp->cycle)
+        n == s || n == t
+        || gp->type() == ir::compat::GateType::DUMMY
+        || gp->type() == ir::compat::GateType::CLASSICAL
+        || gp->type() == ir::compat::GateType::WAIT
         ) {
-        // are resources available?
-        if (
-            n == s || n == t
-            || gp->type() == ir::compat::GateType::DUMMY
-            || gp->type() == ir::compat::GateType::CLASSICAL
-            || gp->type() == ir::compat::GateType::WAIT
-            ) {
-            return true;
-        }
-        if (rs.available(curr_cycle, gp)) {
-            return true;
-        }
-        isres = true;
-        return false;
-    } else {
-        isres = false;
-        return false;
+        return curr_cycle;
     }
+    return rs.get_next_cycle(curr_cycle, gp);
 }
 
 // select a node from the avlist
-// the avlist is deep-ordered from high to low criticality (see criticality_lessthan above)
-ListDigraph::Node Scheduler::select_available(
-    utils::List<lemon::ListDigraph::Node> &avlist,
+// the avlist is deep-ordered from high to low criticality (see criticality_lessthan above);
+// nodes found blocked by resources are moved to avlist.blocked
+// when no node can be scheduled, false is returned and all nodes are in the buckets
+Bool Scheduler::select_available(
+    AvailableList &avlist,
     rmgr::Direction dir,
     const UInt curr_cycle,
     rmgr::State &rs,
-    Bool &success
+    AvailableNode &selected
 ) {
-    success = false;                        // whether a node was found and returned
-
-    QL_DOUT("avlist(@" << curr_cycle << "):");
-    for (auto n : avlist) {
-        QL_DOUT("...... node(@" << instruction[n]->cycle << "): " << name[n] << " remaining: " << remaining.dbg(n));
-    }
+    // move the nodes that may be schedulable in curr_cycle to the ready sets
+    auto key = [dir](UInt cycle) {
+        return dir == rmgr::Direction::FORWARD ? (Int)cycle : -(Int)cycle;
+    };
+    avlist.make_ready(avlist.waiting, key(curr_cycle));
+    avlist.make_ready(avlist.blocked, key(curr_cycle));
 
-    // select the first (most critical) immediately schedulable gate that has duration 0
-    for (auto n : avlist) {
-        Bool isres;
-        if (instruction[n]->duration == 0 && immediately_schedulable(n, dir, curr_cycle, rs, isres)) {
-            QL_DOUT("... node (@" << instruction[n]->cycle << "): " << name[n] << " duration 0 and immediately schedulable, remaining=" << remaining.dbg(n) << ", selected");
-            success = true;
-            return n;
+    QL_IF_LOG_DEBUG {
+        QL_DOUT("avlist(@" << curr_cycle << "): " << avlist.size << " nodes, of which "
+            << avlist.ready_zero_duration.size() + avlist.ready.size() << " ready");
+        for (const auto &an : avlist.ready_zero_duration) {
+            QL_DOUT("...... node(@" << instruction[an.node]->cycle << "): " << name[an.node] << " remaining: " << an.remaining);
         }
-    }
-    // select the first (most critical) immediately schedulable, if any, otherwise
-    // since avlist is deep-criticality ordered, highest first, the first is the most deep-critical
-    for (auto n : avlist) {
-        Bool isres;
-        if (immediately_schedulable(n, dir, curr_cycle, rs, isres)) {
-            QL_DOUT("... node (@" << instruction[n]->cycle << "): " << name[n] << " immediately schedulable, remaining=" << remaining.dbg(n) << ", selected");
-            success = true;
-            return n;
-        } else {
-            QL_DOUT("... node (@" << instruction[n]->cycle << "): " << name[n] << " remaining=" << remaining.dbg(n) << ", waiting for " << (isres ? "resource" : "dependent completion"));
+        for (const auto &an : avlist.ready) {
+            QL_DOUT("...... node(@" << instruction[an.node]->cycle << "): " << name[an.node] << " remaining: " << an.remaining);
         }
     }
 
-    success = false;
-    return s;   // fake return value
+    // select the first (most critical) immediately schedulable node from the given ready set,
+    // moving the nodes in front of it to the blocked buckets
+    auto select_from = [&](Set<AvailableNode> &ready) {
+        for (auto it = ready.begin(); it != ready.end(); ) {
+            auto next_cycle = next_schedulable_cycle(it->node, curr_cycle, rs);
+            if (next_cycle == curr_cycle) {
+                QL_DOUT("... node (@" << instruction[it->node]->cycle << "): " << name[it->node] << " immediately schedulable, remaining=" << it->remaining << ", selected");
+                selected = *it;
+                ready.erase(it);
+                return true;
+            }
+            QL_DOUT("... node (@" << instruction[it->node]->cycle << "): " << name[it->node] << " remaining=" << it->remaining << ", waiting for resource until " << next_cycle);
+            avlist.blocked.set(key(next_cycle)).push_back(*it);
+            it = ready.erase(it);
+        }
+        return false;
+    };
+
+    // select the first (most critical) immediately schedulable gate that has duration 0;
+    // otherwise select the first (most critical) immediately schedulable gate, if any;
+    // the ones with duration 0 were just found to be blocked, so there's no need to try those again
+    return select_from(avlist.ready_zero_duration) || select_from(avlist.ready);
 }
 
 // ASAP/ALAP scheduler with RC
@@ -1226,35 +1227,30 @@ void Scheduler::schedule(
     // build a new resource state
     auto rs = rm.build(dir);
 
-    // scheduled[gp] :=: whether gate *gp has been scheduled, init all false
-    Map<ir::compat::GateRef, Bool> scheduled;
     // avlist :=: list of schedulable nodes, initially (see below) just s or t
-    List<ListDigraph::Node> avlist;
+    AvailableList avlist(graph);
 
     // initializations for this scheduler
     // note that dependency graph is not modified by a scheduler, so it can be reused
     QL_DOUT("... initialization");
-    for (ListDigraph::NodeIt n(graph); n != lemon::INVALID; ++n) {
-        scheduled.set(instruction[n]) = false;   // none were scheduled, including SOURCE/SINK
-    }
     UInt  curr_cycle;         // current cycle for which instructions are sought
-    init_available(avlist, dir, curr_cycle);     // first node (SOURCE/SINK) is made available and curr_cycle set
     set_remaining(dir);         // for each gate, number of cycles until end of schedule
+    init_available(avlist, dir, curr_cycle);     // first node (SOURCE/SINK) is made available and curr_cycle set
 
     QL_DOUT("... loop over avlist until it is empty");
-    while (!avlist.empty()) {
-        Bool success;
-        ListDigraph::Node selected_node;
-
-        selected_node = select_available(avlist, dir, curr_cycle, rs, success);
-        if (!success) {
-            // i.e. none from avlist was found suitable to schedule in this cycle
-            advance_curr_cycle(dir, curr_cycle);
-            // so try again; eventually instrs complete and machine is empty
+    while (avlist.size) {
+        AvailableNode selected;
+        if (!select_available(avlist, dir, curr_cycle, rs, selected)) {
+            // i.e. none from avlist was found suitable to schedule in this cycle;
+            // they are all waiting for their dependencies to complete or for resources to become available,
+            // so skip ahead to the first cycle in which one of them might be schedulable
+            auto next_key = avlist.get_next_key();
+            curr_cycle = dir == rmgr::Direction::FORWARD ? next_key : -next_key;
             continue;
         }
 
-        // commit selected_node to the schedule
+        // commit selected node to the schedule
+        auto selected_node = selected.node;
         ir::compat::GateRef gp = instruction[selected_node];
         QL_DOUT("... selected " << gp->qasm() << " in cycle " << curr_cycle);
         gp->cycle = curr_cycle;                     // scheduler result, including s and t
@@ -1266,8 +1262,15 @@ void Scheduler::schedule(
             && gp->type() != ir::compat::GateType::WAIT
             ) {
             rs.reserve(curr_cycle, gp);
+
+            // reserving a gate normally only takes resources, so the nodes that are blocked
+            // remain blocked until the cycle of their bucket; a gate with duration 0 can however
+            // replace the reservation of the qubits and channels it uses, so play safe
+            if (selected.zero_duration) {
+                avlist.make_ready(avlist.blocked, MAX);
+            }
         }
-        take_available(selected_node, avlist, scheduled, dir);   // update avlist/scheduled/cycle
+        take_available(selected, avlist, dir);   // update avlist/cycle
         // more nodes that could be scheduled in this cycle, will be found in an other round of the loop
     }
 
@@ -17,6 +17,7 @@
 #include "ql/utils/str.h"
 #include "ql/utils/list.h"
 #include "ql/utils/map.h"
+#include "ql/utils/set.h"
 #include "ql/utils/ptr.h"
 #include "ql/rmgr/manager.h"
 #include "ql/ir/compat/compat.h"
@@ -249,6 +250,66 @@ public:
     // checking before selection whether the nodes/instructions have completed execution
     // and whether the resource constraints are fulfilled.
 
+    // The avlist is represented by the AvailableList below instead of by a plain list of nodes;
+    // a plain list must be scanned linearly to insert a node at its place in the criticality order,
+    // and must be scanned completely for every cycle in which no node can be scheduled,
+    // checking the resources of every node in it again and again;
+    // with thousands of parallel gates waiting for the same resources, that is quadratic per cycle.
+    //
+    // The AvailableList therefore splits the avlist in three parts:
+    // - the nodes of which the dependences have not completed yet at curr_cycle,
+    //   bucketed by the cycle at which they do (the cycle attribute set by make_available)
+    // - the nodes that were found blocked by resources,
+    //   bucketed by the cycle before which the resource state says they can't be scheduled
+    //   (see rmgr::State::get_next_cycle())
+    // - the nodes that are ready to be tried in curr_cycle, in two sets (for duration 0 and other gates)
+    //   that are ordered on deep-criticality like the avlist was
+    // Nodes move from the buckets to the ready sets when curr_cycle gets to their bucket.
+    // Reserving gates with a nonzero duration only takes resources,
+    // so blocked nodes need not be checked again before the cycle of their bucket;
+    // a gate with duration 0 can however replace the reservation of the qubits it uses,
+    // so then all blocked nodes are made ready again.
+    // Selecting a node in this way gives exactly the same schedule as scanning the plain avlist.
+    struct AvailableNode {
+        utils::UInt remaining;          // remaining[node], the primary criticality key
+        utils::UInt depending;          // number of depending nodes, when enable_criticality
+        utils::Int order;               // order[node], when enable_criticality
+        utils::UInt sequence;           // sequence number of make_available, for a stable order
+        utils::Bool zero_duration;      // whether the gate has duration 0
+        lemon::ListDigraph::Node node;
+
+        // ordered from high to low deep-criticality, see criticality_lessthan
+        utils::Bool operator<(const AvailableNode &other) const;
+    };
+
+    // nodes bucketed by a cycle; the key is the cycle when forward scheduling and its negation
+    // when backward scheduling, so in both directions the first bucket in the map is the first in time
+    using AvailableBuckets = utils::Map<utils::Int, utils::Vec<AvailableNode>>;
+
+    struct AvailableList {
+        AvailableBuckets waiting;
+        AvailableBuckets blocked;
+        utils::Set<AvailableNode> ready_zero_duration;
+        utils::Set<AvailableNode> ready;
+
+        // number of unscheduled depending nodes (counting duplicate arcs) for each node
+        lemon::ListDigraph::NodeMap<utils::UInt> unscheduled;
+        lemon::ListDigraph::NodeMap<utils::Bool> available;
+        utils::UInt sequence = 0;
+        utils::UInt size = 0;
+
+        explicit AvailableList(const lemon::ListDigraph &graph);
+
+        // put a node of which the dependences have completed in the right ready set
+        void insert_ready(const AvailableNode &an);
+
+        // move the nodes in the buckets up to and including the given one to the ready sets
+        void make_ready(AvailableBuckets &buckets, utils::Int key);
+
+        // the key of the first bucket, when the ready sets are empty
+        utils::Int get_next_key() const;
+    };
+
     // Initialize avlist to the single starting node
     // when forward scheduling:
     //  node s (with SOURCE instruction) is the top of the dependence graph; all instructions depend on it
@@ -258,7 +319,7 @@ public:
     // Set the curr_cycle of the scheduling algorithm to start at the appropriate end as well;
     // note that the cycle attributes will be shifted down to start at 1 after backward scheduling.
     void init_available(
-        utils::List<lemon::ListDigraph::Node> &avlist,
+        AvailableList &avlist,
         rmgr::Direction dir,
         utils::UInt &curr_cycle
     );
@@ -293,12 +354,11 @@ public:
     // avlist is kept ordered on deep-criticality, non-increasing (i.e. highest deep-criticality first)
     void make_available(
         lemon::ListDigraph::Node n,
-        utils::List<lemon::ListDigraph::Node> &avlist,
+        AvailableList &avlist,
         rmgr::Direction dir
     );
 
     // take node n out of avlist because it has been scheduled;
-    // reflect that the node has been scheduled in the scheduled vector;
     // having scheduled it means that its depending nodes might become available:
     // such a depending node becomes available when all its dependent nodes have been scheduled now
     //
@@ -315,39 +375,32 @@ public:
     // because from then on that value is compared to the curr_cycle to check
     // whether a node has completed execution and thus is available for scheduling in curr_cycle
     void take_available(
-        lemon::ListDigraph::Node n,
-        utils::List<lemon::ListDigraph::Node> &avlist,
-        utils::Map<ir::compat::GateRef, utils::Bool> &scheduled,
+        const AvailableNode &an,
+        AvailableList &avlist,
         rmgr::Direction dir
     );
 
-    // advance curr_cycle
-    // when no node was selected from the avlist, advance to the next cycle
-    // and try again; this makes nodes/instructions to complete execution for one more cycle,
-    // and makes resources finally available in case of resource constrained scheduling
-    // so it contributes to proceeding and to finally have an empty avlist
-    static void advance_curr_cycle(rmgr::Direction dir, utils::UInt &curr_cycle);
-
     // a gate must wait until all its operand are available, i.e. the gates having computed them have completed,
     // and must wait until all resources required for the gate's execution are available;
-    // return true when immediately schedulable
-    // when returning false, isres indicates whether resource occupation was the reason or operand completion (for debugging)
-    utils::Bool immediately_schedulable(
+    // the former is guaranteed by the AvailableList for the nodes in its ready sets,
+    // so this returns the first cycle from curr_cycle onward at which the resources may be available:
+    // curr_cycle itself when the node is immediately schedulable
+    utils::UInt next_schedulable_cycle(
         lemon::ListDigraph::Node n,
-        rmgr::Direction dir,
         const utils::UInt curr_cycle,
-        rmgr::State &rs,
-        utils::Bool &isres
+        rmgr::State &rs
     );
 
     // select a node from the avlist
-    // the avlist is deep-ordered from high to low criticality (see criticality_lessthan above)
-    lemon::ListDigraph::Node select_available(
-        utils::List<lemon::ListDigraph::Node> &avlist,
+    // the avlist is deep-ordered from high to low criticality (see criticality_lessthan above);
+    // nodes found blocked by resources are moved to avlist.blocked
+    // when no node can be scheduled, false is returned and all nodes are in the buckets
+    utils::Bool select_available(
+        AvailableList &avlist,
         rmgr::Direction dir,
         const utils::UInt curr_cycle,
         rmgr::State &rs,
-        utils::Bool &success
+        AvailableNode &selected
     );
 
     // ASAP/ALAP scheduler with RC
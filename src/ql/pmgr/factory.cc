@@ -13,6 +13,8 @@
 #include "ql/pass/ana/visualize/mapping.h"
 #include "ql/pass/ana/statistics/clean.h"
 #include "ql/pass/ana/statistics/report.h"
+#include "ql/pass/io/checkpoint/read.h"
+#include "ql/pass/io/checkpoint/write.h"
 #include "ql/pass/io/cqasm/read.h"
 #include "ql/pass/io/cqasm/report.h"
 #include "ql/pass/io/sweep_points/write.h"
@@ -42,6 +44,8 @@ Factory::Factory() {
     register_pass<::ql::pass::ana::visualize::mapping::Pass>("ana.visualize.Mapping");
     register_pass<::ql::pass::ana::statistics::clean::Pass>("ana.statistics.Clean");
     register_pass<::ql::pass::ana::statistics::report::Pass>("ana.statistics.Report");
+    register_pass<::ql::pass::io::checkpoint::read::Pass>("io.checkpoint.Read");
+    register_pass<::ql::pass::io::checkpoint::write::Pass>("io.checkpoint.Write");
     register_pass<::ql::pass::io::cqasm::read::Pass>("io.cqasm.Read");
     register_pass<::ql::pass::io::cqasm::report::Pass>("io.cqasm.Report");
     register_pass<::ql::pass::io::sweep_points::write::Pass>("io.sweep_points.Write");
@@ -8,6 +8,7 @@
 #include "ql/com/options.h"
 #include "ql/arch/architecture.h"
 #include "ql/ir/cqasm/write.h"
+#include "ql/pmgr/pass_types/specializations.h"
 
 namespace ql {
 namespace pmgr {
@@ -901,8 +902,27 @@ void Manager::compile(const ir::Ref &ir) {
     construct();
 
     // Compile the program.
+    root->clear_profile();
     root->compile(ir, "");
 
+    // If the strategy ended with legacy passes, make sure their result ends
+    // up in the new IR.
+    pass_types::flush_legacy_session(ir);
+
+    // Collect the profiling information of the passes that ran.
+    profile.passes.clear();
+    root->get_profile(profile.passes);
+
+}
+
+/**
+ * Returns the profiling information for the passes that ran during the most
+ * recent call to compile(), i.e. the wall-clock time, CPU time, and peak
+ * memory increase of each pass and pass group, as well as the size of the IR
+ * before and after.
+ */
+const Profile &Manager::get_profile() const {
+    return profile;
 }
 
 } // namespace pmgr
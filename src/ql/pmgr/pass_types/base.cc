@@ -7,8 +7,10 @@
 #include <cctype>
 #include <regex>
 #include "ql/utils/filesystem.h"
+#include "ql/com/options.h"
 #include "ql/ir/cqasm/write.h"
 #include "ql/pmgr/manager.h"
+#include "ql/pmgr/pass_types/specializations.h"
 #include "ql/pass/ana/statistics/report.h"
 
 namespace ql {
@@ -173,14 +175,17 @@ Base::Base(
         "and after, the latter of which includes statistics as comments. The "
         "filename is built using the output_prefix option, using suffix "
         "`_debug_[in|out].ir` for the IR dump, and `_debug_[in|out].cq` for "
-        "the cQASM file. The option values `stats`, `cqasm`, and `both` are "
+        "the cQASM file. `gzip` does the same, but writes gzip-compressed "
+        "files with an additional `.gz` suffix instead, which is much faster "
+        "for large programs; this requires OpenQL to be built with zlib. "
+        "The option values `stats`, `cqasm`, and `both` are "
         "used for backward compatibility with the `write_qasm_files` and "
         "`write_report_files` global options; for `stats` and `both` a "
         "statistics report file is written with suffix `_[in|out].report`, "
         "and for `qasm` and `both` a cQASM file is written (without stats "
         "in the comments) with suffix `_[in|out].qasm`.",
         "no",
-        {"no", "yes", "stats", "qasm", "both"}
+        {"no", "yes", "gzip", "stats", "qasm", "both"}
     );
 }
 
@@ -999,6 +1004,9 @@ void Base::handle_debugging(
 ) {
     utils::Str in_or_out = after_pass ? "out" : "in";
     auto debug_opt = options["debug"].as_str();
+    if (debug_opt != "no") {
+        flush_legacy_session(ir);
+    }
     if (debug_opt == "yes") {
         ir->dump_seq(
             utils::OutFile(context.output_prefix + "_debug_" + in_or_out + ".ir").unwrap()
@@ -1010,6 +1018,16 @@ void Base::handle_debugging(
             utils::OutFile(context.output_prefix + "_debug_" + in_or_out + ".cq").unwrap()
         );
     }
+    if (debug_opt == "gzip") {
+        utils::GzOutFile ir_file(context.output_prefix + "_debug_" + in_or_out + ".ir.gz");
+        ir->dump_seq(ir_file.unwrap());
+        ir_file.close();
+        ir::cqasm::WriteOptions write_options;
+        write_options.include_statistics = true;
+        utils::GzOutFile cq_file(context.output_prefix + "_debug_" + in_or_out + ".cq.gz");
+        ir::cqasm::write(ir, write_options, cq_file.unwrap());
+        cq_file.close();
+    }
     if (debug_opt == "stats" || debug_opt == "both") {
         pass::ana::statistics::report::dump_all(
             ir,
@@ -1033,6 +1051,15 @@ utils::Int Base::run_main_pass(
     const Context &context
 ) const {
     QL_IOUT("starting pass \"" << context.full_pass_name << "\" of type \"" << type_name << "\"...");
+    if (!is_legacy()) {
+        auto conversion_time = flush_legacy_session(ir);
+        if (conversion_time > 0.0) {
+            QL_IOUT(
+                "IR conversion for pass \"" << context.full_pass_name << "\" took "
+                << conversion_time << "s"
+            );
+        }
+    }
     auto retval = run_internal(ir, context);
     QL_IOUT("completed pass \"" << context.full_pass_name << "\"; return value is " << retval);
     return retval;
@@ -1123,6 +1150,19 @@ void Base::compile(
     // Handle configured debugging actions before running the pass.
     handle_debugging(ir, context, false);
 
+    // Measure the pass for profiling if enabled, excluding the debugging
+    // actions and the measurements of the IR size, including those done for
+    // our sub-passes.
+    utils::Bool profiling = com::options::global["profile_passes"].as_bool();
+    IrSize ir_size_before;
+    ResourceUsage usage_before;
+    ResourceUsage measure_time_before;
+    if (profiling) {
+        ir_size_before = IrSize::measure(ir);
+        usage_before = ResourceUsage::now();
+        measure_time_before = IrSize::get_measure_time();
+    }
+
     // Traverse our level of the pass tree based on our node type.
     switch (node_type) {
         case NodeType::NORMAL: {
@@ -1179,11 +1219,53 @@ void Base::compile(
         default: QL_ASSERT(false);
     }
 
+    // Record the measurements.
+    if (profiling) {
+        auto usage_after = ResourceUsage::now();
+        auto measure_time_after = IrSize::get_measure_time();
+        usage_after.wall_time -= measure_time_after.wall_time - measure_time_before.wall_time;
+        usage_after.cpu_time -= measure_time_after.cpu_time - measure_time_before.cpu_time;
+        profile.full_pass_name = context.full_pass_name;
+        profile.record(usage_before, ir_size_before, usage_after, IrSize::measure(ir));
+        QL_IOUT(
+            "pass \"" << context.full_pass_name << "\" took "
+            << usage_after.wall_time - usage_before.wall_time << "s"
+        );
+    }
+
     // Handle configured debugging actions after running the pass.
     handle_debugging(ir, context, true);
 
 }
 
+/**
+ * Clears the profiling information of this pass and its sub-passes.
+ */
+void Base::clear_profile() {
+    profile = {};
+    for (const auto &pass : sub_pass_order) {
+        pass->clear_profile();
+    }
+}
+
+/**
+ * Appends the profiling information of this pass and its sub-passes to the
+ * given list in depth-first pre-order, skipping passes that have not run since
+ * clear_profile() was last called.
+ */
+void Base::get_profile(utils::Vec<PassProfile> &profiles, utils::UInt depth) const {
+    if (!profile.num_runs) {
+        return;
+    }
+    profiles.push_back(profile);
+    profiles.back().type_name = type_name;
+    profiles.back().depth = depth;
+    profiles.back().is_group = is_group();
+    for (const auto &pass : sub_pass_order) {
+        pass->get_profile(profiles, depth + 1);
+    }
+}
+
 } // namespace pass_types
 } // namespace pmgr
 } // namespace ql
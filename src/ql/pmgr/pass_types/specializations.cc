@@ -5,13 +5,149 @@
 
 #include "ql/pmgr/pass_types/specializations.h"
 
+#include <chrono>
+#include "ql/utils/logger.h"
 #include "ql/ir/new_to_old.h"
 #include "ql/ir/old_to_new.h"
+#include "ql/com/options.h"
 
 namespace ql {
 namespace pmgr {
 namespace pass_types {
 
+/**
+ * Annotation placed on the root node of the new IR while a legacy IR
+ * conversion session is active. program is the old-IR representation of the
+ * program that all consecutive legacy passes operate on. modified is set when
+ * a legacy transformation ran since the session was opened, in which case the
+ * new IR tree is stale and must be regenerated from program when the session
+ * is closed. peeked is the conversion made by peek_legacy_session() since the
+ * last legacy transformation, if any, which can then be reused.
+ */
+struct LegacySession {
+    ir::compat::ProgramRef program;
+    utils::Bool modified;
+    ir::Ref peeked;
+};
+
+/**
+ * Returns the number of seconds elapsed since the given time point.
+ */
+static utils::Real seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<utils::Real>(
+        std::chrono::steady_clock::now() - start
+    ).count();
+}
+
+/**
+ * Returns whether consecutive legacy passes should share a single old-IR
+ * program, as controlled by the `legacy_ir_session` global option.
+ */
+static utils::Bool legacy_sessions_enabled() {
+    return com::options::global["legacy_ir_session"].as_bool();
+}
+
+/**
+ * Returns the old-IR representation of the given program for use by a legacy
+ * pass. If a conversion session is active, the program of the session is
+ * returned as is; otherwise the new IR is converted. The time spent converting
+ * is added to conversion_time.
+ */
+static ir::compat::ProgramRef open_legacy_session(
+    const ir::Ref &ir,
+    utils::Real &conversion_time
+) {
+    if (auto session = ir->get_annotation_ptr<LegacySession>()) {
+        return session->program;
+    }
+    auto start = std::chrono::steady_clock::now();
+    auto program = ir::convert_new_to_old(ir);
+    conversion_time += seconds_since(start);
+    return program;
+}
+
+/**
+ * Finishes running a legacy pass on the given old-IR program. modified must be
+ * set for transformations and cleared for analyses. When conversion sessions
+ * are enabled, the old IR is retained for the next legacy pass; otherwise the
+ * new IR is updated immediately if needed. The time spent converting is added
+ * to conversion_time.
+ */
+static void close_legacy_session(
+    const ir::Ref &ir,
+    const ir::compat::ProgramRef &program,
+    utils::Bool modified,
+    utils::Real &conversion_time
+) {
+    if (legacy_sessions_enabled()) {
+        if (auto session = ir->get_annotation_ptr<LegacySession>()) {
+            session->modified |= modified;
+            if (modified) {
+                session->peeked.reset();
+            }
+        } else {
+            ir->set_annotation<LegacySession>({program, modified, {}});
+        }
+        return;
+    }
+    if (modified) {
+        auto start = std::chrono::steady_clock::now();
+        auto new_ir = ir::convert_old_to_new(program);
+        ir->program = new_ir->program;
+        ir->platform = new_ir->platform;
+        ir->copy_annotations(*new_ir);
+        conversion_time += seconds_since(start);
+    }
+}
+
+/**
+ * Ends the legacy IR conversion session for the given IR, if one is active.
+ * If a legacy transformation ran during the session, the new IR is rebuilt
+ * from the old IR. Must be called before anything operates on the new IR
+ * after a legacy pass may have run. Returns the time spent converting in
+ * seconds.
+ */
+utils::Real flush_legacy_session(const ir::Ref &ir) {
+    auto session = ir->get_annotation_ptr<LegacySession>();
+    if (!session) {
+        return 0.0;
+    }
+    auto program = session->program;
+    auto modified = session->modified;
+    auto new_ir = session->peeked;
+    ir->erase_annotation<LegacySession>();
+    if (!modified) {
+        return 0.0;
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (new_ir.empty()) {
+        new_ir = ir::convert_old_to_new(program);
+    }
+    ir->program = new_ir->program;
+    ir->platform = new_ir->platform;
+    ir->copy_annotations(*new_ir);
+    return seconds_since(start);
+}
+
+/**
+ * Returns an up-to-date new-IR representation of the given IR without ending
+ * the legacy IR conversion session, if one is active. This is the given IR
+ * itself unless a legacy transformation ran during the session, in which case
+ * the old IR is converted into a separate IR tree, which is reused until the
+ * next legacy transformation and when the session is flushed. Used to inspect
+ * the program; the returned IR must not be modified.
+ */
+ir::Ref peek_legacy_session(const ir::Ref &ir) {
+    auto session = ir->get_annotation_ptr<LegacySession>();
+    if (!session || !session->modified) {
+        return ir;
+    }
+    if (session->peeked.empty()) {
+        session->peeked = ir::convert_old_to_new(session->program);
+    }
+    return session->peeked;
+}
+
 /**
  * Constructs the abstract pass group. No error checking here; this is up to
  * the parent pass group.
@@ -111,12 +247,16 @@ utils::Int ProgramTransformation::run_internal(
     const ir::Ref &ir,
     const Context &context
 ) const {
-    auto program = ir::convert_new_to_old(ir);
+    utils::Real conversion_time = 0.0;
+    auto program = open_legacy_session(ir, conversion_time);
     auto retval = run(program, context);
-    auto new_ir = ir::convert_old_to_new(program);
-    ir->program = new_ir->program;
-    ir->platform = new_ir->platform;
-    ir->copy_annotations(*new_ir);
+    close_legacy_session(ir, program, true, conversion_time);
+    if (conversion_time > 0.0) {
+        QL_IOUT(
+            "IR conversion for pass \"" << context.full_pass_name << "\" took "
+            << conversion_time << "s"
+        );
+    }
     return retval;
 }
 
@@ -162,15 +302,19 @@ utils::Int KernelTransformation::run_internal(
     const ir::Ref &ir,
     const Context &context
 ) const {
-    auto program = ir::convert_new_to_old(ir);
+    utils::Real conversion_time = 0.0;
+    auto program = open_legacy_session(ir, conversion_time);
     utils::Int accumulator = retval_initialize();
     for (const auto &kernel : program->kernels) {
         accumulator = retval_accumulate(accumulator, run(program, kernel, context));
     }
-    auto new_ir = ir::convert_old_to_new(program);
-    ir->program = new_ir->program;
-    ir->platform = new_ir->platform;
-    ir->copy_annotations(*new_ir);
+    close_legacy_session(ir, program, true, conversion_time);
+    if (conversion_time > 0.0) {
+        QL_IOUT(
+            "IR conversion for pass \"" << context.full_pass_name << "\" took "
+            << conversion_time << "s"
+        );
+    }
     return accumulator;
 }
 
@@ -220,12 +364,16 @@ utils::Int ProgramAnalysis::run_internal(
     const ir::Ref &ir,
     const Context &context
 ) const {
-    auto program = ir::convert_new_to_old(ir);
+    utils::Real conversion_time = 0.0;
+    auto program = open_legacy_session(ir, conversion_time);
     auto retval = run(program, context);
-    auto new_ir = ir::convert_old_to_new(program);
-    ir->program = new_ir->program;
-    ir->platform = new_ir->platform;
-    ir->copy_annotations(*new_ir);
+    close_legacy_session(ir, program, false, conversion_time);
+    if (conversion_time > 0.0) {
+        QL_IOUT(
+            "IR conversion for pass \"" << context.full_pass_name << "\" took "
+            << conversion_time << "s"
+        );
+    }
     return retval;
 }
 
@@ -271,15 +419,19 @@ utils::Int KernelAnalysis::run_internal(
     const ir::Ref &ir,
     const Context &context
 ) const {
-    auto program = ir::convert_new_to_old(ir);
+    utils::Real conversion_time = 0.0;
+    auto program = open_legacy_session(ir, conversion_time);
     utils::Int accumulator = retval_initialize();
     for (const auto &kernel : program->kernels) {
         accumulator = retval_accumulate(accumulator, run(program, kernel, context));
     }
-    auto new_ir = ir::convert_old_to_new(program);
-    ir->program = new_ir->program;
-    ir->platform = new_ir->platform;
-    ir->copy_annotations(*new_ir);
+    close_legacy_session(ir, program, false, conversion_time);
+    if (conversion_time > 0.0) {
+        QL_IOUT(
+            "IR conversion for pass \"" << context.full_pass_name << "\" took "
+            << conversion_time << "s"
+        );
+    }
     return accumulator;
 }
 
@@ -0,0 +1,267 @@
+/** \file
+ * Defines the structures used by the pass manager to record how much time and
+ * memory each pass takes.
+ */
+
+#include "ql/pmgr/profile.h"
+
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include "ql/utils/filesystem.h"
+#include "ql/pmgr/pass_types/specializations.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+
+namespace ql {
+namespace pmgr {
+
+/**
+ * Returns the current resource usage of the process.
+ */
+ResourceUsage ResourceUsage::now() {
+    ResourceUsage usage;
+    usage.wall_time = std::chrono::duration<utils::Real>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+#ifdef _WIN32
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time)) {
+        ULARGE_INTEGER kernel, user;
+        kernel.LowPart = kernel_time.dwLowDateTime;
+        kernel.HighPart = kernel_time.dwHighDateTime;
+        user.LowPart = user_time.dwLowDateTime;
+        user.HighPart = user_time.dwHighDateTime;
+        usage.cpu_time = (kernel.QuadPart + user.QuadPart) * 1.0e-7;
+    } else {
+        usage.cpu_time = (utils::Real)std::clock() / CLOCKS_PER_SEC;
+    }
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        usage.peak_rss = counters.PeakWorkingSetSize;
+    }
+#else
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) == 0) {
+        usage.cpu_time = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec * 1.0e-6
+                       + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec * 1.0e-6;
+#ifdef __APPLE__
+        usage.peak_rss = ru.ru_maxrss;
+#else
+        usage.peak_rss = ru.ru_maxrss * 1024;
+#endif
+    } else {
+        usage.cpu_time = (utils::Real)std::clock() / CLOCKS_PER_SEC;
+    }
+#endif
+    return usage;
+}
+
+/**
+ * Total wall-clock and CPU time spent in IrSize::measure() by each thread.
+ */
+static thread_local ResourceUsage measure_time;
+
+/**
+ * Adds the statements in the given block and its sub-blocks to the given IR
+ * size.
+ */
+static void measure_block(const ir::BlockBaseRef &block, IrSize &size) {
+    for (const auto &statement : block->statements) {
+        size.num_statements++;
+        if (statement->as_custom_instruction()) {
+            size.num_gates++;
+        } else if (auto if_else = statement->as_if_else()) {
+            for (const auto &branch : if_else->branches) {
+                measure_block(branch->body, size);
+            }
+            if (!if_else->otherwise.empty()) {
+                measure_block(if_else->otherwise, size);
+            }
+        } else if (auto loop = statement->as_loop()) {
+            measure_block(loop->body, size);
+        }
+    }
+}
+
+/**
+ * Measures the size of the program in the given IR. The new-IR representation
+ * of the program is always measured, such that measurements before and after
+ * a pass can be compared regardless of the kind of pass. If a legacy IR
+ * conversion session is active and the old IR was modified, the old IR is
+ * converted for this purpose without ending the session. The conversion is
+ * reused until the next legacy pass runs.
+ */
+IrSize IrSize::measure(const ir::Ref &ir) {
+    auto start = ResourceUsage::now();
+    IrSize size;
+    auto current = pass_types::peek_legacy_session(ir);
+    if (!current->program.empty()) {
+        for (const auto &block : current->program->blocks) {
+            measure_block(block, size);
+        }
+    }
+    auto end = ResourceUsage::now();
+    measure_time.wall_time += end.wall_time - start.wall_time;
+    measure_time.cpu_time += end.cpu_time - start.cpu_time;
+    return size;
+}
+
+/**
+ * Returns the total wall-clock and CPU time that the calling thread spent in
+ * measure() so far. The pass manager uses this to exclude the time spent
+ * measuring the sub-passes of a pass group from the time measured for the
+ * group.
+ */
+ResourceUsage IrSize::get_measure_time() {
+    return measure_time;
+}
+
+/**
+ * Records a run of the pass, given the resource usage and IR size before and
+ * after it.
+ */
+void PassProfile::record(
+    const ResourceUsage &usage_before,
+    const IrSize &ir_size_before,
+    const ResourceUsage &usage_after,
+    const IrSize &ir_size_after
+) {
+    if (!num_runs) {
+        size_before = ir_size_before;
+    }
+    size_after = ir_size_after;
+    num_runs++;
+    wall_time += usage_after.wall_time - usage_before.wall_time;
+    cpu_time += usage_after.cpu_time - usage_before.cpu_time;
+    if (usage_after.peak_rss > usage_before.peak_rss) {
+        peak_rss_delta += usage_after.peak_rss - usage_before.peak_rss;
+    }
+}
+
+/**
+ * Returns the name used for the given pass in the profile output.
+ */
+static utils::Str get_display_name(const PassProfile &pass) {
+    if (pass.full_pass_name.empty()) {
+        return "<root>";
+    }
+    return pass.full_pass_name;
+}
+
+/**
+ * Dumps the profile as a human-readable table.
+ */
+void Profile::dump(std::ostream &os, const utils::Str &line_prefix) const {
+
+    // Determine the width of the name column, indenting names by depth.
+    utils::UInt name_width = 4;
+    for (const auto &pass : passes) {
+        name_width = utils::max<utils::UInt>(
+            name_width,
+            2 * pass.depth + get_display_name(pass).size()
+        );
+    }
+
+    // Format the table in a separate stream, to leave the formatting flags of
+    // os alone.
+    utils::StrStrm ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << line_prefix << std::left << std::setw(name_width) << "pass" << std::right
+       << std::setw(8) << "runs"
+       << std::setw(12) << "wall [s]"
+       << std::setw(12) << "cpu [s]"
+       << std::setw(16) << "peak RSS [KiB]"
+       << std::setw(24) << "statements"
+       << std::setw(24) << "gates" << "\n";
+    for (const auto &pass : passes) {
+        ss << line_prefix << std::left << std::setw(name_width)
+           << (utils::Str(2 * pass.depth, ' ') + get_display_name(pass)) << std::right
+           << std::setw(8) << pass.num_runs
+           << std::setw(12) << pass.wall_time
+           << std::setw(12) << pass.cpu_time
+           << std::setw(16) << ("+" + utils::to_string(pass.peak_rss_delta / 1024))
+           << std::setw(24) << (
+               utils::to_string(pass.size_before.num_statements) + " -> "
+               + utils::to_string(pass.size_after.num_statements)
+           )
+           << std::setw(24) << (
+               utils::to_string(pass.size_before.num_gates) + " -> "
+               + utils::to_string(pass.size_after.num_gates)
+           ) << "\n";
+    }
+    os << ss.str();
+
+}
+
+/**
+ * Returns the profile as a JSON object with a single "passes" key mapping to
+ * an array of pass objects.
+ */
+utils::Json Profile::to_json() const {
+    utils::Json json_passes = utils::Json::array();
+    for (const auto &pass : passes) {
+        json_passes.push_back({
+            {"name", pass.full_pass_name},
+            {"type", pass.type_name},
+            {"depth", pass.depth},
+            {"group", pass.is_group},
+            {"runs", pass.num_runs},
+            {"wall_time", pass.wall_time},
+            {"cpu_time", pass.cpu_time},
+            {"peak_rss_delta", pass.peak_rss_delta},
+            {"statements_before", pass.size_before.num_statements},
+            {"statements_after", pass.size_after.num_statements},
+            {"gates_before", pass.size_before.num_gates},
+            {"gates_after", pass.size_after.num_gates}
+        });
+    }
+    return {{"passes", json_passes}};
+}
+
+/**
+ * Dumps the profile in CSV format, with a header row and one row per pass.
+ * Pass and type names cannot contain commas or quotes, so no quoting is
+ * needed.
+ */
+void Profile::dump_csv(std::ostream &os) const {
+    os << "name,type,depth,group,runs,wall_time,cpu_time,peak_rss_delta,"
+          "statements_before,statements_after,gates_before,gates_after\n";
+    for (const auto &pass : passes) {
+        os << pass.full_pass_name << ","
+           << pass.type_name << ","
+           << pass.depth << ","
+           << (pass.is_group ? 1 : 0) << ","
+           << pass.num_runs << ","
+           << pass.wall_time << ","
+           << pass.cpu_time << ","
+           << pass.peak_rss_delta << ","
+           << pass.size_before.num_statements << ","
+           << pass.size_after.num_statements << ","
+           << pass.size_before.num_gates << ","
+           << pass.size_after.num_gates << "\n";
+    }
+}
+
+/**
+ * Writes the profile to the given file. The file is written in CSV format if
+ * its name ends in `.csv`, or in JSON format otherwise.
+ */
+void Profile::write(const utils::Str &filename) const {
+    utils::OutFile file(filename);
+    if (utils::ends_with(utils::to_lower(filename), ".csv")) {
+        dump_csv(file.unwrap());
+    } else {
+        file << to_json().dump(4) << "\n";
+    }
+}
+
+} // namespace pmgr
+} // namespace ql
@@ -5,6 +5,8 @@
 
 #include "ql/resource/instrument.h"
 
+#include <mutex>
+
 // uncomment next line to enable multi-line dumping
 // #define MULTI_LINE_LOG_DEBUG
 
@@ -47,6 +49,38 @@ using Predicate = utils::Pair<utils::Str, utils::Set<utils::Str>>;
  */
 using Predicates = utils::Vec<Predicate>;
 
+/**
+ * Represents a set of instruments as a bitset, stored as words of
+ * INSTRUMENTS_PER_WORD bits.
+ */
+using InstrumentBits = utils::Vec<utils::UInt>;
+
+/**
+ * The number of instruments represented by each word of an InstrumentBits.
+ */
+static const utils::UInt INSTRUMENTS_PER_WORD = 64;
+
+/**
+ * Properties of a gate type that determine how it uses the instruments,
+ * derived from the JSON data of the instruction once rather than for every
+ * gate.
+ */
+struct GateDescriptor {
+
+    /**
+     * Whether the gate type matches the predicates, indexed in the same way as
+     * Config::predicates.
+     */
+    utils::Bool matches[3];
+
+    /**
+     * The function index of the gate type. Always 0 when all instrument usage
+     * is mutually exclusive.
+     */
+    Function function;
+
+};
+
 /**
  * Configuration structure. This does not need to be copied every time the
  * resource state is cloned; we keep a shared_ptr to it instead.
@@ -111,6 +145,61 @@ struct Config {
      */
     utils::Map<Qubit, Instruments> multi_qubit_instrument[3];
 
+    /**
+     * The number of words in the instrument bitsets.
+     */
+    utils::UInt num_words;
+
+    /**
+     * Bitset representation of single_qubit_instruments, with the num_words
+     * words of each qubit stored consecutively.
+     */
+    InstrumentBits single_qubit_bits;
+
+    /**
+     * Bitset representation of two_qubit_instrument, with the num_words words
+     * of each qubit stored consecutively.
+     */
+    InstrumentBits two_qubit_bits[2];
+
+    /**
+     * Bitset representation of two_qubit_edge_instrument.
+     */
+    utils::Map<Edge, InstrumentBits> two_qubit_edge_bits;
+
+    /**
+     * Bitset representation of multi_qubit_instrument, with the num_words
+     * words of each qubit stored consecutively.
+     */
+    InstrumentBits multi_qubit_bits[3];
+
+    /**
+     * Precomputed gate descriptors for the instructions known to the platform
+     * when the resource was initialized, indexed by the address of their JSON
+     * data. Never modified after initialization, so clones of the resource
+     * can use it concurrently.
+     */
+    utils::Map<const utils::Json*, GateDescriptor> descriptors;
+
+    /**
+     * Gate descriptor for gates without JSON data.
+     */
+    GateDescriptor empty_descriptor;
+
+    /**
+     * Gate descriptors for JSON data that was not known to the platform when
+     * the resource was initialized, indexed by the contents of the JSON data
+     * rather than its address, as the latter may be reused after the gate is
+     * destroyed. Only ever extended, so references to entries remain valid.
+     */
+    utils::Map<utils::Json, GateDescriptor> late_descriptors;
+
+    /**
+     * Mutex protecting late_descriptors, and function_map, which may still be
+     * extended by clones of the resource while describing these gates.
+     */
+    std::mutex late_mutex;
+
     /**
      * Defines the scheduling direction, if there is one. This controls whether
      * old reservations will be removed when a new reservation is added. For
@@ -129,6 +218,139 @@ struct Config {
 
 };
 
+/**
+ * Adds the given instruments to the given bitset of num_words words, starting
+ * at the given word offset.
+ */
+static void add_instruments(
+    const Instruments &instruments,
+    InstrumentBits &bits,
+    utils::UInt offset = 0
+) {
+    for (auto instrument : instruments) {
+        bits[offset + instrument / INSTRUMENTS_PER_WORD] |= 1ull << (instrument % INSTRUMENTS_PER_WORD);
+    }
+}
+
+/**
+ * Converts a map from qubit to instruments to its bitset representation, with
+ * the num_words words of each qubit stored consecutively.
+ */
+static InstrumentBits qubit_map_to_bits(
+    const utils::Map<Qubit, Instruments> &map,
+    utils::UInt num_qubits,
+    utils::UInt num_words
+) {
+    InstrumentBits bits(num_qubits * num_words, 0);
+    for (const auto &it : map) {
+        add_instruments(it.second, bits, it.first * num_words);
+    }
+    return bits;
+}
+
+/**
+ * Derives the gate descriptor for the given JSON data of an instruction.
+ */
+static GateDescriptor describe_gate(Config &config, const utils::Json &gate_json) {
+    GateDescriptor descriptor;
+
+    // Check predicates for each operand count.
+    for (utils::UInt op_count_pos = 0; op_count_pos < 3; op_count_pos++) {
+        descriptor.matches[op_count_pos] = true;
+        for (const auto &predicate : config.predicates[op_count_pos]) {
+            auto it = gate_json.find(predicate.first);
+            if (
+                it == gate_json.end()
+                || !it->is_string()
+                || predicate.second.count(it->get<utils::Str>()) == 0
+            ) {
+                descriptor.matches[op_count_pos] = false;
+                break;
+            }
+        }
+    }
+
+    // If not mutually exclusive, determine the function based on keys in the
+    // gate's JSON.
+    descriptor.function = 0;
+    if (!config.mutually_exclusive) {
+        utils::Vec<utils::Str> function_key;
+        function_key.resize(config.function_keys.size());
+        for (utils::UInt i = 0; i < function_key.size(); i++) {
+            auto it = gate_json.find(config.function_keys[i]);
+            if (it != gate_json.end() && it->is_string()) {
+                function_key[i] = it->get<utils::Str>();
+            }
+        }
+
+        // Because storing vectors of strings in the resource state is a bit
+        // ridiculous, we map these string tuples to unique integers. We just
+        // generate a new integer whenever we see a function that we haven't
+        // seen before. Note that this is fine even when resources are cloned
+        // (remember: config is NOT cloned!) because we only ever add indices
+        // here. Doing so doesn't affect the state. At worst, it may change
+        // *future* indices added by other clones of this resource. After
+        // initialization, the caller must hold late_mutex.
+        auto it = config.function_map.find(function_key);
+        if (it == config.function_map.end()) {
+            descriptor.function = config.function_map.size();
+            config.function_map.set(function_key) = descriptor.function;
+        } else {
+            descriptor.function = it->second;
+        }
+    }
+
+    return descriptor;
+}
+
+/**
+ * Returns the gate descriptor for JSON data that was not known to the platform
+ * when the resource was initialized, describing it only the first time these
+ * contents are seen.
+ */
+static const GateDescriptor &describe_late_gate(Config &config, const utils::Json &gate_json) {
+    std::lock_guard<std::mutex> lock(config.late_mutex);
+    auto it = config.late_descriptors.find(gate_json);
+    if (it != config.late_descriptors.end()) {
+        return it->second;
+    }
+    return config.late_descriptors.set(gate_json) = describe_gate(config, gate_json);
+}
+
+/**
+ * Returns the index of the least significant set bit of the given nonzero
+ * word.
+ */
+static utils::UInt count_trailing_zeros(utils::UInt word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    static const utils::UInt DE_BRUIJN_SEQUENCE = 0x03F79D71B4CB0A89ull;
+    static const unsigned char DE_BRUIJN_INDEX[64] = {
+         0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6
+    };
+    return DE_BRUIJN_INDEX[((word & (~word + 1)) * DE_BRUIJN_SEQUENCE) >> 58];
+#endif
+}
+
+/**
+ * Precomputes the gate descriptors for the given new-IR instruction type and
+ * its specializations.
+ */
+static void describe_instruction_type(
+    Config &config,
+    const utils::One<ir::InstructionType> &instruction_type
+) {
+    const auto &gate_json = instruction_type->data.data;
+    config.descriptors.set(&gate_json) = describe_gate(config, gate_json);
+    for (const auto &specialization : instruction_type->specializations) {
+        describe_instruction_type(config, specialization);
+    }
+}
+
 /**
  * Initializes this resource.
  */
@@ -454,6 +676,37 @@ void InstrumentResource::on_initialize(rmgr::Direction direction) {
         cfg->instrument_names.push_back(name);
     }
 
+    // Convert the qubit-to-instrument maps to bitsets, so on_gate() can
+    // determine the affected instruments with a couple of bitwise ORs.
+    auto num_qubits = context->platform->qubit_count;
+    cfg->num_words = utils::div_ceil(cfg->instrument_names.size(), INSTRUMENTS_PER_WORD);
+    cfg->single_qubit_bits = qubit_map_to_bits(cfg->single_qubit_instruments, num_qubits, cfg->num_words);
+    for (utils::UInt i = 0; i < 2; i++) {
+        cfg->two_qubit_bits[i] = qubit_map_to_bits(cfg->two_qubit_instrument[i], num_qubits, cfg->num_words);
+    }
+    for (const auto &it : cfg->two_qubit_edge_instrument) {
+        auto &bits = cfg->two_qubit_edge_bits.set(it.first);
+        bits.resize(cfg->num_words, 0);
+        add_instruments(it.second, bits);
+    }
+    for (utils::UInt i = 0; i < 3; i++) {
+        cfg->multi_qubit_bits[i] = qubit_map_to_bits(cfg->multi_qubit_instrument[i], num_qubits, cfg->num_words);
+    }
+
+    // Precompute the gate descriptors for all instructions known to the
+    // platform, so on_gate() doesn't have to query the JSON data of every
+    // gate it sees.
+    cfg->empty_descriptor = describe_gate(*cfg, utils::Json());
+    const auto &instructions = context->platform->get_instructions();
+    for (auto it = instructions.begin(); it != instructions.end(); ++it) {
+        cfg->descriptors.set(&*it) = describe_gate(*cfg, *it);
+    }
+    if (!context->ir.empty() && !context->ir->platform.empty()) {
+        for (const auto &instruction_type : context->ir->platform->instructions) {
+            describe_instruction_type(*cfg, instruction_type);
+        }
+    }
+
     // Whew, what a mouthful. But now we're done.
     config = cfg;
 
@@ -499,12 +752,15 @@ void InstrumentResource::on_initialize(rmgr::Direction direction) {
 }
 
 /**
- * Checks availability of and/or reserves a gate.
+ * Checks availability of and/or reserves a gate. When the gate is not
+ * available, conflict is set to a reserved range that prevents it from being
+ * placed.
  */
-utils::Bool InstrumentResource::on_gate(
+utils::Bool InstrumentResource::check_gate(
     utils::Int cycle,
     const rmgr::resource_types::GateData &gate,
-    utils::Bool commit
+    utils::Bool commit,
+    State::Range &conflict
 ) {
     QL_DOUT(
         "instrument resource " << context->instance_name
@@ -520,75 +776,79 @@ utils::Bool InstrumentResource::on_gate(
         return true;
     }
 
-    // Fetch the JSON data for this gate.
+    // Look up the precomputed descriptor for the gate type. Gates whose
+    // JSON data was not known to the platform when the resource was
+    // initialized are described the first time their data is seen.
     const auto &gate_json = *gate.data;
+    const GateDescriptor *descriptor;
+    auto descriptor_it = config->descriptors.find(&gate_json);
+    if (descriptor_it != config->descriptors.end()) {
+        descriptor = &descriptor_it->second;
+    } else if (gate_json.empty()) {
+        descriptor = &config->empty_descriptor;
+    } else {
+        descriptor = &describe_late_gate(*config, gate_json);
+    }
 
     // Check predicates. If the gate doesn't match, we don't care about it, so
     // we can return true, such that it can be started in any cycle.
     auto op_count_pos = utils::min<utils::UInt>(gate.qubits.size() - 1, 2);
-    for (const auto &predicate : config->predicates[op_count_pos]) {
-        auto it = gate_json.find(predicate.first);
-        if (it == gate_json.end()) {
-            QL_DOUT(
-                " -> available: gate does not match predicate "
-                << predicate.first << ": key does not exist"
-            );
-            return true;
-        } else if (!it->is_string()) {
-            QL_DOUT(
-                " -> available: gate does not match predicate "
-                << predicate.first << ": key is not a string"
-            );
-            return true;
-        } else if (predicate.second.count(it->get<utils::Str>()) == 0) {
-            QL_DOUT(
-                " -> available: gate does not match predicate "
-                << predicate.first << ": value " << it->get<utils::Str>()
-                << " not in " << predicate.second
-            );
-            return true;
-        }
+    if (!descriptor->matches[op_count_pos]) {
+        QL_DOUT(" -> available: gate does not match predicates");
+        return true;
     }
 
-    // Check operands to see which instruments are affected.
-    utils::Set<Instrument> affected;
+    // Check operands to see which instruments are affected. The scratch space
+    // is thread-local rather than part of the resource, because the mapper
+    // may check availability against a shared resource state from multiple
+    // threads.
+    static thread_local InstrumentBits affected_bits;
+    static thread_local Instruments affected;
+    auto num_words = config->num_words;
+    auto num_qubits = context->platform->qubit_count;
+    affected_bits.assign(num_words, 0);
+    auto add_qubit = [&](const InstrumentBits &bits, Qubit qubit) {
+        if (qubit < num_qubits) {
+            for (utils::UInt i = 0; i < num_words; i++) {
+                affected_bits[i] |= bits[qubit * num_words + i];
+            }
+        }
+    };
     switch (gate.qubits.size()) {
         case 1: {
             // Single-qubit gate.
-            auto it = config->single_qubit_instruments.find(gate.qubits[0]);
-            if (it != config->single_qubit_instruments.end()) {
-                affected.insert(it->second.begin(), it->second.end());
-            }
+            add_qubit(config->single_qubit_bits, gate.qubits[0]);
             break;
         }
         case 2: {
             // Two-qubit gate.
-            for (auto i = 0; i < 2; i++) {
-                auto it = config->two_qubit_instrument[i].find(gate.qubits[i]);
-                if (it != config->two_qubit_instrument[i].end()) {
-                    affected.insert(it->second.begin(), it->second.end());
-                }
+            for (utils::UInt i = 0; i < 2; i++) {
+                add_qubit(config->two_qubit_bits[i], gate.qubits[i]);
             }
-            auto it = config->two_qubit_edge_instrument.find(
+            auto it = config->two_qubit_edge_bits.find(
                 Edge(gate.qubits[0], gate.qubits[1])
             );
-            if (it != config->two_qubit_edge_instrument.end()) {
-                affected.insert(it->second.begin(), it->second.end());
+            if (it != config->two_qubit_edge_bits.end()) {
+                for (utils::UInt i = 0; i < num_words; i++) {
+                    affected_bits[i] |= it->second[i];
+                }
             }
             break;
         }
         default: {
             // Three-or-more-qubit gate.
             for (utils::UInt i = 0; i < gate.qubits.size(); i++) {
-                auto j = utils::min<utils::UInt>(i, 2);
-                auto it = config->two_qubit_instrument[j].find(gate.qubits[i]);
-                if (it != config->two_qubit_instrument[j].end()) {
-                    affected.insert(it->second.begin(), it->second.end());
-                }
+                add_qubit(config->multi_qubit_bits[utils::min<utils::UInt>(i, 2)], gate.qubits[i]);
             }
             break;
         }
     }
+    affected.clear();
+    for (utils::UInt i = 0; i < num_words; i++) {
+        for (auto word = affected_bits[i]; word; word &= word - 1) {
+            affected.push_back(i * INSTRUMENTS_PER_WORD + count_trailing_zeros(word));
+        }
+    }
 
     // If no instruments are affected, short-circuit here.
     if (affected.empty()) {
@@ -605,42 +865,17 @@ utils::Bool InstrumentResource::on_gate(
     // If function is set to exclusive, just check/reserve the cycle range for
     // this gate for all affected instruments without caring about the function
     // value.
-    Function function = 0;
+    auto function = descriptor->function;
     if (config->mutually_exclusive) {
         for (auto index : affected) {
-            if (state[index].find(range).type != utils::RangeMatchType::NONE) {
+            auto result = state[index].find(range);
+            if (result.type != utils::RangeMatchType::NONE) {
                 QL_DOUT(" -> not available because of instrument " << config->instrument_names[index]);
+                conflict = result.begin->first;
                 return false;
             }
         }
     } else {
-
-        // If not mutually exclusive, determine the function based on keys in
-        // the gate's JSON.
-        utils::Vec<utils::Str> function_key;
-        function_key.resize(config->function_keys.size());
-        for (utils::UInt i = 0; i < function_key.size(); i++) {
-            auto it = gate_json.find(config->function_keys[i]);
-            if (it != gate_json.end() && it->is_string()) {
-                function_key[i] = it->get<utils::Str>();
-            }
-        }
-        QL_DOUT("    function key = " << function_key);
-
-        // Because storing vectors of strings in the resource state is a bit
-        // ridiculous, we map these string tuples to unique integers. We just
-        // generate a new integer whenever we see a function that we haven't
-        // seen before. Note that this is fine even when resources are cloned
-        // (remember: config is NOT cloned!) because we only ever add indices
-        // here. Doing so doesn't affect the state. At worst, it may change
-        // *future* indices added by other clones of this resource.
-        auto it = config->function_map.find(function_key);
-        if (it == config->function_map.end()) {
-            function = config->function_map.size();
-            config->function_map.set(function_key) = function;
-        } else {
-            function = it->second;
-        }
         QL_DOUT("    function index = " << function);
 
         // Check the resources based on function index.
@@ -674,6 +909,7 @@ utils::Bool InstrumentResource::on_gate(
                             << config->instrument_names[index]
                             << ", function mismatch"
                         );
+                        conflict = result.begin->first;
                         return false;
                     }
                     break;
@@ -689,6 +925,7 @@ utils::Bool InstrumentResource::on_gate(
                             << config->instrument_names[index]
                             << ", overlapping wrong"
                         );
+                        conflict = result.begin->first;
                         return false;
                     }
 
@@ -701,6 +938,7 @@ utils::Bool InstrumentResource::on_gate(
                                 << config->instrument_names[index]
                                 << ", function mismatch in overlapping range"
                             );
+                            conflict = it2->first;
                             return false;
                         }
                     }
@@ -736,6 +974,44 @@ utils::Bool InstrumentResource::on_gate(
     return true;
 }
 
+/**
+ * Checks availability of and/or reserves a gate.
+ */
+utils::Bool InstrumentResource::on_gate(
+    utils::Int cycle,
+    const rmgr::resource_types::GateData &gate,
+    utils::Bool commit
+) {
+    State::Range conflict;
+    return check_gate(cycle, gate, commit, conflict);
+}
+
+/**
+ * Returns the given cycle if the gate is available in it, or otherwise the
+ * cycle before which the gate certainly can't be started.
+ */
+utils::Int InstrumentResource::on_next_cycle(
+    utils::Int cycle,
+    const rmgr::resource_types::GateData &gate
+) {
+    State::Range conflict;
+    if (check_gate(cycle, gate, false, conflict)) {
+        return cycle;
+    }
+
+    // All reservations start at or before the scheduling frontier when
+    // scheduling forward, and at or after it when scheduling backward, so
+    // the conflicting range can't match the gate exactly at any cycle further
+    // in scheduling direction. Hence, the gate remains blocked at least for as
+    // long as the conflicting range overlaps with it.
+    if (config->direction == rmgr::Direction::FORWARD) {
+        return conflict.second;
+    } else if (config->direction == rmgr::Direction::BACKWARD) {
+        return conflict.first - (utils::Int)gate.duration_cycles;
+    }
+    return cycle + 1;
+}
+
 /**
  * Dumps documentation for this resource.
  */
@@ -1287,6 +1563,7 @@ void InstrumentResource::on_dump_state(
         os << line_prefix << "Not yet initialized" << std::endl;
         return;
     }
+    std::lock_guard<std::mutex> lock(config->late_mutex);
     for (utils::UInt i = 0; i < state.size(); i++) {
         os << line_prefix << "Instrument " << config->instrument_names[i] << ":\n";
         state[i].dump_state(
@@ -62,12 +62,6 @@ struct Config {
      */
     utils::UInt num_system_wide_channels;
 
-    /**
-     * When set, there is a defined scheduling direction, which means it's
-     * sufficient to only track the latest reservation for each qubit.
-     */
-    utils::Bool optimize;
-
     /**
      * The (desugared) JSON configuration of this resource. Only retained for
      * dumping the configuration.
@@ -88,7 +82,6 @@ void InterCoreChannelResource::on_initialize(rmgr::Direction direction) {
 
     // Set the easy stuff.
     cfg->num_cores = context->platform->topology->get_num_cores();
-    cfg->optimize = direction != rmgr::Direction::UNDEFINED;
 
     // Parse the JSON configuration.
     cfg->json = context->configuration;
@@ -208,11 +201,7 @@ void InterCoreChannelResource::on_initialize(rmgr::Direction direction) {
     config = cfg;
 
     // Initialize state.
-    state.clear();
-    state.resize(cfg->num_cores);
-    for (auto &s : state) {
-        s.resize(cfg->num_channels);
-    }
+    state = rmgr::ExclusiveReservations(cfg->num_cores * cfg->num_channels, direction);
 
     // Print result if debug is enabled.
 #ifdef MULTI_LINE_LOG_DEBUG
@@ -318,16 +307,17 @@ utils::Bool InterCoreChannelResource::on_gate(
     // When acquisition fails, return false.
     
     // Compute cycle range for this gate.
-    State::Range range = {
+    rmgr::ExclusiveReservations::Range range = {
         cycle,
         cycle + gate.duration_cycles
     };
 
     // Check availability wrt number of channels per core.
+    auto num_channels = config->num_channels;
     for (auto core : affected) {
         utils::Bool core_available = false;
-        for (auto &s : state[core]) {
-            if (s.find(range).type == utils::RangeMatchType::NONE) {
+        for (utils::UInt channel = 0; channel < num_channels; channel++) {
+            if (state.is_available(core * num_channels + channel, range)) {
                 core_available = true;
                 break;
             }
@@ -340,11 +330,9 @@ utils::Bool InterCoreChannelResource::on_gate(
 
     // Check availability wrt number of channels system-wide
     utils::UInt num_channels_in_use = 0;
-    for (auto &core : state) {
-        for (auto &channel : core) {
-            if (channel.find(range).type != utils::RangeMatchType::NONE) {
-                num_channels_in_use++;
-            }
+    for (utils::UInt index = 0; index < state.size(); index++) {
+        if (!state.is_available(index, range)) {
+            num_channels_in_use++;
         }
     }
     if (num_channels_in_use + gate.qubits.size() > config->num_system_wide_channels) {
@@ -361,12 +349,10 @@ utils::Bool InterCoreChannelResource::on_gate(
         );
         for (auto core : affected) {
             utils::Bool core_found = false;
-            for (auto &s : state[core]) {
-                if (s.find(range).type == utils::RangeMatchType::NONE) {
-                    if (config->optimize) {
-                        s.clear();
-                    }
-                    s.set(range);
+            for (utils::UInt channel = 0; channel < num_channels; channel++) {
+                auto index = core * num_channels + channel;
+                if (state.is_available(index, range)) {
+                    state.reserve(index, range);
                     core_found = true;
                     break;
                 }
@@ -502,7 +488,7 @@ void InterCoreChannelResource::on_dump_config(
     std::ostream &os,
     const utils::Str &line_prefix
 ) const {
-    if (state.empty()) {
+    if (config.empty()) {
         os << line_prefix << "Not yet initialized" << std::endl;
         return;
     }
@@ -517,16 +503,15 @@ void InterCoreChannelResource::on_dump_state(
     std::ostream &os,
     const utils::Str &line_prefix
 ) const {
-    if (state.empty()) {
+    if (config.empty()) {
         os << line_prefix << "Not yet initialized" << std::endl;
         return;
     }
-    for (utils::UInt core = 0; core < state.size(); core++) {
+    for (utils::UInt core = 0; core < config->num_cores; core++) {
         os << line_prefix << "Core " << core << ":\n";
-        const auto &core_state = state[core];
-        for (utils::UInt channel = 0; channel < core_state.size(); channel++) {
+        for (utils::UInt channel = 0; channel < config->num_channels; channel++) {
             os << line_prefix << "  Channel " << channel << ":\n";
-            core_state[channel].dump_state(os, line_prefix + "    ");
+            state.dump_state(core * config->num_channels + channel, os, line_prefix + "    ");
         }
     }
     os.flush();
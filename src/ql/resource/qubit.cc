@@ -13,8 +13,7 @@ namespace qubit {
  * Initializes this resource.
  */
 void QubitResource::on_initialize(rmgr::Direction direction) {
-    state = utils::Vec<State>(context->platform->qubit_count);
-    optimize = direction != rmgr::Direction::UNDEFINED;
+    state = rmgr::ExclusiveReservations(context->platform->qubit_count, direction);
 }
 
 /**
@@ -27,14 +26,14 @@ utils::Bool QubitResource::on_gate(
 ) {
 
     // Compute cycle range for this gate.
-    State::Range range = {
+    rmgr::ExclusiveReservations::Range range = {
         cycle,
         cycle + gate.duration_cycles
     };
 
     // Check qubit availability for all operands.
     for (auto qubit : gate.qubits) {
-        if (state[qubit].find(range).type != utils::RangeMatchType::NONE) {
+        if (!state.is_available(qubit, range)) {
             return false;
         }
     }
@@ -42,16 +41,35 @@ utils::Bool QubitResource::on_gate(
     // If we're committing, reserve for all operands.
     if (commit) {
         for (auto qubit : gate.qubits) {
-            if (optimize) {
-                state[qubit].clear();
-            }
-            state[qubit].set(range);
+            state.reserve(qubit, range);
         }
     }
 
     return true;
 }
 
+/**
+ * Returns the given cycle if the gate is available in it, or otherwise the
+ * cycle before which the gate certainly can't be started.
+ */
+utils::Int QubitResource::on_next_cycle(
+    utils::Int cycle,
+    const rmgr::resource_types::GateData &gate
+) {
+    rmgr::ExclusiveReservations::Range range = {
+        cycle,
+        cycle + gate.duration_cycles
+    };
+
+    // The gate must wait for the first qubit that is in use.
+    for (auto qubit : gate.qubits) {
+        if (!state.is_available(qubit, range)) {
+            return state.get_next_cycle(qubit, range);
+        }
+    }
+    return cycle;
+}
+
 /**
  * Dumps documentation for this resource.
  */
@@ -94,7 +112,7 @@ void QubitResource::on_dump_state(
 ) const {
     for (utils::UInt q = 0; q < state.size(); q++) {
         os << line_prefix << "Qubit " << q << ":\n";
-        state[q].dump_state(os, line_prefix + "  ");
+        state.dump_state(q, os, line_prefix + "  ");
     }
 }
 
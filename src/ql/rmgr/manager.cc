@@ -362,6 +362,7 @@ void Manager::remove_resource(
  */
 State Manager::build(Direction direction) const {
     State state;
+    state.direction = direction;
     state.resources.reserve(resources.size());
     for (const auto &it : resources) {
         state.resources.emplace_back(it.second.clone());
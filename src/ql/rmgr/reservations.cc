@@ -0,0 +1,118 @@
+/** \file
+ * Defines a compact reservation state for resources that can only be used by
+ * one gate at a time.
+ */
+
+#include "ql/rmgr/reservations.h"
+
+namespace ql {
+namespace rmgr {
+
+/**
+ * Placeholder for the most recent reservation of a resource that has not been
+ * reserved yet. This does not overlap with any valid range.
+ */
+const ExclusiveReservations::Range ExclusiveReservations::NONE = {utils::MIN, utils::MIN};
+
+/**
+ * Constructs an empty state for the given number of resources and the given
+ * scheduling direction.
+ */
+ExclusiveReservations::ExclusiveReservations(
+    utils::UInt num_resources,
+    Direction direction
+) :
+    direction(direction),
+    windowed(direction != Direction::UNDEFINED)
+{
+    if (windowed) {
+        latest.resize(num_resources, NONE);
+    } else {
+        history.resize(num_resources);
+    }
+}
+
+/**
+ * Returns the number of resources.
+ */
+utils::UInt ExclusiveReservations::size() const {
+    return windowed ? latest.size() : history.size();
+}
+
+/**
+ * Returns whether the given resource is free for the given cycle range.
+ */
+utils::Bool ExclusiveReservations::is_available(
+    utils::UInt resource,
+    const Range &range
+) const {
+    if (!windowed) {
+        return history[resource].find(range).type == utils::RangeMatchType::NONE;
+    }
+
+    // Same overlap semantics as RangeMap::find(): ranges that merely touch
+    // do not overlap, and neither do empty ranges at the boundary of another.
+    const auto &reserved = latest[resource];
+    return reserved.second <= range.first || range.second <= reserved.first;
+}
+
+/**
+ * Returns a cycle beyond the start of the given range, in scheduling direction,
+ * before which a gate with the duration of the given range can certainly not
+ * use the given resource, given that the resource is not available for the
+ * given range. When the direction is undefined, this is simply the next cycle.
+ */
+utils::Int ExclusiveReservations::get_next_cycle(
+    utils::UInt resource,
+    const Range &range
+) const {
+    if (!windowed) {
+        return range.first + 1;
+    }
+
+    // The most recent reservation overlaps with the given range. Reservations
+    // made after it lie beyond it in scheduling direction, so the resource
+    // becomes free for the given duration no sooner than just after (forward)
+    // or before (backward) it.
+    const auto &reserved = latest[resource];
+    if (direction == Direction::FORWARD) {
+        return reserved.second;
+    } else {
+        return reserved.first - (range.second - range.first);
+    }
+}
+
+/**
+ * Reserves the given resource for the given cycle range, which must be
+ * available.
+ */
+void ExclusiveReservations::reserve(
+    utils::UInt resource,
+    const Range &range
+) {
+    if (windowed) {
+        latest[resource] = range;
+    } else {
+        history[resource].set(range);
+    }
+}
+
+/**
+ * Dumps the reservations of the given resource.
+ */
+void ExclusiveReservations::dump_state(
+    utils::UInt resource,
+    std::ostream &os,
+    const utils::Str &line_prefix
+) const {
+    if (!windowed) {
+        history[resource].dump_state(os, line_prefix);
+    } else if (latest[resource] == NONE) {
+        os << line_prefix << "empty" << std::endl;
+    } else {
+        os << line_prefix << "[" << latest[resource].first << ".." << latest[resource].second << ")" << std::endl;
+    }
+}
+
+} // namespace rmgr
+} // namespace ql
@@ -32,6 +32,29 @@ void Base::on_initialize(Direction direction) {
     (void)direction;
 }
 
+/**
+ * Abstract implementation for next_cycle(). It should return the given cycle
+ * if the gate is available in it, like on_gate() without commit. Otherwise,
+ * it should return a cycle beyond the given one, in the scheduling direction,
+ * before which the gate can certainly not be started given the current state.
+ * The default implementation checks availability with on_gate(), and returns
+ * the next cycle in scheduling direction if the gate is not available, which
+ * is always correct.
+ */
+utils::Int Base::on_next_cycle(
+    utils::Int cycle,
+    const GateData &gate
+) {
+    if (on_gate(cycle, gate, false)) {
+        return cycle;
+    }
+    if (direction == Direction::BACKWARD) {
+        return cycle - 1;
+    } else {
+        return cycle + 1;
+    }
+}
+
 /**
  * Returns the type name for this resource.
  */
@@ -130,6 +153,19 @@ utils::Bool Base::gate(
     return retval;
 }
 
+/**
+ * Converts the given old-IR gate to the GateData wrapper.
+ */
+GateData Base::get_gate_data(const ir::compat::GateRef &gate) const {
+    GateData data;
+    data.gate = gate;
+    data.name = gate->name;
+    data.duration_cycles = utils::div_ceil(gate->duration, context->platform->cycle_time);
+    data.qubits = gate->operands;
+    data.data = &context->platform->find_instruction(gate->name);
+    return data;
+}
+
 /**
  * Checks and optionally updates the resource manager state for the given
  * old-IR gate and (start) cycle number. The state is only updated if the
@@ -143,16 +179,7 @@ utils::Bool Base::gate(
     if (!initialized) {
         throw utils::Exception("resource gate() called before initialization");
     }
-
-    // Convert to GateData wrapper.
-    GateData data;
-    data.gate = gate;
-    data.name = gate->name;
-    data.duration_cycles = utils::div_ceil(gate->duration, context->platform->cycle_time);
-    data.qubits = gate->operands;
-    data.data = &context->platform->find_instruction(gate->name);
-
-    return this->gate((utils::Int)cycle, data, commit);
+    return this->gate((utils::Int)cycle, get_gate_data(gate), commit);
 }
 
 /**
@@ -220,6 +247,57 @@ utils::Bool Base::gate(
     return this->gate(cycle, data, commit);
 }
 
+/**
+ * Returns the first cycle from the given cycle onward, in scheduling
+ * direction, at which the given gate might be schedulable as far as this
+ * resource is concerned. This is the given cycle itself if the gate is
+ * schedulable for it. Otherwise, it is a cycle before which the gate can
+ * certainly not be started, even when more gates with a nonzero duration are
+ * scheduled in the meantime.
+ */
+utils::Int Base::next_cycle(
+    utils::Int cycle,
+    const GateData &data
+) {
+    if (!initialized) {
+        throw utils::Exception("resource next_cycle() called before initialization");
+    }
+
+    // Gates can't be scheduled before the most recently scheduled gate.
+    switch (direction) {
+        case Direction::FORWARD: if (cycle < prev_cycle) return prev_cycle; break;
+        case Direction::BACKWARD: if (cycle > prev_cycle) return prev_cycle; break;
+        default: void();
+    }
+
+    // The resource checks availability and determines the next cycle in one
+    // go, so it doesn't have to evaluate the gate twice.
+    auto next = on_next_cycle(cycle, data);
+    if (next == cycle) {
+        return cycle;
+    }
+
+    // Make sure that the resource implementation makes progress.
+    if (direction == Direction::BACKWARD) {
+        return utils::min(next, cycle - 1);
+    } else {
+        return utils::max(next, cycle + 1);
+    }
+}
+
+/**
+ * Same as the above, but for the given old-IR gate.
+ */
+utils::Int Base::next_cycle(
+    utils::UInt cycle,
+    const ir::compat::GateRef &gate
+) {
+    if (!initialized) {
+        throw utils::Exception("resource next_cycle() called before initialization");
+    }
+    return next_cycle((utils::Int)cycle, get_gate_data(gate));
+}
+
 /**
  * Dumps a debug representation of the current resource state.
  */
@@ -14,7 +14,7 @@ namespace rmgr {
 /**
  * Constructor for the initial state, called from Manager::build().
  */
-State::State() : resources(), is_broken(false) {
+State::State() : resources(), is_broken(false), direction(Direction::UNDEFINED) {
 }
 
 /**
@@ -26,6 +26,7 @@ State::State(const State &src) {
         resources[i] = src.resources[i].clone();
     }
     is_broken = src.is_broken;
+    direction = src.direction;
 }
 
 /**
@@ -37,6 +38,7 @@ State &State::operator=(const State &src) {
         resources[i] = src.resources[i].clone();
     }
     is_broken = src.is_broken;
+    direction = src.direction;
     return *this;
 }
 
@@ -78,6 +80,34 @@ utils::Bool State::available(
     return true;
 }
 
+/**
+ * Returns the first cycle from the given cycle onward, in scheduling
+ * direction, at which the given old-IR gate might be schedulable. This is the
+ * given cycle itself if available() returns true for it. Otherwise, the gate
+ * can certainly not be scheduled before the returned cycle, even when more
+ * gates with a nonzero duration are scheduled in the meantime.
+ */
+utils::UInt State::get_next_cycle(
+    utils::UInt cycle,
+    const ir::compat::GateRef &gate
+) const {
+    if (is_broken) {
+        throw utils::Exception("usage of resource state that was left in an undefined state");
+    }
+
+    // The gate has to wait for the resource that blocks it the longest.
+    auto next = (utils::Int)cycle;
+    for (auto &resource : resources) {
+        auto resource_next = resource->next_cycle(cycle, gate);
+        if (direction == Direction::BACKWARD) {
+            next = utils::min(next, resource_next);
+        } else {
+            next = utils::max(next, resource_next);
+        }
+    }
+    return (utils::UInt)next;
+}
+
 /**
  * Schedules the given gate at the given (start) cycle. Throws an exception
  * if this is not possible. When an exception is thrown, the resulting state
@@ -0,0 +1,156 @@
+#include <random>
+#include <sstream>
+
+#include "ql/utils/num.h"
+#include "ql/utils/vec.h"
+#include "ql/rmgr/reservations.h"
+
+using namespace ql::utils;
+using namespace ql::rmgr;
+
+using Range = ExclusiveReservations::Range;
+
+/**
+ * Returns the dumped state of the given resource.
+ */
+static Str dump(const ExclusiveReservations &res, UInt resource) {
+    std::ostringstream ss;
+    res.dump_state(resource, ss, "");
+    return ss.str();
+}
+
+/**
+ * Schedules random gates on random subsets of a few resources in the given
+ * direction, checking every availability query and every next cycle hint of
+ * the windowed state against a state that keeps the complete history.
+ */
+static void check_against_history(Direction direction, UInt seed) {
+    const UInt num_resources = 5;
+    ExclusiveReservations windowed(num_resources, direction);
+    ExclusiveReservations history(num_resources, Direction::UNDEFINED);
+    auto forward = direction == Direction::FORWARD;
+    std::mt19937 rng(seed);
+    Int frontier = 0;
+    UInt num_conflicts = 0;
+    for (UInt i = 0; i < 2000; i++) {
+
+        // Pick the resources and duration of the gate, and the start cycle
+        // at which to start looking, which may lie beyond the frontier.
+        Vec<UInt> resources;
+        for (UInt resource = 0; resource < num_resources; resource++) {
+            if (rng() % 3 == 0) {
+                resources.push_back(resource);
+            }
+        }
+        if (resources.empty()) {
+            resources.push_back(rng() % num_resources);
+        }
+        Int duration = 1 + rng() % 4;
+        Int cycle = frontier + (forward ? 1 : -1) * (Int)(rng() % 3);
+
+        // Find the first cycle in scheduling direction at which all resources
+        // are available, making sure the hints don't skip any.
+        while (true) {
+            Range range = {cycle, cycle + duration};
+            Int next = forward ? MAX : MIN;
+            for (auto resource : resources) {
+                auto available = windowed.is_available(resource, range);
+                QL_ASSERT(available == history.is_available(resource, range));
+                if (available) {
+                    continue;
+                }
+                num_conflicts++;
+                auto resource_next = windowed.get_next_cycle(resource, range);
+                QL_ASSERT(forward ? resource_next > cycle : resource_next < cycle);
+                for (auto c = cycle; c != resource_next; c += forward ? 1 : -1) {
+                    QL_ASSERT(!history.is_available(resource, {c, c + duration}));
+                }
+                next = forward ? min(next, resource_next) : max(next, resource_next);
+            }
+            if (next == (forward ? MAX : MIN)) {
+                break;
+            }
+            cycle = next;
+        }
+
+        // Reserve the gate, which moves the frontier.
+        for (auto resource : resources) {
+            windowed.reserve(resource, {cycle, cycle + duration});
+            history.reserve(resource, {cycle, cycle + duration});
+        }
+        frontier = cycle;
+
+    }
+    QL_ASSERT(num_conflicts > 100);
+}
+
+int main() {
+
+    // Ranges include their first cycle and exclude their last, so ranges that
+    // merely touch don't overlap, for all directions.
+    for (auto direction : {Direction::FORWARD, Direction::BACKWARD, Direction::UNDEFINED}) {
+        ExclusiveReservations res(2, direction);
+        QL_ASSERT(res.size() == 2);
+        QL_ASSERT(res.is_available(0, {10, 20}));
+        res.reserve(0, {10, 20});
+        QL_ASSERT(!res.is_available(0, {10, 20}));
+        QL_ASSERT(!res.is_available(0, {5, 11}));
+        QL_ASSERT(!res.is_available(0, {19, 25}));
+        QL_ASSERT(!res.is_available(0, {12, 14}));
+        QL_ASSERT(!res.is_available(0, {5, 25}));
+        QL_ASSERT(res.is_available(0, {5, 10}));
+        QL_ASSERT(res.is_available(0, {20, 25}));
+        QL_ASSERT(res.is_available(1, {10, 20}));
+        QL_ASSERT(dump(res, 1) == "empty\n" || direction == Direction::UNDEFINED);
+    }
+
+    // Forward: the hint is the end of the overlapping reservation, and only
+    // the latest reservation is kept.
+    ExclusiveReservations fwd(1, Direction::FORWARD);
+    fwd.reserve(0, {10, 20});
+    QL_ASSERT(fwd.get_next_cycle(0, {15, 18}) == 20);
+    QL_ASSERT(fwd.get_next_cycle(0, {10, 30}) == 20);
+    fwd.reserve(0, {20, 22});
+    QL_ASSERT(fwd.is_available(0, {22, 30}));
+    QL_ASSERT(fwd.get_next_cycle(0, {21, 23}) == 22);
+    QL_ASSERT(dump(fwd, 0) == "[20..22)\n");
+
+    // Backward: the hint is the latest start at which the gate ends before
+    // the overlapping reservation starts.
+    ExclusiveReservations bwd(1, Direction::BACKWARD);
+    bwd.reserve(0, {10, 20});
+    QL_ASSERT(bwd.get_next_cycle(0, {15, 18}) == 7);
+    QL_ASSERT(bwd.get_next_cycle(0, {10, 30}) == -10);
+    bwd.reserve(0, {7, 10});
+    QL_ASSERT(bwd.is_available(0, {5, 7}));
+    QL_ASSERT(!bwd.is_available(0, {5, 8}));
+    QL_ASSERT(bwd.get_next_cycle(0, {5, 8}) == 4);
+    QL_ASSERT(dump(bwd, 0) == "[7..10)\n");
+
+    // Undefined: reservations may be made out of order, and all of them are
+    // remembered, so gaps between them can still be filled.
+    ExclusiveReservations any(1, Direction::UNDEFINED);
+    any.reserve(0, {30, 40});
+    any.reserve(0, {10, 20});
+    any.reserve(0, {50, 60});
+    QL_ASSERT(!any.is_available(0, {35, 36}));
+    QL_ASSERT(!any.is_available(0, {15, 16}));
+    QL_ASSERT(!any.is_available(0, {55, 56}));
+    QL_ASSERT(!any.is_available(0, {15, 35}));
+    QL_ASSERT(any.is_available(0, {20, 30}));
+    QL_ASSERT(any.is_available(0, {40, 50}));
+    QL_ASSERT(any.is_available(0, {0, 10}));
+    QL_ASSERT(any.get_next_cycle(0, {15, 16}) == 16);
+    any.reserve(0, {20, 30});
+    QL_ASSERT(!any.is_available(0, {25, 26}));
+    QL_ASSERT(any.is_available(0, {40, 50}));
+
+    // Scheduling many overlapping gates in either direction must give the
+    // same answers as keeping the complete history.
+    for (UInt seed = 1; seed <= 4; seed++) {
+        check_against_history(Direction::FORWARD, seed);
+        check_against_history(Direction::BACKWARD, seed);
+    }
+
+    return 0;
+}
@@ -9,6 +9,11 @@
 #include <cerrno>
 #include <algorithm>
 #include <cctype>
+#include "ql/utils/vec.h"
+
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
 
 #ifdef _WIN32
 #include <direct.h>
@@ -205,11 +210,10 @@ void make_dirs(const Str &path) {
 }
 
 /**
- * Tries to create a file (if it doesn't already exist) and opens it for
- * writing. If the directory that path is contained by does not exists, it is
- * first created.
+ * Processes the given path of a file that is to be written, and makes sure
+ * that the directory containing it exists.
  */
-OutFile::OutFile(const Str &path) : ofs(), path(path) {
+static Str prepare_output_path(const Str &path) {
     auto processed_path = process_path(path);
 
     // If the parent path does not exist yet, recursively try to create a
@@ -219,10 +223,18 @@ OutFile::OutFile(const Str &path) : ofs(), path(path) {
         make_dirs_raw(parent);
     }
 
-    // Open the file.
-    ofs.open(processed_path);
-    check();
+    return processed_path;
+}
 
+/**
+ * Tries to create a file (if it doesn't already exist) and opens it for
+ * writing. If the directory that path is contained by does not exists, it is
+ * first created. If binary is set, the file is opened in binary mode, i.e.
+ * without newline conversion on Windows.
+ */
+OutFile::OutFile(const Str &path, Bool binary) : ofs(), path(path) {
+    ofs.open(prepare_output_path(path), binary ? std::ios::out | std::ios::binary : std::ios::out);
+    check();
 }
 
 /**
@@ -259,11 +271,186 @@ std::ofstream &OutFile::unwrap() {
     return ofs;
 }
 
+#ifdef WITH_ZLIB
+
+/**
+ * Stream buffer that compresses whatever is written to it into a gzip file.
+ */
+class GzOutFile::Buffer : public std::streambuf {
+private:
+
+    /**
+     * Size of the uncompressed data buffer.
+     */
+    static constexpr UInt SIZE = 1 << 16;
+
+    /**
+     * The zlib file handle, or nullptr if the file is closed or could not be
+     * opened.
+     */
+    gzFile file;
+
+    /**
+     * The uncompressed data buffer.
+     */
+    Vec<char> data;
+
+    /**
+     * Whether an error has occurred.
+     */
+    Bool failed = false;
+
+    /**
+     * Compresses the contents of the data buffer and empties it.
+     */
+    void flush_data() {
+        auto size = pptr() - pbase();
+        if (size && !failed) {
+            if (!file || gzwrite(file, pbase(), (unsigned)size) != (int)size) {
+                failed = true;
+            }
+        }
+        setp(data.data(), data.data() + data.size());
+    }
+
+protected:
+
+    /**
+     * Called when the data buffer is full.
+     */
+    int_type overflow(int_type c) override {
+        flush_data();
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return failed ? traits_type::eof() : traits_type::not_eof(c);
+    }
+
+    /**
+     * Called when the stream is flushed. Note that this does not flush the
+     * compressor, as that would degrade compression.
+     */
+    int sync() override {
+        flush_data();
+        return failed ? -1 : 0;
+    }
+
+public:
+
+    /**
+     * Opens the given (processed) path for writing.
+     */
+    explicit Buffer(const Str &path) :
+        file(gzopen(path.c_str(), "wb")),
+        data(SIZE)
+    {
+        failed = !file;
+        setp(data.data(), data.data() + data.size());
+    }
+
+    /**
+     * Flushes the remaining data and closes the file. Returns whether all
+     * data was written successfully.
+     */
+    Bool close() {
+        if (file) {
+            flush_data();
+            if (gzclose(file) != Z_OK) {
+                failed = true;
+            }
+            file = nullptr;
+        }
+        return !failed;
+    }
+
+    /**
+     * Closes the file if this was not already done, ignoring errors.
+     */
+    ~Buffer() override {
+        close();
+    }
+
+};
+
+#else
+
 /**
- * Tries to open a file for reading.
+ * Placeholder for the stream buffer, used when zlib is not available.
  */
-InFile::InFile(const Str &path) : ifs(), path(path) {
-    ifs.open(process_path(path));
+class GzOutFile::Buffer : public std::streambuf {
+};
+
+#endif
+
+/**
+ * Tries to create a gzip file (if it doesn't already exist) and opens it for
+ * writing. If the directory that path is contained by does not exists, it is
+ * first created.
+ */
+GzOutFile::GzOutFile(const Str &path) : buf(), os(nullptr), path(path) {
+#ifdef WITH_ZLIB
+    buf.reset(new Buffer(prepare_output_path(path)));
+    os.rdbuf(buf.get());
+    check();
+#else
+    QL_USER_ERROR(
+        "cannot write gzip-compressed file \"" << path << "\", "
+        "because OpenQL was built without zlib"
+    );
+#endif
+}
+
+/**
+ * Closes the file if close() was not called, ignoring any errors.
+ */
+GzOutFile::~GzOutFile() = default;
+
+/**
+ * Writes to the file.
+ */
+void GzOutFile::write(const Str &content) {
+    os << content;
+    check();
+}
+
+/**
+ * Flushes the remaining data and closes the file prior to destruction. Unlike
+ * for OutFile, this is the only way to detect errors that occur while the
+ * last block of data is written.
+ */
+void GzOutFile::close() {
+    check();
+#ifdef WITH_ZLIB
+    if (!buf->close()) {
+        os.setstate(std::ios::badbit);
+    }
+#endif
+    check();
+}
+
+/**
+ * Throws an exception if badbit or failbit are set.
+ */
+void GzOutFile::check() {
+    if (os.fail()) {
+        QL_SYSTEM_ERROR("failed to write file \"" << path << "\"");
+    }
+}
+
+/**
+ * Provides unchecked access to the underlying output stream.
+ */
+std::ostream &GzOutFile::unwrap() {
+    return os;
+}
+
+/**
+ * Tries to open a file for reading. If binary is set, the file is opened in
+ * binary mode, i.e. without newline conversion on Windows.
+ */
+InFile::InFile(const Str &path, Bool binary) : ifs(), path(path) {
+    ifs.open(process_path(path), binary ? std::ios::in | std::ios::binary : std::ios::in);
     check();
 }
 
@@ -271,6 +458,27 @@ InFile::InFile(const Str &path) : ifs(), path(path) {
  * Reads the entire (remainder of the) file to a string.
  */
 Str InFile::read() {
+
+    // If the size of the remainder of the file can be determined, read it in
+    // one go rather than character by character. In text mode on Windows,
+    // this size is an upper bound, because line endings are converted.
+    auto start = ifs.tellg();
+    if (start != std::streampos(-1) && ifs.seekg(0, std::ios::end)) {
+        auto size = ifs.tellg() - start;
+        ifs.seekg(start);
+        Str s;
+        s.resize(size);
+        ifs.read(&s[0], size);
+        s.resize(ifs.gcount());
+        if (!ifs.bad()) {
+            ifs.clear();
+        }
+        check();
+        return s;
+    }
+
+    // Fall back to reading until EOF.
+    ifs.clear();
     Str s{(std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>()};
     check();
     return s;
@@ -0,0 +1,60 @@
+#include <iostream>
+
+#include "ql/utils/thread_pool.h"
+#include "ql/utils/exception.h"
+#include "ql/utils/vec.h"
+
+using namespace ql::utils;
+
+int main() {
+
+    // Every index must be visited exactly once.
+    ThreadPool pool(4);
+    QL_ASSERT(pool.get_num_threads() == 4);
+    Vec<UInt> visited(1000, 0);
+    pool.parallel_for(visited.size(), [&visited](UInt i) {
+        visited[i]++;
+    });
+    for (auto v : visited) {
+        QL_ASSERT(v == 1);
+    }
+
+    // Nested loops must not deadlock.
+    Vec<UInt> sums(16, 0);
+    pool.parallel_for(sums.size(), [&pool, &sums](UInt i) {
+        Vec<UInt> parts(i + 1, 0);
+        pool.parallel_for(parts.size(), [&parts](UInt j) {
+            parts[j] = j;
+        });
+        for (auto p : parts) {
+            sums[i] += p;
+        }
+    });
+    for (UInt i = 0; i < sums.size(); i++) {
+        QL_ASSERT(sums[i] == i * (i + 1) / 2);
+    }
+
+    // Exceptions must be propagated to the caller.
+    Bool caught = false;
+    try {
+        pool.parallel_for(100, [](UInt i) {
+            if (i == 42) {
+                throw Exception("index 42");
+            }
+        });
+    } catch (Exception &) {
+        caught = true;
+    }
+    QL_ASSERT(caught);
+
+    // A single-threaded pool runs the loop serially.
+    ThreadPool serial(1);
+    QL_ASSERT(serial.get_num_threads() == 1);
+    UInt count = 0;
+    serial.parallel_for(10, [&count](UInt) {
+        count++;
+    });
+    QL_ASSERT(count == 10);
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+/** \file
+ * Provides a simple thread pool for running independent work items
+ * concurrently.
+ */
+
+#include "ql/utils/thread_pool.h"
+
+namespace ql {
+namespace utils {
+
+/**
+ * Entry point for the worker threads.
+ */
+void ThreadPool::worker_main() {
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeup.wait(lock, [this]{ return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+
+            // Drop the job at the front of the queue once all its indices have
+            // been claimed; the threads working on the claimed indices still
+            // hold a reference to it.
+            job = jobs.front();
+            if (job->next.load() >= job->count) {
+                jobs.pop_front();
+                continue;
+            }
+
+        }
+        work_on(*job);
+    }
+}
+
+/**
+ * Claims and executes indices of the given job until none remain.
+ */
+void ThreadPool::work_on(Job &job) {
+    while (true) {
+        UInt index = job.next.fetch_add(1);
+        if (index >= job.count) {
+            return;
+        }
+        std::exception_ptr error;
+        try {
+            job.function(index);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(job.mutex);
+        if (error && !job.error) {
+            job.error = error;
+        }
+        job.done++;
+        if (job.done == job.count) {
+            job.completed.notify_all();
+        }
+    }
+}
+
+/**
+ * Constructs a thread pool. num_threads is the total number of threads
+ * that will work on a parallel_for(), including the calling thread, so
+ * num_threads - 1 worker threads are started. 0 means the number of
+ * hardware threads reported by the system. When this results in a single
+ * thread, parallel_for() simply runs the loop serially.
+ */
+ThreadPool::ThreadPool(UInt num_threads) : stopping(false) {
+    if (num_threads == 0) {
+        num_threads = std::thread::hardware_concurrency();
+    }
+    for (UInt i = 1; i < num_threads; i++) {
+        workers.emplace_back(&ThreadPool::worker_main, this);
+    }
+}
+
+/**
+ * Stops and joins the worker threads.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * Returns the total number of threads that work on a parallel_for(),
+ * including the calling thread.
+ */
+UInt ThreadPool::get_num_threads() const {
+    return workers.size() + 1;
+}
+
+/**
+ * Calls function for each index in [0, count), using the worker threads
+ * and the calling thread, and returns when all calls have completed. If
+ * any of the calls throws an exception, the first one that was thrown is
+ * rethrown after all other calls have completed.
+ */
+void ThreadPool::parallel_for(UInt count, const std::function<void(UInt)> &function) {
+
+    // Don't bother with the workers if there is nothing to distribute.
+    if (workers.empty() || count <= 1) {
+        for (UInt index = 0; index < count; index++) {
+            function(index);
+        }
+        return;
+    }
+
+    // Publish the job to the workers.
+    auto job = std::make_shared<Job>();
+    job->function = function;
+    job->count = count;
+    job->next = 0;
+    job->done = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(job);
+    }
+    wakeup.notify_all();
+
+    // Work on it ourselves as well, then wait for the indices claimed by the
+    // workers to complete.
+    work_on(*job);
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->completed.wait(lock, [&job]{ return job->done == job->count; });
+    if (job->error) {
+        std::rethrow_exception(job->error);
+    }
+
+}
+
+} // namespace utils
+} // namespace ql
@@ -154,6 +154,39 @@ class Test_central_controller(unittest.TestCase):
         p.add_kernel(k)
         p.compile()
 
+    def test_output_replaced_on_success(self):
+        # A compilation that fails while generating code must not leave a
+        # partial program behind, nor replace the program of an earlier
+        # successful compilation.
+        name = 'test_output_replaced_on_success'
+        vq1asm_fn = os.path.join(output_dir, name + '.vq1asm')
+
+        platform = ql.Platform(platform_name, config_fn)
+        p = ql.Program(name, platform, num_qubits, num_cregs, num_bregs)
+        k = ql.Kernel('kernel_0', platform, num_qubits, num_cregs, num_bregs)
+        k.gate("rx180", [16])
+        p.add_kernel(k)
+        p.compile()
+        with open(vq1asm_fn) as f:
+            expected = f.read()
+
+        # Without an instrument driving qubit 16, code generation fails in the
+        # second kernel, after the first one has been written out.
+        with open(config_fn) as f:
+            config = f.read()
+        platform = ql.Platform.from_json_string(platform_name, config.replace('[3, 7, 11, 16]', '[3, 7, 11]'))
+        p = ql.Program(name, platform, num_qubits, num_cregs, num_bregs)
+        for i, q in enumerate([0, 16]):
+            k = ql.Kernel('kernel_' + str(i), platform, num_qubits, num_cregs, num_bregs)
+            k.gate("rx180", [q])
+            p.add_kernel(k)
+        with self.assertRaises(Exception):
+            p.compile()
+
+        with open(vq1asm_fn) as f:
+            self.assertEqual(f.read(), expected)
+        self.assertFalse(os.path.exists(vq1asm_fn + '.tmp'))
+
     def test_qi_example(self):
         platform = ql.Platform(platform_name, os.path.join(curdir, 'cc_s5_direct_iq.json'))
 
@@ -57,5 +57,52 @@ class Test_platform(unittest.TestCase):
             os.path.join(curdir, 'golden', name + '_last.qasm')
         ))
 
+    def test_platform_cache(self):
+        name = 'test_platform_cache'
+        config_fn = os.path.join(curdir, 'test_cfg_none.json')
+        outputs = []
+        for cache in ['no', 'yes', 'yes']:
+            ql.set_option('platform_cache', cache)
+            platf = ql.Platform('starmon', config_fn)
+            k = ql.Kernel('test', platf, 3)
+            k.gate('h', [0])
+            k.gate('cnot', [0, 1])
+            k.gate('measure', [0])
+            p = ql.Program(name, platf, 3)
+            p.add_kernel(k)
+            p.compile()
+            with open(os.path.join(output_dir, name + '_last.qasm')) as f:
+                outputs.append(f.read())
+        ql.set_option('platform_cache', 'no')
+        self.assertEqual(outputs[0], outputs[1])
+        self.assertEqual(outputs[0], outputs[2])
+
+        # The configuration doesn't specify the number of classical registers,
+        # so programs with classical registers increase them. That must not
+        # affect other platforms built from the cached one, regardless of the
+        # order in which the programs are created.
+        for order in [[0, 3], [3, 0], [3, 0, 3]]:
+            outputs = {}
+            for cache in ['no', 'yes']:
+                ql.set_option('platform_cache', cache)
+                for num_cregs in order:
+                    platf = ql.Platform('starmon', config_fn)
+                    k = ql.Kernel('test', platf, 3, num_cregs)
+                    k.gate('h', [0])
+                    if num_cregs:
+                        k.classical(ql.CReg(1), ql.Operation(3))
+                        k.classical(ql.CReg(2), ql.Operation(4))
+                        k.classical(ql.CReg(0), ql.Operation(ql.CReg(1), '+', ql.CReg(2)))
+                    k.gate('measure', [0])
+                    p = ql.Program('%s_%d' % (name, num_cregs), platf, 3, num_cregs)
+                    p.add_kernel(k)
+                    p.compile()
+                    with open(os.path.join(output_dir, p.name + '_last.qasm')) as f:
+                        outputs.setdefault(num_cregs, []).append(f.read())
+            ql.set_option('platform_cache', 'no')
+            for num_cregs, results in outputs.items():
+                for result in results[1:]:
+                    self.assertEqual(result, results[0])
+
 if __name__ == '__main__':
     unittest.main()
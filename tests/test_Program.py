@@ -67,12 +67,45 @@ class Test_program(unittest.TestCase):
             'add_do_while',
             'add_for',
             'print_interaction_matrix',
+            'get_qubit_interaction_matrix',
             'write_interaction_matrix',
             'compile',
             'set_sweep_points',
             'get_sweep_points']
         self.assertTrue(set(program_methods).issubset(dir(p)))
 
+    def test_interaction_matrix(self):
+        nqubits = 3
+        platform = ql.Platform('none', 'none')
+        p = ql.Program('interaction_matrix', platform, nqubits)
+        k = ql.Kernel('interaction_kernel', platform, nqubits)
+        k.gate('cnot', [0, 1])
+        k.gate('cnot', [1, 0])
+        k.gate('cz', [1, 2])
+        k.gate('x', [2])
+        p.add_kernel(k)
+
+        # By default, only CNOTs are counted, ignoring operand order.
+        self.assertEqual(list(p.get_qubit_interaction_matrix()), [
+            0, 2, 0,
+            2, 0, 0,
+            0, 0, 0
+        ])
+        self.assertEqual(list(p.get_qubit_interaction_matrix(0, ['cz'])), [
+            0, 0, 0,
+            0, 0, 1,
+            0, 1, 0
+        ])
+        self.assertEqual(list(p.get_qubit_interaction_matrix(0, [])), [
+            0, 2, 0,
+            2, 0, 1,
+            0, 1, 0
+        ])
+
+        p.write_interaction_matrix(True, ['cnot', 'cz'])
+        with open(os.path.join(output_dir, 'interaction_kernelInteractionMatrix.csv')) as f:
+            self.assertEqual(f.read(), 'qubit0,qubit1,count\n0,1,2\n1,2,1\n')
+
     def test_simple_program(self):
         nqubits = 2
         k = ql.Kernel("kernel1", platf, nqubits)
@@ -1,5 +1,6 @@
 from openql import openql as ql
 import os
+import re
 import unittest
 from utils import file_compare
 
@@ -331,6 +332,94 @@ class Test_Alap_Rc_Schedule(unittest.TestCase):
 
         self.assertTrue(file_compare(QASM_fn, GOLD_fn))
 
+    def test_qwg_contention(self):
+        # Many independent chains of x and y gates that contend for the QWGs.
+        # Rather than comparing with a golden file, check that the schedule
+        # respects the dependencies and the QWG resource, and that every gate
+        # that was delayed beyond its dependencies was in fact blocked by a
+        # conflicting gate in every cycle it was delayed for. This is what
+        # resource-constrained list scheduling guarantees, regardless of the
+        # criticality tie-breaking.
+        qwg = {0: 0, 1: 0, 2: 1, 3: 1, 4: 1, 5: 2, 6: 2}
+        duration = 2
+        for scheduler in ['ASAP', 'ALAP']:
+            prog_name = "test_qwg_contention_" + scheduler
+            starmon = ql.Platform("starmon", self.config)
+            prog = ql.Program(prog_name, starmon, 7, 0)
+            k = ql.Kernel("kernel_qwg_contention_" + scheduler, starmon, 7, 0)
+            chains = {q: [] for q in range(7)}
+            for layer in range(6):
+                for q in range(7):
+                    name = 'x' if (q + layer * (q // 2 + 1)) % 2 == 0 else 'y'
+                    k.gate(name, [q])
+                    chains[q].append(name)
+            prog.add_kernel(k)
+            ql.set_option("scheduler", scheduler)
+            prog.compile()
+
+            # Parse the cycle of each gate from the output.
+            gates = {q: [] for q in range(7)}
+            cycle = 0
+            in_bundle = False
+            with open(os.path.join(output_dir, prog.name + '_last.qasm')) as f:
+                for line in f:
+                    line = line.strip()
+                    m = re.match(r'\{ # start at cycle (\d+)', line)
+                    if m:
+                        cycle = int(m.group(1))
+                        in_bundle = True
+                        continue
+                    if line == '}':
+                        in_bundle = False
+                        cycle += 1
+                        continue
+                    m = re.match(r'skip (\d+)', line)
+                    if m:
+                        cycle += int(m.group(1))
+                        continue
+                    m = re.match(r'([xy]) q\[(\d+)\]', line)
+                    if m:
+                        gates[int(m.group(2))].append((m.group(1), cycle))
+                        if not in_bundle:
+                            cycle += 1
+            for q in range(7):
+                self.assertEqual([g[0] for g in gates[q]], chains[q])
+            end = max(c for q in gates for _, c in gates[q]) + duration
+
+            def conflicts(q, name, c, other_q, other_name, other_c):
+                if other_q == q or qwg[other_q] != qwg[q]:
+                    return False
+                if other_c + duration <= c or c + duration <= other_c:
+                    return False
+                return other_name != name or other_c != c
+
+            for q in range(7):
+                for i, (name, c) in enumerate(gates[q]):
+
+                    # Dependencies and resources.
+                    if i > 0:
+                        self.assertGreaterEqual(c, gates[q][i - 1][1] + duration)
+                    for other_q in range(7):
+                        for other_name, other_c in gates[other_q]:
+                            self.assertFalse(conflicts(q, name, c, other_q, other_name, other_c))
+
+                    # Every cycle between the gate and the bound set by its
+                    # dependencies must be blocked by a gate that was
+                    # scheduled before it.
+                    if scheduler == 'ASAP':
+                        bound = gates[q][i - 1][1] + duration if i > 0 else 0
+                        delayed = range(bound, c)
+                    else:
+                        bound = gates[q][i + 1][1] - duration if i + 1 < len(gates[q]) else end - duration
+                        delayed = range(c + 1, bound + 1)
+                    for d in delayed:
+                        self.assertTrue(any(
+                            conflicts(q, name, d, other_q, other_name, other_c)
+                            and (other_c <= d if scheduler == 'ASAP' else other_c >= d)
+                            for other_q in range(7)
+                            for other_name, other_c in gates[other_q]
+                        ), '%s %s q%d delayed past cycle %d' % (scheduler, name, q, d))
+
 
 if __name__ == '__main__':
     # ql.set_option('log_level', 'LOG_DEBUG')
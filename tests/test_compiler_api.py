@@ -1,5 +1,8 @@
 import openql as ql
 import os
+import csv
+import gzip
+import json
 import unittest
 from utils import file_compare
 import tempfile
@@ -123,20 +126,25 @@ Indices start from 0 in both cases.
     don't exist will be created as soon as an output file is written.
 
   * `debug` *
-    Must be one of `no`, `yes`, `stats`, `qasm`, or `both`, default `no`. May be
-    used to implicitly surround this pass with cQASM/report file output printers, to
-    aid in debugging. Set to `no` to disable this functionality or to `yes` to write
-    a tree dump and a cQASM file before and after, the latter of which includes
-    statistics as comments. The filename is built using the output_prefix option,
-    using suffix `_debug_[in|out].ir` for the IR dump, and `_debug_[in|out].cq` for
-    the cQASM file. The option values `stats`, `cqasm`, and `both` are used for
-    backward compatibility with the `write_qasm_files` and `write_report_files`
-    global options; for `stats` and `both` a statistics report file is written with
-    suffix `_[in|out].report`, and for `qasm` and `both` a cQASM file is written
-    (without stats in the comments) with suffix `_[in|out].qasm`.
+    Must be one of `no`, `yes`, `gzip`, `stats`, `qasm`, or `both`, default `no`.
+    May be used to implicitly surround this pass with cQASM/report file output
+    printers, to aid in debugging. Set to `no` to disable this functionality or to
+    `yes` to write a tree dump and a cQASM file before and after, the latter of
+    which includes statistics as comments. The filename is built using the
+    output_prefix option, using suffix `_debug_[in|out].ir` for the IR dump, and
+    `_debug_[in|out].cq` for the cQASM file. `gzip` does the same, but writes
+    gzip-compressed files with an additional `.gz` suffix instead, which is much
+    faster for large programs; this requires OpenQL to be built with zlib. The
+    option values `stats`, `cqasm`, and `both` are used for backward compatibility
+    with the `write_qasm_files` and `write_report_files` global options; for `stats`
+    and `both` a statistics report file is written with suffix `_[in|out].report`,
+    and for `qasm` and `both` a cQASM file is written (without stats in the
+    comments) with suffix `_[in|out].qasm`.
 
   * `output_suffix` *
-    Must be any string, default `.cq`. Suffix to use for the output filename.
+    Must be any string, default `.cq`. Suffix to use for the output filename. If it
+    ends in `.gz`, the file is gzip-compressed, which requires OpenQL to be built
+    with zlib.
 
   * `cqasm_version` *
     Must be one of `1.0`, `1.1`, or `1.2`, default `1.2`. The cQASM version to
@@ -402,6 +410,224 @@ with_timing: yes
    |- no options to dump
 """.strip())
 
+    def test_legacy_ir_session(self):
+        # Consecutive legacy passes must give the same result whether or not
+        # they share a single old-IR program.
+        outputs = []
+        for session in ['no', 'yes']:
+            ql.initialize()
+            ql.set_option('legacy_ir_session', session)
+            platf = ql.Platform('platform', 'cc_light.s7')
+            p = ql.Program('test_legacy_ir_session', platf, 7)
+            k = ql.Kernel('kernel', platf, 7)
+            for q in range(7):
+                k.gate('h', [q])
+            k.gate('cnot', [0, 6])
+            k.gate('cnot', [2, 4])
+            k.gate('x', [3])
+            k.gate('x', [3])
+            k.gate('cnot', [1, 5])
+            for q in range(7):
+                k.gate('measure', [q])
+            p.add_kernel(k)
+            c = p.get_compiler()
+            c.clear_passes()
+            c.append_pass('opt.clifford.Optimize', '', {})
+            c.append_pass('map.qubits.Map', '', {})
+            c.append_pass('sch.Schedule', '', {})
+            c.append_pass('io.cqasm.Report', '', {'output_prefix': output_dir + '/%N_' + session})
+            p.compile()
+            with open(os.path.join(output_dir, 'test_legacy_ir_session_' + session + '.cq')) as f:
+                outputs.append(f.read())
+        ql.set_option('legacy_ir_session', 'no')
+        self.assertEqual(outputs[0], outputs[1])
+
+    def test_profile(self):
+        platf = ql.Platform('platform', 'none')
+        p = ql.Program('test_profile', platf, 2)
+        k = ql.Kernel('kernel', platf, 2)
+        k.gate('x', [0])
+        k.gate('x', [0])
+        k.gate('cnot', [0, 1])
+        k.gate('measure', [1])
+        p.add_kernel(k)
+        c = p.get_compiler()
+        c.clear_passes()
+        c.append_pass('opt.clifford.Optimize', 'clifford')
+        c.append_pass('sch.Schedule', 'scheduler')
+
+        # Without the option, nothing is recorded.
+        p.compile()
+        self.assertNotIn('clifford', c.dump_profile())
+
+        ql.set_option('profile_passes', 'yes')
+        try:
+            p.compile()
+        finally:
+            ql.set_option('profile_passes', 'no')
+
+        c.print_profile()
+        table = c.dump_profile()
+        self.assertIn('clifford', table)
+        self.assertIn('scheduler', table)
+
+        json_fn = os.path.join(output_dir, 'test_profile.json')
+        c.write_profile(json_fn)
+        with open(json_fn) as f:
+            passes = {x['name']: x for x in json.load(f)['passes']}
+        self.assertEqual(passes['clifford']['type'], 'opt.clifford.Optimize')
+        self.assertEqual(passes['clifford']['runs'], 1)
+        self.assertEqual(passes['clifford']['depth'], 1)
+        self.assertEqual(passes['']['depth'], 0)
+
+        # The optimizer cancels the x gates. Both passes must be measured in
+        # the same IR, so the sizes must line up between them.
+        self.assertEqual(passes['clifford']['gates_before'], 4)
+        self.assertLess(passes['clifford']['gates_after'], 4)
+        self.assertEqual(passes['scheduler']['gates_before'], passes['clifford']['gates_after'])
+        self.assertEqual(passes['scheduler']['statements_before'], passes['clifford']['statements_after'])
+        self.assertEqual(passes['']['gates_before'], passes['clifford']['gates_before'])
+        self.assertEqual(passes['']['gates_after'], passes['scheduler']['gates_after'])
+
+        # Legacy IR sessions must not affect the measured sizes.
+        ql.set_option('profile_passes', 'yes')
+        ql.set_option('legacy_ir_session', 'yes')
+        try:
+            p.compile()
+        finally:
+            ql.set_option('profile_passes', 'no')
+            ql.set_option('legacy_ir_session', 'no')
+        session_json_fn = os.path.join(output_dir, 'test_profile_session.json')
+        c.write_profile(session_json_fn)
+        with open(session_json_fn) as f:
+            session_passes = {x['name']: x for x in json.load(f)['passes']}
+        for name, pass_profile in passes.items():
+            for key in ['statements_before', 'statements_after', 'gates_before', 'gates_after']:
+                self.assertEqual(session_passes[name][key], pass_profile[key])
+
+        csv_fn = os.path.join(output_dir, 'test_profile.csv')
+        c.write_profile(csv_fn)
+        with open(csv_fn) as f:
+            rows = list(csv.DictReader(f))
+        self.assertEqual([r['name'] for r in rows], ['', 'clifford', 'scheduler'])
+        self.assertEqual(int(rows[1]['gates_after']), passes['clifford']['gates_after'])
+
+    def test_list_schedule_block_threads(self):
+        # Scheduling blocks concurrently must give the same program and dot
+        # graphs as scheduling them serially, also for nested blocks.
+        for name in ['for', 'if_else', 'while', 'repeat_until']:
+            outputs = []
+            for threads in ['1', '4']:
+                ql.initialize()
+                platform = ql.Platform('structure', os.path.join(curdir, 'test_structure_decomposition_platform.json'))
+                c = platform.get_compiler()
+                c.clear_passes()
+                c.append_pass('io.cqasm.Read', '', {
+                    'cqasm_file': os.path.join(curdir, 'test_structure_decomposition_' + name + '.cq')
+                })
+                prefix = 'block_threads_' + name + '_' + threads
+                c.append_pass('sch.ListSchedule', '', {
+                    'output_prefix': output_dir + '/' + prefix,
+                    'block_threads': threads,
+                    'write_dot_graphs': 'yes'
+                })
+                c.append_pass('io.cqasm.Report', '', {
+                    'output_prefix': output_dir + '/' + prefix
+                })
+                c.compile_with_frontend(platform)
+                files = {}
+                for fn in sorted(os.listdir(output_dir)):
+                    if fn.startswith(prefix + '.') or fn.startswith(prefix + '_'):
+                        with open(os.path.join(output_dir, fn)) as f:
+                            files[fn[len(prefix):]] = f.read()
+                outputs.append(files)
+            self.assertIn('.cq', outputs[0])
+            self.assertTrue(any(fn.endswith('.dot') for fn in outputs[0]))
+            self.assertEqual(outputs[0], outputs[1])
+
+    def test_compile_cqasm_files(self):
+        # Compiling a batch of cQASM files must give the same result as reading
+        # and compiling each of them separately.
+        names = ['for', 'foreach', 'if_else', 'while', 'repeat_until']
+        fnames = [os.path.join(curdir, 'test_structure_decomposition_' + name + '.cq') for name in names]
+        for threads in [1, 4]:
+            ql.initialize()
+            platform = ql.Platform('structure', os.path.join(curdir, 'test_structure_decomposition_platform.json'))
+            c = platform.get_compiler()
+            c.clear_passes()
+            c.append_pass('io.cqasm.Report', '', {
+                'output_prefix': output_dir + '/cqasm_files_' + str(threads) + '_%N'
+            })
+            c.compile_cqasm_files(platform, fnames, threads)
+
+        for name, fname in zip(names, fnames):
+            ql.initialize()
+            platform = ql.Platform('structure', os.path.join(curdir, 'test_structure_decomposition_platform.json'))
+            c = platform.get_compiler()
+            c.clear_passes()
+            c.append_pass('io.cqasm.Read', '', {'cqasm_file': fname})
+            c.append_pass('io.cqasm.Report', '', {
+                'output_prefix': output_dir + '/cqasm_files_ref_%N'
+            })
+            c.compile_with_frontend(platform)
+
+            def read(prefix):
+                with open(os.path.join(output_dir, prefix + '_structure_decomposition_' + name + '.cq')) as f:
+                    return f.read()
+
+            self.assertEqual(read('cqasm_files_1'), read('cqasm_files_ref'))
+            self.assertEqual(read('cqasm_files_4'), read('cqasm_files_ref'))
+
+    def test_gzip_output(self):
+        # Gzip-compressed debug dumps and cQASM output must decompress to the
+        # same content as their uncompressed counterparts. The report passes
+        # don't modify the IR, so the output of the scheduler should be seen
+        # by all of them.
+        platf = ql.Platform('platform', 'none')
+        p = ql.Program('test_gzip_output', platf, 2)
+        k = ql.Kernel('kernel', platf, 2)
+        k.gate('x', [0])
+        k.gate('cnot', [0, 1])
+        k.gate('measure', [1])
+        p.add_kernel(k)
+        c = p.get_compiler()
+        c.clear_passes()
+        prefix = output_dir + '/test_gzip_output_%p'
+        c.append_pass('sch.Schedule', 'plain', {
+            'output_prefix': prefix,
+            'debug': 'yes'
+        })
+        c.append_pass('io.cqasm.Report', 'gzip', {
+            'output_prefix': prefix,
+            'output_suffix': '.cq',
+            'debug': 'gzip'
+        })
+        c.append_pass('io.cqasm.Report', 'report', {
+            'output_prefix': prefix,
+            'output_suffix': '.cq.gz'
+        })
+        try:
+            p.compile()
+        except Exception as e:
+            if 'built without zlib' in str(e):
+                self.skipTest('OpenQL was built without zlib')
+            raise
+
+        def read(fn):
+            with open(os.path.join(output_dir, 'test_gzip_output_' + fn)) as f:
+                return f.read()
+
+        def read_gz(fn):
+            with gzip.open(os.path.join(output_dir, 'test_gzip_output_' + fn), 'rt') as f:
+                return f.read()
+
+        for ext in ['.ir', '.cq']:
+            plain = read('plain_debug_out' + ext)
+            self.assertEqual(read_gz('gzip_debug_in' + ext + '.gz'), plain)
+            self.assertEqual(read_gz('gzip_debug_out' + ext + '.gz'), plain)
+        self.assertIn('measure', read('gzip.cq'))
+        self.assertEqual(read_gz('report.cq.gz'), read('gzip.cq'))
+
 
 if __name__ == '__main__':
     # ql.set_option('log_level', 'LOG_DEBUG')
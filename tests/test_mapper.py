@@ -684,6 +684,73 @@ class Test_mapper(unittest.TestCase):
         self.assertTrue(file_compare(qasm_fn, gold_fn))
 
 
+    def _compile_with_mapper_options(self, name, tag, options):
+        # Maps all possible cnots in s7 with the given options for the mapper
+        # pass, returning the resulting cQASM. The tag is appended to the name
+        # of the output file.
+        num_qubits = 7
+        starmon = ql.Platform("starmon", "cc_light.s7")
+        prog = ql.Program(name, starmon, num_qubits, 0)
+        k = ql.Kernel("kernel", starmon, num_qubits, 0)
+        for i in range(num_qubits):
+            for j in range(num_qubits):
+                if i != j:
+                    k.gate("cnot", [i, j])
+        prog.add_kernel(k)
+        c = prog.get_compiler()
+        c.clear_passes()
+        c.append_pass('map.qubits.Map', 'mapper', options)
+        c.append_pass('io.cqasm.Report', 'report', {'output_prefix': output_dir + '/%N_' + tag})
+        prog.compile()
+        with open(os.path.join(output_dir, name + '_' + tag + '.cq')) as f:
+            return f.read()
+
+    def test_mapper_recursion_threads(self):
+        # Evaluating the alternatives of a recursion step concurrently must
+        # give the same mapping as evaluating them serially, also with random
+        # tie-breaking, as long as the random seed is fixed.
+        options = {
+            'route_heuristic': 'minextend',
+            'tie_break_method': 'random',
+            'random_seed': '42',
+            'recursion_depth_limit': '2',
+            'recursion_width_factor': '2',
+        }
+        outputs = []
+        for run, threads in enumerate(['1', '1', '4']):
+            options['recursion_threads'] = threads
+            outputs.append(self._compile_with_mapper_options(
+                'test_mapper_recursion_threads', str(run), options))
+        self.assertEqual(outputs[0], outputs[1])
+        self.assertEqual(outputs[0], outputs[2])
+
+    def test_mapper_max_alternative_routes(self):
+        # A limit on the number of alternatives that is never reached must not
+        # change the mapping, for all path selection modes.
+        for mode in ['all', 'borders', 'random']:
+            outputs = []
+            for limit in ['0', '1000000']:
+                outputs.append(self._compile_with_mapper_options(
+                    'test_mapper_max_alternative_routes', mode + '_' + limit, {
+                        'path_selection_mode': mode,
+                        'max_alternative_routes': limit,
+                        'random_seed': '42',
+                    }))
+            self.assertEqual(outputs[0], outputs[1])
+
+        # With a limit that applies, random path selection samples the paths,
+        # which must be deterministic for a fixed seed.
+        outputs = []
+        for run in range(2):
+            outputs.append(self._compile_with_mapper_options(
+                'test_mapper_max_alternative_routes', 'sampled_' + str(run), {
+                    'path_selection_mode': 'random',
+                    'max_alternative_routes': '2',
+                    'tie_break_method': 'random',
+                    'random_seed': '42',
+                }))
+        self.assertEqual(outputs[0], outputs[1])
+
 
 if __name__ == '__main__':
     # ql.set_option('log_level', 'LOG_DEBUG')
@@ -4,7 +4,10 @@
 #
 
 from openql import openql as ql
+import json
 import os
+import random
+import re
 import unittest
 from utils import file_compare
 
@@ -189,6 +192,81 @@ class Test_multi_core(unittest.TestCase):
         qasm_fn = os.path.join(output_dir, prog.name+'_last.qasm')
         self.assertTrue( file_compare(qasm_fn, gold_fn) )
 
+    def test_mc_partition(self):
+        # The ROEE partitioner must move the operands of every two-qubit gate
+        # into the same core, including qubits that only interact far beyond
+        # the lookahead window of the interaction weights.
+        v = 'partition'
+        config = os.path.join(curdir, "test_multi_core_4x4_full.json")
+        num_qubits = 16
+
+        prog_name = "test_mc_" + v
+        kernel_name = "kernel_" + v
+        starmon = ql.Platform("mc4x4full", config)
+        prog = ql.Program(prog_name, starmon, num_qubits, 0)
+        k = ql.Kernel(kernel_name, starmon, num_qubits, 0)
+
+        for i in range(4):
+            k.gate("cnot", [i, 4+i])
+            k.gate("cnot", [8+i, 12+i])
+        for n in range(200):
+            k.gate("cnot", [0, 1])
+        for i in range(4):
+            k.gate("cnot", [i, 15-i])
+
+        prog.add_kernel(k)
+        prog.compile()
+
+        qasm_fn = os.path.join(output_dir, prog.name+'_last.qasm')
+        num_cnots = 0
+        with open(qasm_fn) as f:
+            for m in re.finditer(r'cnot q\[(\d+)\], *q\[(\d+)\]', f.read()):
+                self.assertEqual(int(m.group(1)) // 4, int(m.group(2)) // 4)
+                num_cnots += 1
+        self.assertEqual(num_cnots, 216)
+
+    def test_mc_partition_large(self):
+        # The partitioner must scale to thousands of qubits: the work done per
+        # routed gate may only depend on the lookahead window, not on the
+        # number of remaining gates. Derive a 4-core platform with 1024 qubits
+        # from the 16-qubit one.
+        v = 'partition_large'
+        num_qubits = 1024
+        num_cores = 4
+        with open(os.path.join(curdir, "test_multi_core_4x4_full.json")) as f:
+            config_data = json.load(f)
+        config_data['hardware_settings']['qubit_number'] = num_qubits
+        config_data['topology']['number_of_cores'] = num_cores
+        config_data['topology']['comm_qubits_per_core'] = num_qubits // num_cores
+        config_data['resources']['qubits']['count'] = num_qubits
+        config = os.path.join(output_dir, "test_multi_core_1024_full.json")
+        with open(config, 'w') as f:
+            json.dump(config_data, f)
+
+        prog_name = "test_mc_" + v
+        kernel_name = "kernel_" + v
+        starmon = ql.Platform("mc1024full", config)
+        prog = ql.Program(prog_name, starmon, num_qubits, 0)
+        k = ql.Kernel(kernel_name, starmon, num_qubits, 0)
+
+        rng = random.Random(42)
+        num_gates = 2000
+        for n in range(num_gates):
+            a, b = rng.sample(range(num_qubits), 2)
+            k.gate("cnot", [a, b])
+
+        prog.add_kernel(k)
+        prog.compile()
+
+        qasm_fn = os.path.join(output_dir, prog.name+'_last.qasm')
+        qubits_per_core = num_qubits // num_cores
+        num_cnots = 0
+        with open(qasm_fn) as f:
+            for m in re.finditer(r'cnot q\[(\d+)\], *q\[(\d+)\]', f.read()):
+                self.assertEqual(int(m.group(1)) // qubits_per_core, int(m.group(2)) // qubits_per_core)
+                num_cnots += 1
+        self.assertEqual(num_cnots, num_gates)
+
 if __name__ == '__main__':
     # ql.set_option('log_level', 'LOG_DEBUG')
     unittest.main()
@@ -380,6 +380,120 @@ class Test_conjugated_kernel(unittest.TestCase):
         self.assertAlmostEqual(helper_prob(matrix[8]), helper_regex(c0)[2], 5)
         self.assertAlmostEqual(helper_prob(matrix[12]), helper_regex(c0)[3], 5)   
 
+    def test_decomposition_cache(self):
+        num_qubits = 2
+        cache_dir = os.path.join(output_dir, 'unitary_cache')
+        ql.Unitary.set_decomposition_cache(16, cache_dir)
+        try:
+            p = ql.Program('test_unitary_decomposition_cache', platform, num_qubits)
+
+            matrix =  [-0.43874989-0.10659111j, -0.47325212+0.12917344j, -0.58227163+0.20750072j, -0.29075334+0.29807585j,
+                        0.30168601-0.22307459j,  0.32626   +0.4534935j , -0.20523265-0.42403593j, -0.01012565+0.5701683j ,
+                        -0.40954341-0.49946371j,  0.28560698-0.06740801j,  0.52146754+0.1833513j , -0.37248653+0.22891636j,
+                        0.03113162-0.48703302j, -0.57180014+0.18486244j,  0.2943625 -0.06148912j,  0.55533888+0.04322811j]
+
+            # The second unitary is taken from the in-memory cache, the third
+            # from the cache file written for the first.
+            for i in range(3):
+                if i == 2:
+                    ql.Unitary.clear_decomposition_cache()
+                k = ql.Kernel('kernel%d' % i, platform, num_qubits)
+                u = ql.Unitary('u%d' % i, matrix)
+                u.decompose()
+                k.gate(u, [0, 1])
+                p.add_kernel(k)
+
+            # Cache files are named after the hash, the byte order, and an
+            # index to disambiguate matrices with the same hash.
+            self.assertTrue(any(
+                re.match(r'^[0-9a-f]{16}-(le|be)-[0-9]+\.qlu$', f)
+                for f in os.listdir(cache_dir)
+            ))
+            self.assertFalse(any(f.endswith('.tmp') for f in os.listdir(cache_dir)))
+
+            p.get_compiler().set_option('initialqasmwriter.cqasm_version', '1.0')
+            p.get_compiler().set_option('initialqasmwriter.with_metadata', 'no')
+            p.compile()
+
+            with open(os.path.join(output_dir, p.name + '.qasm')) as f:
+                kernels = f.read().split('.kernel')[1:]
+            self.assertEqual(len(kernels), 3)
+            for kernel in kernels[1:]:
+                self.assertEqual(kernel.split('\n', 1)[1], kernels[0].split('\n', 1)[1])
+        finally:
+            ql.Unitary.set_decomposition_cache(0)
+
+    def test_unitary_decomposition_verify(self):
+        # In verification mode, the angles of the multiplexed rotations that
+        # are found with the fast Walsh-Hadamard transform are also solved for
+        # with the dense solver, and decomposition fails if they differ. The
+        # multiplexors only become nontrivial from three qubits onward.
+        rng = np.random.RandomState(42)
+        matrices = {}
+        for num_qubits in [3, 4, 5]:
+            size = 2**num_qubits
+            q, r = np.linalg.qr(rng.randn(size, size) + 1j * rng.randn(size, size))
+            q = q * (np.diag(r) / abs(np.diag(r)))
+            matrices[num_qubits] = q.flatten().tolist()
+
+        # The decomposition must not depend on the mode.
+        outputs = []
+        for verify in ['no', 'yes']:
+            ql.set_option('unitary_decomposition_verify', verify)
+            try:
+                p = ql.Program('test_unitary_decomposition_verify_' + verify, platform, 5)
+                for num_qubits, matrix in matrices.items():
+                    k = ql.Kernel('kernel%d' % num_qubits, platform, 5)
+                    u = ql.Unitary('u%d' % num_qubits, matrix)
+                    u.decompose()
+                    k.gate(u, list(range(num_qubits)))
+                    p.add_kernel(k)
+            finally:
+                ql.set_option('unitary_decomposition_verify', 'no')
+
+            p.get_compiler().set_option('initialqasmwriter.cqasm_version', '1.0')
+            p.get_compiler().set_option('initialqasmwriter.with_metadata', 'no')
+            p.compile()
+            with open(os.path.join(output_dir, p.name + '.qasm')) as f:
+                outputs.append(f.read().split('.kernel')[1:])
+        self.assertEqual(len(outputs[0]), 3)
+        self.assertEqual(outputs[0], outputs[1])
+
+    def test_unitary_decomposition_threads(self):
+        # Decomposing the independent sub-unitaries concurrently must give the
+        # same result as decomposing them serially. Multiple unitaries are
+        # decomposed per program to also exercise reuse of the thread pool.
+        rng = np.random.RandomState(7)
+        matrices = []
+        for num_qubits in [4, 5, 5]:
+            size = 2**num_qubits
+            q, r = np.linalg.qr(rng.randn(size, size) + 1j * rng.randn(size, size))
+            q = q * (np.diag(r) / abs(np.diag(r)))
+            matrices.append((num_qubits, q.flatten().tolist()))
+
+        outputs = []
+        for threads in ['1', '4', '0']:
+            ql.set_option('unitary_decomposition_threads', threads)
+            try:
+                p = ql.Program('test_unitary_decomposition_threads_' + threads, platform, 5)
+                for i, (num_qubits, matrix) in enumerate(matrices):
+                    k = ql.Kernel('kernel%d' % i, platform, 5)
+                    u = ql.Unitary('u%d' % i, matrix)
+                    u.decompose()
+                    k.gate(u, list(range(num_qubits)))
+                    p.add_kernel(k)
+            finally:
+                ql.set_option('unitary_decomposition_threads', '1')
+
+            p.get_compiler().set_option('initialqasmwriter.cqasm_version', '1.0')
+            p.get_compiler().set_option('initialqasmwriter.with_metadata', 'no')
+            p.compile()
+            with open(os.path.join(output_dir, p.name + '.qasm')) as f:
+                outputs.append(f.read().split('.kernel')[1:])
+        self.assertEqual(len(outputs[0]), 3)
+        self.assertEqual(outputs[0], outputs[1])
+        self.assertEqual(outputs[0], outputs[2])
+
     @unittest.skipIf(qx is None, "qxelarator not installed")
     def test_usingqx_00(self):
         num_qubits = 2